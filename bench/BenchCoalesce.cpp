@@ -0,0 +1,140 @@
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// BenchCoalesce.cpp
+//
+// Circular buffer stores and evictions of RainGauge with and without coalescing of
+// unchanged readings, at several fractions of dry days
+//
+// https://github.com/matthias-bs/BresserWeatherSensorReceiver
+//
+//
+// created: 10/2026
+//
+//
+// MIT License
+//
+// Copyright (c) 2026 Matthias Prinke
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+// History:
+//
+// 20261016 Created
+//
+// ToDo:
+// -
+//
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+
+#include <string.h>
+#include <vector>
+
+#include "BenchUtil.h"
+#include "RainGauge.h"
+#include "TimeZone.h"
+
+#define BENCH_INTERVAL 30  // seconds between readings
+
+// Circular buffer large enough for one reading every BENCH_INTERVAL seconds
+typedef RainGaugeT<3600, 256, 10> RainGaugeBench;
+
+/*
+ * Readings every BENCH_INTERVAL seconds; rain in showers on the given percentage of days
+ */
+static void makeSamples(std::vector<rainSample_t> &samples, size_t days, unsigned wetPercent)
+{
+    uint32_t x    = 2463534242u;
+    float    rain = 0;
+    size_t   n    = days * CIVIL_SECONDS_PER_DAY / BENCH_INTERVAL;
+
+    samples.resize(n);
+    for (size_t i = 0; i < n; i++) {
+        x ^= x << 13;
+        x ^= x >> 17;
+        x ^= x << 5;
+        time_t t = 1662422400 + (time_t)i * BENCH_INTERVAL;
+        // Wet days spread evenly over the period
+        bool wet = ((i / (CIVIL_SECONDS_PER_DAY / BENCH_INTERVAL)) * wetPercent) % 100 < wetPercent;
+        // Showers in the first quarter of every three hours
+        if (wet && ((t % 10800) < 2700) && ((x >> 8) % 4 == 0)) {
+            rain += 0.1f * (float)(1 + (x >> 16) % 5);
+        }
+        if (rain >= RAINGAUGE_MAX_VALUE) {
+            rain -= RAINGAUGE_MAX_VALUE;
+        }
+        samples[i].epoch   = t;
+        samples[i].rain    = rain;
+        samples[i].startup = false;
+    }
+}
+
+/*
+ * Update a rain gauge with all samples and report time, stores and evictions
+ */
+static void run(const std::vector<rainSample_t> &samples, const TimeZone *tz, bool coalesce, unsigned wetPercent)
+{
+    nvDataT<256>   data;
+    RainGaugeBench rg(&data);
+    char           name[80];
+
+    memset(&data, 0, sizeof(data));
+    rg.reset();
+    rg.setTimeZone(tz);
+    rg.setCoalescing(coalesce);
+
+    snprintf(name, sizeof(name), "update(), %3u%% wet days, %s", wetPercent, coalesce ? "coalescing" : "every reading");
+    benchReport(name, benchNsPerOp(samples.size(), [&](size_t i) {
+        rg.update(samples[i].epoch, samples[i].rain, samples[i].startup);
+    }));
+    benchSink = rg.pastHour();
+
+    // Second (untimed) pass: count stores and evictions from the movement of head and tail
+    uint64_t stores    = 0;
+    uint64_t evictions = 0;
+    memset(&data, 0, sizeof(data));
+    rg.reset();
+    for (size_t i = 0; i < samples.size(); i++) {
+        unsigned head = data.head;
+        unsigned tail = data.tail;
+        rg.update(samples[i].epoch, samples[i].rain, samples[i].startup);
+        stores    += (data.head + 256 - head) % 256;
+        evictions += (data.tail + 256 - tail) % 256;
+    }
+    printf("    %10llu stores (%5.1f%%) %10llu evictions\n", (unsigned long long)stores,
+           100.0 * (double)stores / (double)samples.size(), (unsigned long long)evictions);
+}
+
+int main(int argc, char *argv[])
+{
+    size_t   days = benchIterations(argc, argv, 365);
+    unsigned wet[] = {100, 75, 50, 25, 10, 0};
+    TimeZone utc;
+
+    std::vector<rainSample_t> samples;
+
+    printf("%zu days, one reading every %d s\n", days, BENCH_INTERVAL);
+
+    for (size_t k = 0; k < sizeof(wet) / sizeof(wet[0]); k++) {
+        makeSamples(samples, days, wet[k]);
+        run(samples, &utc, false, wet[k]);
+        run(samples, &utc, true, wet[k]);
+    }
+
+    return 0;
+}
@@ -0,0 +1,165 @@
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// BenchFleet.cpp
+//
+// Benchmark: RainGaugeFleet (structure of arrays, batch update) versus one
+// RainGauge and nvData_t per gauge at 10k, 100k and 1M gauges
+//
+// https://github.com/matthias-bs/BresserWeatherSensorReceiver
+//
+//
+// created: 10/2026
+//
+//
+// MIT License
+//
+// Copyright (c) 2026 Matthias Prinke
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+// History:
+//
+// 20261016 Created
+// 20261016 Added updateAll() with scalar and SIMD kernels
+// 20261017 Report SSE4.1 level
+//
+// ToDo:
+// -
+//
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+
+#include <vector>
+
+#include "BenchUtil.h"
+#include "RainGauge.h"
+#include "RainGaugeFleet.h"
+#include "TimeZone.h"
+
+// Update rate: one reading per gauge every 6 minutes
+#define BENCH_INTERVAL 360
+
+/*
+ * Readings of one tick: every gauge once, in pseudo-random arrival order
+ */
+static void makeTick(size_t gauges, std::vector<uint32_t> &ids)
+{
+    ids.resize(gauges);
+    for (size_t i = 0; i < gauges; i++) {
+        ids[i] = (uint32_t)i;
+    }
+    uint32_t x = 2463534242u;
+    for (size_t i = gauges - 1; i > 0; i--) {
+        x ^= x << 13;
+        x ^= x >> 17;
+        x ^= x << 5;
+        size_t j = x % (i + 1);
+        uint32_t tmp = ids[i];
+        ids[i] = ids[j];
+        ids[j] = tmp;
+    }
+}
+
+static void run(size_t gauges, size_t ticks)
+{
+    const time_t t0 = 1662422400; // 2022-09-06 00:00 UTC
+    TimeZone     utc;
+    char         name[64];
+
+    std::vector<uint32_t> ids;
+    std::vector<time_t>   epochs(gauges);
+    std::vector<float>    values(gauges);
+    makeTick(gauges, ids);
+
+    // One RainGauge and nvData_t per gauge
+    std::vector<nvData_t>  data(gauges);
+    std::vector<RainGauge> single;
+    single.reserve(gauges);
+    for (size_t g = 0; g < gauges; g++) {
+        single.push_back(RainGauge(&data[g]));
+        single[g].reset();
+        single[g].setTimeZone(&utc);
+    }
+    double nsSingle = benchNsPerOp(ticks, [&](size_t tick) {
+        time_t t = t0 + (time_t)tick * BENCH_INTERVAL;
+        for (size_t k = 0; k < gauges; k++) {
+            uint32_t id = ids[k];
+            single[id].update(t + (time_t)(k % BENCH_INTERVAL), 0.1f * (float)((tick + id) % 1000));
+        }
+    }) / (double)gauges;
+    benchSink = single[0].pastHour();
+    single.clear();
+    single.shrink_to_fit();
+    data.clear();
+    data.shrink_to_fit();
+
+    // Structure of arrays, one batch per tick
+    double nsFleet;
+    {
+        RainGaugeFleet fleet(gauges);
+        fleet.setTimeZone(&utc);
+        nsFleet = benchNsPerOp(ticks, [&](size_t tick) {
+            time_t t = t0 + (time_t)tick * BENCH_INTERVAL;
+            for (size_t k = 0; k < gauges; k++) {
+                epochs[k] = t + (time_t)(k % BENCH_INTERVAL);
+                values[k] = 0.1f * (float)((tick + ids[k]) % 1000);
+            }
+            fleet.updateBatch(gauges, &ids[0], &epochs[0], &values[0]);
+        }) / (double)gauges;
+        benchSink = fleet.pastHour(0);
+    }
+
+    // Structure of arrays, all gauges at a common time stamp
+    double nsAll[2];
+    RainSimdLevel levels[2] = {RAIN_SIMD_SCALAR, rainSimdDetect()};
+    for (int l = 0; l < 2; l++) {
+        RainGaugeFleet fleet(gauges);
+        fleet.setTimeZone(&utc);
+        rainSimdSelect(levels[l]);
+        nsAll[l] = benchNsPerOp(ticks, [&](size_t tick) {
+            for (size_t id = 0; id < gauges; id++) {
+                values[id] = 0.1f * (float)((tick + id) % 1000);
+            }
+            fleet.updateAll(t0 + (time_t)tick * BENCH_INTERVAL, &values[0]);
+        }) / (double)gauges;
+        benchSink = fleet.pastHour(0);
+    }
+
+    snprintf(name, sizeof(name), "%zu x RainGauge::update(time_t)", gauges);
+    benchReport(name, nsSingle);
+    snprintf(name, sizeof(name), "RainGaugeFleet(%zu)::updateBatch()", gauges);
+    benchReport(name, nsFleet);
+    snprintf(name, sizeof(name), "RainGaugeFleet(%zu)::updateAll(), scalar", gauges);
+    benchReport(name, nsAll[0]);
+    snprintf(name, sizeof(name), "RainGaugeFleet(%zu)::updateAll(), %s", gauges,
+             (levels[1] == RAIN_SIMD_AVX2) ? "AVX2" : (levels[1] == RAIN_SIMD_SSE41) ? "SSE4.1" : "scalar");
+    benchReport(name, nsAll[1]);
+}
+
+int main(int argc, char *argv[])
+{
+    size_t ticks = benchIterations(argc, argv, 20);
+
+    printf("RainGaugeFleet benchmark, %zu ticks, one reading per gauge and tick (ns per reading)\n", ticks);
+
+    run(10000, ticks);
+    run(100000, ticks);
+    run(1000000, ticks);
+
+    return 0;
+}
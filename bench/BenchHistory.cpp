@@ -0,0 +1,142 @@
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// BenchHistory.cpp
+//
+// Benchmark: parallel replay of rain gauge history (RainHistory) with 1..N threads,
+// one gauge with a long history and many gauges with short histories,
+// compared to sequential RainGauge::update()
+//
+// Usage: bench_history [days] [max_threads]
+//
+// https://github.com/matthias-bs/BresserWeatherSensorReceiver
+//
+//
+// created: 10/2026
+//
+//
+// MIT License
+//
+// Copyright (c) 2026 Matthias Prinke
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+// History:
+//
+// 20261016 Created
+// 20261017 Thread counts end with maxThreads
+//
+// ToDo:
+// -
+//
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+
+
+#include <thread>
+#include <vector>
+
+#include "BenchUtil.h"
+#include "RainGauge.h"
+#include "RainHistory.h"
+#include "TimeZone.h"
+
+#define BENCH_GAUGES 64
+
+/*
+ * Readings every minute, interleaved across gauges
+ */
+static void makeArchive(std::vector<RainReading> &archive, unsigned gauges, size_t minutes)
+{
+    std::vector<float> rain(gauges, 0.0f);
+    uint32_t x = 2463534242u;
+
+    archive.resize(minutes * gauges);
+    for (size_t m = 0; m < minutes; m++) {
+        for (unsigned g = 0; g < gauges; g++) {
+            x ^= x << 13;
+            x ^= x >> 17;
+            x ^= x << 5;
+            if ((m / 600 + g) % 5 == 0)
+                rain[g] += 0.1f * (float)(x % 3);
+            if (rain[g] >= RAINGAUGE_MAX_VALUE)
+                rain[g] -= RAINGAUGE_MAX_VALUE;
+            RainReading &r = archive[m * gauges + g];
+            r.epoch   = 1577836800 + (time_t)m * 60; // from 2020-01-01 00:00 UTC
+            r.id      = g;
+            r.value   = rain[g];
+            r.startup = false;
+        }
+    }
+}
+
+static void run(const char *title, unsigned gauges, size_t minutes, unsigned maxThreads, const TimeZone *tz)
+{
+    std::vector<RainReading> archive;
+    char                     name[64];
+
+    makeArchive(archive, gauges, minutes);
+    printf("%s: %u gauge(s), %zu readings (ns per reading)\n", title, gauges, archive.size());
+
+    std::vector<nvData_t> data(gauges);
+    double nsSeq = benchNsPerOp(1, [&](size_t) {
+        for (unsigned g = 0; g < gauges; g++) {
+            RainGauge gauge(&data[g]);
+            gauge.reset();
+            gauge.setTimeZone(tz);
+            for (size_t k = g; k < archive.size(); k += gauges) {
+                gauge.update(archive[k].epoch, archive[k].value);
+            }
+            benchSink = gauge.currentDay();
+        }
+    }) / (double)archive.size();
+    benchReport("RainGauge::update(), sequential", nsSeq);
+
+    std::vector<unsigned> counts = benchThreadCounts(maxThreads);
+    double                nsOne  = 0;
+    for (size_t c = 0; c < counts.size(); c++) {
+        unsigned    threads = counts[c];
+        RainHistory history(gauges, threads);
+        history.setTimeZone(tz);
+        double ns = benchNsPerOp(1, [&](size_t) {
+            history.replay(archive.size(), &archive[0]);
+        }) / (double)archive.size();
+        benchSink = history.current(0);
+        if (threads == 1)
+            nsOne = ns;
+
+        snprintf(name, sizeof(name), "RainHistory, %u thread(s), speedup %.2f", threads, nsOne / ns);
+        benchReport(name, ns);
+    }
+}
+
+int main(int argc, char *argv[])
+{
+    size_t   days       = benchIterations(argc, argv, 3 * 365);
+    unsigned maxThreads = (argc > 2) ? (unsigned)strtoul(argv[2], NULL, 10) : std::thread::hardware_concurrency();
+    TimeZone cet;
+
+    if (maxThreads == 0)
+        maxThreads = 1;
+    cet.loadPosix("CET-1CEST,M3.5.0,M10.5.0/3");
+
+    // Same number of readings: split by month vs. split by gauge
+    run("Long history", 1, days * 1440, maxThreads, &cet);
+    run("Many gauges", BENCH_GAUGES, days * 1440 / BENCH_GAUGES, maxThreads, &cet);
+
+    return 0;
+}
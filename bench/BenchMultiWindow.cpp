@@ -0,0 +1,142 @@
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// BenchMultiWindow.cpp
+//
+// Benchmark: several rolling windows (10 min / 1 h / 3 h / 24 h) in one RainGaugeMultiT
+// versus one independent rain gauge per window
+//
+// https://github.com/matthias-bs/BresserWeatherSensorReceiver
+//
+//
+// created: 10/2026
+//
+//
+// MIT License
+//
+// Copyright (c) 2026 Matthias Prinke
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+// History:
+//
+// 20261016 Created
+//
+// ToDo:
+// -
+//
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+
+#include <vector>
+
+#include "BenchUtil.h"
+#include "RainGauge.h"
+#include "RainGaugeBuckets.h"
+#include "RainGaugeMulti.h"
+#include "TimeZone.h"
+
+// Update rate: one reading per minute
+#define BENCH_INTERVAL 60
+
+static const uint32_t windows[4] = {600, 3600, 3 * 3600, 24 * 3600};
+
+int main(int argc, char *argv[])
+{
+    size_t iterations = benchIterations(argc, argv, 1000000);
+
+    // Readings every minute, starting 2022-09-06 00:00 UTC
+    const time_t t0 = 1662422400;
+    TimeZone     utc;
+
+    printf("RainGauge multi-window benchmark, %zu iterations, 4 windows, %d s update rate\n",
+           iterations, BENCH_INTERVAL);
+
+    // One shared buffer and eviction pass for all windows
+    static nvMultiDataT<1442, 4> dataMulti;
+    RainGaugeMultiT<1442, 4, 10> multi(&dataMulti, windows);
+    multi.reset();
+    multi.setTimeZone(&utc);
+    double nsMulti = benchNsPerOp(iterations, [&](size_t i) {
+        multi.update(t0 + (time_t)i * BENCH_INTERVAL, 0.1f * (float)(i % 1000));
+        benchSink = multi.pastWindow(0) + multi.pastWindow(1) + multi.pastWindow(2) + multi.pastWindow(3);
+    });
+
+    // Same engine, one instance per window
+    static nvMultiDataT<12, 1>   data10m;
+    static nvMultiDataT<62, 1>   data1h;
+    static nvMultiDataT<182, 1>  data3h;
+    static nvMultiDataT<1442, 1> data24h;
+    const uint32_t w10m[1] = {windows[0]};
+    const uint32_t w1h[1]  = {windows[1]};
+    const uint32_t w3h[1]  = {windows[2]};
+    const uint32_t w24h[1] = {windows[3]};
+    RainGaugeMultiT<12, 1, 10>   single10m(&data10m, w10m);
+    RainGaugeMultiT<62, 1, 10>   single1h(&data1h, w1h);
+    RainGaugeMultiT<182, 1, 10>  single3h(&data3h, w3h);
+    RainGaugeMultiT<1442, 1, 10> single24h(&data24h, w24h);
+    single10m.reset();
+    single1h.reset();
+    single3h.reset();
+    single24h.reset();
+    single10m.setTimeZone(&utc);
+    single1h.setTimeZone(&utc);
+    single3h.setTimeZone(&utc);
+    single24h.setTimeZone(&utc);
+    double nsSingle = benchNsPerOp(iterations, [&](size_t i) {
+        time_t t    = t0 + (time_t)i * BENCH_INTERVAL;
+        float  rain = 0.1f * (float)(i % 1000);
+        single10m.update(t, rain);
+        single1h.update(t, rain);
+        single3h.update(t, rain);
+        single24h.update(t, rain);
+        benchSink = single10m.pastWindow(0) + single1h.pastWindow(0) + single3h.pastWindow(0) + single24h.pastWindow(0);
+    });
+
+    // Existing engines: RainGaugeT for windows < 1 day, time buckets for 24 h
+    static nvDataT<12>  dataT10m;
+    static nvDataT<62>  dataT1h;
+    static nvDataT<182> dataT3h;
+    static nvBucketDataT<1440> dataB24h;
+    RainGaugeT<600, 12, 10>         gauge10m(&dataT10m);
+    RainGaugeT<3600, 62, 10>        gauge1h(&dataT1h);
+    RainGaugeT<3 * 3600, 182, 10>   gauge3h(&dataT3h);
+    RainGaugeBucketT<24 * 3600, 1440, 10> gauge24h(&dataB24h);
+    gauge10m.reset();
+    gauge1h.reset();
+    gauge3h.reset();
+    gauge24h.reset();
+    gauge10m.setTimeZone(&utc);
+    gauge1h.setTimeZone(&utc);
+    gauge3h.setTimeZone(&utc);
+    gauge24h.setTimeZone(&utc);
+    double nsEngines = benchNsPerOp(iterations, [&](size_t i) {
+        time_t t    = t0 + (time_t)i * BENCH_INTERVAL;
+        float  rain = 0.1f * (float)(i % 1000);
+        gauge10m.update(t, rain);
+        gauge1h.update(t, rain);
+        gauge3h.update(t, rain);
+        gauge24h.update(t, rain);
+        benchSink = gauge10m.pastHour() + gauge1h.pastHour() + gauge3h.pastHour() + gauge24h.pastHour();
+    });
+
+    benchReport("RainGaugeMultiT, 4 windows, one pass", nsMulti);
+    benchReport("4 x RainGaugeMultiT, 1 window each", nsSingle);
+    benchReport("3 x RainGaugeT + RainGaugeBucketT (24 h)", nsEngines);
+
+    return 0;
+}
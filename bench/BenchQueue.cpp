@@ -0,0 +1,198 @@
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// BenchQueue.cpp
+//
+// Benchmark: ingestion queues - mutex-protected deque versus RainSpscQueue and
+// RainMpscQueue, and queued ingestion into RainGaugeShards
+//
+// https://github.com/matthias-bs/BresserWeatherSensorReceiver
+//
+//
+// created: 10/2026
+//
+//
+// MIT License
+//
+// Copyright (c) 2026 Matthias Prinke
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+// History:
+//
+// 20261016 Created
+//
+// ToDo:
+// -
+//
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+
+#include <atomic>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "BenchUtil.h"
+#include "RainGaugeShards.h"
+#include "RainQueue.h"
+#include "TimeZone.h"
+
+#define BENCH_GAUGES   10000
+#define BENCH_CAPACITY 4096
+#define BENCH_BATCH    256
+
+/*
+ * Baseline: std::deque protected by a mutex
+ */
+class MutexQueue {
+public:
+    bool push(const RainReading &r) {
+      std::lock_guard<std::mutex> guard(lock);
+      if (q.size() >= BENCH_CAPACITY)
+          return false;
+      q.push_back(r);
+      return true;
+    };
+
+    size_t popBatch(RainReading *out, size_t max) {
+      std::lock_guard<std::mutex> guard(lock);
+      size_t n = 0;
+      while ((n < max) && !q.empty()) {
+          out[n++] = q.front();
+          q.pop_front();
+      }
+      return n;
+    };
+
+private:
+    std::mutex              lock;
+    std::deque<RainReading> q;
+};
+
+static RainReading reading(uint32_t producer, size_t i)
+{
+    RainReading r;
+    r.id      = (uint32_t)((producer + i * 7) % BENCH_GAUGES);
+    r.epoch   = 1662422400 + (time_t)(i / BENCH_GAUGES) * 60;
+    r.value   = 0.1f * (float)(i % 1000);
+    r.startup = false;
+    return r;
+}
+
+/*
+ * Time per reading for producers -> queue -> one consumer
+ */
+template <class Q>
+static double transfer(Q &q, unsigned producers, size_t perProducer)
+{
+    return benchNsPerOp(1, [&](size_t) {
+        std::vector<std::thread> threads;
+        for (unsigned p = 0; p < producers; p++) {
+            threads.push_back(std::thread([&q, p, perProducer]() {
+                for (size_t i = 0; i < perProducer; ) {
+                    if (q.push(reading(p, i)))
+                        i++;
+                    else
+                        std::this_thread::yield();
+                }
+            }));
+        }
+        RainReading out[BENCH_BATCH];
+        size_t      received = 0;
+        while (received < producers * perProducer) {
+            size_t n = q.popBatch(out, BENCH_BATCH);
+            if (n == 0)
+                std::this_thread::yield();
+            for (size_t k = 0; k < n; k++) {
+                benchSink = out[k].value;
+            }
+            received += n;
+        }
+        for (size_t p = 0; p < threads.size(); p++) {
+            threads[p].join();
+        }
+    }) / (double)(producers * perProducer);
+}
+
+int main(int argc, char *argv[])
+{
+    size_t   perProducer = benchIterations(argc, argv, 1000000);
+    unsigned producers   = (argc > 2) ? (unsigned)strtoul(argv[2], NULL, 10) : 4;
+    char     name[64];
+
+    printf("Ingestion queue benchmark, %u producers x %zu readings, capacity %d (ns per reading)\n",
+           producers, perProducer, BENCH_CAPACITY);
+
+    {
+        MutexQueue q;
+        benchReport("1 producer, mutex + std::deque", transfer(q, 1, perProducer));
+    }
+    {
+        RainSpscQueue<RainReading> q(BENCH_CAPACITY);
+        benchReport("1 producer, RainSpscQueue", transfer(q, 1, perProducer));
+    }
+    {
+        MutexQueue q;
+        snprintf(name, sizeof(name), "%u producers, mutex + std::deque", producers);
+        benchReport(name, transfer(q, producers, perProducer));
+    }
+    {
+        RainMpscQueue<RainReading> q(BENCH_CAPACITY);
+        snprintf(name, sizeof(name), "%u producers, RainMpscQueue", producers);
+        benchReport(name, transfer(q, producers, perProducer));
+    }
+
+    // Receivers push into the shard queues, one thread drains
+    TimeZone        utc;
+    RainGaugeShards shards(BENCH_GAUGES, producers, 0, BENCH_CAPACITY);
+    shards.setTimeZone(&utc);
+    double ns = benchNsPerOp(1, [&](size_t) {
+        std::vector<std::thread> threads;
+        std::atomic<unsigned>    finished(0);
+        for (unsigned p = 0; p < producers; p++) {
+            threads.push_back(std::thread([&shards, &finished, p, perProducer, producers]() {
+                for (size_t i = 0; i < perProducer; i++) {
+                    RainReading r = reading(0, i);
+                    // Each gauge is served by one receiver
+                    r.id = (uint32_t)((r.id / producers) * producers + p);
+                    if (r.id >= BENCH_GAUGES)
+                        continue;
+                    while (!shards.push(r)) {
+                        std::this_thread::yield();
+                    }
+                }
+                finished++;
+            }));
+        }
+        while (finished.load() < producers) {
+            if (shards.drain() == 0)
+                std::this_thread::yield();
+        }
+        for (size_t p = 0; p < threads.size(); p++) {
+            threads[p].join();
+        }
+        shards.drain();
+    }) / (double)(producers * perProducer);
+    benchSink = shards.pastHour(0);
+    snprintf(name, sizeof(name), "%u receivers, RainGaugeShards push/drain", producers);
+    benchReport(name, ns);
+    printf("rejected (back-pressure): %llu\n", (unsigned long long)shards.rejected());
+
+    return 0;
+}
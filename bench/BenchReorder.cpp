@@ -0,0 +1,132 @@
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// BenchReorder.cpp
+//
+// Throughput of RainReorderBuffer in front of RainGaugeFleet::update() at several
+// lateness horizons (reorder depths)
+//
+// https://github.com/matthias-bs/BresserWeatherSensorReceiver
+//
+//
+// created: 10/2026
+//
+//
+// MIT License
+//
+// Copyright (c) 2026 Matthias Prinke
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+// History:
+//
+// 20261016 Created
+//
+// ToDo:
+// -
+//
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+
+
+
+#include <algorithm>
+#include <vector>
+
+#include "BenchUtil.h"
+#include "RainGaugeFleet.h"
+#include "RainReorder.h"
+#include "TimeZone.h"
+
+#define BENCH_GAUGES 1000
+#define BENCH_RATE   50    // readings per second
+#define BENCH_BATCH  256
+
+/*
+ * Readings of BENCH_GAUGES gauges in arrival order, each delayed by up to jitter seconds
+ */
+static void makeReadings(std::vector<RainReading> &readings, size_t n, uint32_t jitter)
+{
+    std::vector<std::pair<int64_t, size_t> > arrival(n);
+    std::vector<RainReading>                 sorted(n);
+    std::vector<float>                       rain(BENCH_GAUGES, 0.0f);
+    uint32_t x = 2463534242u;
+
+    for (size_t i = 0; i < n; i++) {
+        x ^= x << 13;
+        x ^= x >> 17;
+        x ^= x << 5;
+        RainReading &r = sorted[i];
+        r.id      = x % BENCH_GAUGES;
+        r.epoch   = 1662422400 + (time_t)(i / BENCH_RATE);
+        r.startup = false;
+        rain[r.id] += 0.1f * (float)(x % 3);
+        r.value   = rain[r.id];
+        // Delay in 1/BENCH_RATE s, so readings of the same second are shuffled as well
+        int64_t delay = (jitter > 0) ? (int64_t)((x >> 8) % (jitter * BENCH_RATE)) : 0;
+        arrival[i] = std::make_pair((int64_t)i + delay, i);
+    }
+    std::sort(arrival.begin(), arrival.end());
+    readings.resize(n);
+    for (size_t i = 0; i < n; i++) {
+        readings[i] = sorted[arrival[i].second];
+    }
+}
+
+int main(int argc, char *argv[])
+{
+    size_t     n = benchIterations(argc, argv, 1000000);
+    uint32_t   horizons[] = {0, 10, 60, 300, 900};
+    TimeZone   utc;
+    char       name[80];
+
+    std::vector<RainReading> readings;
+    RainReading              out[BENCH_BATCH];
+
+    printf("%zu readings of %d rain gauges, %d readings/s\n", n, BENCH_GAUGES, BENCH_RATE);
+
+    makeReadings(readings, n, 0);
+    RainGaugeFleet plain(BENCH_GAUGES);
+    plain.setTimeZone(&utc);
+    benchReport("update() without reorder stage", benchNsPerOp(n / BENCH_BATCH, [&](size_t b) {
+        plain.update(BENCH_BATCH, &readings[b * BENCH_BATCH]);
+    }) / BENCH_BATCH);
+
+    for (size_t h = 0; h < sizeof(horizons) / sizeof(horizons[0]); h++) {
+        RainGaugeFleet    fleet(BENCH_GAUGES);
+        RainReorderBuffer reorder(BENCH_GAUGES, horizons[h], (size_t)horizons[h] * BENCH_RATE + BENCH_BATCH);
+        size_t            maxHeld = 0;
+
+        fleet.setTimeZone(&utc);
+        makeReadings(readings, n, horizons[h]);
+        snprintf(name, sizeof(name), "reorder + update(), horizon %4u s", horizons[h]);
+        double ns = benchNsPerOp(n / BENCH_BATCH, [&](size_t b) {
+            for (size_t k = 0; k < BENCH_BATCH; k++) {
+                reorder.push(readings[b * BENCH_BATCH + k]);
+            }
+            maxHeld = std::max(maxHeld, reorder.size());
+            size_t m;
+            while ((m = reorder.pop(out, BENCH_BATCH)) > 0) {
+                fleet.update(m, out);
+            }
+        }) / BENCH_BATCH;
+        benchReport(name, ns);
+        printf("    max. depth %zu readings, %llu late\n", maxHeld, (unsigned long long)reorder.late());
+    }
+
+    return 0;
+}
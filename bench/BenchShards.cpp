@@ -0,0 +1,104 @@
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// BenchShards.cpp
+//
+// Benchmark: throughput scaling of RainGaugeShards (sharded fleet, work-stealing
+// thread pool) from 1 to N threads
+//
+// https://github.com/matthias-bs/BresserWeatherSensorReceiver
+//
+//
+// created: 10/2026
+//
+//
+// MIT License
+//
+// Copyright (c) 2026 Matthias Prinke
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+// History:
+//
+// 20261016 Created
+// 20261017 Thread counts end with maxThreads
+//
+// ToDo:
+// -
+//
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+
+#include <thread>
+#include <vector>
+
+#include "BenchUtil.h"
+#include "RainGaugeShards.h"
+#include "TimeZone.h"
+
+#define BENCH_GAUGES 100000
+#define BENCH_BATCH  (4 * BENCH_GAUGES)
+
+int main(int argc, char *argv[])
+{
+    size_t   batches = benchIterations(argc, argv, 20);
+    unsigned maxThreads = (argc > 2) ? (unsigned)strtoul(argv[2], NULL, 10) : std::thread::hardware_concurrency();
+    if (maxThreads == 0)
+        maxThreads = 1;
+
+    const time_t t0 = 1662422400; // 2022-09-06 00:00 UTC
+    TimeZone     utc;
+    char         name[64];
+
+    printf("RainGaugeShards benchmark, %d gauges, %zu batches of %d readings, 1..%u threads (ns per reading)\n",
+           BENCH_GAUGES, batches, BENCH_BATCH, maxThreads);
+
+    // Readings in pseudo-random gauge order; a gauge's readings stay in chronological order
+    std::vector<RainReading> batch(BENCH_BATCH);
+    uint32_t x = 2463534242u;
+    for (size_t k = 0; k < batch.size(); k++) {
+        x ^= x << 13;
+        x ^= x >> 17;
+        x ^= x << 5;
+        batch[k].id      = x % BENCH_GAUGES;
+        batch[k].startup = false;
+    }
+
+    double nsOne = 0;
+    std::vector<unsigned> counts = benchThreadCounts(maxThreads);
+    for (size_t c = 0; c < counts.size(); c++) {
+        unsigned        threads = counts[c];
+        RainGaugeShards shards(BENCH_GAUGES, threads);
+        shards.setTimeZone(&utc);
+
+        double ns = benchNsPerOp(batches, [&](size_t b) {
+            for (size_t k = 0; k < batch.size(); k++) {
+                batch[k].epoch = t0 + (time_t)(b * 600 + k * 600 / BENCH_BATCH);
+                batch[k].value = 0.1f * (float)((b + batch[k].id) % 1000);
+            }
+            shards.ingest(batch.size(), &batch[0]);
+        }) / (double)BENCH_BATCH;
+        benchSink = shards.pastHour(0);
+        if (threads == 1)
+            nsOne = ns;
+
+        snprintf(name, sizeof(name), "%u thread(s), %u shards, speedup %.2f", threads, shards.shards(), nsOne / ns);
+        benchReport(name, ns);
+    }
+
+    return 0;
+}
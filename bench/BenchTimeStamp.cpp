@@ -0,0 +1,261 @@
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// BenchTimeStamp.cpp
+//
+// Benchmark of RainGauge::update() time stamp calculation:
+// libc mktime() (previous implementation) vs. civil calendar arithmetic,
+// update() with struct tm vs. epoch time stamps, backfill() of history
+//
+// Usage: bench_timestamp [iterations]
+//
+// https://github.com/matthias-bs/BresserWeatherSensorReceiver
+//
+//
+// created: 10/2026
+//
+//
+// MIT License
+//
+// Copyright (c) 2026 Matthias Prinke
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+// History:
+//
+// 20261016 Created
+// 20261016 Added update() with epoch time stamp
+// 20261016 Added backfill()
+// 20261017 Measure RainGauge::update() of 10/2026 instead of estimating it
+//
+// ToDo:
+// -
+//
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include <string.h>
+#include <vector>
+
+#include "BenchUtil.h"
+#include "RainGauge.h"
+
+/*
+ * Time stamp calculation as implemented up to 10/2026 (two mktime() calls)
+ */
+static uint32_t legacyTimeStamp(tm t)
+{
+    time_t  ts;
+    tm      t_midnight;
+    time_t  ts_midnight;
+
+    t.tm_sec           = 0;
+    t_midnight = t;
+    t_midnight.tm_hour = 0;
+    t_midnight.tm_min  = 0;
+    ts          = mktime(&t);
+    ts_midnight = mktime(&t_midnight);
+
+    return (uint32_t)(ts - ts_midnight);
+}
+
+/*
+ * Non-volatile data and update() as implemented up to 10/2026
+ */
+typedef struct {
+    uint32_t  tsBuf[RAINGAUGE_BUF_SIZE];
+    uint16_t  rainBuf[RAINGAUGE_BUF_SIZE];
+    uint8_t   head;
+    uint8_t   tail;
+    bool      startupPrev;
+    float     rainStartup;
+    uint8_t   tsDayBegin;
+    float     rainDayBegin;
+    uint8_t   tsWeekBegin;
+    float     rainWeekBegin;
+    uint8_t   wdayPrev;
+    uint8_t   tsMonthBegin;
+    float     rainMonthBegin;
+    float     rainPrev;
+    uint16_t  rainOvf;
+} legacyData_t;
+
+class LegacyRainGauge {
+public:
+    LegacyRainGauge(void) : rainCurr(0) {
+      reset();
+    };
+
+    void reset(void) {
+      memset(&nvData, 0, sizeof(nvData));
+      nvData.tsDayBegin   = 0xFF;
+      nvData.tsWeekBegin  = 0xFF;
+      nvData.wdayPrev     = 0xFF;
+      nvData.tsMonthBegin = 0xFF;
+    };
+
+    void update(tm t, float rain, bool startup = false, float raingaugeMax = RAINGAUGE_MAX_VALUE) {
+      uint8_t  head_tmp;
+      uint32_t ts = legacyTimeStamp(t);
+
+      if (rain < nvData.rainPrev) {
+          if (!nvData.startupPrev && startup) {
+              nvData.rainStartup = nvData.rainPrev;
+          } else {
+              nvData.rainOvf++;
+          }
+      }
+      nvData.startupPrev = startup;
+      nvData.rainPrev = rain;
+      rainCurr = (nvData.rainOvf * raingaugeMax) + nvData.rainStartup + rain;
+
+      if (nvData.wdayPrev == 0xFF) {
+          nvData.wdayPrev = t.tm_wday;
+          nvData.tsBuf[nvData.tail]   = ts;
+          nvData.rainBuf[nvData.tail] = (uint16_t)(rainCurr * 10);
+      }
+
+      uint32_t ts_cmp;
+      while (!(nvData.tail == nvData.head)) {
+          ts_cmp = ts;
+          if (ts_cmp < nvData.tsBuf[nvData.tail]) {
+              ts_cmp = ts_cmp + CIVIL_SECONDS_PER_DAY;
+          }
+          if ((ts_cmp - nvData.tsBuf[nvData.tail]) <= CIVIL_SECONDS_PER_HOUR)
+              break;
+          nvData.tail = (nvData.tail == RAINGAUGE_BUF_SIZE-1) ? 0 : nvData.tail+1;
+      }
+
+      head_tmp = (nvData.head == RAINGAUGE_BUF_SIZE-1) ? 0 : nvData.head+1;
+      nvData.head = (head_tmp == nvData.tail) ? nvData.head : head_tmp;
+      nvData.tsBuf[nvData.head]   = ts;
+      nvData.rainBuf[nvData.head] = (uint16_t)(rainCurr * 10);
+
+      if ((t.tm_wday != nvData.tsDayBegin) || (nvData.tsDayBegin == 0xFF)) {
+          nvData.tsDayBegin = t.tm_wday;
+          nvData.rainDayBegin = rainCurr;
+      }
+      if (((t.tm_wday == 1) && (nvData.wdayPrev == 0)) || (nvData.tsWeekBegin == 0xFF)) {
+          nvData.tsWeekBegin = t.tm_wday;
+          nvData.rainWeekBegin = rainCurr;
+      }
+      nvData.wdayPrev = t.tm_wday;
+      if ((t.tm_mon != nvData.tsMonthBegin) || (nvData.tsMonthBegin == 0xFF)) {
+          nvData.tsMonthBegin = t.tm_mon;
+          nvData.rainMonthBegin = rainCurr;
+      }
+    };
+
+    float pastHour(void) const {
+      return (float)(0.1 * (nvData.rainBuf[nvData.head] - nvData.rainBuf[nvData.tail]));
+    };
+
+private:
+    legacyData_t nvData;
+    float        rainCurr;
+};
+
+/*
+ * Time stamp calculation as implemented in RainGauge::timeStamp()
+ */
+static uint32_t civilTimeStamp(const tm &t)
+{
+    int64_t ts = (int64_t)daysFromTm(t.tm_year, t.tm_mon, t.tm_mday) * CIVIL_SECONDS_PER_DAY
+                 + (int64_t)t.tm_hour * CIVIL_SECONDS_PER_HOUR
+                 + (int64_t)t.tm_min * CIVIL_SECONDS_PER_MINUTE;
+
+    return (uint32_t)civilFloorMod(ts, CIVIL_SECONDS_PER_DAY);
+}
+
+int main(int argc, char *argv[])
+{
+    size_t iterations = benchIterations(argc, argv, 1000000);
+
+    // Readings every 6 minutes, starting 2022-09-06 00:00 local time
+    std::vector<tm>     readings(4096);
+    std::vector<time_t> epochs(4096);
+    time_t t0 = 1662422400;
+    for (size_t i = 0; i < readings.size(); i++) {
+        epochs[i] = t0 + (time_t)i * 360;
+        localtime_r(&epochs[i], &readings[i]);
+    }
+    size_t mask = readings.size() - 1;
+
+    nvData_t data;
+    RainGauge rainGauge(&data);
+    rainGauge.reset();
+
+    printf("RainGauge time stamp benchmark, %zu iterations, TZ=%s\n",
+           iterations, getenv("TZ") ? getenv("TZ") : "(unset)");
+
+    double nsLegacy = benchNsPerOp(iterations, [&](size_t i) {
+        benchSink = legacyTimeStamp(readings[i & mask]);
+    });
+    double nsCivil = benchNsPerOp(iterations, [&](size_t i) {
+        benchSink = civilTimeStamp(readings[i & mask]);
+    });
+    double nsUpdate = benchNsPerOp(iterations, [&](size_t i) {
+        rainGauge.update(readings[i & mask], 0.1f * (float)(i % 1000));
+    });
+    benchSink = rainGauge.pastHour();
+
+    LegacyRainGauge legacyGauge;
+    double nsUpdateLegacy = benchNsPerOp(iterations, [&](size_t i) {
+        legacyGauge.update(readings[i & mask], 0.1f * (float)(i % 1000));
+    });
+    benchSink = legacyGauge.pastHour();
+
+    rainGauge.reset();
+    double nsEpochTm = benchNsPerOp(iterations, [&](size_t i) {
+        tm t;
+        localtime_r(&epochs[i & mask], &t);
+        rainGauge.update(t, 0.1f * (float)(i % 1000));
+    });
+    rainGauge.reset();
+    double nsEpoch = benchNsPerOp(iterations, [&](size_t i) {
+        rainGauge.update(epochs[i & mask], 0.1f * (float)(i % 1000));
+    });
+    benchSink = rainGauge.pastHour();
+
+    // History of readings every 30 s (circular buffer overwritten)
+    std::vector<rainSample_t> history(iterations);
+    for (size_t i = 0; i < iterations; i++) {
+        history[i].epoch   = t0 + (time_t)i * 30;
+        history[i].rain    = 0.1f * (float)(i % 1000);
+        history[i].startup = false;
+    }
+    rainGauge.reset();
+    double nsHistory = benchNsPerOp(iterations, [&](size_t i) {
+        rainGauge.update(history[i].epoch, history[i].rain);
+    });
+    benchSink = rainGauge.pastHour();
+    rainGauge.reset();
+    double nsBackfill = benchNsPerOp(1, [&](size_t) {
+        rainGauge.backfill(iterations, &history[0]);
+    }) / (double)iterations;
+    benchSink = rainGauge.pastHour();
+
+    benchReport("timeStamp, mktime() (before)", nsLegacy);
+    benchReport("timeStamp, civil arithmetic (after)", nsCivil);
+    benchReport("RainGauge::update() (before)", nsUpdateLegacy);
+    benchReport("RainGauge::update() (after)", nsUpdate);
+    benchReport("localtime_r() + RainGauge::update(tm)", nsEpochTm);
+    benchReport("RainGauge::update(time_t), cached midnight", nsEpoch);
+    benchReport("RainGauge::update(time_t), 30 s history", nsHistory);
+    benchReport("RainGauge::backfill(), 30 s history", nsBackfill);
+
+    return 0;
+}
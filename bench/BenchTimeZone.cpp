@@ -0,0 +1,117 @@
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// BenchTimeZone.cpp
+//
+// Benchmark of RainGauge::update(time_t) on several threads:
+// process-global libc local time vs. per-gauge TimeZone table
+//
+// Readings are 97 minutes apart, so every 15th update crosses a local day boundary.
+//
+// Usage: bench_timezone [iterations per thread] [max. threads]
+//
+// https://github.com/matthias-bs/BresserWeatherSensorReceiver
+//
+//
+// created: 10/2026
+//
+//
+// MIT License
+//
+// Copyright (c) 2026 Matthias Prinke
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+// History:
+//
+// 20261016 Created
+//
+// ToDo:
+// -
+//
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include <string.h>
+#include <thread>
+#include <vector>
+
+#include "BenchUtil.h"
+#include "RainGauge.h"
+#include "TimeZone.h"
+
+static const char *ZONES[] = {
+    "CET-1CEST,M3.5.0,M10.5.0/3",
+    "EST5EDT,M3.2.0,M11.1.0",
+    "AEST-10AEDT,M10.1.0,M4.1.0/3",
+    "NZST-12NZDT,M9.5.0,M4.1.0/3"
+};
+static const size_t NUM_ZONES = sizeof(ZONES) / sizeof(ZONES[0]);
+
+/*
+ * Run updates of one gauge per thread, return aggregated throughput [updates/s]
+ */
+static double runThreads(unsigned threads, size_t iterations, const std::vector<TimeZone> *zones)
+{
+    std::vector<std::thread> workers;
+
+    double ns = benchNsPerOp(1, [&](size_t) {
+        for (unsigned n = 0; n < threads; n++) {
+            workers.push_back(std::thread([&, n]() {
+                nvData_t  data;
+                RainGauge rainGauge(&data);
+                rainGauge.reset();
+                if (zones != NULL)
+                    rainGauge.setTimeZone(&(*zones)[n % NUM_ZONES]);
+
+                time_t t0 = 1662422400 + n * 60;
+                for (size_t i = 0; i < iterations; i++) {
+                    rainGauge.update(t0 + (time_t)i * 97 * 60, 0.1f * (float)(i % 1000));
+                }
+                benchSink = rainGauge.currentDay();
+            }));
+        }
+        for (size_t n = 0; n < workers.size(); n++)
+            workers[n].join();
+    });
+
+    return (double)threads * (double)iterations * 1.0e9 / ns;
+}
+
+int main(int argc, char *argv[])
+{
+    size_t   iterations = benchIterations(argc, argv, 500000);
+    unsigned maxThreads = (argc > 2) ? (unsigned)atoi(argv[2]) : std::thread::hardware_concurrency();
+    if (maxThreads == 0)
+        maxThreads = 1;
+
+    std::vector<TimeZone> zones(NUM_ZONES);
+    for (size_t i = 0; i < NUM_ZONES; i++)
+        zones[i].loadPosix(ZONES[i], 2000, 2100);
+
+    setenv("TZ", ZONES[0], 1);
+    tzset();
+
+    printf("RainGauge timezone benchmark, %zu iterations per thread\n", iterations);
+    printf("%8s %20s %20s\n", "threads", "libc [updates/s]", "TimeZone [updates/s]");
+    for (unsigned threads = 1; threads <= maxThreads; threads *= 2) {
+        double libc  = runThreads(threads, iterations, NULL);
+        double table = runThreads(threads, iterations, &zones);
+        printf("%8u %20.0f %20.0f\n", threads, libc, table);
+    }
+
+    return 0;
+}
@@ -0,0 +1,121 @@
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// BenchTopK.cpp
+//
+// Benchmark: top-K query of rain gauges by pastHour() - full scan and sort versus
+// incrementally maintained RainTopK, and its cost per fleet update
+//
+// https://github.com/matthias-bs/BresserWeatherSensorReceiver
+//
+//
+// created: 10/2026
+//
+//
+// MIT License
+//
+// Copyright (c) 2026 Matthias Prinke
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+// History:
+//
+// 20261016 Created
+//
+// ToDo:
+// -
+//
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+
+
+#include <algorithm>
+#include <vector>
+
+#include "BenchUtil.h"
+#include "RainGaugeFleet.h"
+#include "RainTopK.h"
+#include "TimeZone.h"
+
+#define BENCH_GAUGES 100000
+#define BENCH_K      50
+
+static bool greater(const RainRank &a, const RainRank &b)
+{
+    return (a.value > b.value) || ((a.value == b.value) && (a.id < b.id));
+}
+
+/*
+ * Time per reading of updateBatch(), with ranking observer if topK != NULL
+ */
+static double update(RainGaugeFleet &fleet, RainTopK *topK, size_t ticks)
+{
+    std::vector<uint32_t> ids(BENCH_GAUGES);
+    std::vector<time_t>   epochs(BENCH_GAUGES);
+    std::vector<float>    values(BENCH_GAUGES);
+    TimeZone              utc;
+
+    fleet.setTimeZone(&utc);
+    if (topK)
+        fleet.addObserver(topK);
+    double ns = benchNsPerOp(ticks, [&](size_t tick) {
+        for (size_t k = 0; k < BENCH_GAUGES; k++) {
+            ids[k]    = (uint32_t)k;
+            epochs[k] = 1662422400 + (time_t)tick * 360 + (time_t)(k % 360);
+            values[k] = 0.1f * (float)((tick * (k % 13)) % 1000);
+        }
+        fleet.updateBatch(BENCH_GAUGES, &ids[0], &epochs[0], &values[0]);
+    }) / (double)BENCH_GAUGES;
+    if (topK)
+        fleet.removeObserver(topK);
+    return ns;
+}
+
+int main(int argc, char *argv[])
+{
+    size_t   ticks = benchIterations(argc, argv, 20);
+    char     name[64];
+    RainRank top[BENCH_K];
+
+    printf("Top-%d query over %d rain gauges, %zu update ticks\n", BENCH_K, BENCH_GAUGES, ticks);
+
+    RainGaugeFleet plain(BENCH_GAUGES);
+    benchReport("updateBatch() per reading", update(plain, NULL, ticks));
+
+    RainGaugeFleet fleet(BENCH_GAUGES);
+    RainTopK       topK(BENCH_GAUGES);
+    benchReport("updateBatch() per reading, with RainTopK", update(fleet, &topK, ticks));
+
+    std::vector<RainRank> all(BENCH_GAUGES);
+    snprintf(name, sizeof(name), "top-%d: pastHour() of all + partial_sort", BENCH_K);
+    benchReport(name, benchNsPerOp(100, [&](size_t) {
+        for (uint32_t g = 0; g < BENCH_GAUGES; g++) {
+            all[g].id    = g;
+            all[g].value = fleet.pastHour(g);
+        }
+        std::partial_sort(all.begin(), all.begin() + BENCH_K, all.end(), greater);
+        benchSink = all[0].value;
+    }));
+
+    snprintf(name, sizeof(name), "top-%d: RainTopK::top()", BENCH_K);
+    benchReport(name, benchNsPerOp(100000, [&](size_t) {
+        topK.top(BENCH_K, top);
+        benchSink = top[0].value;
+    }));
+
+    return 0;
+}
@@ -0,0 +1,100 @@
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// BenchUtil.h
+//
+// Minimal timing helpers for the RainGauge benchmarks (no external dependencies)
+//
+// https://github.com/matthias-bs/BresserWeatherSensorReceiver
+//
+//
+// created: 10/2026
+//
+//
+// MIT License
+//
+// Copyright (c) 2026 Matthias Prinke
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+// History:
+//
+// 20261016 Created
+// 20261017 Added benchThreadCounts()
+//
+// ToDo:
+// -
+//
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <chrono>
+#include <vector>
+
+/**
+ * Sink for benchmark results - prevents the compiler from removing the measured code
+ */
+static volatile double benchSink;
+
+/**
+ * Run fn(i) for i in [0, iterations) and return the elapsed time in nanoseconds per iteration
+ */
+template <class F>
+double benchNsPerOp(size_t iterations, F fn)
+{
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < iterations; i++) {
+        fn(i);
+    }
+    std::chrono::steady_clock::time_point stop = std::chrono::steady_clock::now();
+
+    return std::chrono::duration<double, std::nano>(stop - start).count() / (double)iterations;
+}
+
+/**
+ * Print one benchmark result line
+ */
+static inline void benchReport(const char *name, double nsPerOp)
+{
+    printf("%-48s %12.1f ns/op %14.0f ops/s\n", name, nsPerOp, 1.0e9 / nsPerOp);
+}
+
+/**
+ * Iteration count from first command line argument (or default)
+ */
+static inline size_t benchIterations(int argc, char *argv[], size_t def)
+{
+    return (argc > 1) ? (size_t)strtoull(argv[1], NULL, 10) : def;
+}
+
+/**
+ * Thread counts 1, 2, 4, ... and finally maxThreads (at least 1)
+ */
+static inline std::vector<unsigned> benchThreadCounts(unsigned maxThreads)
+{
+    std::vector<unsigned> counts;
+
+    for (unsigned n = 1; n < maxThreads; n *= 2) {
+        counts.push_back(n);
+    }
+    counts.push_back(maxThreads ? maxThreads : 1);
+    return counts;
+}
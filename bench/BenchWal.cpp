@@ -0,0 +1,103 @@
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// BenchWal.cpp
+//
+// Benchmark: write-ahead log commit latency and throughput versus group commit size
+//
+// https://github.com/matthias-bs/BresserWeatherSensorReceiver
+//
+//
+// created: 10/2026
+//
+//
+// MIT License
+//
+// Copyright (c) 2026 Matthias Prinke
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+// History:
+//
+// 20261016 Created
+//
+// ToDo:
+// -
+//
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+
+
+#include <stdio.h>
+#include <chrono>
+
+#include "BenchUtil.h"
+#include "RainWal.h"
+
+#define BENCH_WAL_FILE "bench_wal.wal"
+#define BENCH_GAUGES   10000
+
+static RainReading reading(size_t i)
+{
+    RainReading r;
+    r.id      = (uint32_t)(i % BENCH_GAUGES);
+    r.epoch   = 1662422400 + (time_t)(i / BENCH_GAUGES) * 60;
+    r.value   = 0.1f * (float)(i % 1000);
+    r.startup = false;
+    return r;
+}
+
+int main(int argc, char *argv[])
+{
+    size_t       readings = benchIterations(argc, argv, 200000);
+    const size_t groups[] = {1, 4, 16, 64, 256, 1024, 4096};
+    char         name[64];
+
+    printf("Write-ahead log, %zu readings per group size (file %s)\n", readings, BENCH_WAL_FILE);
+    printf("%-48s %12s\n", "", "commit [us]");
+
+    for (size_t g = 0; g < sizeof(groups) / sizeof(groups[0]); g++) {
+        // One fdatasync() per reading is slow - limit the number of commits
+        size_t n = readings;
+        if (n > groups[g] * 2000)
+            n = groups[g] * 2000;
+
+        remove(BENCH_WAL_FILE);
+        RainWal wal(SIZE_MAX);
+        if (!wal.open(BENCH_WAL_FILE)) {
+            printf("cannot open %s\n", BENCH_WAL_FILE);
+            return 1;
+        }
+
+        double commitNs = 0;
+        double ns = benchNsPerOp(n, [&](size_t i) {
+            wal.append(reading(i));
+            if (((i + 1) % groups[g] == 0) || (i + 1 == n)) {
+                std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+                wal.commit();
+                commitNs += std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+            }
+        });
+        snprintf(name, sizeof(name), "group commit of %zu readings", groups[g]);
+        printf("%-48s %12.1f\n", name, commitNs / 1000.0 / (double)wal.commits());
+        benchReport("  per reading", ns);
+        wal.close();
+    }
+    remove(BENCH_WAL_FILE);
+
+    return 0;
+}
@@ -0,0 +1,221 @@
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// CivilTime.h
+//
+// Calendar arithmetic on the proleptic Gregorian calendar without any libc time calls.
+//
+// All functions are constexpr and operate on "days since 1970-01-01" (day 0 is a Thursday).
+// The algorithms are the well-known days_from_civil() / civil_from_days() conversions
+// by Howard Hinnant (http://howardhinnant.github.io/date_algorithms.html), written in
+// C++11 constexpr style (one return statement per function).
+//
+// https://github.com/matthias-bs/BresserWeatherSensorReceiver
+//
+//
+// created: 10/2026
+//
+//
+// MIT License
+//
+// Copyright (c) 2026 Matthias Prinke
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+// History:
+//
+// 20261016 Created
+//
+// ToDo:
+// -
+//
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <stdint.h>
+
+/**
+ * \def
+ *
+ * Number of seconds per minute, hour and day
+ */
+#define CIVIL_SECONDS_PER_MINUTE 60
+#define CIVIL_SECONDS_PER_HOUR   3600
+#define CIVIL_SECONDS_PER_DAY    86400
+
+/**
+ * Floor division (rounds towards negative infinity)
+ */
+constexpr int64_t civilFloorDiv(int64_t a, int64_t b)
+{
+    return (a >= 0) ? (a / b) : -((-a + b - 1) / b);
+}
+
+/**
+ * Floor modulo (result has the sign of b)
+ */
+constexpr int64_t civilFloorMod(int64_t a, int64_t b)
+{
+    return a - civilFloorDiv(a, b) * b;
+}
+
+/*
+ * Internal helpers for daysFromCivil()
+ */
+constexpr int32_t civilEra(int32_t y)
+{
+    return (y >= 0 ? y : y - 399) / 400;
+}
+
+constexpr int32_t civilDayOfYear(int32_t m, int32_t d)
+{
+    return (153 * (m > 2 ? m - 3 : m + 9) + 2) / 5 + d - 1;
+}
+
+constexpr int32_t civilDayOfEra(int32_t yoe, int32_t doy)
+{
+    return yoe * 365 + yoe / 4 - yoe / 100 + doy;
+}
+
+constexpr int32_t civilDaysShifted(int32_t y, int32_t m, int32_t d)
+{
+    return civilEra(y) * 146097 + civilDayOfEra(y - civilEra(y) * 400, civilDayOfYear(m, d)) - 719468;
+}
+
+/**
+ * Days since 1970-01-01 from civil date
+ *
+ * \param y year (e.g. 2022)
+ * \param m month [1..12]
+ * \param d day of month [1..31]; values out of range are carried into the adjacent months
+ *
+ * \returns days since 1970-01-01
+ */
+constexpr int32_t daysFromCivil(int32_t y, int32_t m, int32_t d)
+{
+    return civilDaysShifted(m <= 2 ? y - 1 : y, m, d);
+}
+
+/**
+ * Days since 1970-01-01 from struct tm style fields
+ *
+ * Month values out of range [0..11] are normalized as done by mktime().
+ *
+ * \param tmYear years since 1900
+ * \param tmMon  months since January
+ * \param tmMday day of month
+ *
+ * \returns days since 1970-01-01
+ */
+constexpr int32_t daysFromTm(int32_t tmYear, int32_t tmMon, int32_t tmMday)
+{
+    return daysFromCivil(tmYear + 1900 + (int32_t)civilFloorDiv(tmMon, 12),
+                         (int32_t)civilFloorMod(tmMon, 12) + 1,
+                         tmMday);
+}
+
+/**
+ * Day of week from days since 1970-01-01
+ *
+ * \returns day of week [0..6], 0 - Sunday (as tm_wday)
+ */
+constexpr uint8_t weekdayFromDays(int32_t z)
+{
+    return (uint8_t)(z >= -4 ? (z + 4) % 7 : (z + 5) % 7 + 6);
+}
+
+/*
+ * Internal helpers for the civil_from_days() direction
+ */
+constexpr int32_t civilDayOfEraFromDays(int32_t z)
+{
+    return (z + 719468) - (((z + 719468) >= 0 ? (z + 719468) : (z + 719468) - 146096) / 146097) * 146097;
+}
+
+constexpr int32_t civilYearOfEra(int32_t doe)
+{
+    return (doe - doe / 1460 + doe / 36524 - doe / 146096) / 365;
+}
+
+constexpr int32_t civilDayOfYearFromDoe(int32_t doe)
+{
+    return doe - (365 * civilYearOfEra(doe) + civilYearOfEra(doe) / 4 - civilYearOfEra(doe) / 100);
+}
+
+constexpr int32_t civilMonthIndex(int32_t doy)
+{
+    return (5 * doy + 2) / 153;
+}
+
+constexpr int32_t civilMonth(int32_t mp)
+{
+    return mp < 10 ? mp + 3 : mp - 9;
+}
+
+/**
+ * Month from days since 1970-01-01
+ *
+ * \returns month [1..12]
+ */
+constexpr uint8_t monthFromDays(int32_t z)
+{
+    return (uint8_t)civilMonth(civilMonthIndex(civilDayOfYearFromDoe(civilDayOfEraFromDays(z))));
+}
+
+/**
+ * Day of month from days since 1970-01-01
+ *
+ * \returns day of month [1..31]
+ */
+constexpr uint8_t dayFromDays(int32_t z)
+{
+    return (uint8_t)(civilDayOfYearFromDoe(civilDayOfEraFromDays(z))
+        - (153 * civilMonthIndex(civilDayOfYearFromDoe(civilDayOfEraFromDays(z))) + 2) / 5 + 1);
+}
+
+/**
+ * Year from days since 1970-01-01
+ *
+ * \returns year (e.g. 2022)
+ */
+constexpr int32_t yearFromDays(int32_t z)
+{
+    return civilYearOfEra(civilDayOfEraFromDays(z))
+        + (((z + 719468) >= 0 ? (z + 719468) : (z + 719468) - 146096) / 146097) * 400
+        + (monthFromDays(z) <= 2 ? 1 : 0);
+}
+
+/**
+ * Number of days in given month
+ *
+ * \param y year
+ * \param m month [1..12]
+ */
+constexpr int32_t daysInMonth(int32_t y, int32_t m)
+{
+    return daysFromCivil(m == 12 ? y + 1 : y, m == 12 ? 1 : m + 1, 1) - daysFromCivil(y, m, 1);
+}
+
+// Compile-time sanity checks
+static_assert(daysFromCivil(1970, 1, 1) == 0, "civil epoch");
+static_assert(daysFromCivil(2000, 3, 1) == 11017, "civil leap year");
+static_assert(weekdayFromDays(0) == 4, "1970-01-01 was a Thursday");
+static_assert(monthFromDays(daysFromCivil(2024, 2, 29)) == 2, "civil month");
+static_assert(dayFromDays(daysFromCivil(2024, 2, 29)) == 29, "civil day");
+static_assert(yearFromDays(daysFromCivil(1969, 12, 31)) == 1969, "civil year");
+static_assert(daysFromTm(122, 12, 1) == daysFromCivil(2023, 1, 1), "tm month normalization");
@@ -0,0 +1,632 @@
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// RainAsync.h
+//
+// Asynchronous ingestion pipeline based on C++20 coroutines: executor, bounded
+// channels of reading batches and the stages decode, validate, reorder, update and
+// publish. Optional - requires C++20; the core library remains C++11.
+//
+// https://github.com/matthias-bs/BresserWeatherSensorReceiver
+//
+//
+// created: 10/2026
+//
+//
+// MIT License
+//
+// Copyright (c) 2026 Matthias Prinke
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+// History:
+//
+// 20261016 Created
+// 20261017 setPublisher() enables snapshots of the fleet
+//
+// ToDo:
+// -
+//
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+
+#pragma once
+
+#if !defined(__cpp_impl_coroutine)
+  #error "RainAsync.h requires C++20 coroutines (link target RainGaugeAsync)"
+#endif
+
+#include <stddef.h>
+#include <stdint.h>
+#include <cmath>
+#include <coroutine>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <optional>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "RainGaugeFleet.h"
+#include "RainGaugeStats.h"
+#include "RainReorder.h"
+#include "RainReplay.h"
+
+/**
+ * \def
+ *
+ * Maximum number of readings per batch passed between the pipeline stages
+ */
+#ifndef RAIN_ASYNC_BATCH
+  #define RAIN_ASYNC_BATCH 256
+#endif
+
+class RainExecutor;
+
+/**
+ * \class RainTask
+ *
+ * \brief Coroutine started and owned by a RainExecutor (see RainExecutor::spawn())
+ */
+class RainTask {
+public:
+    struct promise_type {
+        std::exception_ptr error;
+
+        RainTask get_return_object() {
+          return RainTask(std::coroutine_handle<promise_type>::from_promise(*this));
+        };
+        std::suspend_always initial_suspend() noexcept {
+          return {};
+        };
+        std::suspend_always final_suspend() noexcept {
+          return {};
+        };
+        void return_void() {};
+        void unhandled_exception() {
+          error = std::current_exception();
+        };
+    };
+
+    RainTask(RainTask &&other) noexcept : handle(other.handle) {
+      other.handle = nullptr;
+    };
+
+    ~RainTask() {
+      if (handle)
+          handle.destroy();
+    };
+
+private:
+    friend class RainExecutor;
+
+    std::coroutine_handle<promise_type> handle;
+
+    explicit RainTask(std::coroutine_handle<promise_type> h) : handle(h) {};
+    RainTask(const RainTask &) = delete;
+    RainTask &operator=(const RainTask &) = delete;
+};
+
+/**
+ * \class RainExecutor
+ *
+ * \brief Single-threaded executor of coroutines
+ *
+ * Coroutines which can continue are resumed in FIFO order by run(); coroutines waiting
+ * for a channel are not polled. Several executors may run in separate threads, each
+ * with its own pipeline (e.g. gauges partitioned by id as in RainGaugeShardsT); the
+ * coroutines of one executor must not interact with another one.
+ */
+class RainExecutor {
+public:
+    RainExecutor() = default;
+
+    ~RainExecutor() {
+      for (size_t i = 0; i < tasks.size(); i++) {
+          tasks[i].destroy();
+      }
+    };
+
+    /**
+     * Start coroutine; the executor takes ownership
+     */
+    void  spawn(RainTask task) {
+      std::coroutine_handle<RainTask::promise_type> h = task.handle;
+      task.handle = nullptr;
+      tasks.push_back(h);
+      post(h);
+    };
+
+    /**
+     * Queue suspended coroutine for resumption
+     */
+    void  post(std::coroutine_handle<> h) {
+      ready.push_back(h);
+    };
+
+    /**
+     * Awaitable which lets other coroutines run first
+     */
+    auto  yield(void) {
+      struct Awaiter {
+          RainExecutor *ex;
+          bool await_ready() const noexcept {
+            return false;
+          };
+          void await_suspend(std::coroutine_handle<> h) {
+            ex->post(h);
+          };
+          void await_resume() const noexcept {};
+      };
+      return Awaiter{this};
+    };
+
+    /**
+     * \fn run
+     *
+     * \brief Resume coroutines until all are finished or waiting
+     *
+     * Finished coroutines are destroyed; an exception thrown by a coroutine is
+     * rethrown here.
+     *
+     * \returns number of resumptions
+     */
+    size_t run(void) {
+      size_t n = 0;
+
+      while (!ready.empty()) {
+          std::coroutine_handle<> h = ready.front();
+          ready.pop_front();
+          h.resume();
+          n++;
+      }
+
+      std::exception_ptr error;
+      size_t             k = 0;
+      for (size_t i = 0; i < tasks.size(); i++) {
+          if (tasks[i].done()) {
+              if (tasks[i].promise().error && !error)
+                  error = tasks[i].promise().error;
+              tasks[i].destroy();
+          } else {
+              tasks[k++] = tasks[i];
+          }
+      }
+      tasks.resize(k);
+      if (error)
+          std::rethrow_exception(error);
+      return n;
+    };
+
+    /**
+     * Number of coroutines not yet finished
+     */
+    size_t pending(void) const {
+      return tasks.size();
+    };
+
+private:
+    std::deque<std::coroutine_handle<> > ready;
+    std::vector<std::coroutine_handle<RainTask::promise_type> > tasks;
+};
+
+/**
+ * \class RainChannel
+ *
+ * \brief Bounded channel between coroutines of one executor
+ *
+ * push() suspends while the channel is full, pop() while it is empty. Values are
+ * handed over directly to a waiting coroutine, so the order of values and waiters is
+ * kept. After close(), values still queued can be popped; then pop() returns no value
+ * and push() returns false.
+ *
+ * \tparam T value type, e.g. a batch of readings
+ */
+template <class T>
+class RainChannel {
+public:
+    /**
+     * Constructor
+     *
+     * \param executor executor of the coroutines using the channel
+     *
+     * \param capacity maximum number of queued values (at least 1)
+     */
+    RainChannel(RainExecutor &executor, size_t capacity) :
+      ex(executor),
+      cap(capacity > 0 ? capacity : 1),
+      closed(false)
+    {};
+
+    struct PushAwaiter {
+        RainChannel *ch;
+        T            value;
+        bool         ok;
+        std::coroutine_handle<> h;
+
+        bool await_ready() {
+          return ch->tryPush(*this);
+        };
+        void await_suspend(std::coroutine_handle<> handle) {
+          h = handle;
+          ch->pushWaiters.push_back(this);
+        };
+        bool await_resume() const noexcept {
+          return ok;
+        };
+    };
+
+    struct PopAwaiter {
+        RainChannel     *ch;
+        std::optional<T> value;
+        std::coroutine_handle<> h;
+
+        bool await_ready() {
+          return ch->tryPop(*this);
+        };
+        void await_suspend(std::coroutine_handle<> handle) {
+          h = handle;
+          ch->popWaiters.push_back(this);
+        };
+        std::optional<T> await_resume() {
+          return std::move(value);
+        };
+    };
+
+    /**
+     * Awaitable: queue value; result false if the channel has been closed
+     */
+    PushAwaiter push(T value) {
+      return PushAwaiter{this, std::move(value), false, nullptr};
+    };
+
+    /**
+     * Awaitable: dequeue value; result empty if the channel has been closed and drained
+     */
+    PopAwaiter pop(void) {
+      return PopAwaiter{this, std::nullopt, nullptr};
+    };
+
+    /**
+     * Close channel and wake all waiting coroutines
+     */
+    void  close(void) {
+      closed = true;
+      while (!popWaiters.empty()) {
+          ex.post(popWaiters.front()->h);
+          popWaiters.pop_front();
+      }
+      while (!pushWaiters.empty()) {
+          pushWaiters.front()->ok = false;
+          ex.post(pushWaiters.front()->h);
+          pushWaiters.pop_front();
+      }
+    };
+
+    /**
+     * Number of queued values
+     */
+    size_t size(void) const {
+      return queue.size();
+    };
+
+    /**
+     * Channel has been closed
+     */
+    bool  isClosed(void) const {
+      return closed;
+    };
+
+private:
+    RainExecutor              &ex;
+    size_t                     cap;
+    bool                       closed;
+    std::deque<T>              queue;
+    std::deque<PushAwaiter *>  pushWaiters;
+    std::deque<PopAwaiter *>   popWaiters;
+
+    bool  tryPush(PushAwaiter &a) {
+      if (closed) {
+          a.ok = false;
+          return true;
+      }
+      a.ok = true;
+      if (!popWaiters.empty()) {
+          PopAwaiter *w = popWaiters.front();
+          popWaiters.pop_front();
+          w->value = std::move(a.value);
+          ex.post(w->h);
+          return true;
+      }
+      if (queue.size() < cap) {
+          queue.push_back(std::move(a.value));
+          return true;
+      }
+      return false;
+    };
+
+    bool  tryPop(PopAwaiter &a) {
+      if (!queue.empty()) {
+          a.value = std::move(queue.front());
+          queue.pop_front();
+          if (!pushWaiters.empty()) {
+              PushAwaiter *w = pushWaiters.front();
+              pushWaiters.pop_front();
+              queue.push_back(std::move(w->value));
+              w->ok = true;
+              ex.post(w->h);
+          }
+          return true;
+      }
+      return closed;
+    };
+};
+
+/**
+ * \typedef RainBatch
+ *
+ * \brief Batch of readings passed between pipeline stages
+ */
+typedef std::vector<RainReading> RainBatch;
+
+/**
+ * \struct RainAsyncStats
+ *
+ * \brief Counters of RainAsyncPipelineT
+ */
+typedef struct {
+    uint64_t  decoded;   // readings decoded
+    uint64_t  errors;    // lines which could not be decoded
+    uint64_t  rejected;  // readings rejected by validation
+    uint64_t  late;      // readings dropped by the reorder stage
+    uint64_t  applied;   // readings applied to the rain gauges
+    uint64_t  published; // statistics published
+} RainAsyncStats;
+
+/**
+ * \class RainAsyncPipelineT
+ *
+ * \brief Ingestion pipeline of coroutines on one executor
+ *
+ * \verbatim
+ * input() -> decode -> validate -> reorder -> update -> publish
+ *  text     (RainReplayParser)  (RainReorderBuffer)  (Fleet)  (callback)
+ * \endverbatim
+ *
+ * Each stage is a coroutine which suspends while its input channel is empty or its
+ * output channel is full; readings are passed on in batches of up to RAIN_ASYNC_BATCH.
+ * Any number of producer coroutines (e.g. one per gauge stream) can push text with
+ * complete lines (CSV or JSON lines, see RainReplayParser) to input(). close() ends
+ * the input; the stages finish after all readings have been applied and published.
+ *
+ * \tparam Fleet RainGaugeFleetT (or any type with update(n, readings, max), setSnapshots() and snapshot())
+ */
+template <class Fleet>
+class RainAsyncPipelineT {
+public:
+    typedef std::function<void(uint32_t id, const RainGaugeStats &s)> Publisher;
+
+    /**
+     * Constructor
+     *
+     * \param executor executor running the stages
+     *
+     * \param fleet    rain gauges (ids 0..fleet.size()-1)
+     *
+     * \param horizon  lateness horizon of the reorder stage in seconds
+     *
+     * \param depth    capacity of each channel in batches
+     */
+    RainAsyncPipelineT(RainExecutor &executor, Fleet &fleet, uint32_t horizon, size_t depth = 16) :
+      ex(executor),
+      gauges(fleet),
+      text(executor, depth),
+      decoded(executor, depth),
+      valid(executor, depth),
+      ordered(executor, depth),
+      updated(executor, depth),
+      reorder(fleet.size(), horizon),
+      seen(fleet.size(), 0),
+      generation(0),
+      counters()
+    {};
+
+    /**
+     * Publish statistics of each rain gauge changed by a batch
+     *
+     * Enables snapshots of the fleet (see RainGaugeFleetT::setSnapshots()).
+     */
+    void  setPublisher(Publisher fn) {
+      publisher = fn;
+      gauges.setSnapshots(true);
+    };
+
+    /**
+     * Start stage coroutines (once)
+     *
+     * \param rainGaugeMax overflow value; when reached, the rain gauge is reset to zero
+     */
+    void  start(float raingaugeMax = RAINGAUGE_MAX_VALUE) {
+      ex.spawn(decodeStage());
+      ex.spawn(validateStage());
+      ex.spawn(reorderStage());
+      ex.spawn(updateStage(raingaugeMax));
+      ex.spawn(publishStage());
+    };
+
+    /**
+     * Input channel: text with complete lines
+     */
+    RainChannel<std::string> &input(void) {
+      return text;
+    };
+
+    /**
+     * End of input - readings held back by the reorder stage are applied
+     */
+    void  close(void) {
+      text.close();
+    };
+
+    /**
+     * Counters
+     */
+    const RainAsyncStats &stats(void) const {
+      return counters;
+    };
+
+private:
+    RainExecutor              &ex;
+    Fleet                     &gauges;
+    RainChannel<std::string>   text;
+    RainChannel<RainBatch>     decoded;
+    RainChannel<RainBatch>     valid;
+    RainChannel<RainBatch>     ordered;
+    RainChannel<RainBatch>     updated;
+    RainReorderBuffer          reorder;
+    std::vector<uint32_t>      seen;       // generation of last publication per gauge
+    uint32_t                   generation;
+    Publisher                  publisher;
+    RainAsyncStats             counters;
+
+    RainTask decodeStage(void);
+    RainTask validateStage(void);
+    RainTask reorderStage(void);
+    RainTask updateStage(float raingaugeMax);
+    RainTask publishStage(void);
+};
+
+/**
+ * \typedef RainAsyncPipeline
+ *
+ * \brief Pipeline for RainGaugeFleet
+ */
+typedef RainAsyncPipelineT<RainGaugeFleet> RainAsyncPipeline;
+
+
+template <class Fleet>
+RainTask
+RainAsyncPipelineT<Fleet>::decodeStage(void)
+{
+    RainReplayParser parser;
+    RainBatch        batch;
+
+    while (std::optional<std::string> chunk = co_await text.pop()) {
+        const char *pos = chunk->data();
+        const char *end = pos + chunk->size();
+        while (pos < end) {
+            size_t n = batch.size();
+            batch.resize(n + RAIN_ASYNC_BATCH);
+            batch.resize(n + parser.parse(pos, end, &batch[n], RAIN_ASYNC_BATCH));
+            if ((batch.size() >= RAIN_ASYNC_BATCH) || ((pos >= end) && (text.size() == 0))) {
+                counters.decoded += batch.size();
+                if (!batch.empty() && !co_await decoded.push(std::move(batch)))
+                    break;
+                batch.clear();
+            }
+        }
+        counters.errors = parser.errors();
+    }
+    decoded.close();
+}
+
+template <class Fleet>
+RainTask
+RainAsyncPipelineT<Fleet>::validateStage(void)
+{
+    while (std::optional<RainBatch> batch = co_await decoded.pop()) {
+        size_t n = 0;
+        for (size_t k = 0; k < batch->size(); k++) {
+            const RainReading &r = (*batch)[k];
+            if ((r.id < gauges.size()) && std::isfinite(r.value) && (r.value >= 0)) {
+                (*batch)[n++] = r;
+            }
+        }
+        counters.rejected += batch->size() - n;
+        batch->resize(n);
+        if (!batch->empty() && !co_await valid.push(std::move(*batch)))
+            break;
+    }
+    valid.close();
+}
+
+template <class Fleet>
+RainTask
+RainAsyncPipelineT<Fleet>::reorderStage(void)
+{
+    RainBatch out;
+    bool      open = true;
+
+    while (open) {
+        std::optional<RainBatch> batch = co_await valid.pop();
+        if (batch) {
+            for (size_t k = 0; k < batch->size(); k++) {
+                reorder.push((*batch)[k]);
+            }
+        }
+        open = batch.has_value();
+
+        // Release readings past the watermark (all of them at end of input)
+        size_t m;
+        do {
+            out.resize(RAIN_ASYNC_BATCH);
+            m = open ? reorder.pop(&out[0], RAIN_ASYNC_BATCH) : reorder.flush(&out[0], RAIN_ASYNC_BATCH);
+            out.resize(m);
+            if ((m > 0) && !co_await ordered.push(std::move(out)))
+                open = false;
+        } while (m > 0);
+        counters.late = reorder.late();
+    }
+    ordered.close();
+}
+
+template <class Fleet>
+RainTask
+RainAsyncPipelineT<Fleet>::updateStage(float raingaugeMax)
+{
+    while (std::optional<RainBatch> batch = co_await ordered.pop()) {
+        gauges.update(batch->size(), &(*batch)[0], raingaugeMax);
+        counters.applied += batch->size();
+        if (!co_await updated.push(std::move(*batch)))
+            break;
+    }
+    updated.close();
+}
+
+template <class Fleet>
+RainTask
+RainAsyncPipelineT<Fleet>::publishStage(void)
+{
+    RainGaugeStats s;
+
+    while (std::optional<RainBatch> batch = co_await updated.pop()) {
+        if (!publisher)
+            continue;
+        // Publish each gauge once per batch
+        generation++;
+        for (size_t k = 0; k < batch->size(); k++) {
+            uint32_t id = (*batch)[k].id;
+            if (seen[id] != generation) {
+                seen[id] = generation;
+                gauges.snapshot(id, s);
+                publisher(id, s);
+                counters.published++;
+            }
+        }
+    }
+}
@@ -0,0 +1,321 @@
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// RainCheckpoint.cpp
+//
+// Versioned binary checkpoints of rain gauge fleets with per-block CRC
+//
+// https://github.com/matthias-bs/BresserWeatherSensorReceiver
+//
+//
+// created: 10/2026
+//
+//
+// MIT License
+//
+// Copyright (c) 2026 Matthias Prinke
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+// History:
+//
+// 20261016 Created
+// 20261017 Version 3 - shadow slots per block, two header copies
+//
+// ToDo:
+// -
+//
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include <stddef.h>
+#include <string.h>
+
+#include "RainCheckpoint.h"
+#include "RainWal.h"
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#define RAIN_CHECKPOINT_POSIX
+#endif
+
+static_assert(sizeof(RainCheckpointHeader) == 64, "RainCheckpointHeader layout");
+
+static const char RAIN_CHECKPOINT_MAGIC[4] = {'R', 'G', 'C', 'P'};
+
+/*
+ * CRC of header (all fields but crc)
+ */
+static uint32_t
+headerCrc(const RainCheckpointHeader &hdr)
+{
+    return rainCrc32(&hdr, offsetof(RainCheckpointHeader, crc));
+}
+
+/*
+ * Header is valid
+ */
+static bool
+headerValid(const RainCheckpointHeader &hdr)
+{
+    return (memcmp(hdr.magic, RAIN_CHECKPOINT_MAGIC, sizeof(hdr.magic)) == 0) &&
+           (hdr.version == RAIN_CHECKPOINT_VERSION) &&
+           (hdr.headerSize == sizeof(RainCheckpointHeader)) &&
+           (hdr.blockRecords != 0) &&
+           (hdr.blocks == (hdr.count + hdr.blockRecords - 1) / hdr.blockRecords) &&
+           (hdr.crc == headerCrc(hdr));
+}
+
+RainCheckpointFile::RainCheckpointFile() : fd(-1)
+{
+    memset(&header, 0, sizeof(header));
+}
+
+RainCheckpointFile::~RainCheckpointFile()
+{
+    close();
+}
+
+int
+RainCheckpointFile::current(uint32_t b) const
+{
+    int      s   = -1;
+    uint32_t gen = 0;
+
+    for (unsigned k = 0; k < 2; k++) {
+        const RainCheckpointSlot &slot = slots[2 * b + k];
+        if ((slot.generation > gen) && (slot.generation <= header.generation)) {
+            gen = slot.generation;
+            s   = (int)k;
+        }
+    }
+    return s;
+}
+
+#ifdef RAIN_CHECKPOINT_POSIX
+
+/*
+ * Read valid header copy with the highest generation
+ */
+static bool
+readHeader(int fd, RainCheckpointHeader &hdr)
+{
+    RainCheckpointHeader copy[2];
+    bool                 ok[2];
+
+    for (unsigned k = 0; k < 2; k++) {
+        ok[k] = (pread(fd, &copy[k], sizeof(copy[k]), k * sizeof(copy[k])) == (ssize_t)sizeof(copy[k])) &&
+                headerValid(copy[k]);
+    }
+    if (!ok[0] && !ok[1])
+        return false;
+    hdr = (ok[0] && (!ok[1] || (copy[0].generation > copy[1].generation))) ? copy[0] : copy[1];
+    return true;
+}
+
+bool
+RainCheckpointFile::create(const char *path, const RainCheckpointHeader &layout, bool &fresh)
+{
+    RainCheckpointHeader hdr;
+
+    close();
+    this->path = path;
+    tmpPath.clear();
+    fd = ::open(path, O_RDWR);
+    fresh = !((fd >= 0) && readHeader(fd, hdr) &&
+              (hdr.bufSize == layout.bufSize) && (hdr.recordSize == layout.recordSize) &&
+              (hdr.count == layout.count) && (hdr.blockRecords == layout.blockRecords));
+    if (fresh) {
+        // The previous file stays valid until the new one is committed
+        close();
+        tmpPath = this->path + ".tmp";
+        fd = ::open(tmpPath.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+        if (fd < 0)
+            return false;
+        memset(&header, 0, sizeof(header));
+        memcpy(header.magic, RAIN_CHECKPOINT_MAGIC, sizeof(header.magic));
+        header.version      = RAIN_CHECKPOINT_VERSION;
+        header.headerSize   = sizeof(RainCheckpointHeader);
+        header.bufSize      = layout.bufSize;
+        header.recordSize   = layout.recordSize;
+        header.count        = layout.count;
+        header.blockRecords = layout.blockRecords;
+        header.blocks       = layout.blocks;
+        slots.assign((size_t)header.blocks * 2, RainCheckpointSlot());
+        return true;
+    }
+
+    header = hdr;
+    slots.resize((size_t)header.blocks * 2);
+    size_t bytes = slots.size() * sizeof(RainCheckpointSlot);
+    if (bytes && (pread(fd, &slots[0], bytes, directoryOffset()) != (ssize_t)bytes)) {
+        close();
+        return false;
+    }
+
+    // Discard slots written by an uncommitted checkpoint - they would become
+    // current with the next commit() otherwise
+    bool stale = false;
+    for (size_t k = 0; k < slots.size(); k++) {
+        if (slots[k].generation > header.generation) {
+            memset(&slots[k], 0, sizeof(slots[k]));
+            stale = true;
+        }
+    }
+    if (stale && (pwrite(fd, &slots[0], bytes, directoryOffset()) != (ssize_t)bytes)) {
+        close();
+        return false;
+    }
+    return true;
+}
+
+bool
+RainCheckpointFile::open(const char *path, RainCheckpointHeader &hdr)
+{
+    close();
+    fd = ::open(path, O_RDONLY);
+    if (fd < 0)
+        return false;
+    if (!readHeader(fd, header)) {
+        close();
+        return false;
+    }
+    slots.resize((size_t)header.blocks * 2);
+    size_t bytes = slots.size() * sizeof(RainCheckpointSlot);
+    if (bytes && (pread(fd, &slots[0], bytes, directoryOffset()) != (ssize_t)bytes)) {
+        close();
+        return false;
+    }
+    hdr = header;
+    return true;
+}
+
+void
+RainCheckpointFile::close(void)
+{
+    if (fd >= 0) {
+        ::close(fd);
+        fd = -1;
+    }
+}
+
+bool
+RainCheckpointFile::writeBlocks(uint32_t first, uint32_t n, const void *data)
+{
+    const uint8_t *p    = (const uint8_t *)data;
+    size_t         size = blockSize();
+
+    if ((fd < 0) || (first + n > header.blocks))
+        return false;
+    for (uint32_t b = first; b < first + n; b++, p += size) {
+        // Slot not referenced by the committed header
+        unsigned s = (current(b) == 0) ? 1 : 0;
+        if (pwrite(fd, p, size, (off_t)slotOffset(b, s)) != (ssize_t)size)
+            return false;
+        slots[2 * b + s].generation = header.generation + 1;
+        slots[2 * b + s].crc        = rainCrc32(p, size);
+    }
+    size_t bytes = (size_t)n * 2 * sizeof(RainCheckpointSlot);
+    off_t  pos   = (off_t)(directoryOffset() + (size_t)first * 2 * sizeof(RainCheckpointSlot));
+    return pwrite(fd, &slots[2 * first], bytes, pos) == (ssize_t)bytes;
+}
+
+bool
+RainCheckpointFile::readBlocks(uint32_t first, uint32_t n, void *data, bool *valid) const
+{
+    uint8_t *p    = (uint8_t *)data;
+    size_t   size = blockSize();
+
+    if ((fd < 0) || (first + n > header.blocks))
+        return false;
+    for (uint32_t b = first; b < first + n; b++, p += size) {
+        int s = current(b);
+        if (s < 0) {
+            memset(p, 0, size);
+            valid[b - first] = false;
+            continue;
+        }
+        if (pread(fd, p, size, (off_t)slotOffset(b, (unsigned)s)) != (ssize_t)size)
+            return false;
+        valid[b - first] = (rainCrc32(p, size) == slots[2 * b + s].crc);
+    }
+    return true;
+}
+
+bool
+RainCheckpointFile::commit(uint64_t lsn)
+{
+    if (fd < 0)
+        return false;
+
+    // Blocks first, then the header referring to them
+    if (fsync(fd) != 0)
+        return false;
+    header.lsn = lsn;
+    header.generation++;
+    header.crc = headerCrc(header);
+    off_t pos = (off_t)((header.generation & 1) * sizeof(header));
+    if ((pwrite(fd, &header, sizeof(header), pos) != (ssize_t)sizeof(header)) || (fsync(fd) != 0))
+        return false;
+    if (!tmpPath.empty()) {
+        if (!rainDurableRename(tmpPath.c_str(), path.c_str()))
+            return false;
+        tmpPath.clear();
+    }
+    return true;
+}
+
+#else
+
+bool
+RainCheckpointFile::create(const char *, const RainCheckpointHeader &, bool &fresh)
+{
+    fresh = false;
+    return false;
+}
+
+bool
+RainCheckpointFile::open(const char *, RainCheckpointHeader &)
+{
+    return false;
+}
+
+void
+RainCheckpointFile::close(void)
+{
+}
+
+bool
+RainCheckpointFile::writeBlocks(uint32_t, uint32_t, const void *)
+{
+    return false;
+}
+
+bool
+RainCheckpointFile::readBlocks(uint32_t, uint32_t, void *, bool *) const
+{
+    return false;
+}
+
+bool
+RainCheckpointFile::commit(uint64_t)
+{
+    return false;
+}
+
+#endif
@@ -0,0 +1,419 @@
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// RainCheckpoint.h
+//
+// Versioned binary checkpoints of rain gauge fleets with per-block CRC;
+// periodic checkpoints only rewrite blocks containing modified rain gauges,
+// each into the shadow slot of the block which is not part of the committed checkpoint
+//
+// https://github.com/matthias-bs/BresserWeatherSensorReceiver
+//
+//
+// created: 10/2026
+//
+//
+// MIT License
+//
+// Copyright (c) 2026 Matthias Prinke
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+// History:
+//
+// 20261016 Created
+// 20261016 Version 2 - nvDataT::tsPrev
+// 20261017 Version 3 - two slots per block, two header copies; blocks are no longer
+//                      overwritten in place before the header is committed
+// 20261017 Version 4 - nvDataT: 16 bit time stamps with tsHigh bitmap
+//
+// ToDo:
+// -
+//
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+#include <string>
+#include <vector>
+
+#include "RainGaugeFleet.h"
+
+/**
+ * \def
+ *
+ * Version of the checkpoint file layout
+ */
+#define RAIN_CHECKPOINT_VERSION 4
+
+/**
+ * \struct RainCheckpointHeader
+ *
+ * \brief Header at the begin of a checkpoint file
+ *
+ * \verbatim
+ * File: header copy 0 and 1 (64 bytes each)
+ *       slot directory (two RainCheckpointSlot per block)
+ *       slot 0 of all blocks, slot 1 of all blocks (at 64 byte aligned offset);
+ *       each block holds blockRecords nvDataT records
+ * \endverbatim
+ *
+ * commit() writes the header to copy (generation & 1), so a torn header write
+ * leaves the previous header valid.
+ */
+typedef struct {
+    char      magic[4];     // "RGCP"
+    uint16_t  version;      // RAIN_CHECKPOINT_VERSION
+    uint16_t  headerSize;   // sizeof(RainCheckpointHeader)
+    uint32_t  bufSize;      // circular buffer size of nvDataT
+    uint32_t  recordSize;   // sizeof(nvDataT<bufSize>)
+    uint32_t  count;        // number of records
+    uint32_t  blockRecords; // number of records per block
+    uint32_t  blocks;       // number of blocks
+    uint32_t  reserved0;
+    uint64_t  lsn;          // log sequence number covered by the checkpoint (see RainWal)
+    uint32_t  generation;   // number of checkpoints committed to the file
+    uint32_t  reserved[4];
+    uint32_t  crc;          // CRC-32 of the preceding fields
+} RainCheckpointHeader;
+
+/**
+ * \struct RainCheckpointSlot
+ *
+ * \brief Slot directory entry
+ *
+ * A slot belongs to the checkpoint of the header if 0 < generation <= header generation;
+ * of two such slots of a block, the one with the higher generation is current.
+ */
+typedef struct {
+    uint32_t  generation;   // checkpoint generation which wrote the slot; 0 - empty
+    uint32_t  crc;          // CRC-32 of the block data
+} RainCheckpointSlot;
+
+/**
+ * \class RainCheckpointFile
+ *
+ * \brief Block I/O of a checkpoint file
+ *
+ * writeBlocks() never overwrites the current slot of a block, but the other one, and
+ * tags it with the next generation. The written blocks replace the current ones only
+ * when commit() has written the header - a crash before leaves the previous
+ * checkpoint intact.
+ *
+ * Only available on POSIX systems - open() fails elsewhere.
+ */
+class RainCheckpointFile {
+public:
+    RainCheckpointFile();
+    ~RainCheckpointFile();
+
+    /**
+     * Open checkpoint file for writing
+     *
+     * If the file does not exist or its header does not match layout, a new file
+     * is written to path + ".tmp" which replaces path on the first commit(); all
+     * blocks have to be written then.
+     * Slots left over by an uncommitted checkpoint are discarded.
+     *
+     * \param path   file name
+     * \param layout bufSize, recordSize, count and blockRecords of the checkpoint
+     * \param fresh  file has been created (output)
+     *
+     * \returns true on success
+     */
+    bool  create(const char *path, const RainCheckpointHeader &layout, bool &fresh);
+
+    /**
+     * Open checkpoint file for reading and validate header
+     *
+     * \param path file name
+     * \param hdr  header (output)
+     *
+     * \returns true on success
+     */
+    bool  open(const char *path, RainCheckpointHeader &hdr);
+
+    /**
+     * Close file
+     */
+    void  close(void);
+
+    /**
+     * Write consecutive blocks to their shadow slots
+     *
+     * \param first index of first block
+     * \param n     number of blocks
+     * \param data  block data (n * block size bytes)
+     */
+    bool  writeBlocks(uint32_t first, uint32_t n, const void *data);
+
+    /**
+     * Read current slots of consecutive blocks
+     *
+     * \param first index of first block
+     * \param n     number of blocks
+     * \param data  block data (n * block size bytes)
+     * \param valid CRC of each block matches (output)
+     */
+    bool  readBlocks(uint32_t first, uint32_t n, void *data, bool *valid) const;
+
+    /**
+     * Make written blocks durable, then write header with lsn and next generation
+     */
+    bool  commit(uint64_t lsn);
+
+private:
+    int                             fd;
+    RainCheckpointHeader            header;
+    std::vector<RainCheckpointSlot> slots;    // slot directory
+    std::string                     tmpPath;  // new file (see create())
+    std::string                     path;
+
+    size_t blockSize(void) const {
+      return (size_t)header.blockRecords * header.recordSize;
+    };
+
+    size_t directoryOffset(void) const {
+      return 2 * sizeof(RainCheckpointHeader);
+    };
+
+    size_t slotOffset(uint32_t b, unsigned s) const {
+      size_t data = (directoryOffset() + (size_t)header.blocks * 2 * sizeof(RainCheckpointSlot) + 63) & ~(size_t)63;
+      return data + ((size_t)s * header.blocks + b) * blockSize();
+    };
+
+    /**
+     * Current slot of block b, -1 if none
+     */
+    int   current(uint32_t b) const;
+
+    RainCheckpointFile(const RainCheckpointFile &);
+    RainCheckpointFile &operator=(const RainCheckpointFile &);
+};
+
+/**
+ * \class RainCheckpointT
+ *
+ * \brief Incremental checkpoints of a RainGaugeFleetT
+ *
+ * The rain gauges are grouped into blocks of blockRecords gauges. write() only
+ * writes the blocks containing a gauge which has been modified since the previous
+ * write() (RainGaugeFleetT::dirty()) and clears the modification flags on success.
+ * The blocks go to their shadow slots (see RainCheckpointFile), so an interrupted
+ * write() leaves the previous checkpoint readable.
+ * read() checks the header and the CRC of each block before loading it.
+ *
+ * write() and read() must not run concurrently with updates of the fleet.
+ */
+template <unsigned WindowSeconds, unsigned BufSize, unsigned Scale>
+class RainCheckpointT {
+public:
+    typedef RainGaugeFleetT<WindowSeconds, BufSize, Scale> Fleet;
+
+    /**
+     * Constructor
+     *
+     * \param blockRecords number of rain gauges per block
+     */
+    RainCheckpointT(uint32_t blockRecords = 64) :
+      blockRecords(blockRecords ? blockRecords : 1), written(0), corrupt(0), lsnRead(0)
+    {};
+
+    /**
+     * Write checkpoint (modified blocks only, all blocks of a new file)
+     *
+     * \param path  file name
+     * \param fleet rain gauges
+     * \param lsn   log sequence number covered by the checkpoint
+     *
+     * \returns true on success
+     */
+    bool  write(const char *path, Fleet &fleet, uint64_t lsn = 0);
+
+    /**
+     * Load checkpoint into fleet
+     *
+     * Rain gauges in blocks with CRC errors are reset and counted by corruptBlocks().
+     *
+     * \param path         file name
+     * \param fleet        rain gauges (same number as in checkpoint)
+     * \param raingaugeMax overflow value
+     *
+     * \returns true if the checkpoint was loaded without errors
+     */
+    bool  read(const char *path, Fleet &fleet, float raingaugeMax = RAINGAUGE_MAX_VALUE);
+
+    /**
+     * Number of blocks written by the last write()
+     */
+    uint32_t blocksWritten(void) const {
+      return written;
+    };
+
+    /**
+     * Number of blocks with CRC errors found by the last read()
+     */
+    uint32_t corruptBlocks(void) const {
+      return corrupt;
+    };
+
+    /**
+     * Log sequence number of the checkpoint loaded by the last read()
+     */
+    uint64_t lsn(void) const {
+      return lsnRead;
+    };
+
+private:
+    // Maximum number of blocks per write/read call
+    static const uint32_t RUN_BLOCKS = 16;
+
+    uint32_t blockRecords;
+    uint32_t written;
+    uint32_t corrupt;
+    uint64_t lsnRead;
+
+    std::vector<nvDataT<BufSize> > buf;
+
+    /**
+     * Layout of checkpoint of fleet
+     */
+    void  layout(const Fleet &fleet, RainCheckpointHeader &hdr) const {
+      memset(&hdr, 0, sizeof(hdr));
+      hdr.bufSize      = BufSize;
+      hdr.recordSize   = sizeof(nvDataT<BufSize>);
+      hdr.count        = (uint32_t)fleet.size();
+      hdr.blockRecords = blockRecords;
+      hdr.blocks       = (hdr.count + blockRecords - 1) / blockRecords;
+    };
+
+    /**
+     * Block contains a modified rain gauge
+     */
+    bool  dirtyBlock(const Fleet &fleet, uint32_t b) const {
+      uint32_t end = (b + 1) * blockRecords;
+      if (end > fleet.size())
+          end = (uint32_t)fleet.size();
+      for (uint32_t id = b * blockRecords; id < end; id++) {
+          if (fleet.dirty(id))
+              return true;
+      }
+      return false;
+    };
+};
+
+
+template <unsigned WindowSeconds, unsigned BufSize, unsigned Scale>
+bool
+RainCheckpointT<WindowSeconds, BufSize, Scale>::write(const char *path, Fleet &fleet, uint64_t lsn)
+{
+    RainCheckpointFile   file;
+    RainCheckpointHeader hdr;
+    bool                 fresh;
+
+    written = 0;
+    layout(fleet, hdr);
+    if (!file.create(path, hdr, fresh))
+        return false;
+
+    buf.resize(RUN_BLOCKS * blockRecords);
+
+    uint32_t b = 0;
+    while (b < hdr.blocks) {
+        if (!fresh && !dirtyBlock(fleet, b)) {
+            b++;
+            continue;
+        }
+
+        // Run of consecutive blocks to be written
+        uint32_t n = 0;
+        while ((b + n < hdr.blocks) && (n < RUN_BLOCKS) && (fresh || dirtyBlock(fleet, b + n))) {
+            n++;
+        }
+        memset(&buf[0], 0, (size_t)n * blockRecords * sizeof(nvDataT<BufSize>));
+        for (uint32_t k = 0; k < n * blockRecords; k++) {
+            uint32_t id = b * blockRecords + k;
+            if (id < fleet.size())
+                fleet.store(id, buf[k]);
+        }
+        if (!file.writeBlocks(b, n, &buf[0]))
+            return false;
+        written += n;
+        b += n;
+    }
+
+    if (!file.commit(lsn))
+        return false;
+    fleet.markClean();
+    return true;
+}
+
+template <unsigned WindowSeconds, unsigned BufSize, unsigned Scale>
+bool
+RainCheckpointT<WindowSeconds, BufSize, Scale>::read(const char *path, Fleet &fleet, float raingaugeMax)
+{
+    RainCheckpointFile   file;
+    RainCheckpointHeader hdr;
+    bool                 valid[RUN_BLOCKS];
+
+    corrupt = 0;
+    lsnRead = 0;
+    if (!file.open(path, hdr))
+        return false;
+    if ((hdr.bufSize != BufSize) || (hdr.recordSize != sizeof(nvDataT<BufSize>)) || (hdr.count != fleet.size()))
+        return false;
+
+    buf.resize((size_t)RUN_BLOCKS * hdr.blockRecords);
+
+    for (uint32_t b = 0; b < hdr.blocks; b += RUN_BLOCKS) {
+        uint32_t n = (hdr.blocks - b < RUN_BLOCKS) ? hdr.blocks - b : RUN_BLOCKS;
+        if (!file.readBlocks(b, n, &buf[0], valid))
+            return false;
+        for (uint32_t k = 0; k < n; k++) {
+            const nvDataT<BufSize> *block = &buf[(size_t)k * hdr.blockRecords];
+            bool ok = valid[k];
+            if (!ok)
+                corrupt++;
+            for (uint32_t r = 0; r < hdr.blockRecords; r++) {
+                uint32_t id = (b + k) * hdr.blockRecords + r;
+                if (id >= fleet.size())
+                    break;
+                if (ok) {
+                    fleet.load(id, block[r], raingaugeMax);
+                } else {
+                    fleet.reset(id);
+                }
+            }
+        }
+    }
+    lsnRead = hdr.lsn;
+    if (corrupt)
+        return false;
+    // Fleet matches checkpoint
+    fleet.markClean();
+    return true;
+}
+
+/**
+ * \typedef RainCheckpoint
+ *
+ * \brief Checkpoints of a RainGaugeFleet
+ */
+typedef RainCheckpointT<RAINGAUGE_WINDOW, RAINGAUGE_BUF_SIZE, RAINGAUGE_SCALE> RainCheckpoint;
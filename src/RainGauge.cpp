@@ -39,6 +39,12 @@
 // 20220830 Created
 // 20230716 Implemented sensor startup handling
 // 20230817 Implemented partial reset
+// 20261016 Replaced mktime() in timeStamp() by civil calendar arithmetic
+// 20261016 Added update() with epoch time stamp and cached local day boundaries
+// 20261016 Added timezone binding
+// 20261016 Moved RainGaugeT implementation (class template) to RainGauge.h
+// 20261016 Added nvData.tsPrev
+// 20261017 fromEpoch(): wall clock seconds since midnight on days with UTC offset change
 //
 // ToDo: 
 // -
@@ -47,6 +53,7 @@
 
 #include <Arduino.h>
 #include "RainGauge.h"
+#include "TimeZone.h"
 
 const int SECONDS_PER_HOUR = 3600;
 const int SECONDS_PER_DAY  = 86400;
@@ -73,255 +80,135 @@ RTC_DATA_ATTR nvData_t nvData = {
    .tsMonthBegin = 0xFF,
    .rainMonthBegin = 0,
    .rainPrev = 0,
-   .rainOvf = 0
+   .rainOvf = 0,
+   .peakIdx = {0},
+   .peakFirst = 0,
+   .peakCount = 0,
+   .tsPrev = 0
 };
 
 
-/**
- * \verbatim
- * Total rainfall in the past hour
- * -------------------------------
- * To determine the rainfall in the past hour, timestamps (ts) and rain gauge values (rain) 
- * are stored in a circular buffer:
- *
- *      ---------------     -----------
- * .-> |   |   |   |   |...|   |   |   |--. 
- * |    ---------------     -----------   |
- * |     ^                   ^            |
- * |    tail                head          |
- * `--------------------------------------'
- *
- * 
- * - Add new value: 
- *   increment(head); 
- *   rainBuf[head] = rainNow; 
- *   tsBuf[head]   = tsNow;
- * 
- * - Remove stale entries: 
- *   if ((tsBuf[head]-tsBuf[tail]) > 1hour) {
- *     increment(tail);
- *   }
- * 
- * - Calculate hourly rate:
- *   rainHour = rainBuf[head] - rainBuf[tail];
- * 
- * Notes:
- * - increment(i) := "i = (i+1) mod RAINGAUGE_BUF_SIZE"
- * - If a new value is added when the buffer is already filled
- *   (which would result in increment(head) == tail), head is
- *   NOT incremented and the previous value is overwritten instead.
- * - Rain values are stored as uint16_t encoded as fixed-point data with one decimal
- *   to reduce memory consumption.
- * - Timestamps are stored as seconds since midnight; the discontinuity between days
- *   is handled when stale entries are removed. 
- * \endverbatim
- */
-
-#ifdef _DEBUG_CIRCULAR_BUFFER_
 void
-RainGauge::printCircularBuffer(void)
+RainClock::fromTm(const tm &t, rainTime_t &rt)
 {
-    for (int i=0; i<RAINGAUGE_BUF_SIZE; i++)
-        printf("[%3d ]\t", i);
-    printf("\n");
-    for (int i=0; i<RAINGAUGE_BUF_SIZE; i++)
-        printf("%6d\t", nvData->tsBuf[i] & 0xFFFF);
-    printf("\n");
-    for (int i=0; i<RAINGAUGE_BUF_SIZE; i++)
-        printf("%6.1f\t", 0.1 * nvData->rainBuf[i]);
-    printf("\n");
-    for (int i=0; i<RAINGAUGE_BUF_SIZE; i++)
-        printf("%3s\t", (i == nvData->tail) ? "T" : "");
-    printf("\n");
-    for (int i=0; i<RAINGAUGE_BUF_SIZE; i++)
-        printf("%3s\t", (i == nvData->head) ? "H" : "");
-    printf("\n\n");
+    // Seconds since epoch in local (wall clock) time; seconds are discarded.
+    // Out-of-range fields are normalized as done by mktime(), but without
+    // taking the libc timezone lock.
+    int64_t ts = (int64_t)daysFromTm(t.tm_year, t.tm_mon, t.tm_mday) * SECONDS_PER_DAY
+                 + (int64_t)t.tm_hour * SECONDS_PER_HOUR
+                 + (int64_t)t.tm_min * CIVIL_SECONDS_PER_MINUTE;
+
+    rt.day  = (int32_t)civilFloorDiv(ts, SECONDS_PER_DAY);
+    rt.ts   = (uint32_t)(ts - (int64_t)rt.day * SECONDS_PER_DAY);
+    rt.wday = weekdayFromDays(rt.day);
+    rt.mon  = monthFromDays(rt.day) - 1;
+    rt.mono = ts;
 }
-#endif
-
 
 void
-RainGauge::reset(uint8_t flags)
+RainClock::fromEpoch(time_t epoch, rainTime_t &rt)
 {
-    if (flags & RESET_RAIN_H) {
-        nvData->head           = 0;
-        nvData->tail           = 0;
-        for (int i=0; i < RAINGAUGE_BUF_SIZE; i++) {
-           nvData->tsBuf[i]   = 0;
-           nvData->rainBuf[i] = 0;
-        }
-    }
-    if (flags & RESET_RAIN_D) {
-        nvData->tsDayBegin     = 0xFF;
-        nvData->rainDayBegin   = 0;
+    // Common case: same local day as previous call
+    if ((epoch < midnight) || (epoch >= nextMidnight)) {
+        newDay(epoch);
     }
-    if (flags & RESET_RAIN_W) {
-        nvData->tsWeekBegin    = 0xFF;
-        nvData->rainWeekBegin  = 0;
-        nvData->wdayPrev       = 0xFF;
-    }
-    if (flags & RESET_RAIN_M) {
-        nvData->tsMonthBegin   = 0xFF;
-        nvData->rainMonthBegin = 0;
+    rt    = today;
+
+    // Wall clock seconds since midnight; seconds are discarded (see fromTm())
+    if (uniform) {
+        // No UTC offset change during this day - wall clock time is elapsed time
+        rt.ts = (uint32_t)(epoch - midnight);
+    } else {
+        rt.ts = (uint32_t)civilFloorMod(localTime(epoch), SECONDS_PER_DAY);
     }
+    rt.ts = rt.ts - (rt.ts % CIVIL_SECONDS_PER_MINUTE);
 
-    if (flags == (RESET_RAIN_H | RESET_RAIN_D | RESET_RAIN_W | RESET_RAIN_M)) {
-        nvData->startupPrev    = false;
-        nvData->rainStartup    = 0;
-        nvData->rainPrev       = 0;
-        nvData->rainOvf        = 0;
-        rainCurr              = 0;
-    }
+    // Local standard time; seconds are discarded
+    rt.mono = (int64_t)epoch + stdOffset;
+    rt.mono = rt.mono - civilFloorMod(rt.mono, CIVIL_SECONDS_PER_MINUTE);
 }
 
-void
-RainGauge::init(tm t, float rain)
+int64_t
+RainClock::localTime(time_t epoch) const
 {
-    // Seconds since midnight
-    uint32_t ts = timeStamp(t);
-    
-    // Init circular buffer with current timestamp (seconds since midnight) and rain gauge data
-    for (int i=0; i<RAINGAUGE_BUF_SIZE; i++) {
-        nvData->tsBuf[i]   = (uint32_t)ts;
-        nvData->rainBuf[i] = (uint16_t)(rain * 10);
+    tm t;
+
+    if (tz != NULL) {
+        return (int64_t)epoch + tz->utcOffset(epoch);
     }
-    nvData->head = 0;
-    nvData->tail = 0;
-    nvData->tsDayBegin = t.tm_wday;
+
+    localtime_r(&epoch, &t);
+    return (int64_t)daysFromTm(t.tm_year, t.tm_mon, t.tm_mday) * SECONDS_PER_DAY
+           + (int64_t)t.tm_hour * SECONDS_PER_HOUR
+           + (int64_t)t.tm_min * CIVIL_SECONDS_PER_MINUTE
+           + t.tm_sec;
 }
 
-uint32_t
-RainGauge::timeStamp(tm t)
+int32_t
+RainClock::standardOffset(int32_t day) const
 {
-    time_t  ts;          // seconds since epoch
-    tm      t_midnight;  // timestamp at midnight
-    time_t  ts_midnight; // seconds since epoch at midnight
-   
-    // Calculate seconds since midnight
-    t.tm_sec           = 0;
-    t_midnight = t;
-    t_midnight.tm_hour = 0;
-    t_midnight.tm_min  = 0;
-    ts          = mktime(&t);
-    ts_midnight = mktime(&t_midnight);
-    ts = ts - ts_midnight;
-    
-    return (uint32_t)ts;
+    // Smaller UTC offset of January and July (northern and southern hemisphere)
+    int32_t year   = yearFromDays(day);
+    time_t  jan    = (time_t)daysFromCivil(year, 1, 1) * SECONDS_PER_DAY;
+    time_t  jul    = (time_t)daysFromCivil(year, 7, 1) * SECONDS_PER_DAY;
+    int64_t offJan = localTime(jan) - jan;
+    int64_t offJul = localTime(jul) - jul;
+
+    return (int32_t)((offJan < offJul) ? offJan : offJul);
 }
 
 void
-RainGauge::update(tm t, float rain, bool startup, float raingaugeMax)
+RainClock::newDay(time_t epoch)
 {
-    uint8_t  head_tmp; // circular buffer; temporary head index
-
-    // Seconds since Midnight
-    uint32_t ts = timeStamp(t);
-
-    if (rain < nvData->rainPrev) {
-       // Startup change 0->1 detected
-       if (!nvData->startupPrev && startup) {
-           // Save last rain value before startup
-           nvData->rainStartup = nvData->rainPrev;
-       } else {
-           nvData->rainOvf++;
-       }
-    }
-   
-    nvData->startupPrev = startup;
-    nvData->rainPrev = rain;
-    
-    rainCurr = (nvData->rainOvf * raingaugeMax) + nvData->rainStartup + rain;
-
-    // Check if no saved data is available yet
-    if (nvData->wdayPrev == 0xFF) {
-        // Save day of week to allow detection of new week
-        nvData->wdayPrev = t.tm_wday;
-
-        // Init tail of circular buffer
-        nvData->tsBuf[nvData->tail]   = ts;
-        nvData->rainBuf[nvData->tail] = (uint16_t)(rainCurr * 10);
-    }
-
-    // Remove stale entries
-    uint32_t ts_cmp;
-    while (!(nvData->tail == nvData->head)) {
-        ts_cmp = ts;
-        // if current timestamp smaller than saved timestamp, add one day
-        if (ts_cmp < nvData->tsBuf[nvData->tail]) {
-            ts_cmp = ts_cmp + SECONDS_PER_DAY;
-        }
-        if ((ts_cmp - nvData->tsBuf[nvData->tail]) <= SECONDS_PER_HOUR)
-            break;
-        nvData->tail = (nvData->tail == RAINGAUGE_BUF_SIZE-1) ? 0 : nvData->tail+1;
+    tm t;
+    tm t_midnight;
+
+    if (tz != NULL) {
+        int64_t m;
+        int64_t n;
+
+        // Lock-free lookup in immutable transition table
+        tz->localDay(epoch, today.day, m, n);
+        today.ts     = 0;
+        today.wday   = weekdayFromDays(today.day);
+        today.mon    = monthFromDays(today.day) - 1;
+        midnight     = (time_t)m;
+        nextMidnight = (time_t)n;
+        uniform      = (nextMidnight - midnight == SECONDS_PER_DAY);
+        stdOffset    = standardOffset(today.day);
+        return;
     }
 
-    //printCircularBuffer();
-    // Add new value
-    head_tmp = (nvData->head == RAINGAUGE_BUF_SIZE-1) ? 0 : nvData->head+1;
-    // Prevent head from reaching tail if update rate is too fast
-    nvData->head = (head_tmp == nvData->tail) ? nvData->head : head_tmp;
-    nvData->tsBuf[nvData->head]   = ts;
-    nvData->rainBuf[nvData->head] = (uint16_t)(rainCurr * 10);
-            
-    // Check if day of the week has changed
-    // or no saved data is available yet
-    if ((t.tm_wday != nvData->tsDayBegin) || 
-        (nvData->tsDayBegin == 0xFF)) {
-        // save timestamp
-        nvData->tsDayBegin = t.tm_wday;
-        
-        // save rain gauge value
-        nvData->rainDayBegin = rainCurr;
-    }
-    
-    // Check if the week has changed
-    // (transition from 0 - Sunday to 1 - Monday
-    // or no saved data is available yet
-    if (((t.tm_wday == 1) && (nvData->wdayPrev == 0)) ||
-        (nvData->tsWeekBegin == 0xFF)) {
-        // save timestamp
-        nvData->tsWeekBegin = t.tm_wday;
-        
-        // save rain gauge value
-        nvData->rainWeekBegin = rainCurr;
+    localtime_r(&epoch, &t);
+
+    today.day  = daysFromTm(t.tm_year, t.tm_mon, t.tm_mday);
+    today.ts   = 0;
+    today.wday = weekdayFromDays(today.day);
+    today.mon  = monthFromDays(today.day) - 1;
+
+    // Let mktime() resolve daylight saving time at both midnights
+    t_midnight          = t;
+    t_midnight.tm_hour  = 0;
+    t_midnight.tm_min   = 0;
+    t_midnight.tm_sec   = 0;
+    t_midnight.tm_isdst = -1;
+    midnight            = mktime(&t_midnight);
+
+    t_midnight          = t;
+    t_midnight.tm_mday += 1;
+    t_midnight.tm_hour  = 0;
+    t_midnight.tm_min   = 0;
+    t_midnight.tm_sec   = 0;
+    t_midnight.tm_isdst = -1;
+    nextMidnight        = mktime(&t_midnight);
+
+    // Fallback if midnight does not exist in local time or conversion failed
+    if ((midnight > epoch) || (midnight == (time_t)-1)) {
+        midnight = epoch - (t.tm_hour * SECONDS_PER_HOUR + t.tm_min * CIVIL_SECONDS_PER_MINUTE + t.tm_sec);
     }
-    
-    // Update day of week
-    nvData->wdayPrev = t.tm_wday;
-        
-    // Check if month has changed
-    // or no saved data is available yet
-    if ((t.tm_mon != nvData->tsMonthBegin) ||
-        (nvData->tsMonthBegin == 0xFF)) {
-        // save timestamp
-        nvData->tsMonthBegin = t.tm_mon;
-        
-        // save rain gauge value
-        nvData->rainMonthBegin = rainCurr;
+    if ((nextMidnight <= epoch) || (nextMidnight == (time_t)-1)) {
+        nextMidnight = midnight + SECONDS_PER_DAY;
     }
-
-}
-
-float
-RainGauge::pastHour(void)
-{
-    return (float)(0.1 * (nvData->rainBuf[nvData->head] - nvData->rainBuf[nvData->tail]));
-}
-
-float
-RainGauge::currentDay(void)
-{
-    return rainCurr - nvData->rainDayBegin;
-}
-
-float
-RainGauge::currentWeek(void)
-{
-    return rainCurr - nvData->rainWeekBegin;
-}
-
-float
-RainGauge::currentMonth(void)
-{
-    return rainCurr - nvData->rainMonthBegin;
+    uniform   = (nextMidnight - midnight == SECONDS_PER_DAY);
+    stdOffset = standardOffset(today.day);
 }
@@ -40,17 +40,36 @@
 // 20230330 Added changes for Adafruit Feather 32u4 LoRa Radio
 // 20230716 Implemented sensor startup handling
 // 20230817 Implemented partial reset
+// 20261016 Replaced mktime() in timeStamp() by civil calendar arithmetic
+// 20261016 Added update() with epoch time stamp and cached local day boundaries
+// 20261016 Added timezone binding
+// 20261016 Changed RainGauge/nvData_t into class templates RainGaugeT/nvDataT
+// 20261016 Moved update steps shared by all engines to RainGaugeCore
+// 20261016 Added peak rain rate of past window (monotonic deque)
+// 20261016 Added resume()
+// 20261016 Added backfill()
+// 20261016 Added rebuildBuffer()
+// 20261016 Added coalescing of unchanged readings in circular buffer
+// 20261017 RainClock::fromEpoch(): wall clock seconds since midnight
+// 20261017 Added continuous local time (rainTime_t::mono)
+// 20261017 Peak rain rate deque: indices only, O(1) update with full circular buffer
+// 20261017 nvDataT: 17 bit time stamps, rain values modulo 2^16 (no wrap at 6553.5 mm)
 //
 // ToDo: 
 // -
 //
 ///////////////////////////////////////////////////////////////////////////////////////////////////
 
+#pragma once
+
 #include "time.h"
+#include "CivilTime.h"
 #if defined(ESP32) || defined(ESP8266)
   #include <sys/time.h>
 #endif
 
+class TimeZone;
+
 /**
  * \def
  * 
@@ -66,6 +85,20 @@
  */ 
 #define RAINGAUGE_BUF_SIZE 11
 
+/**
+ * \def
+ * 
+ * Length of the rolling window of RainGauge::pastHour() in seconds
+ */ 
+#define RAINGAUGE_WINDOW 3600
+
+/**
+ * \def
+ * 
+ * Fixed-point scale of the circular buffer (10: resolution 0.1 mm)
+ */ 
+#define RAINGAUGE_SCALE 10
+
 /**
  * \defgroup Reset rain counters
  */
@@ -81,18 +114,37 @@
 //#define _DEBUG_CIRCULAR_BUFFER_
 
 /**
- * \typedef nvData_t
+ * \struct rainIndex
+ *
+ * \brief Smallest unsigned type for circular buffer indices [0..BufSize-1]
+ */
+template <unsigned BufSize, bool Small = (BufSize <= 256)>
+struct rainIndex {
+    typedef uint8_t type;
+};
+
+template <unsigned BufSize>
+struct rainIndex<BufSize, false> {
+    typedef uint16_t type;
+};
+
+/**
+ * \struct nvDataT
  *
  * \brief Data structure for rain statistics to be stored in non-volatile memory
  *
  * On ESP32, this data is stored in the RTC RAM. 
+ *
+ * \tparam BufSize size of circular buffer for rainfall during past window
  */
-typedef struct {
+template <unsigned BufSize>
+struct nvDataT {
     /* rainfall during past hour - circular buffer */
-    uint32_t  tsBuf[RAINGAUGE_BUF_SIZE];
-    uint16_t  rainBuf[RAINGAUGE_BUF_SIZE];
-    uint8_t   head;
-    uint8_t   tail;
+    uint16_t  tsBuf[BufSize]; // seconds since local midnight, bits 0..15 (see ts())
+    uint16_t  rainBuf[BufSize]; // accumulated rain gauge value, fixed-point modulo 2^16 (see RainGaugeCore::rainDelta())
+    uint8_t   tsHigh[(BufSize + 7) / 8]; // bit 16 of tsBuf entries, one bit per entry
+    typename rainIndex<BufSize>::type head;
+    typename rainIndex<BufSize>::type tail;
 
     /* Sensor startup handling */
     bool      startupPrev; // previous state of startup
@@ -113,22 +165,310 @@ typedef struct {
 
     float     rainPrev;  // rain gauge at previous run - to detect overflow
     uint16_t  rainOvf; // number of rain gauge overflows
-} nvData_t;
+
+    /* Peak rain rate during past window - monotonic deque of circular buffer indices */
+    typename rainIndex<BufSize>::type peakIdx[BufSize]; // end of sample interval before head; rates decreasing
+    typename rainIndex<BufSize>::type peakFirst; // deque front (position in peakIdx)
+    typename rainIndex<BufSize>::type peakCount; // number of deque entries
+
+    uint32_t  tsPrev; // time stamp of previous reading - end of unchanged readings not stored (coalescing)
+
+    /**
+     * Time stamp of circular buffer entry i (seconds since local midnight)
+     */
+    uint32_t ts(unsigned i) const {
+      return tsBuf[i] | ((uint32_t)((tsHigh[i >> 3] >> (i & 7)) & 1) << 16);
+    };
+
+    /**
+     * Set time stamp of circular buffer entry i (seconds since local midnight)
+     */
+    void  setTs(unsigned i, uint32_t t) {
+      tsBuf[i] = (uint16_t)t;
+      tsHigh[i >> 3] = (uint8_t)((tsHigh[i >> 3] & ~(1u << (i & 7))) | (((t >> 16) & 1) << (i & 7)));
+    };
+};
+
+/**
+ * \typedef nvData_t
+ *
+ * \brief Non-volatile data of the default RainGauge
+ */
+typedef nvDataT<RAINGAUGE_BUF_SIZE> nvData_t;
+
+/**
+ * \typedef rainTime_t
+ *
+ * \brief Local calendar position of a rain gauge reading
+ */
+typedef struct {
+    int32_t   day;  // days since 1970-01-01 (local date)
+    uint32_t  ts;   // seconds since local midnight (wall clock) [0..86399]
+    uint8_t   wday; // day of week [0..6], 0 - Sunday
+    uint8_t   mon;  // month [0..11]
+    int64_t   mono; // continuous local time in seconds since 1970-01-01 00:00 (see RainClock)
+} rainTime_t;
+
+/**
+ * \struct rainSample_t
+ *
+ * \brief Historical rain gauge reading for RainGauge::backfill()
+ */
+typedef struct {
+    time_t    epoch;   // seconds since epoch (UTC)
+    float     rain;    // rain gauge raw value
+    bool      startup; // sensor startup flag
+} rainSample_t;
 
 /**
- * \class RainGauge
+ * \class RainClock
+ *
+ * \brief Conversion of date/time into the local calendar position used by RainGauge
  *
- * \brief Calculation of hourly (past 60 minutes), daily, weekly and monthly rainfall
+ * For epoch time stamps, the boundaries of the current local day are cached;
+ * only readings outside of [midnight, next midnight) require a timezone conversion.
+ *
+ * Seconds since midnight (ts) follow the wall clock and jump at daylight saving time
+ * changes. Engines which compare time stamps across days use the continuous local
+ * time (mono) instead: local standard time for epoch time stamps, and day and ts
+ * combined for struct tm (which carries no UTC offset).
+ */
+class RainClock {
+public:
+    RainClock() {
+      tz = NULL;
+      invalidate();
+    };
+
+    /**
+     * Use given timezone instead of the process-global local time (TZ)
+     *
+     * With a timezone bound, epoch conversion calls no libc time functions
+     * and is thread-safe.
+     *
+     * \param timezone timezone table (must outlive the clock) or NULL for libc local time
+     */
+    void setTimeZone(const TimeZone *timezone) {
+      tz = timezone;
+      invalidate();
+    };
+
+    /**
+     * Convert date and time (struct tm, local wall clock time)
+     *
+     * Only tm_year, tm_mon, tm_mday, tm_hour and tm_min are evaluated;
+     * no libc time functions are called.
+     *
+     * \param t  date and time (struct tm)
+     * 
+     * \param rt local calendar position (output)
+     */
+    static void fromTm(const tm &t, rainTime_t &rt);
+
+    /**
+     * Convert seconds since epoch (UTC)
+     *
+     * Seconds since midnight are local wall clock time as with fromTm(), so
+     * the time stamps of both conversions can be mixed in the circular buffer.
+     *
+     * \param epoch seconds since epoch (UTC)
+     * 
+     * \param rt    local calendar position (output)
+     */
+    void fromEpoch(time_t epoch, rainTime_t &rt);
+
+    /**
+     * Discard cached day boundaries (e.g. after the timezone has changed)
+     */
+    void invalidate(void) {
+      midnight     = 1;
+      nextMidnight = 0;
+      uniform      = true;
+      stdOffset    = 0;
+    };
+
+private:
+    const TimeZone *tz;      // bound timezone or NULL
+    time_t     midnight;     // epoch at begin of cached local day
+    time_t     nextMidnight; // epoch at begin of following local day
+    rainTime_t today;        // cached calendar position of current day
+    bool       uniform;      // no UTC offset change during cached day (24 hours)
+    int32_t    stdOffset;    // UTC offset of local standard time in year of cached day
+
+    /**
+     * Update cached day boundaries for the local day containing epoch
+     */
+    void newDay(time_t epoch);
+
+    /**
+     * Local wall clock time in seconds since 1970-01-01 00:00
+     */
+    int64_t localTime(time_t epoch) const;
+
+    /**
+     * UTC offset of local standard time in the year of given local day
+     */
+    int32_t standardOffset(int32_t day) const;
+};
+
+/**
+ * \struct RainGaugeCore
+ *
+ * \brief Update steps shared by all rain gauge engines
+ *
+ * NV is any non-volatile data structure providing the sensor startup, overflow
+ * and calendar fields of nvDataT (startupPrev ... rainOvf).
+ */
+struct RainGaugeCore {
+    /**
+     * Circular buffer entry of accumulated rain gauge value: fixed-point modulo 2^16
+     *
+     * Only differences of entries are used (see rainDelta()), so the value may exceed
+     * 65535 / scale.
+     */
+    static uint16_t rainFixed(float rain, unsigned scale) {
+      return (uint16_t)(uint32_t)(rain * scale);
+    };
+
+    /**
+     * Difference a - b of circular buffer entries (exact for less than 2^15 / scale)
+     */
+    static int32_t rainDelta(uint16_t a, uint16_t b) {
+      return (int16_t)(uint16_t)(a - b);
+    };
+
+    /**
+     * Handle rain gauge overflow and sensor startup
+     *
+     * \returns accumulated rain gauge value (rainCurr)
+     */
+    template <class NV>
+    static float accumulate(NV *nv, float rain, bool startup, float raingaugeMax) {
+      if (rain < nv->rainPrev) {
+         // Startup change 0->1 detected
+         if (!nv->startupPrev && startup) {
+             // Save last rain value before startup
+             nv->rainStartup = nv->rainPrev;
+         } else {
+             nv->rainOvf++;
+         }
+      }
+   
+      nv->startupPrev = startup;
+      nv->rainPrev = rain;
+    
+      return (nv->rainOvf * raingaugeMax) + nv->rainStartup + rain;
+    };
+
+    /**
+     * Detect begin of new day, week and month
+     */
+    template <class NV>
+    static void calendar(NV *nv, const rainTime_t &t, float rainCurr) {
+      // Check if no saved data is available yet
+      if (nv->wdayPrev == 0xFF) {
+          // Save day of week to allow detection of new week
+          nv->wdayPrev = t.wday;
+      }
+
+      // Check if day of the week has changed
+      // or no saved data is available yet
+      if ((t.wday != nv->tsDayBegin) || 
+          (nv->tsDayBegin == 0xFF)) {
+          // save timestamp
+          nv->tsDayBegin = t.wday;
+        
+          // save rain gauge value
+          nv->rainDayBegin = rainCurr;
+      }
+    
+      // Check if the week has changed
+      // (transition from 0 - Sunday to 1 - Monday
+      // or no saved data is available yet
+      if (((t.wday == 1) && (nv->wdayPrev == 0)) ||
+          (nv->tsWeekBegin == 0xFF)) {
+          // save timestamp
+          nv->tsWeekBegin = t.wday;
+        
+          // save rain gauge value
+          nv->rainWeekBegin = rainCurr;
+      }
+    
+      // Update day of week
+      nv->wdayPrev = t.wday;
+        
+      // Check if month has changed
+      // or no saved data is available yet
+      if ((t.mon != nv->tsMonthBegin) ||
+          (nv->tsMonthBegin == 0xFF)) {
+          // save timestamp
+          nv->tsMonthBegin = t.mon;
+        
+          // save rain gauge value
+          nv->rainMonthBegin = rainCurr;
+      }
+    };
+
+    /**
+     * Reset daily, weekly and monthly rain counters and - if all flags are set -
+     * sensor startup/overflow state and current rain counter value
+     */
+    template <class NV>
+    static void reset(NV *nv, uint8_t flags, float &rainCurr) {
+      if (flags & RESET_RAIN_D) {
+          nv->tsDayBegin     = 0xFF;
+          nv->rainDayBegin   = 0;
+      }
+      if (flags & RESET_RAIN_W) {
+          nv->tsWeekBegin    = 0xFF;
+          nv->rainWeekBegin  = 0;
+          nv->wdayPrev       = 0xFF;
+      }
+      if (flags & RESET_RAIN_M) {
+          nv->tsMonthBegin   = 0xFF;
+          nv->rainMonthBegin = 0;
+      }
+
+      if (flags == (RESET_RAIN_H | RESET_RAIN_D | RESET_RAIN_W | RESET_RAIN_M)) {
+          nv->startupPrev    = false;
+          nv->rainStartup    = 0;
+          nv->rainPrev       = 0;
+          nv->rainOvf        = 0;
+          rainCurr           = 0;
+      }
+    };
+};
+
+/**
+ * \class RainGaugeT
+ *
+ * \brief Calculation of rolling window (e.g. past 60 minutes), daily, weekly and monthly rainfall
  *
  * Additionally overflow of the rain gauge is handled when reaching RAINGAUGE_MAX_VALUE. 
+ *
+ * Index wrap-around of the circular buffer is resolved at compile time;
+ * a power-of-two BufSize results in a simple bit mask.
+ *
+ * \tparam WindowSeconds length of rolling window in seconds (less than one day)
+ * \tparam BufSize       size of circular buffer; (WindowSeconds / update_rate [sec]) + 1
+ * \tparam Scale         fixed-point scale of rain values in circular buffer (10: 0.1 mm)
  */
-class RainGauge {
+template <unsigned WindowSeconds, unsigned BufSize, unsigned Scale>
+class RainGaugeT {
 public:
+    static_assert(WindowSeconds > 0 && WindowSeconds < CIVIL_SECONDS_PER_DAY,
+                  "Window must be shorter than one day (time stamps are seconds since midnight)");
+    static_assert(BufSize >= 2 && BufSize <= 65535, "Invalid circular buffer size");
+    static_assert(Scale >= 1, "Invalid fixed-point scale");
+
+    typedef typename rainIndex<BufSize>::type index_t;
+
     float rainCurr;
-    nvData_t *nvData;
+    nvDataT<BufSize> *nvData;
     
-    RainGauge(nvData_t *data) {
-      nvData = data;
+    RainGaugeT(nvDataT<BufSize> *data) {
+      nvData   = data;
+      coalesce = false;
     };
 
 #ifdef _DEBUG_CIRCULAR_BUFFER_
@@ -150,6 +490,19 @@ public:
     void  init(tm t, float rain);
     
     
+    /**
+     * Resume from non-volatile data restored by the caller (e.g. RainNvStore)
+     *
+     * Restores the current rain counter value, so the statistics are valid
+     * before the next update.
+     *
+     * \param rainGaugeMax overflow value used with the non-volatile data
+     */
+    void  resume(float raingaugeMax = RAINGAUGE_MAX_VALUE) {
+      rainCurr = (nvData->rainOvf * raingaugeMax) + nvData->rainStartup + nvData->rainPrev;
+    };
+    
+    
     /**
      * \fn update
      * 
@@ -163,14 +516,137 @@ public:
      * 
      * \param rainGaugeMax overflow value; when reached, the rain gauge is reset to zero
      */  
-    void  update(tm timeinfo, float rain, bool startup = false, float raingaugeMax = RAINGAUGE_MAX_VALUE);
+    void  update(tm timeinfo, float rain, bool startup = false, float raingaugeMax = RAINGAUGE_MAX_VALUE) {
+      rainTime_t rt;
+
+      // Day of week and month are derived from the date, tm_wday/tm_yday need not be set
+      RainClock::fromTm(timeinfo, rt);
+      updateLocal(rt, rain, startup, raingaugeMax);
+    };
+    
+    
+    /**
+     * \fn update
+     * 
+     * \brief Update rain gauge statistics
+     * 
+     * The boundaries of the current local day are cached, so only the first update
+     * after midnight requires a timezone conversion.
+     * 
+     * \param epoch        seconds since epoch (UTC)
+     * 
+     * \param rain         rain gauge raw value
+     * 
+     * \param startup      sensor startup flag
+     * 
+     * \param rainGaugeMax overflow value; when reached, the rain gauge is reset to zero
+     */  
+    void  update(time_t epoch, float rain, bool startup = false, float raingaugeMax = RAINGAUGE_MAX_VALUE) {
+      rainTime_t rt;
+
+      clock.fromEpoch(epoch, rt);
+      updateLocal(rt, rain, startup, raingaugeMax);
+    };
+    
+    
+    /**
+     * \fn backfill
+     *
+     * \brief Load history of readings at once
+     *
+     * The resulting state matches update(time_t) called with each sample in turn:
+     * - overflow and startup handling is applied to each sample (it depends on every
+     *   pair of consecutive raw values),
+     * - the calendar baselines are only evaluated when the local day changes, since
+     *   RainGaugeCore::calendar() is a no-op for further samples of the same day,
+     * - the circular buffer is maintained without the peak rain rate deque, which is
+     *   rebuilt once from the final circular buffer. The deque always holds the entries
+     *   of (tail, head) whose rate exceeds the rates of all later entries, so the
+     *   rebuilt deque equals the incrementally maintained one (up to its position in
+     *   peakIdx).
+     *
+     * \param n            number of samples
+     *
+     * \param samples      samples in chronological order
+     *
+     * \param rainGaugeMax overflow value; when reached, the rain gauge is reset to zero
+     */
+    void  backfill(size_t n, const rainSample_t *samples, float raingaugeMax = RAINGAUGE_MAX_VALUE);
+    
+    
+    /**
+     * \fn rebuildBuffer
+     *
+     * \brief Rebuild circular buffer from readings with known accumulated rain values
+     *
+     * Writes the circular buffer and the peak rain rate deque as update() would for
+     * the given readings. Sensor startup, overflow and calendar fields are not touched;
+     * the caller (e.g. RainHistoryT, which determines them in parallel) sets them.
+     *
+     * \param n        number of readings
+     *
+     * \param t        local calendar positions of readings in chronological order
+     *
+     * \param values   accumulated rain gauge values (rainCurr, including overflows)
+     */
+    void  rebuildBuffer(size_t n, const rainTime_t *t, const float *values);
+    
+    
+    /**
+     * Bind rain gauge to timezone used by update(time_t)
+     *
+     * \param tz timezone table (must outlive the rain gauge) or NULL for libc local time
+     */
+    void  setTimeZone(const TimeZone *tz) {
+      clock.setTimeZone(tz);
+    };
     
     
     /**
-     * Rainfall during past 60 minutes
+     * Rainfall during past window (WindowSeconds, i.e. 60 minutes for RainGauge)
      */
     float pastHour(void);
     
+    /**
+     * Enable/disable coalescing of unchanged readings in the circular buffer
+     *
+     * With coalescing, a reading is only stored if the rain value has changed
+     * or if the head entry is about to leave the window. When the value changes,
+     * the last unchanged reading is stored as boundary in front of the new entry.
+     * pastHour() is the same as without coalescing, as long as the circular buffer
+     * does not overflow and readings are less than one day apart; pastHourPeakRate()
+     * is the same if the rain counter does not decrease (zero rate intervals are
+     * not stored).
+     */
+    void  setCoalescing(bool enable) {
+      coalesce = enable;
+    };
+
+    /**
+     * Peak rain rate [mm/h] of all sample intervals during past window
+     *
+     * The maximum of the sample intervals before head is maintained incrementally by
+     * update(); the interval ending at head (which is overwritten if the circular buffer
+     * is full) is compared on read.
+     */
+    float pastHourPeakRate(void) {
+      if (nvData->head == nvData->tail)
+          return 0;
+      float rate = intervalRate(nvData->head);
+      if (nvData->peakCount > 0) {
+          float front = intervalRate(nvData->peakIdx[nvData->peakFirst]);
+          rate = (front > rate) ? front : rate;
+      }
+      return rate;
+    };
+
+    /**
+     * Rebuild peak rain rate deque from circular buffer
+     *
+     * Call after the circular buffer in nvData has been written by other means.
+     */
+    void  peakRebuild(void);
+    
     /**
      * Rainfall of current calendar day
      */
@@ -187,12 +663,396 @@ public:
     float currentMonth(void);
     
 private:
+    static const bool BUF_SIZE_POW2 = (BufSize & (BufSize - 1)) == 0;
+
+    RainClock clock;
+
+    /**
+     * Increment circular buffer index - i := (i+1) mod BufSize
+     */
+    static index_t inc(index_t i) {
+      return BUF_SIZE_POW2 ? (index_t)((i + 1) & (BufSize - 1)) : (index_t)((i == BufSize - 1) ? 0 : i + 1);
+    };
+
+    /**
+     * Decrement circular buffer index - i := (i-1) mod BufSize
+     */
+    static index_t dec(index_t i) {
+      return (index_t)((i == 0) ? BufSize - 1 : i - 1);
+    };
+
     /**
-     * Calculate seconds since midnight from given time and date
+     * Number of increments from circular buffer index a to b
+     */
+    static unsigned dist(index_t a, index_t b) {
+      return (b >= a) ? (unsigned)(b - a) : (unsigned)(b + BufSize - a);
+    };
+
+    /**
+     * Rain rate [mm/h] during sample interval ending at circular buffer index i
+     */
+    float intervalRate(index_t i);
+
+    /**
+     * Remove deque entries whose sample interval is no longer in (tail, head)
+     */
+    void  peakEvict(void);
+
+    /**
+     * Append sample interval ending at circular buffer index i (before head) to deque
+     */
+    void  peakPush(index_t i);
+
+    bool  coalesce; // see setCoalescing()
+
+    /**
+     * Seconds elapsed from time stamp tsFrom to ts (both seconds since local midnight)
+     */
+    static uint32_t elapsed(uint32_t tsFrom, uint32_t ts) {
+      // if timestamp smaller than previous timestamp, add one day
+      return (ts < tsFrom) ? ts + CIVIL_SECONDS_PER_DAY - tsFrom : ts - tsFrom;
+    };
+
+    /**
+     * Add entry to circular buffer
      *
-     * \param t date and time (struct tm)
-     * 
-     * \returns Seconds since midnight
+     * \param ts   seconds since local midnight
+     *
+     * \param rain rain gauge value (fixed-point)
+     *
+     * \param peak update peak rain rate deque
      */
-    uint32_t timeStamp(tm t);
+    void  append(uint32_t ts, uint16_t rain, bool peak);
+
+    /**
+     * Remove stale entries from circular buffer and add entry at time stamp ts
+     *
+     * \param ts    seconds since local midnight
+     *
+     * \param first no saved data available yet (initializes tail)
+     *
+     * \param peak  update peak rain rate deque; otherwise the caller has to call peakRebuild()
+     */
+    void  store(uint32_t ts, bool first, bool peak);
+
+    /**
+     * Update rain gauge statistics at given local calendar position
+     */
+    void  updateLocal(const rainTime_t &t, float rain, bool startup, float raingaugeMax);
 };
+
+/**
+ * \typedef RainGauge
+ *
+ * \brief Rainfall of past 60 minutes with RAINGAUGE_BUF_SIZE entries at 0.1 mm resolution
+ */
+typedef RainGaugeT<RAINGAUGE_WINDOW, RAINGAUGE_BUF_SIZE, RAINGAUGE_SCALE> RainGauge;
+
+/**
+ * \verbatim
+ * Total rainfall in the past hour
+ * -------------------------------
+ * To determine the rainfall in the past hour, timestamps (ts) and rain gauge values (rain) 
+ * are stored in a circular buffer:
+ *
+ *      ---------------     -----------
+ * .-> |   |   |   |   |...|   |   |   |--. 
+ * |    ---------------     -----------   |
+ * |     ^                   ^            |
+ * |    tail                head          |
+ * `--------------------------------------'
+ *
+ * 
+ * - Add new value: 
+ *   increment(head); 
+ *   rainBuf[head] = rainNow; 
+ *   tsBuf[head]   = tsNow;
+ * 
+ * - Remove stale entries: 
+ *   if ((tsBuf[head]-tsBuf[tail]) > WindowSeconds) {
+ *     increment(tail);
+ *   }
+ * 
+ * - Calculate hourly rate:
+ *   rainHour = rainBuf[head] - rainBuf[tail];
+ * 
+ * - Peak rain rate:
+ *   The rates of the sample intervals (prev(i), i] for i in (tail, head] are kept
+ *   in a monotonic deque (decreasing rate, ascending index); its front is the maximum.
+ *   New intervals are appended after removing all entries with a lower or equal rate,
+ *   entries leaving the window are removed from the front. If the head entry is
+ *   overwritten, the deque is rebuilt from the circular buffer.
+ * 
+ * Notes:
+ * - increment(i) := "i = (i+1) mod BufSize"
+ * - If a new value is added when the buffer is already filled
+ *   (which would result in increment(head) == tail), head is
+ *   NOT incremented and the previous value is overwritten instead.
+ * - Rain values are stored as uint16_t encoded as fixed-point data (Scale, default: one decimal)
+ *   to reduce memory consumption.
+ * - Timestamps are stored as seconds since midnight; the discontinuity between days
+ *   is handled when stale entries are removed. 
+ * \endverbatim
+ */
+
+#ifdef _DEBUG_CIRCULAR_BUFFER_
+#include <stdio.h>
+
+template <unsigned WindowSeconds, unsigned BufSize, unsigned Scale>
+void
+RainGaugeT<WindowSeconds, BufSize, Scale>::printCircularBuffer(void)
+{
+    for (unsigned i=0; i<BufSize; i++)
+        printf("[%3d ]\t", i);
+    printf("\n");
+    for (unsigned i=0; i<BufSize; i++)
+        printf("%6u\t", (unsigned)nvData->ts(i));
+    printf("\n");
+    for (unsigned i=0; i<BufSize; i++)
+        printf("%6.1f\t", (1.0 / Scale) * nvData->rainBuf[i]);
+    printf("\n");
+    for (unsigned i=0; i<BufSize; i++)
+        printf("%3s\t", (i == nvData->tail) ? "T" : "");
+    printf("\n");
+    for (unsigned i=0; i<BufSize; i++)
+        printf("%3s\t", (i == nvData->head) ? "H" : "");
+    printf("\n\n");
+}
+#endif
+
+
+template <unsigned WindowSeconds, unsigned BufSize, unsigned Scale>
+void
+RainGaugeT<WindowSeconds, BufSize, Scale>::reset(uint8_t flags)
+{
+    if (flags & RESET_RAIN_H) {
+        nvData->head           = 0;
+        nvData->tail           = 0;
+        for (unsigned i=0; i < BufSize; i++) {
+           nvData->tsBuf[i]   = 0;
+           nvData->rainBuf[i] = 0;
+        }
+        for (unsigned i=0; i < (BufSize + 7) / 8; i++) {
+           nvData->tsHigh[i]  = 0;
+        }
+        nvData->peakFirst      = 0;
+        nvData->peakCount      = 0;
+        nvData->tsPrev         = 0;
+    }
+    RainGaugeCore::reset(nvData, flags, rainCurr);
+}
+
+template <unsigned WindowSeconds, unsigned BufSize, unsigned Scale>
+void
+RainGaugeT<WindowSeconds, BufSize, Scale>::init(tm t, float rain)
+{
+    // Seconds since midnight
+    rainTime_t rt;
+    RainClock::fromTm(t, rt);
+    uint32_t ts = rt.ts;
+    
+    // Init circular buffer with current timestamp (seconds since midnight) and rain gauge data
+    for (unsigned i=0; i<BufSize; i++) {
+        nvData->setTs(i, ts);
+        nvData->rainBuf[i] = RainGaugeCore::rainFixed(rain, Scale);
+    }
+    nvData->head = 0;
+    nvData->tail = 0;
+    nvData->peakFirst = 0;
+    nvData->peakCount = 0;
+    nvData->tsPrev = ts;
+    nvData->tsDayBegin = rt.wday;
+}
+
+template <unsigned WindowSeconds, unsigned BufSize, unsigned Scale>
+float
+RainGaugeT<WindowSeconds, BufSize, Scale>::intervalRate(index_t i)
+{
+    index_t  prev = dec(i);
+    uint32_t dt   = elapsed(nvData->ts(prev), nvData->ts(i));
+
+    if (dt == 0) {
+        return 0;
+    }
+    return (float)((1.0 / Scale) * RainGaugeCore::rainDelta(nvData->rainBuf[i], nvData->rainBuf[prev]) *
+                   CIVIL_SECONDS_PER_HOUR / dt);
+}
+
+template <unsigned WindowSeconds, unsigned BufSize, unsigned Scale>
+void
+RainGaugeT<WindowSeconds, BufSize, Scale>::peakEvict(void)
+{
+    unsigned window = dist(nvData->tail, nvData->head);
+
+    while (nvData->peakCount > 0) {
+        unsigned d = dist(nvData->tail, nvData->peakIdx[nvData->peakFirst]);
+        if ((d > 0) && (d < window))
+            break;
+        nvData->peakFirst = inc(nvData->peakFirst);
+        nvData->peakCount--;
+    }
+}
+
+template <unsigned WindowSeconds, unsigned BufSize, unsigned Scale>
+void
+RainGaugeT<WindowSeconds, BufSize, Scale>::peakPush(index_t i)
+{
+    float rate = intervalRate(i);
+
+    // Remove entries which can never become the maximum again
+    while ((nvData->peakCount > 0) &&
+           (intervalRate(nvData->peakIdx[(nvData->peakFirst + nvData->peakCount - 1) % BufSize]) <= rate)) {
+        nvData->peakCount--;
+    }
+    index_t back = (index_t)((nvData->peakFirst + nvData->peakCount) % BufSize);
+    nvData->peakIdx[back] = i;
+    nvData->peakCount++;
+}
+
+template <unsigned WindowSeconds, unsigned BufSize, unsigned Scale>
+void
+RainGaugeT<WindowSeconds, BufSize, Scale>::peakRebuild(void)
+{
+    nvData->peakFirst = 0;
+    nvData->peakCount = 0;
+    if (nvData->tail == nvData->head)
+        return;
+    for (index_t i = inc(nvData->tail); i != nvData->head; i = inc(i)) {
+        peakPush(i);
+    }
+}
+
+template <unsigned WindowSeconds, unsigned BufSize, unsigned Scale>
+void
+RainGaugeT<WindowSeconds, BufSize, Scale>::append(uint32_t ts, uint16_t rain, bool peak)
+{
+    index_t  head_tmp; // circular buffer; temporary head index
+
+    head_tmp = inc(nvData->head);
+    // Prevent head from reaching tail if update rate is too fast
+    bool overwrite = (head_tmp == nvData->tail);
+    // The interval ending at head is complete when head moves on; if head is
+    // overwritten, only the interval ending at head changes (not in the deque)
+    if (peak && !overwrite && (nvData->head != nvData->tail)) {
+        peakPush(nvData->head);
+    }
+    nvData->head = overwrite ? nvData->head : head_tmp;
+    nvData->setTs(nvData->head, ts);
+    nvData->rainBuf[nvData->head] = rain;
+}
+
+template <unsigned WindowSeconds, unsigned BufSize, unsigned Scale>
+void
+RainGaugeT<WindowSeconds, BufSize, Scale>::store(uint32_t ts, bool first, bool peak)
+{
+    uint16_t rain = RainGaugeCore::rainFixed(rainCurr, Scale);
+
+    // Check if no saved data is available yet
+    if (first) {
+        // Init tail of circular buffer
+        nvData->setTs(nvData->tail, ts);
+        nvData->rainBuf[nvData->tail] = rain;
+    }
+
+    // Remove stale entries
+    while (!(nvData->tail == nvData->head)) {
+        if (elapsed(nvData->ts(nvData->tail), ts) <= WindowSeconds)
+            break;
+        nvData->tail = inc(nvData->tail);
+    }
+    if (peak) {
+        peakEvict();
+    }
+
+    //printCircularBuffer();
+    if (!first && (rain == nvData->rainBuf[nvData->head])) {
+        // Unchanged value - the head entry stands for this reading as long as it is in the window
+        if (coalesce && (elapsed(nvData->ts(nvData->head), ts) <= WindowSeconds)) {
+            nvData->tsPrev = ts;
+            return;
+        }
+    } else if (!first && (nvData->tsPrev != nvData->ts(nvData->head))) {
+        // Value changed after coalesced readings - store the last unchanged reading,
+        // which may become the first entry within the window (never the case without coalescing)
+        append(nvData->tsPrev, nvData->rainBuf[nvData->head], peak);
+    }
+
+    // Add new value
+    append(ts, rain, peak);
+    nvData->tsPrev = ts;
+}
+
+template <unsigned WindowSeconds, unsigned BufSize, unsigned Scale>
+void
+RainGaugeT<WindowSeconds, BufSize, Scale>::updateLocal(const rainTime_t &t, float rain, bool startup, float raingaugeMax)
+{
+    rainCurr = RainGaugeCore::accumulate(nvData, rain, startup, raingaugeMax);
+
+    store(t.ts, nvData->wdayPrev == 0xFF, true);
+            
+    RainGaugeCore::calendar(nvData, t, rainCurr);
+}
+
+template <unsigned WindowSeconds, unsigned BufSize, unsigned Scale>
+void
+RainGaugeT<WindowSeconds, BufSize, Scale>::backfill(size_t n, const rainSample_t *samples, float raingaugeMax)
+{
+    rainTime_t t;
+    int32_t    day = 0;
+
+    for (size_t i = 0; i < n; i++) {
+        clock.fromEpoch(samples[i].epoch, t);
+        rainCurr = RainGaugeCore::accumulate(nvData, samples[i].rain, samples[i].startup, raingaugeMax);
+        store(t.ts, nvData->wdayPrev == 0xFF, false);
+
+        // Calendar fields only change with the local day
+        if ((i == 0) || (t.day != day)) {
+            RainGaugeCore::calendar(nvData, t, rainCurr);
+            day = t.day;
+        }
+    }
+    if (n > 0) {
+        peakRebuild();
+    }
+}
+
+template <unsigned WindowSeconds, unsigned BufSize, unsigned Scale>
+void
+RainGaugeT<WindowSeconds, BufSize, Scale>::rebuildBuffer(size_t n, const rainTime_t *t, const float *values)
+{
+    bool first = (nvData->wdayPrev == 0xFF);
+
+    for (size_t i = 0; i < n; i++) {
+        rainCurr = values[i];
+        store(t[i].ts, first && (i == 0), false);
+    }
+    peakRebuild();
+}
+
+template <unsigned WindowSeconds, unsigned BufSize, unsigned Scale>
+float
+RainGaugeT<WindowSeconds, BufSize, Scale>::pastHour(void)
+{
+    return (float)((1.0 / Scale) * RainGaugeCore::rainDelta(nvData->rainBuf[nvData->head], nvData->rainBuf[nvData->tail]));
+}
+
+template <unsigned WindowSeconds, unsigned BufSize, unsigned Scale>
+float
+RainGaugeT<WindowSeconds, BufSize, Scale>::currentDay(void)
+{
+    return rainCurr - nvData->rainDayBegin;
+}
+
+template <unsigned WindowSeconds, unsigned BufSize, unsigned Scale>
+float
+RainGaugeT<WindowSeconds, BufSize, Scale>::currentWeek(void)
+{
+    return rainCurr - nvData->rainWeekBegin;
+}
+
+template <unsigned WindowSeconds, unsigned BufSize, unsigned Scale>
+float
+RainGaugeT<WindowSeconds, BufSize, Scale>::currentMonth(void)
+{
+    return rainCurr - nvData->rainMonthBegin;
+}
@@ -0,0 +1,285 @@
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// RainGaugeBuckets.h
+//
+// Calculation of rolling window (e.g. past 60 minutes), daily, weekly and monthly rainfall
+// from raw rain gauge data - time-bucketed engine.
+//
+// Rain is accumulated per fixed time slot, so update() and pastHour() take constant time
+// and memory is fixed regardless of reporting rate and burstiness.
+//
+// https://github.com/matthias-bs/BresserWeatherSensorReceiver
+//
+//
+// created: 10/2026
+//
+//
+// MIT License
+//
+// Copyright (c) 2026 Matthias Prinke
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+// History:
+//
+// 20261016 Created
+// 20261017 Time slots from continuous local time (DST changes)
+//
+// ToDo:
+// -
+//
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include "RainGauge.h"
+
+/**
+ * \struct nvBucketDataT
+ *
+ * \brief Data structure for rain statistics to be stored in non-volatile memory
+ *
+ * \tparam Slots number of time slots in rolling window
+ */
+template <unsigned Slots>
+struct nvBucketDataT {
+    /* rainfall during past window - rain per time slot */
+    uint16_t  rainSlot[Slots]; // rain in time slot (fixed-point)
+    uint32_t  slotCurr; // time slot of most recent update (slots since epoch, continuous local time; 0: none)
+    uint32_t  rainSum; // sum of rainSlot[] (fixed-point)
+    uint32_t  rainFixed; // accumulated rain gauge value at most recent update (fixed-point)
+
+    /* Sensor startup handling */
+    bool      startupPrev; // previous state of startup
+    float     rainStartup; // rain gauge before startup 
+
+    /* Rainfall of current day (can start anytime, but will reset on begin of new day) */
+    uint8_t   tsDayBegin; // day of week
+    float     rainDayBegin; // rain gauge @ begin of day
+
+    /* Rainfall of current week (can start anytime, but will reset on Monday */
+    uint8_t   tsWeekBegin; // day of week 
+    float     rainWeekBegin; // rain gauge @ begin of week
+    uint8_t   wdayPrev; // day of week at previous run - to detect new week
+
+    /* Rainfall of current calendar month (can start anytime, but will reset at begin of month */
+    uint8_t   tsMonthBegin; // month
+    float     rainMonthBegin; // rain gauge @ begin of month
+
+    float     rainPrev;  // rain gauge at previous run - to detect overflow
+    uint16_t  rainOvf; // number of rain gauge overflows
+};
+
+/**
+ * \class RainGaugeBucketT
+ *
+ * \brief Calculation of rolling window, daily, weekly and monthly rainfall with time slots
+ *
+ * \verbatim
+ * The rolling window is divided into Slots time slots of SlotSeconds each, indexed by
+ * time stamp ("slot number" = local time / SlotSeconds):
+ *
+ *      -------------------------------
+ *     |   |   |   |   |...|   |   |   |  rainSlot[slot mod Slots]
+ *      -------------------------------
+ *                       ^
+ *                    slotCurr
+ *
+ * - Add new value:
+ *   clear all slots between slotCurr and slotNow (at most Slots);
+ *   rainSlot[slotNow] += rainNow - rainPrev;
+ *
+ * - Calculate rolling window:
+ *   rainWindow = sum(rainSlot[]) (maintained incrementally as rainSum)
+ *
+ * Notes:
+ * - The window covers the current (partial) slot and the preceding Slots-1 slots,
+ *   i.e. between (Slots-1) * SlotSeconds and WindowSeconds.
+ * - Rain values are stored as uint16_t encoded as fixed-point data (Scale).
+ * - Time stamps are continuous local time (rainTime_t::mono), i.e. the window is
+ *   continuous across midnight and daylight saving time changes.
+ * \endverbatim
+ *
+ * \tparam WindowSeconds length of rolling window in seconds
+ * \tparam Slots         number of time slots; WindowSeconds must be a multiple of Slots
+ * \tparam Scale         fixed-point scale of rain values (10: 0.1 mm)
+ */
+template <unsigned WindowSeconds, unsigned Slots, unsigned Scale>
+class RainGaugeBucketT {
+public:
+    static_assert(Slots >= 1 && WindowSeconds % Slots == 0, "Window must be a multiple of the time slot length");
+    static_assert(Scale >= 1, "Invalid fixed-point scale");
+
+    static const uint32_t SlotSeconds = WindowSeconds / Slots;
+
+    float rainCurr;
+    nvBucketDataT<Slots> *nvData;
+
+    RainGaugeBucketT(nvBucketDataT<Slots> *data) {
+      nvData = data;
+    };
+
+    /**
+     * Reset non-volatile data and current rain counter value
+     */
+    void  reset(uint8_t flags=0xF) {
+      if (flags & RESET_RAIN_H) {
+          for (unsigned i=0; i < Slots; i++) {
+              nvData->rainSlot[i] = 0;
+          }
+          nvData->rainSum   = 0;
+          nvData->slotCurr  = 0;
+          nvData->rainFixed = 0;
+      }
+      RainGaugeCore::reset(nvData, flags, rainCurr);
+    };
+
+    /**
+     * \fn update
+     * 
+     * \brief Update rain gauge statistics
+     * 
+     * \param timeinfo     date and time (struct tm)
+     * 
+     * \param rain         rain gauge raw value
+     * 
+     * \param startup      sensor startup flag
+     * 
+     * \param rainGaugeMax overflow value; when reached, the rain gauge is reset to zero
+     */  
+    void  update(tm timeinfo, float rain, bool startup = false, float raingaugeMax = RAINGAUGE_MAX_VALUE) {
+      rainTime_t rt;
+
+      RainClock::fromTm(timeinfo, rt);
+      updateLocal(rt, rain, startup, raingaugeMax);
+    };
+
+    /**
+     * \fn update
+     * 
+     * \brief Update rain gauge statistics
+     * 
+     * \param epoch        seconds since epoch (UTC)
+     * 
+     * \param rain         rain gauge raw value
+     * 
+     * \param startup      sensor startup flag
+     * 
+     * \param rainGaugeMax overflow value; when reached, the rain gauge is reset to zero
+     */  
+    void  update(time_t epoch, float rain, bool startup = false, float raingaugeMax = RAINGAUGE_MAX_VALUE) {
+      rainTime_t rt;
+
+      clock.fromEpoch(epoch, rt);
+      updateLocal(rt, rain, startup, raingaugeMax);
+    };
+
+    /**
+     * Bind rain gauge to timezone used by update(time_t)
+     *
+     * \param tz timezone table (must outlive the rain gauge) or NULL for libc local time
+     */
+    void  setTimeZone(const TimeZone *tz) {
+      clock.setTimeZone(tz);
+    };
+
+    /**
+     * Rainfall during past window (WindowSeconds)
+     */
+    float pastHour(void) {
+      return (float)((1.0 / Scale) * nvData->rainSum);
+    };
+
+    /**
+     * Rainfall of current calendar day
+     */
+    float currentDay(void) {
+      return rainCurr - nvData->rainDayBegin;
+    };
+
+    /**
+     * Rainfall of current calendar week
+     */
+    float currentWeek(void) {
+      return rainCurr - nvData->rainWeekBegin;
+    };
+
+    /**
+     * Rainfall of current calendar month
+     */
+    float currentMonth(void) {
+      return rainCurr - nvData->rainMonthBegin;
+    };
+
+private:
+    RainClock clock;
+
+    /**
+     * Update rain gauge statistics at given local calendar position
+     */
+    void  updateLocal(const rainTime_t &t, float rain, bool startup, float raingaugeMax);
+};
+
+template <unsigned WindowSeconds, unsigned Slots, unsigned Scale>
+void
+RainGaugeBucketT<WindowSeconds, Slots, Scale>::updateLocal(const rainTime_t &t, float rain, bool startup, float raingaugeMax)
+{
+    // Time slot of current update
+    uint32_t slot = (uint32_t)(t.mono / SlotSeconds);
+
+    rainCurr = RainGaugeCore::accumulate(nvData, rain, startup, raingaugeMax);
+
+    uint32_t rainFixed = (uint32_t)(rainCurr * Scale);
+
+    // Check if no saved data is available yet
+    if (nvData->slotCurr == 0) {
+        nvData->slotCurr  = slot;
+        nvData->rainFixed = rainFixed;
+    }
+
+    // Clear slots which have left the window - at most Slots
+    if (slot > nvData->slotCurr) {
+        uint32_t n = slot - nvData->slotCurr;
+        if (n >= Slots) {
+            for (unsigned i=0; i < Slots; i++) {
+                nvData->rainSlot[i] = 0;
+            }
+            nvData->rainSum = 0;
+        } else {
+            for (uint32_t s = nvData->slotCurr + 1; s <= slot; s++) {
+                nvData->rainSum -= nvData->rainSlot[s % Slots];
+                nvData->rainSlot[s % Slots] = 0;
+            }
+        }
+        nvData->slotCurr = slot;
+    }
+
+    // Add rain since previous update to its time slot;
+    // late readings older than the window only update the accumulated value
+    if ((rainFixed > nvData->rainFixed) && (slot + Slots > nvData->slotCurr)) {
+        uint32_t delta = rainFixed - nvData->rainFixed;
+        uint32_t room  = 0xFFFF - nvData->rainSlot[slot % Slots];
+        if (delta > room)
+            delta = room;
+        nvData->rainSlot[slot % Slots] += (uint16_t)delta;
+        nvData->rainSum += delta;
+    }
+    nvData->rainFixed = rainFixed;
+
+    RainGaugeCore::calendar(nvData, t, rainCurr);
+}
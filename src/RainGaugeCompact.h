@@ -0,0 +1,322 @@
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// RainGaugeCompact.h
+//
+// Calculation of rolling window (e.g. past 60 minutes), daily, weekly and monthly rainfall
+// from raw rain gauge data - compact circular buffer.
+//
+// The circular buffer stores minute-of-day time stamps and rain deltas (uint16_t each)
+// instead of absolute values, so the rolling window does not wrap around and
+// non-volatile memory consumption is reduced.
+// This is a separate engine with its own non-volatile data (nvCompactDataT);
+// RainGauge and nvData_t are unchanged.
+//
+// https://github.com/matthias-bs/BresserWeatherSensorReceiver
+//
+//
+// created: 10/2026
+//
+//
+// MIT License
+//
+// Copyright (c) 2026 Matthias Prinke
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+// History:
+//
+// 20261016 Created
+// 20261017 Minute of day is always within [0..1439]
+//
+// ToDo:
+// -
+//
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include "RainGauge.h"
+
+/**
+ * \struct nvCompactDataT
+ *
+ * \brief Data structure for rain statistics to be stored in non-volatile memory
+ *
+ * \tparam BufSize size of circular buffer for rainfall during past window
+ */
+template <unsigned BufSize>
+struct nvCompactDataT {
+    /* rainfall during past window - circular buffer */
+    uint16_t  tsBuf[BufSize]; // minute of day [0..1439]
+    uint16_t  rainDelta[BufSize]; // rain since previous entry (fixed-point)
+    uint32_t  rainHead; // accumulated rain gauge value at head (fixed-point)
+    uint32_t  rainWindow; // sum of rainDelta[] in (tail, head] (fixed-point)
+    typename rainIndex<BufSize>::type head;
+    typename rainIndex<BufSize>::type tail;
+
+    /* Sensor startup handling */
+    bool      startupPrev; // previous state of startup
+    float     rainStartup; // rain gauge before startup 
+
+    /* Rainfall of current day (can start anytime, but will reset on begin of new day) */
+    uint8_t   tsDayBegin; // day of week
+    float     rainDayBegin; // rain gauge @ begin of day
+
+    /* Rainfall of current week (can start anytime, but will reset on Monday */
+    uint8_t   tsWeekBegin; // day of week 
+    float     rainWeekBegin; // rain gauge @ begin of week
+    uint8_t   wdayPrev; // day of week at previous run - to detect new week
+
+    /* Rainfall of current calendar month (can start anytime, but will reset at begin of month */
+    uint8_t   tsMonthBegin; // month
+    float     rainMonthBegin; // rain gauge @ begin of month
+
+    float     rainPrev;  // rain gauge at previous run - to detect overflow
+    uint16_t  rainOvf; // number of rain gauge overflows
+};
+
+/**
+ * \class RainGaugeCompactT
+ *
+ * \brief Calculation of rolling window, daily, weekly and monthly rainfall with a compact circular buffer
+ *
+ * \verbatim
+ * Same circular buffer as RainGaugeT, but each entry holds the rain since the
+ * previous entry instead of the accumulated rain gauge value:
+ *
+ *      ---------------     -----------
+ * .-> |   |   |   |   |...|   |   |   |--. 
+ * |    ---------------     -----------   |
+ * |     ^                   ^            |
+ * |    tail                head          |
+ * `--------------------------------------'
+ *
+ * - Add new value: 
+ *   increment(head); 
+ *   rainDelta[head] = rainNow - rainHead; rainHead = rainNow;
+ *   rainWindow += rainDelta[head];
+ * 
+ * - Remove stale entries: 
+ *   if ((tsBuf[head]-tsBuf[tail]) > WindowSeconds / 60) {
+ *     increment(tail);
+ *     rainWindow -= rainDelta[tail];
+ *   }
+ * 
+ * - Calculate rolling window:
+ *   rainHour = rainWindow;
+ * 
+ * Notes:
+ * - Time stamps are minutes since midnight (update() discards seconds anyway);
+ *   the discontinuity between days is handled when stale entries are removed.
+ * - Only the rain deltas are limited to uint16_t (fixed-point, Scale); the window sum
+ *   and the accumulated value are uint32_t, so the rolling window does not wrap
+ *   around after 65535 / Scale mm.
+ * \endverbatim
+ *
+ * \tparam WindowSeconds length of rolling window in seconds (full minutes, less than one day)
+ * \tparam BufSize       size of circular buffer; (WindowSeconds / update_rate [sec]) + 2
+ * \tparam Scale         fixed-point scale of rain values (10: 0.1 mm)
+ */
+template <unsigned WindowSeconds, unsigned BufSize, unsigned Scale>
+class RainGaugeCompactT {
+public:
+    static_assert(WindowSeconds > 0 && WindowSeconds < CIVIL_SECONDS_PER_DAY,
+                  "Window must be shorter than one day (time stamps are minutes since midnight)");
+    static_assert(WindowSeconds % CIVIL_SECONDS_PER_MINUTE == 0, "Window must be a multiple of one minute");
+    static_assert(BufSize >= 2 && BufSize <= 65535, "Invalid circular buffer size");
+    static_assert(Scale >= 1, "Invalid fixed-point scale");
+
+    typedef typename rainIndex<BufSize>::type index_t;
+
+    float rainCurr;
+    nvCompactDataT<BufSize> *nvData;
+
+    RainGaugeCompactT(nvCompactDataT<BufSize> *data) {
+      nvData = data;
+    };
+
+    /**
+     * Reset non-volatile data and current rain counter value
+     */
+    void  reset(uint8_t flags=0xF) {
+      if (flags & RESET_RAIN_H) {
+          nvData->head       = 0;
+          nvData->tail       = 0;
+          for (unsigned i=0; i < BufSize; i++) {
+              nvData->tsBuf[i]     = 0;
+              nvData->rainDelta[i] = 0;
+          }
+          nvData->rainHead   = 0;
+          nvData->rainWindow = 0;
+      }
+      RainGaugeCore::reset(nvData, flags, rainCurr);
+    };
+
+    /**
+     * \fn update
+     * 
+     * \brief Update rain gauge statistics
+     * 
+     * \param timeinfo     date and time (struct tm)
+     * 
+     * \param rain         rain gauge raw value
+     * 
+     * \param startup      sensor startup flag
+     * 
+     * \param rainGaugeMax overflow value; when reached, the rain gauge is reset to zero
+     */  
+    void  update(tm timeinfo, float rain, bool startup = false, float raingaugeMax = RAINGAUGE_MAX_VALUE) {
+      rainTime_t rt;
+
+      RainClock::fromTm(timeinfo, rt);
+      updateLocal(rt, rain, startup, raingaugeMax);
+    };
+
+    /**
+     * \fn update
+     * 
+     * \brief Update rain gauge statistics
+     * 
+     * \param epoch        seconds since epoch (UTC)
+     * 
+     * \param rain         rain gauge raw value
+     * 
+     * \param startup      sensor startup flag
+     * 
+     * \param rainGaugeMax overflow value; when reached, the rain gauge is reset to zero
+     */  
+    void  update(time_t epoch, float rain, bool startup = false, float raingaugeMax = RAINGAUGE_MAX_VALUE) {
+      rainTime_t rt;
+
+      clock.fromEpoch(epoch, rt);
+      updateLocal(rt, rain, startup, raingaugeMax);
+    };
+
+    /**
+     * Bind rain gauge to timezone used by update(time_t)
+     *
+     * \param tz timezone table (must outlive the rain gauge) or NULL for libc local time
+     */
+    void  setTimeZone(const TimeZone *tz) {
+      clock.setTimeZone(tz);
+    };
+
+    /**
+     * Rainfall during past window (WindowSeconds)
+     */
+    float pastHour(void) {
+      return (float)((1.0 / Scale) * nvData->rainWindow);
+    };
+
+    /**
+     * Rainfall of current calendar day
+     */
+    float currentDay(void) {
+      return rainCurr - nvData->rainDayBegin;
+    };
+
+    /**
+     * Rainfall of current calendar week
+     */
+    float currentWeek(void) {
+      return rainCurr - nvData->rainWeekBegin;
+    };
+
+    /**
+     * Rainfall of current calendar month
+     */
+    float currentMonth(void) {
+      return rainCurr - nvData->rainMonthBegin;
+    };
+
+private:
+    static const bool     BUF_SIZE_POW2 = (BufSize & (BufSize - 1)) == 0;
+    static const uint16_t WINDOW_MINUTES = WindowSeconds / CIVIL_SECONDS_PER_MINUTE;
+    static const uint16_t MINUTES_PER_DAY = CIVIL_SECONDS_PER_DAY / CIVIL_SECONDS_PER_MINUTE;
+
+    RainClock clock;
+
+    /**
+     * Increment circular buffer index - i := (i+1) mod BufSize
+     */
+    static index_t inc(index_t i) {
+      return BUF_SIZE_POW2 ? (index_t)((i + 1) & (BufSize - 1)) : (index_t)((i == BufSize - 1) ? 0 : i + 1);
+    };
+
+    /**
+     * Update rain gauge statistics at given local calendar position
+     */
+    void  updateLocal(const rainTime_t &t, float rain, bool startup, float raingaugeMax);
+};
+
+template <unsigned WindowSeconds, unsigned BufSize, unsigned Scale>
+void
+RainGaugeCompactT<WindowSeconds, BufSize, Scale>::updateLocal(const rainTime_t &t, float rain, bool startup, float raingaugeMax)
+{
+    index_t  head_tmp; // circular buffer; temporary head index
+
+    // Minutes since Midnight
+    uint16_t ts = (uint16_t)((t.ts % CIVIL_SECONDS_PER_DAY) / CIVIL_SECONDS_PER_MINUTE);
+
+    rainCurr = RainGaugeCore::accumulate(nvData, rain, startup, raingaugeMax);
+
+    uint32_t rainFixed = (uint32_t)(rainCurr * Scale);
+
+    // Check if no saved data is available yet
+    if (nvData->wdayPrev == 0xFF) {
+        // Init tail of circular buffer
+        nvData->tsBuf[nvData->tail]     = ts;
+        nvData->rainDelta[nvData->tail] = 0;
+        nvData->rainHead                = rainFixed;
+    }
+
+    // Remove stale entries
+    uint16_t ts_cmp;
+    while (!(nvData->tail == nvData->head)) {
+        ts_cmp = ts;
+        // if current timestamp smaller than saved timestamp, add one day
+        if (ts_cmp < nvData->tsBuf[nvData->tail]) {
+            ts_cmp = ts_cmp + MINUTES_PER_DAY;
+        }
+        if ((uint16_t)(ts_cmp - nvData->tsBuf[nvData->tail]) <= WINDOW_MINUTES)
+            break;
+        nvData->tail = inc(nvData->tail);
+        nvData->rainWindow -= nvData->rainDelta[nvData->tail];
+    }
+
+    // Rain since previous update; a decreasing value (reset) does not count
+    uint32_t delta = (rainFixed > nvData->rainHead) ? rainFixed - nvData->rainHead : 0;
+    nvData->rainHead = rainFixed;
+
+    // Add new value
+    head_tmp = inc(nvData->head);
+    if (head_tmp == nvData->tail) {
+        // Prevent head from reaching tail if update rate is too fast - merge with previous value
+        delta += nvData->rainDelta[nvData->head];
+        nvData->rainWindow -= nvData->rainDelta[nvData->head];
+    } else {
+        nvData->head = head_tmp;
+    }
+    if (delta > 0xFFFF)
+        delta = 0xFFFF;
+    nvData->tsBuf[nvData->head]     = ts;
+    nvData->rainDelta[nvData->head] = (uint16_t)delta;
+    nvData->rainWindow += delta;
+
+    RainGaugeCore::calendar(nvData, t, rainCurr);
+}
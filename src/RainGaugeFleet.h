@@ -0,0 +1,704 @@
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// RainGaugeFleet.h
+//
+// Rain statistics of many rain gauges (e.g. on a gateway or server) in a
+// structure-of-arrays store with batch update.
+//
+// The state of each gauge is the same as in nvDataT, but each field is kept in its
+// own array, so processing a batch of readings touches only the fields required.
+//
+// https://github.com/matthias-bs/BresserWeatherSensorReceiver
+//
+//
+// created: 10/2026
+//
+//
+// MIT License
+//
+// Copyright (c) 2026 Matthias Prinke
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+// History:
+//
+// 20261016 Created
+// 20261016 Added updateAll() with SIMD batch kernels
+// 20261016 Added update() with array of RainReading
+// 20261016 Added snapshot() for readers in other threads
+// 20261016 Added dirty bitmap for incremental checkpoints
+// 20261016 Added observers
+// 20261016 store() sets nvDataT::tsPrev
+// 20261017 Readings with out-of-range ids are ignored
+// 20261017 Statistics are published once per gauge and batch
+// 20261017 Publishing for snapshot() is enabled with setSnapshots()
+// 20261017 Statistics are only computed with snapshots enabled or observers registered
+// 20261017 Rain values in circular buffers modulo 2^16 (as in nvDataT)
+//
+// ToDo:
+// -
+//
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <stddef.h>
+#include <algorithm>
+#include <vector>
+
+#include "RainGauge.h"
+#include "RainGaugeSimd.h"
+#include "RainGaugeStats.h"
+
+/**
+ * \struct RainReading
+ *
+ * \brief Reading of one rain gauge
+ */
+typedef struct {
+    time_t    epoch;   // seconds since epoch (UTC)
+    uint32_t  id;      // rain gauge id
+    float     value;   // rain gauge raw value
+    bool      startup; // sensor startup flag
+} RainReading;
+
+/**
+ * \class RainGaugeFleetT
+ *
+ * \brief Calculation of rolling window, daily, weekly and monthly rainfall for N rain gauges
+ *
+ * \verbatim
+ * Per gauge state as in nvDataT, stored as structure of arrays:
+ *
+ *   tsBuf   [id * BufSize + i]   circular buffers, one block of BufSize entries per gauge
+ *   rainBuf [id * BufSize + i]
+ *   head[id], tail[id], rainPrev[id], rainOvf[id], ...
+ *
+ * updateBatch() processes the readings in the given order with the algorithm of
+ * RainGaugeT (see there); all gauges share one RainClock, so the local day
+ * boundaries are only computed once for all readings of the same day.
+ *
+ * updateAll() applies one reading per gauge at a common time stamp in three passes:
+ * startup/overflow correction (rainAccumulateBatch(), SIMD), circular buffers
+ * (scalar) and day/week/month rollover (rainCalendarBatch(), SIMD).
+ * \endverbatim
+ *
+ * The peak rain rate (RainGaugeT::pastHourPeakRate()) is not tracked; it is rebuilt
+ * when a gauge is exported with store().
+ *
+ * Statistics for snapshot() (setSnapshots()) and observers (addObserver()) are
+ * published once per changed gauge at the end of each batch; with neither enabled,
+ * the update path only marks changed gauges in the dirty bitmap.
+ *
+ * \tparam WindowSeconds length of rolling window in seconds (less than one day)
+ * \tparam BufSize       size of circular buffer; (WindowSeconds / update_rate [sec]) + 2
+ * \tparam Scale         fixed-point scale of rain values in circular buffer (10: 0.1 mm)
+ */
+template <unsigned WindowSeconds, unsigned BufSize, unsigned Scale>
+class RainGaugeFleetT {
+public:
+    static_assert(WindowSeconds > 0 && WindowSeconds < CIVIL_SECONDS_PER_DAY,
+                  "Window must be shorter than one day (time stamps are seconds since midnight)");
+    static_assert(BufSize >= 2 && BufSize <= 65535, "Invalid circular buffer size");
+    static_assert(Scale >= 1, "Invalid fixed-point scale");
+
+    typedef typename rainIndex<BufSize>::type index_t;
+
+    /**
+     * Constructor
+     *
+     * \param n number of rain gauges (ids 0..n-1); all gauges are reset
+     */
+    RainGaugeFleetT(size_t n) :
+      count(n),
+      tsBuf(n * BufSize), rainBuf(n * BufSize), head(n), tail(n),
+      startupPrev(n), rainStartup(n),
+      tsDayBegin(n), rainDayBegin(n), tsWeekBegin(n), rainWeekBegin(n), wdayPrev(n),
+      tsMonthBegin(n), rainMonthBegin(n), rainPrev(n), rainOvf(n), rainCurr(n), stats(n),
+      dirtyMap((n + 63) / 64), seen(n, 0), generation(1), snapshots(false)
+    {
+      for (size_t id = 0; id < n; id++) {
+          reset((uint32_t)id);
+      }
+    };
+
+    /**
+     * Number of rain gauges
+     */
+    size_t size(void) const {
+      return count;
+    };
+
+    /**
+     * Reset state of rain gauge
+     *
+     * \param id    rain gauge id
+     *
+     * \param flags RESET_RAIN_H/D/W/M
+     */
+    void  reset(uint32_t id, uint8_t flags=0xF) {
+      if (flags & RESET_RAIN_H) {
+          head[id] = 0;
+          tail[id] = 0;
+          for (unsigned i=0; i < BufSize; i++) {
+              tsBuf[id * BufSize + i]   = 0;
+              rainBuf[id * BufSize + i] = 0;
+          }
+      }
+      GaugeRef g = ref(id);
+      RainGaugeCore::reset(&g, flags, rainCurr[id]);
+      markDirty(id);
+      if (publishing())
+          publish(id);
+    };
+
+    /**
+     * Bind all rain gauges to timezone used by updateBatch()
+     *
+     * \param tz timezone table (must outlive the fleet) or NULL for libc local time
+     */
+    void  setTimeZone(const TimeZone *tz) {
+      clock.setTimeZone(tz);
+    };
+
+    /**
+     * \fn updateBatch
+     *
+     * \brief Update rain gauge statistics with a batch of readings
+     *
+     * Readings are applied in array order; readings of the same gauge must be
+     * in chronological order. Readings with id >= size() are ignored.
+     *
+     * \param n            number of readings
+     *
+     * \param ids          rain gauge ids
+     *
+     * \param epochs       seconds since epoch (UTC)
+     *
+     * \param values       rain gauge raw values
+     *
+     * \param startup      sensor startup flags or NULL (no startup)
+     *
+     * \param rainGaugeMax overflow value; when reached, the rain gauge is reset to zero
+     *
+     * \returns number of readings applied
+     */
+    size_t updateBatch(size_t n, const uint32_t *ids, const time_t *epochs, const float *values,
+                       const bool *startup = NULL, float raingaugeMax = RAINGAUGE_MAX_VALUE);
+
+    /**
+     * \fn update
+     *
+     * \brief Update rain gauge statistics with a batch of readings
+     *
+     * Same as updateBatch(), but with one array of readings.
+     *
+     * \param n            number of readings
+     *
+     * \param readings     readings; readings of the same gauge must be in chronological order
+     *
+     * \param rainGaugeMax overflow value; when reached, the rain gauge is reset to zero
+     *
+     * \returns number of readings applied
+     */
+    size_t update(size_t n, const RainReading *readings, float raingaugeMax = RAINGAUGE_MAX_VALUE) {
+      size_t applied = 0;
+      bool   pub     = publishing();
+
+      for (size_t k = 0; k < n; k++) {
+          if (updateOne(readings[k].id, readings[k].epoch, readings[k].value, readings[k].startup, raingaugeMax)) {
+              applied++;
+              if (pub)
+                  touch(readings[k].id);
+          }
+      }
+      if (pub)
+          publishTouched();
+      return applied;
+    };
+
+    /**
+     * \fn updateAll
+     *
+     * \brief Update rain gauge statistics of all gauges at a common time stamp
+     *
+     * Results are identical to updateBatch() with ids 0..size()-1.
+     *
+     * \param epoch        seconds since epoch (UTC)
+     *
+     * \param values       rain gauge raw values, one per gauge
+     *
+     * \param startup      sensor startup flags (one per gauge) or NULL (no startup)
+     *
+     * \param rainGaugeMax overflow value; when reached, the rain gauge is reset to zero
+     */
+    void  updateAll(time_t epoch, const float *values, const bool *startup = NULL,
+                    float raingaugeMax = RAINGAUGE_MAX_VALUE);
+
+    /**
+     * Import state of rain gauge from non-volatile data of a single RainGaugeT
+     *
+     * \param id           rain gauge id
+     *
+     * \param nv           non-volatile data
+     *
+     * \param rainGaugeMax overflow value used with nv
+     */
+    void  load(uint32_t id, const nvDataT<BufSize> &nv, float raingaugeMax = RAINGAUGE_MAX_VALUE);
+
+    /**
+     * Export state of rain gauge to non-volatile data of a single RainGaugeT
+     *
+     * \param id rain gauge id
+     *
+     * \param nv non-volatile data (output)
+     */
+    void  store(uint32_t id, nvDataT<BufSize> &nv) const;
+
+    /**
+     * Rainfall during past window (WindowSeconds)
+     */
+    float pastHour(uint32_t id) const {
+      const uint16_t *buf = &rainBuf[id * BufSize];
+      return (float)((1.0 / Scale) * RainGaugeCore::rainDelta(buf[head[id]], buf[tail[id]]));
+    };
+
+    /**
+     * Rainfall of current calendar day
+     */
+    float currentDay(uint32_t id) const {
+      return rainCurr[id] - rainDayBegin[id];
+    };
+
+    /**
+     * Rainfall of current calendar week
+     */
+    float currentWeek(uint32_t id) const {
+      return rainCurr[id] - rainWeekBegin[id];
+    };
+
+    /**
+     * Rainfall of current calendar month
+     */
+    float currentMonth(uint32_t id) const {
+      return rainCurr[id] - rainMonthBegin[id];
+    };
+
+    /**
+     * Current accumulated rain gauge value (including overflows)
+     */
+    float current(uint32_t id) const {
+      return rainCurr[id];
+    };
+
+    /**
+     * Enable or disable publishing of statistics for snapshot() (disabled by default)
+     *
+     * When enabled, the statistics of all rain gauges are published immediately.
+     * Call before readers in other threads use snapshot().
+     *
+     * \param on true: publish statistics after each change
+     */
+    void  setSnapshots(bool on) {
+      if (on && !snapshots) {
+          for (size_t id = 0; id < count; id++) {
+              stats[id].publish(statsOf((uint32_t)id));
+          }
+      }
+      snapshots = on;
+    };
+
+    /**
+     * Consistent statistics of rain gauge as of the end of its most recent update
+     * (update*() publishes once per changed gauge at the end of the batch)
+     *
+     * Unlike pastHour() etc., this may be called from any thread while another
+     * thread updates the fleet; it never blocks the updating thread.
+     * Requires setSnapshots(true); otherwise the statistics are not updated.
+     *
+     * \param id rain gauge id
+     *
+     * \param s  statistics (output)
+     */
+    void  snapshot(uint32_t id, RainGaugeStats &s) const {
+      stats[id].read(s);
+    };
+
+    /**
+     * Register observer notified after every change of a rain gauge
+     * (after update*() once per changed gauge, with the statistics at the end of the batch)
+     *
+     * \param o observer (must outlive the fleet or be removed)
+     */
+    void  addObserver(RainGaugeObserver *o) {
+      observers.push_back(o);
+    };
+
+    /**
+     * Unregister observer
+     */
+    void  removeObserver(RainGaugeObserver *o) {
+      observers.erase(std::remove(observers.begin(), observers.end(), o), observers.end());
+    };
+
+    /**
+     * Rain gauge has been modified since the last markClean()
+     * (by update*(), reset() or load())
+     */
+    bool  dirty(uint32_t id) const {
+      return (dirtyMap[id >> 6] >> (id & 63)) & 1;
+    };
+
+    /**
+     * Clear modification flags of all rain gauges (e.g. after a checkpoint)
+     */
+    void  markClean(void) {
+      std::fill(dirtyMap.begin(), dirtyMap.end(), 0);
+    };
+
+private:
+    static const bool BUF_SIZE_POW2 = (BufSize & (BufSize - 1)) == 0;
+
+    /*
+     * References to the scalar state of one gauge - allows using RainGaugeCore
+     */
+    struct GaugeRef {
+      uint8_t  &startupPrev;
+      float    &rainStartup;
+      uint8_t  &tsDayBegin;
+      float    &rainDayBegin;
+      uint8_t  &tsWeekBegin;
+      float    &rainWeekBegin;
+      uint8_t  &wdayPrev;
+      uint8_t  &tsMonthBegin;
+      float    &rainMonthBegin;
+      float    &rainPrev;
+      uint16_t &rainOvf;
+    };
+
+    size_t    count;
+    RainClock clock;
+
+    /* rainfall during past window - circular buffers */
+    std::vector<uint32_t> tsBuf;
+    std::vector<uint16_t> rainBuf;
+    std::vector<index_t>  head;
+    std::vector<index_t>  tail;
+
+    /* Sensor startup handling */
+    std::vector<uint8_t>  startupPrev;
+    std::vector<float>    rainStartup;
+
+    /* Rainfall of current day, week and month */
+    std::vector<uint8_t>  tsDayBegin;
+    std::vector<float>    rainDayBegin;
+    std::vector<uint8_t>  tsWeekBegin;
+    std::vector<float>    rainWeekBegin;
+    std::vector<uint8_t>  wdayPrev;
+    std::vector<uint8_t>  tsMonthBegin;
+    std::vector<float>    rainMonthBegin;
+
+    /* Overflow handling */
+    std::vector<float>    rainPrev;
+    std::vector<uint16_t> rainOvf;
+    std::vector<float>    rainCurr;
+
+    /* Statistics published for snapshot() */
+    std::vector<RainStatsCell> stats;
+
+    /* Modified rain gauges, one bit per gauge */
+    std::vector<uint64_t> dirtyMap;
+
+    std::vector<RainGaugeObserver *> observers;
+
+    /* Rain gauges changed by the current batch (published at its end) */
+    std::vector<uint32_t> touched;
+    std::vector<uint32_t> seen;
+    uint32_t              generation;
+
+    /* Publish statistics for snapshot() */
+    bool                  snapshots;
+
+    GaugeRef ref(uint32_t id) {
+      GaugeRef g = {
+          startupPrev[id], rainStartup[id],
+          tsDayBegin[id], rainDayBegin[id], tsWeekBegin[id], rainWeekBegin[id], wdayPrev[id],
+          tsMonthBegin[id], rainMonthBegin[id], rainPrev[id], rainOvf[id]
+      };
+      return g;
+    };
+
+    /**
+     * Increment circular buffer index - i := (i+1) mod BufSize
+     */
+    static index_t inc(index_t i) {
+      return BUF_SIZE_POW2 ? (index_t)((i + 1) & (BufSize - 1)) : (index_t)((i == BufSize - 1) ? 0 : i + 1);
+    };
+
+    /**
+     * Update rain gauge statistics with one reading (not published)
+     *
+     * \returns false if the id is out of range (the reading is ignored)
+     */
+    bool  updateOne(uint32_t id, time_t epoch, float value, bool startup, float raingaugeMax);
+
+    /**
+     * Remove stale entries from and add new value to circular buffer of rain gauge
+     * (before the day/week/month rollover)
+     */
+    void  ringUpdate(uint32_t id, uint32_t tsNow, uint16_t rainFixed);
+
+    /**
+     * Statistics are needed by snapshot() or observers
+     */
+    bool  publishing(void) const {
+      return snapshots || !observers.empty();
+    };
+
+    /**
+     * Mark rain gauge as modified (called after every change of a rain gauge)
+     */
+    void  markDirty(uint32_t id) {
+      dirtyMap[id >> 6] |= (uint64_t)1 << (id & 63);
+    };
+
+    /**
+     * Current statistics of rain gauge
+     */
+    RainGaugeStats statsOf(uint32_t id) const {
+      RainGaugeStats s;
+
+      s.pastHour     = pastHour(id);
+      s.currentDay   = currentDay(id);
+      s.currentWeek  = currentWeek(id);
+      s.currentMonth = currentMonth(id);
+      return s;
+    };
+
+    /**
+     * Publish statistics of rain gauge for snapshot() (if enabled) and notify observers
+     * (called once per changed rain gauge at the end of an update)
+     */
+    void  publish(uint32_t id) {
+      RainGaugeStats s = statsOf(id);
+
+      if (snapshots)
+          stats[id].publish(s);
+      for (size_t i = 0; i < observers.size(); i++) {
+          observers[i]->changed(id, s);
+      }
+    };
+
+    /**
+     * Add rain gauge to the gauges to be published at the end of the batch
+     */
+    void  touch(uint32_t id) {
+      if (seen[id] != generation) {
+          seen[id] = generation;
+          touched.push_back(id);
+      }
+    };
+
+    /**
+     * Publish all rain gauges changed by the batch
+     */
+    void  publishTouched(void) {
+      for (size_t k = 0; k < touched.size(); k++) {
+          publish(touched[k]);
+      }
+      touched.clear();
+      if (++generation == 0) {
+          std::fill(seen.begin(), seen.end(), 0);
+          generation = 1;
+      }
+    };
+};
+
+/**
+ * \typedef RainGaugeFleet
+ *
+ * \brief Fleet of rain gauges with the parameters of RainGauge
+ */
+typedef RainGaugeFleetT<RAINGAUGE_WINDOW, RAINGAUGE_BUF_SIZE, RAINGAUGE_SCALE> RainGaugeFleet;
+
+
+template <unsigned WindowSeconds, unsigned BufSize, unsigned Scale>
+size_t
+RainGaugeFleetT<WindowSeconds, BufSize, Scale>::updateBatch(size_t n, const uint32_t *ids, const time_t *epochs,
+    const float *values, const bool *startup, float raingaugeMax)
+{
+    size_t applied = 0;
+    bool   pub     = publishing();
+
+    for (size_t k = 0; k < n; k++) {
+        if (updateOne(ids[k], epochs[k], values[k], startup ? startup[k] : false, raingaugeMax)) {
+            applied++;
+            if (pub)
+                touch(ids[k]);
+        }
+    }
+    if (pub)
+        publishTouched();
+    return applied;
+}
+
+template <unsigned WindowSeconds, unsigned BufSize, unsigned Scale>
+bool
+RainGaugeFleetT<WindowSeconds, BufSize, Scale>::updateOne(uint32_t id, time_t epoch, float value, bool startup,
+    float raingaugeMax)
+{
+    rainTime_t t;
+
+    if (id >= count)
+        return false;
+
+    GaugeRef   g = ref(id);
+
+    clock.fromEpoch(epoch, t);
+
+    float rc = RainGaugeCore::accumulate(&g, value, startup, raingaugeMax);
+    rainCurr[id] = rc;
+    ringUpdate(id, t.ts, RainGaugeCore::rainFixed(rc, Scale));
+
+    RainGaugeCore::calendar(&g, t, rc);
+    markDirty(id);
+    return true;
+}
+
+template <unsigned WindowSeconds, unsigned BufSize, unsigned Scale>
+void
+RainGaugeFleetT<WindowSeconds, BufSize, Scale>::updateAll(time_t epoch, const float *values, const bool *startup,
+    float raingaugeMax)
+{
+    rainTime_t t;
+
+    if (count == 0)
+        return;
+
+    clock.fromEpoch(epoch, t);
+
+    rainAccumulateBatch(count, values, startup, raingaugeMax,
+                        &startupPrev[0], &rainStartup[0], &rainPrev[0], &rainOvf[0], &rainCurr[0]);
+
+    for (size_t id = 0; id < count; id++) {
+        ringUpdate((uint32_t)id, t.ts, RainGaugeCore::rainFixed(rainCurr[id], Scale));
+    }
+
+    rainCalendarBatch(count, t, &rainCurr[0],
+                      &tsDayBegin[0], &rainDayBegin[0], &tsWeekBegin[0], &rainWeekBegin[0], &wdayPrev[0],
+                      &tsMonthBegin[0], &rainMonthBegin[0]);
+
+    bool pub = publishing();
+
+    for (size_t id = 0; id < count; id++) {
+        markDirty((uint32_t)id);
+        if (pub)
+            publish((uint32_t)id);
+    }
+}
+
+template <unsigned WindowSeconds, unsigned BufSize, unsigned Scale>
+void
+RainGaugeFleetT<WindowSeconds, BufSize, Scale>::ringUpdate(uint32_t id, uint32_t tsNow, uint16_t rainFixed)
+{
+    uint32_t *ts  = &tsBuf[id * BufSize];
+    uint16_t *buf = &rainBuf[id * BufSize];
+    index_t   h   = head[id];
+    index_t   tl  = tail[id];
+
+    // Check if no saved data is available yet
+    if (wdayPrev[id] == 0xFF) {
+        // Init tail of circular buffer
+        ts[tl]  = tsNow;
+        buf[tl] = rainFixed;
+    }
+
+    // Remove stale entries
+    while (tl != h) {
+        uint32_t ts_cmp = tsNow;
+        // if current timestamp smaller than saved timestamp, add one day
+        if (ts_cmp < ts[tl]) {
+            ts_cmp = ts_cmp + CIVIL_SECONDS_PER_DAY;
+        }
+        if ((ts_cmp - ts[tl]) <= WindowSeconds)
+            break;
+        tl = inc(tl);
+    }
+
+    // Add new value; prevent head from reaching tail if update rate is too fast
+    index_t head_tmp = inc(h);
+    h = (head_tmp == tl) ? h : head_tmp;
+    ts[h]  = tsNow;
+    buf[h] = rainFixed;
+    head[id] = h;
+    tail[id] = tl;
+}
+
+template <unsigned WindowSeconds, unsigned BufSize, unsigned Scale>
+void
+RainGaugeFleetT<WindowSeconds, BufSize, Scale>::load(uint32_t id, const nvDataT<BufSize> &nv, float raingaugeMax)
+{
+    for (unsigned i=0; i < BufSize; i++) {
+        tsBuf[id * BufSize + i]   = nv.ts(i);
+        rainBuf[id * BufSize + i] = nv.rainBuf[i];
+    }
+    head[id]           = nv.head;
+    tail[id]           = nv.tail;
+    startupPrev[id]    = nv.startupPrev;
+    rainStartup[id]    = nv.rainStartup;
+    tsDayBegin[id]     = nv.tsDayBegin;
+    rainDayBegin[id]   = nv.rainDayBegin;
+    tsWeekBegin[id]    = nv.tsWeekBegin;
+    rainWeekBegin[id]  = nv.rainWeekBegin;
+    wdayPrev[id]       = nv.wdayPrev;
+    tsMonthBegin[id]   = nv.tsMonthBegin;
+    rainMonthBegin[id] = nv.rainMonthBegin;
+    rainPrev[id]       = nv.rainPrev;
+    rainOvf[id]        = nv.rainOvf;
+    rainCurr[id]       = (nv.rainOvf * raingaugeMax) + nv.rainStartup + nv.rainPrev;
+    markDirty(id);
+    if (publishing())
+        publish(id);
+}
+
+template <unsigned WindowSeconds, unsigned BufSize, unsigned Scale>
+void
+RainGaugeFleetT<WindowSeconds, BufSize, Scale>::store(uint32_t id, nvDataT<BufSize> &nv) const
+{
+    for (unsigned i=0; i < BufSize; i++) {
+        nv.setTs(i, tsBuf[id * BufSize + i]);
+        nv.rainBuf[i] = rainBuf[id * BufSize + i];
+    }
+    nv.head           = head[id];
+    nv.tail           = tail[id];
+    nv.tsPrev         = tsBuf[id * BufSize + head[id]];
+    nv.startupPrev    = startupPrev[id] != 0;
+    nv.rainStartup    = rainStartup[id];
+    nv.tsDayBegin     = tsDayBegin[id];
+    nv.rainDayBegin   = rainDayBegin[id];
+    nv.tsWeekBegin    = tsWeekBegin[id];
+    nv.rainWeekBegin  = rainWeekBegin[id];
+    nv.wdayPrev       = wdayPrev[id];
+    nv.tsMonthBegin   = tsMonthBegin[id];
+    nv.rainMonthBegin = rainMonthBegin[id];
+    nv.rainPrev       = rainPrev[id];
+    nv.rainOvf        = rainOvf[id];
+
+    RainGaugeT<WindowSeconds, BufSize, Scale> rainGauge(&nv);
+    rainGauge.peakRebuild();
+}
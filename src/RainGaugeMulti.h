@@ -0,0 +1,318 @@
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// RainGaugeMulti.h
+//
+// Calculation of several rolling windows (e.g. 10 minutes, 1 hour, 3 hours, 24 hours),
+// daily, weekly and monthly rainfall from raw rain gauge data.
+//
+// All windows share one circular buffer of readings, one time stamp conversion and
+// one eviction pass per update.
+//
+// https://github.com/matthias-bs/BresserWeatherSensorReceiver
+//
+//
+// created: 10/2026
+//
+//
+// MIT License
+//
+// Copyright (c) 2026 Matthias Prinke
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+// History:
+//
+// 20261016 Created
+// 20261017 Time stamps from continuous local time (DST changes)
+//
+// ToDo:
+// -
+//
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include "RainGauge.h"
+
+/**
+ * \struct nvMultiDataT
+ *
+ * \brief Data structure for rain statistics to be stored in non-volatile memory
+ *
+ * \tparam BufSize size of circular buffer (longest window / update_rate [sec]) + 2
+ * \tparam Windows number of rolling windows
+ */
+template <unsigned BufSize, unsigned Windows>
+struct nvMultiDataT {
+    /* rainfall during past windows - circular buffer */
+    uint32_t  tsBuf[BufSize]; // continuous local time in seconds since epoch
+    uint32_t  rainBuf[BufSize]; // accumulated rain gauge value (fixed-point)
+    typename rainIndex<BufSize>::type head;
+    typename rainIndex<BufSize>::type tail[Windows]; // one tail per window
+
+    /* Sensor startup handling */
+    bool      startupPrev; // previous state of startup
+    float     rainStartup; // rain gauge before startup 
+
+    /* Rainfall of current day (can start anytime, but will reset on begin of new day) */
+    uint8_t   tsDayBegin; // day of week
+    float     rainDayBegin; // rain gauge @ begin of day
+
+    /* Rainfall of current week (can start anytime, but will reset on Monday */
+    uint8_t   tsWeekBegin; // day of week 
+    float     rainWeekBegin; // rain gauge @ begin of week
+    uint8_t   wdayPrev; // day of week at previous run - to detect new week
+
+    /* Rainfall of current calendar month (can start anytime, but will reset at begin of month */
+    uint8_t   tsMonthBegin; // month
+    float     rainMonthBegin; // rain gauge @ begin of month
+
+    float     rainPrev;  // rain gauge at previous run - to detect overflow
+    uint16_t  rainOvf; // number of rain gauge overflows
+};
+
+/**
+ * \class RainGaugeMultiT
+ *
+ * \brief Calculation of several rolling windows, daily, weekly and monthly rainfall
+ *
+ * \verbatim
+ * One circular buffer holds the readings of the longest window; each window
+ * has its own tail index:
+ *
+ *      ---------------     -----------
+ * .-> |   |   |   |   |...|   |   |   |--. 
+ * |    ---------------     -----------   |
+ * |     ^       ^           ^    ^       |
+ * |   tail[2] tail[1]     tail[0] head   |
+ * `--------------------------------------'
+ *
+ * - Remove stale entries (single pass over all windows):
+ *   for each window k:
+ *     while ((tsBuf[head]-tsBuf[tail[k]]) > window[k]) increment(tail[k]);
+ *
+ * - Calculate rolling window k:
+ *   rainWindow[k] = rainBuf[head] - rainBuf[tail[k]];
+ *
+ * Notes:
+ * - Windows are kept in ascending order, so the last tail is the oldest one;
+ *   head is not incremented if it would reach it (see RainGaugeT).
+ * - Time stamps are continuous local time in seconds since epoch (rainTime_t::mono),
+ *   so windows may exceed one day and span daylight saving time changes.
+ * - Rain values are stored as uint32_t encoded as fixed-point data (Scale).
+ * \endverbatim
+ *
+ * \tparam BufSize size of circular buffer
+ * \tparam Windows number of rolling windows
+ * \tparam Scale   fixed-point scale of rain values (10: 0.1 mm)
+ */
+template <unsigned BufSize, unsigned Windows, unsigned Scale>
+class RainGaugeMultiT {
+public:
+    static_assert(BufSize >= 2 && BufSize <= 65535, "Invalid circular buffer size");
+    static_assert(Windows >= 1, "At least one window is required");
+    static_assert(Scale >= 1, "Invalid fixed-point scale");
+
+    typedef typename rainIndex<BufSize>::type index_t;
+
+    float rainCurr;
+    nvMultiDataT<BufSize, Windows> *nvData;
+
+    /**
+     * Constructor
+     *
+     * \param data    non-volatile data
+     *
+     * \param windows lengths of rolling windows in seconds; sorted into ascending order
+     */
+    RainGaugeMultiT(nvMultiDataT<BufSize, Windows> *data, const uint32_t (&windows)[Windows]) {
+      nvData = data;
+      for (unsigned k = 0; k < Windows; k++) {
+          window[k] = windows[k];
+      }
+      // Insertion sort - Windows is small
+      for (unsigned k = 1; k < Windows; k++) {
+          for (unsigned j = k; (j > 0) && (window[j - 1] > window[j]); j--) {
+              uint32_t w = window[j];
+              window[j] = window[j - 1];
+              window[j - 1] = w;
+          }
+      }
+    };
+
+    /**
+     * Reset non-volatile data and current rain counter value
+     */
+    void  reset(uint8_t flags=0xF) {
+      if (flags & RESET_RAIN_H) {
+          nvData->head = 0;
+          for (unsigned k = 0; k < Windows; k++) {
+              nvData->tail[k] = 0;
+          }
+          for (unsigned i = 0; i < BufSize; i++) {
+              nvData->tsBuf[i]   = 0;
+              nvData->rainBuf[i] = 0;
+          }
+      }
+      RainGaugeCore::reset(nvData, flags, rainCurr);
+    };
+
+    /**
+     * \fn update
+     * 
+     * \brief Update rain gauge statistics
+     * 
+     * \param timeinfo     date and time (struct tm)
+     * 
+     * \param rain         rain gauge raw value
+     * 
+     * \param startup      sensor startup flag
+     * 
+     * \param rainGaugeMax overflow value; when reached, the rain gauge is reset to zero
+     */  
+    void  update(tm timeinfo, float rain, bool startup = false, float raingaugeMax = RAINGAUGE_MAX_VALUE) {
+      rainTime_t rt;
+
+      RainClock::fromTm(timeinfo, rt);
+      updateLocal(rt, rain, startup, raingaugeMax);
+    };
+
+    /**
+     * \fn update
+     * 
+     * \brief Update rain gauge statistics
+     * 
+     * \param epoch        seconds since epoch (UTC)
+     * 
+     * \param rain         rain gauge raw value
+     * 
+     * \param startup      sensor startup flag
+     * 
+     * \param rainGaugeMax overflow value; when reached, the rain gauge is reset to zero
+     */  
+    void  update(time_t epoch, float rain, bool startup = false, float raingaugeMax = RAINGAUGE_MAX_VALUE) {
+      rainTime_t rt;
+
+      clock.fromEpoch(epoch, rt);
+      updateLocal(rt, rain, startup, raingaugeMax);
+    };
+
+    /**
+     * Bind rain gauge to timezone used by update(time_t)
+     *
+     * \param tz timezone table (must outlive the rain gauge) or NULL for libc local time
+     */
+    void  setTimeZone(const TimeZone *tz) {
+      clock.setTimeZone(tz);
+    };
+
+    /**
+     * Length of rolling window in seconds
+     *
+     * \param k window index (ascending order of window length)
+     */
+    uint32_t windowLength(unsigned k) const {
+      return window[k];
+    };
+
+    /**
+     * Rainfall during rolling window
+     *
+     * \param k window index (ascending order of window length)
+     */
+    float pastWindow(unsigned k) {
+      return (float)((1.0 / Scale) * (int32_t)(nvData->rainBuf[nvData->head] - nvData->rainBuf[nvData->tail[k]]));
+    };
+
+    /**
+     * Rainfall of current calendar day
+     */
+    float currentDay(void) {
+      return rainCurr - nvData->rainDayBegin;
+    };
+
+    /**
+     * Rainfall of current calendar week
+     */
+    float currentWeek(void) {
+      return rainCurr - nvData->rainWeekBegin;
+    };
+
+    /**
+     * Rainfall of current calendar month
+     */
+    float currentMonth(void) {
+      return rainCurr - nvData->rainMonthBegin;
+    };
+
+private:
+    static const bool BUF_SIZE_POW2 = (BufSize & (BufSize - 1)) == 0;
+
+    uint32_t  window[Windows]; // window lengths in seconds, ascending
+    RainClock clock;
+
+    /**
+     * Increment circular buffer index - i := (i+1) mod BufSize
+     */
+    static index_t inc(index_t i) {
+      return BUF_SIZE_POW2 ? (index_t)((i + 1) & (BufSize - 1)) : (index_t)((i == BufSize - 1) ? 0 : i + 1);
+    };
+
+    /**
+     * Update rain gauge statistics at given local calendar position
+     */
+    void  updateLocal(const rainTime_t &t, float rain, bool startup, float raingaugeMax);
+};
+
+template <unsigned BufSize, unsigned Windows, unsigned Scale>
+void
+RainGaugeMultiT<BufSize, Windows, Scale>::updateLocal(const rainTime_t &t, float rain, bool startup, float raingaugeMax)
+{
+    index_t  head_tmp; // circular buffer; temporary head index
+
+    // Continuous local time in seconds since epoch
+    uint32_t ts = (uint32_t)t.mono;
+
+    rainCurr = RainGaugeCore::accumulate(nvData, rain, startup, raingaugeMax);
+    uint32_t rainFixed = (uint32_t)(rainCurr * Scale);
+
+    // Check if no saved data is available yet
+    if (nvData->wdayPrev == 0xFF) {
+        // Init tail of circular buffer
+        nvData->tsBuf[nvData->tail[Windows - 1]]   = ts;
+        nvData->rainBuf[nvData->tail[Windows - 1]] = rainFixed;
+    }
+
+    // Remove stale entries - single pass over all windows
+    for (unsigned k = 0; k < Windows; k++) {
+        index_t tail = nvData->tail[k];
+        while ((tail != nvData->head) && (ts - nvData->tsBuf[tail] > window[k])) {
+            tail = inc(tail);
+        }
+        nvData->tail[k] = tail;
+    }
+
+    // Add new value
+    head_tmp = inc(nvData->head);
+    // Prevent head from reaching the oldest tail if update rate is too fast
+    nvData->head = (head_tmp == nvData->tail[Windows - 1]) ? nvData->head : head_tmp;
+    nvData->tsBuf[nvData->head]   = ts;
+    nvData->rainBuf[nvData->head] = rainFixed;
+
+    RainGaugeCore::calendar(nvData, t, rainCurr);
+}
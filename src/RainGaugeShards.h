@@ -0,0 +1,485 @@
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// RainGaugeShards.h
+//
+// Multi-threaded ingestion of rain gauge readings: gauges are partitioned by id
+// into shards (one RainGaugeFleetT each) which are processed by a work-stealing
+// thread pool.
+//
+// https://github.com/matthias-bs/BresserWeatherSensorReceiver
+//
+//
+// created: 10/2026
+//
+//
+// MIT License
+//
+// Copyright (c) 2026 Matthias Prinke
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+// History:
+//
+// 20261016 Created
+// 20261016 Added lock-free ingestion queues (push()/drain(), ingestFrom())
+// 20261016 Added snapshot() for readers in other threads
+// 20261016 Added optional reorder stage for drain() (setReorder(), flushReorder())
+// 20261017 Copying is not allowed (owns fleets and queues)
+// 20261017 Added setSnapshots()
+//
+// ToDo:
+// -
+//
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <stdint.h>
+#include <atomic>
+#include <vector>
+
+#include "RainGaugeFleet.h"
+#include "RainQueue.h"
+#include "RainReorder.h"
+#include "RainWorkPool.h"
+
+/**
+ * \def
+ *
+ * Number of readings dequeued and applied at once by drain() and ingestFrom()
+ */
+#ifndef RAIN_SHARD_BATCH
+  #define RAIN_SHARD_BATCH 256
+#endif
+
+/**
+ * \class RainGaugeShardsT
+ *
+ * \brief Rain statistics of many rain gauges, updated by several threads
+ *
+ * \verbatim
+ * Gauge id is mapped to shard (id mod Shards) and to local id (id / Shards)
+ * in the shard's RainGaugeFleetT:
+ *
+ *   ingest(readings) --> partition by shard (readings keep their order)
+ *                    --> one task per non-empty shard --> RainWorkPool
+ *
+ * A shard is processed by exactly one worker per ingest(), so the readings
+ * of each gauge are applied in their original order.
+ *
+ * Alternatively, receiver threads push() readings into a bounded lock-free
+ * queue per shard (RainMpscQueue); drain() applies the queued readings of all
+ * shards on the thread pool in batches of RAIN_SHARD_BATCH:
+ *
+ *   push(reading) --> queue[id mod Shards] --> drain() --> RainWorkPool
+ * \endverbatim
+ *
+ * Each shard has its own RainClock; with a TimeZone bound (setTimeZone()),
+ * no libc time functions are called by the workers.
+ *
+ * \tparam WindowSeconds length of rolling window in seconds (less than one day)
+ * \tparam BufSize       size of circular buffer; (WindowSeconds / update_rate [sec]) + 2
+ * \tparam Scale         fixed-point scale of rain values in circular buffer (10: 0.1 mm)
+ */
+template <unsigned WindowSeconds, unsigned BufSize, unsigned Scale>
+class RainGaugeShardsT {
+public:
+    typedef RainGaugeFleetT<WindowSeconds, BufSize, Scale> Fleet;
+
+    /**
+     * Constructor
+     *
+     * \param gauges  number of rain gauges (ids 0..gauges-1)
+     *
+     * \param threads number of worker threads
+     *
+     * \param shards  number of shards; 0: four per thread (allows balancing by work stealing)
+     *
+     * \param queueCapacity capacity of the ingestion queue of each shard (see push())
+     */
+    RainGaugeShardsT(size_t gauges, unsigned threads, unsigned shards = 0, size_t queueCapacity = 4096) :
+      pool(threads)
+    {
+      nShards = (shards > 0) ? shards : 4 * pool.size();
+      for (unsigned s = 0; s < nShards; s++) {
+          fleets.push_back(new Fleet((gauges + nShards - 1 - s) / nShards));
+          inbox.push_back(new RainMpscQueue<RainReading>(queueCapacity));
+      }
+      queues.resize(nShards);
+    };
+
+    ~RainGaugeShardsT() {
+      for (size_t s = 0; s < fleets.size(); s++) {
+          delete fleets[s];
+          delete inbox[s];
+      }
+      for (size_t s = 0; s < reorder.size(); s++) {
+          delete reorder[s];
+      }
+    };
+
+    /**
+     * Number of worker threads
+     */
+    unsigned threads(void) const {
+      return pool.size();
+    };
+
+    /**
+     * Number of shards
+     */
+    unsigned shards(void) const {
+      return nShards;
+    };
+
+    /**
+     * Number of shard tasks executed by a worker other than the one it was assigned to
+     */
+    uint64_t steals(void) const {
+      return pool.steals();
+    };
+
+    /**
+     * Bind all rain gauges to timezone
+     *
+     * \param tz timezone table (must outlive this object) or NULL for libc local time
+     */
+    void  setTimeZone(const TimeZone *tz) {
+      for (size_t s = 0; s < fleets.size(); s++) {
+          fleets[s]->setTimeZone(tz);
+      }
+    };
+
+    /**
+     * Reset state of rain gauge
+     */
+    void  reset(uint32_t id, uint8_t flags=0xF) {
+      fleets[id % nShards]->reset(id / nShards, flags);
+    };
+
+    /**
+     * \fn ingest
+     *
+     * \brief Update rain gauge statistics with a batch of readings using all worker threads
+     *
+     * Returns when all readings have been applied.
+     *
+     * \param n            number of readings
+     *
+     * \param readings     readings; readings of the same gauge must be in chronological order
+     *
+     * \param rainGaugeMax overflow value; when reached, the rain gauge is reset to zero
+     */
+    void  ingest(size_t n, const RainReading *readings, float raingaugeMax = RAINGAUGE_MAX_VALUE);
+
+    /**
+     * \fn ingestFrom
+     *
+     * \brief Dequeue readings from a single-consumer queue and apply them using all worker threads
+     *
+     * \param q   RainSpscQueue<RainReading> or RainMpscQueue<RainReading>; the calling
+     *            thread is the consumer
+     *
+     * \param max maximum number of readings
+     *
+     * \returns number of readings applied
+     */
+    template <class Q>
+    size_t ingestFrom(Q &q, size_t max, float raingaugeMax = RAINGAUGE_MAX_VALUE) {
+      size_t total = 0;
+      staging.resize(RAIN_SHARD_BATCH);
+      while (total < max) {
+          size_t n = q.popBatch(&staging[0], (max - total < RAIN_SHARD_BATCH) ? max - total : RAIN_SHARD_BATCH);
+          if (n == 0)
+              break;
+          ingest(n, &staging[0], raingaugeMax);
+          total += n;
+      }
+      return total;
+    };
+
+    /**
+     * \fn push
+     *
+     * \brief Queue reading for its shard (any thread, lock-free)
+     *
+     * \param r reading
+     *
+     * \returns false if the shard's queue is full (back-pressure); the reading is not queued
+     */
+    bool  push(const RainReading &r) {
+      RainReading local = r;
+      unsigned    s     = r.id % nShards;
+      local.id = r.id / nShards;
+      return inbox[s]->push(local);
+    };
+
+    /**
+     * \fn drain
+     *
+     * \brief Apply queued readings of all shards using all worker threads
+     *
+     * Must not be called concurrently with itself, ingest() or ingestFrom().
+     *
+     * \param maxPerShard  maximum number of readings per shard
+     *
+     * \param rainGaugeMax overflow value; when reached, the rain gauge is reset to zero
+     *
+     * \returns number of readings applied
+     */
+    size_t drain(size_t maxPerShard = SIZE_MAX, float raingaugeMax = RAINGAUGE_MAX_VALUE);
+
+    /**
+     * \fn setReorder
+     *
+     * \brief Sort readings queued by push() by time stamp before drain() applies them
+     *
+     * With a reorder stage, each shard holds readings back in a RainReorderBuffer until
+     * they are older than the lateness horizon, so producers need not preserve the order
+     * of readings. drain() then returns the number of readings released and applied;
+     * readings which arrive after a newer reading of the same gauge has been applied are
+     * dropped (see late()). Must not be called concurrently with drain().
+     *
+     * \param horizon  lateness horizon in seconds
+     *
+     * \param capacity maximum number of readings held back per shard
+     */
+    void  setReorder(uint32_t horizon, size_t capacity = 65536) {
+      for (size_t s = 0; s < reorder.size(); s++) {
+          delete reorder[s];
+      }
+      reorder.clear();
+      for (unsigned s = 0; s < nShards; s++) {
+          reorder.push_back(new RainReorderBuffer(fleets[s]->size(), horizon, capacity));
+      }
+    };
+
+    /**
+     * \fn flushReorder
+     *
+     * \brief Apply all readings held back by the reorder stage (e.g. at end of input)
+     *
+     * \returns number of readings applied
+     */
+    size_t flushReorder(float raingaugeMax = RAINGAUGE_MAX_VALUE);
+
+    /**
+     * Number of readings held back by the reorder stage
+     */
+    size_t held(void) const {
+      size_t n = 0;
+      for (size_t s = 0; s < reorder.size(); s++) {
+          n += reorder[s]->size();
+      }
+      return n;
+    };
+
+    /**
+     * Number of readings dropped by the reorder stage because they arrived too late
+     */
+    uint64_t late(void) const {
+      uint64_t n = 0;
+      for (size_t s = 0; s < reorder.size(); s++) {
+          n += reorder[s]->late();
+      }
+      return n;
+    };
+
+    /**
+     * Number of readings waiting in the ingestion queues (approximate)
+     */
+    size_t queued(void) const {
+      size_t n = 0;
+      for (size_t s = 0; s < inbox.size(); s++) {
+          n += inbox[s]->size();
+      }
+      return n;
+    };
+
+    /**
+     * Number of readings rejected by push() because a queue was full
+     */
+    uint64_t rejected(void) const {
+      uint64_t n = 0;
+      for (size_t s = 0; s < inbox.size(); s++) {
+          n += inbox[s]->rejected();
+      }
+      return n;
+    };
+
+    /**
+     * Rainfall during past window (WindowSeconds)
+     */
+    float pastHour(uint32_t id) const {
+      return fleets[id % nShards]->pastHour(id / nShards);
+    };
+
+    /**
+     * Rainfall of current calendar day
+     */
+    float currentDay(uint32_t id) const {
+      return fleets[id % nShards]->currentDay(id / nShards);
+    };
+
+    /**
+     * Rainfall of current calendar week
+     */
+    float currentWeek(uint32_t id) const {
+      return fleets[id % nShards]->currentWeek(id / nShards);
+    };
+
+    /**
+     * Rainfall of current calendar month
+     */
+    float currentMonth(uint32_t id) const {
+      return fleets[id % nShards]->currentMonth(id / nShards);
+    };
+
+    /**
+     * Current accumulated rain gauge value (including overflows)
+     */
+    float current(uint32_t id) const {
+      return fleets[id % nShards]->current(id / nShards);
+    };
+
+    /**
+     * Enable or disable publishing of statistics for snapshot() (disabled by default)
+     */
+    void  setSnapshots(bool on) {
+      for (unsigned s = 0; s < nShards; s++) {
+          fleets[s]->setSnapshots(on);
+      }
+    };
+
+    /**
+     * Consistent statistics of rain gauge (any thread, also during ingest()/drain())
+     * Requires setSnapshots(true).
+     */
+    void  snapshot(uint32_t id, RainGaugeStats &s) const {
+      fleets[id % nShards]->snapshot(id / nShards, s);
+    };
+
+private:
+    RainWorkPool                           pool;
+    unsigned                               nShards;
+    std::vector<Fleet *>                   fleets;
+    std::vector<std::vector<RainReading> > queues; // readings per shard, local ids
+    std::vector<unsigned>                  active; // non-empty shards of current ingest()
+    std::vector<RainMpscQueue<RainReading> *> inbox; // ingestion queue per shard, local ids
+    std::vector<RainReading>               staging; // batch buffer of ingestFrom()
+    std::vector<RainReorderBuffer *>       reorder; // optional reorder stage per shard, local ids
+
+    RainGaugeShardsT(const RainGaugeShardsT &);
+    RainGaugeShardsT &operator=(const RainGaugeShardsT &);
+};
+
+/**
+ * \typedef RainGaugeShards
+ *
+ * \brief Sharded fleet of rain gauges with the parameters of RainGauge
+ */
+typedef RainGaugeShardsT<RAINGAUGE_WINDOW, RAINGAUGE_BUF_SIZE, RAINGAUGE_SCALE> RainGaugeShards;
+
+
+template <unsigned WindowSeconds, unsigned BufSize, unsigned Scale>
+void
+RainGaugeShardsT<WindowSeconds, BufSize, Scale>::ingest(size_t n, const RainReading *readings, float raingaugeMax)
+{
+    // Partition readings by shard; the order within each shard is preserved
+    for (size_t k = 0; k < n; k++) {
+        RainReading r = readings[k];
+        unsigned    s = r.id % nShards;
+        r.id = r.id / nShards;
+        queues[s].push_back(r);
+    }
+
+    active.clear();
+    for (unsigned s = 0; s < nShards; s++) {
+        if (!queues[s].empty()) {
+            active.push_back(s);
+        }
+    }
+
+    pool.run(active.size(), [this, raingaugeMax](size_t task) {
+        unsigned s = active[task];
+        fleets[s]->update(queues[s].size(), &queues[s][0], raingaugeMax);
+        queues[s].clear();
+    });
+}
+
+template <unsigned WindowSeconds, unsigned BufSize, unsigned Scale>
+size_t
+RainGaugeShardsT<WindowSeconds, BufSize, Scale>::drain(size_t maxPerShard, float raingaugeMax)
+{
+    std::atomic<size_t> total(0);
+
+    pool.run(nShards, [this, maxPerShard, raingaugeMax, &total](size_t s) {
+        std::vector<RainReading> &batch = queues[s];
+        size_t done    = 0;
+        size_t applied = 0;
+
+        batch.resize(RAIN_SHARD_BATCH);
+        while (done < maxPerShard) {
+            size_t max = (maxPerShard - done < RAIN_SHARD_BATCH) ? maxPerShard - done : RAIN_SHARD_BATCH;
+            size_t n   = inbox[s]->popBatch(&batch[0], max);
+            if (n == 0)
+                break;
+            if (reorder.empty()) {
+                fleets[s]->update(n, &batch[0], raingaugeMax);
+                applied += n;
+            } else {
+                for (size_t k = 0; k < n; k++) {
+                    reorder[s]->push(batch[k]);
+                }
+                size_t m;
+                while ((m = reorder[s]->pop(&batch[0], RAIN_SHARD_BATCH)) > 0) {
+                    fleets[s]->update(m, &batch[0], raingaugeMax);
+                    applied += m;
+                }
+            }
+            done += n;
+        }
+        batch.clear();
+        total += applied;
+    });
+    return total.load();
+}
+
+template <unsigned WindowSeconds, unsigned BufSize, unsigned Scale>
+size_t
+RainGaugeShardsT<WindowSeconds, BufSize, Scale>::flushReorder(float raingaugeMax)
+{
+    std::atomic<size_t> total(0);
+
+    if (reorder.empty())
+        return 0;
+    pool.run(nShards, [this, raingaugeMax, &total](size_t s) {
+        std::vector<RainReading> &batch = queues[s];
+        size_t applied = 0;
+        size_t m;
+
+        batch.resize(RAIN_SHARD_BATCH);
+        while ((m = reorder[s]->flush(&batch[0], RAIN_SHARD_BATCH)) > 0) {
+            fleets[s]->update(m, &batch[0], raingaugeMax);
+            applied += m;
+        }
+        batch.clear();
+        total += applied;
+    });
+    return total.load();
+}
@@ -0,0 +1,393 @@
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// RainGaugeSimd.cpp
+//
+// Batch kernels for the per-gauge arithmetic of RainGauge::update() over
+// structure-of-arrays state, with AVX2 implementation and runtime CPU dispatch.
+//
+// https://github.com/matthias-bs/BresserWeatherSensorReceiver
+//
+//
+// created: 10/2026
+//
+//
+// MIT License
+//
+// Copyright (c) 2026 Matthias Prinke
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+// History:
+//
+// 20261016 Created
+// 20261017 Added SSE4.1 kernels; level is atomic
+//
+// ToDo:
+// -
+//
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+
+#include <string.h>
+#include <atomic>
+
+#include "RainGaugeSimd.h"
+
+#if RAINGAUGE_SIMD_X86
+  #include <immintrin.h>
+#endif
+
+/*
+ * References to the scalar state of one gauge - allows using RainGaugeCore
+ */
+typedef struct {
+    uint8_t  &startupPrev;
+    float    &rainStartup;
+    float    &rainPrev;
+    uint16_t &rainOvf;
+} accuRef_t;
+
+typedef struct {
+    uint8_t  &tsDayBegin;
+    float    &rainDayBegin;
+    uint8_t  &tsWeekBegin;
+    float    &rainWeekBegin;
+    uint8_t  &wdayPrev;
+    uint8_t  &tsMonthBegin;
+    float    &rainMonthBegin;
+} calendarRef_t;
+
+// Read by the kernels of all threads; the level only selects between
+// bit-identical kernels, so no ordering is required
+static std::atomic<int> simdLevel(rainSimdDetect());
+
+
+RainSimdLevel
+rainSimdDetect(void)
+{
+#if RAINGAUGE_SIMD_X86
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2")) {
+        return RAIN_SIMD_AVX2;
+    }
+    if (__builtin_cpu_supports("sse4.1")) {
+        return RAIN_SIMD_SSE41;
+    }
+#endif
+    return RAIN_SIMD_SCALAR;
+}
+
+RainSimdLevel
+rainSimdSelect(RainSimdLevel level)
+{
+    RainSimdLevel max = rainSimdDetect();
+
+    if (level > max)
+        level = max;
+    simdLevel.store(level, std::memory_order_relaxed);
+    return level;
+}
+
+/*
+ * Scalar kernels - the reference implementation (RainGaugeCore)
+ */
+static void
+accumulateScalar(size_t i, size_t n, const float *rain, const bool *startup, float raingaugeMax,
+                 uint8_t *startupPrev, float *rainStartup, float *rainPrev, uint16_t *rainOvf,
+                 float *rainCurr)
+{
+    for (; i < n; i++) {
+        accuRef_t g = {startupPrev[i], rainStartup[i], rainPrev[i], rainOvf[i]};
+        rainCurr[i] = RainGaugeCore::accumulate(&g, rain[i], startup ? startup[i] : false, raingaugeMax);
+    }
+}
+
+static void
+calendarScalar(size_t i, size_t n, const rainTime_t &t, const float *rainCurr,
+               uint8_t *tsDayBegin, float *rainDayBegin,
+               uint8_t *tsWeekBegin, float *rainWeekBegin, uint8_t *wdayPrev,
+               uint8_t *tsMonthBegin, float *rainMonthBegin)
+{
+    for (; i < n; i++) {
+        calendarRef_t g = {tsDayBegin[i], rainDayBegin[i], tsWeekBegin[i], rainWeekBegin[i], wdayPrev[i],
+                           tsMonthBegin[i], rainMonthBegin[i]};
+        RainGaugeCore::calendar(&g, t, rainCurr[i]);
+    }
+}
+
+#if RAINGAUGE_SIMD_X86
+/*
+ * Load 4 bytes into the low lane
+ */
+static inline __m128i
+load4(const uint8_t *p)
+{
+    int32_t v;
+
+    memcpy(&v, p, sizeof(v));
+    return _mm_cvtsi32_si128(v);
+}
+
+/*
+ * SSE4.1 kernels - 4 gauges per step, starting at gauge i; return index of the
+ * first gauge not processed
+ *
+ * Same operations as the AVX2 kernels.
+ */
+__attribute__((target("sse4.1")))
+static size_t
+accumulateSse41(size_t i, size_t n, const float *rain, const bool *startup, float raingaugeMax,
+                uint8_t *startupPrev, float *rainStartup, float *rainPrev, uint16_t *rainOvf,
+                float *rainCurr)
+{
+    const __m128  vmax   = _mm_set1_ps(raingaugeMax);
+    const __m128i zero   = _mm_setzero_si128();
+    const __m128i mask16 = _mm_set1_epi32(0xFFFF);
+    const uint8_t noStartup[4] = {0};
+
+    for (; i + 4 <= n; i += 4) {
+        const uint8_t *st4 = startup ? (const uint8_t *)(startup + i) : noStartup;
+
+        __m128  r   = _mm_loadu_ps(rain + i);
+        __m128  p   = _mm_loadu_ps(rainPrev + i);
+        __m128  s   = _mm_loadu_ps(rainStartup + i);
+        __m128i sp  = _mm_cvtepu8_epi32(load4(startupPrev + i));
+        __m128i st  = _mm_cvtepu8_epi32(load4(st4));
+        __m128i ovf = _mm_cvtepu16_epi32(_mm_loadl_epi64((const __m128i *)(rainOvf + i)));
+
+        // rain < rainPrev
+        __m128i lt = _mm_castps_si128(_mm_cmplt_ps(r, p));
+        // Startup change 0->1
+        __m128i rise = _mm_andnot_si128(_mm_cmpgt_epi32(sp, zero), _mm_cmpgt_epi32(st, zero));
+
+        // Save last rain value before startup - or count overflow
+        s   = _mm_blendv_ps(s, p, _mm_castsi128_ps(_mm_and_si128(lt, rise)));
+        ovf = _mm_and_si128(_mm_sub_epi32(ovf, _mm_andnot_si128(rise, lt)), mask16);
+
+        __m128 cur = _mm_add_ps(_mm_add_ps(_mm_mul_ps(_mm_cvtepi32_ps(ovf), vmax), s), r);
+
+        _mm_storeu_ps(rainStartup + i, s);
+        _mm_storeu_ps(rainPrev + i, r);
+        _mm_storeu_ps(rainCurr + i, cur);
+        _mm_storel_epi64((__m128i *)(rainOvf + i), _mm_packus_epi32(ovf, ovf));
+        memcpy(startupPrev + i, st4, 4);
+    }
+    return i;
+}
+
+__attribute__((target("sse4.1")))
+static size_t
+calendarSse41(size_t i, size_t n, const rainTime_t &t, const float *rainCurr,
+              uint8_t *tsDayBegin, float *rainDayBegin,
+              uint8_t *tsWeekBegin, float *rainWeekBegin, uint8_t *wdayPrev,
+              uint8_t *tsMonthBegin, float *rainMonthBegin)
+{
+    const __m128i wday    = _mm_set1_epi32(t.wday);
+    const __m128i mon     = _mm_set1_epi32(t.mon);
+    const __m128i invalid = _mm_set1_epi32(0xFF);
+    const __m128i zero    = _mm_setzero_si128();
+    const __m128i ones    = _mm_cmpeq_epi32(zero, zero);
+
+    for (; i + 4 <= n; i += 4) {
+        __m128  cur = _mm_loadu_ps(rainCurr + i);
+        __m128i day = _mm_cvtepu8_epi32(load4(tsDayBegin + i));
+        __m128i wk  = _mm_cvtepu8_epi32(load4(tsWeekBegin + i));
+        __m128i wp  = _mm_cvtepu8_epi32(load4(wdayPrev + i));
+        __m128i mo  = _mm_cvtepu8_epi32(load4(tsMonthBegin + i));
+
+        // No saved data available yet - previous day of week is the current one
+        wp = _mm_blendv_epi8(wp, wday, _mm_cmpeq_epi32(wp, invalid));
+
+        // Day of week has changed (or no saved data, 0xFF)
+        __m128i dayMask = _mm_xor_si128(_mm_cmpeq_epi32(day, wday), ones);
+        // Transition from Sunday to Monday (or no saved data)
+        __m128i weekMask = _mm_cmpeq_epi32(wk, invalid);
+        if (t.wday == 1) {
+            weekMask = _mm_or_si128(weekMask, _mm_cmpeq_epi32(wp, zero));
+        }
+        // Month has changed (or no saved data)
+        __m128i monMask = _mm_xor_si128(_mm_cmpeq_epi32(mo, mon), ones);
+
+        _mm_storeu_ps(rainDayBegin + i,
+                      _mm_blendv_ps(_mm_loadu_ps(rainDayBegin + i), cur, _mm_castsi128_ps(dayMask)));
+        _mm_storeu_ps(rainWeekBegin + i,
+                      _mm_blendv_ps(_mm_loadu_ps(rainWeekBegin + i), cur, _mm_castsi128_ps(weekMask)));
+        _mm_storeu_ps(rainMonthBegin + i,
+                      _mm_blendv_ps(_mm_loadu_ps(rainMonthBegin + i), cur, _mm_castsi128_ps(monMask)));
+
+        // Markers which are not updated already hold the current value
+        memset(tsDayBegin + i, t.wday, 4);
+        memset(wdayPrev + i, t.wday, 4);
+        memset(tsMonthBegin + i, t.mon, 4);
+        int m = _mm_movemask_ps(_mm_castsi128_ps(weekMask));
+        for (int j = 0; m != 0; j++, m >>= 1) {
+            if (m & 1) {
+                tsWeekBegin[i + j] = t.wday;
+            }
+        }
+    }
+    return i;
+}
+
+/*
+ * AVX2 kernels - 8 gauges per step; returns number of gauges processed
+ *
+ * Floating point operations are the same as in the scalar code and in the same
+ * order (no FMA), so the results are bit-identical.
+ */
+__attribute__((target("avx2")))
+static size_t
+accumulateAvx2(size_t n, const float *rain, const bool *startup, float raingaugeMax,
+               uint8_t *startupPrev, float *rainStartup, float *rainPrev, uint16_t *rainOvf,
+               float *rainCurr)
+{
+    const __m256  vmax  = _mm256_set1_ps(raingaugeMax);
+    const __m256i zero  = _mm256_setzero_si256();
+    const __m256i mask16 = _mm256_set1_epi32(0xFFFF);
+    const uint8_t noStartup[8] = {0};
+    size_t i = 0;
+
+    for (; i + 8 <= n; i += 8) {
+        const uint8_t *st8 = startup ? (const uint8_t *)(startup + i) : noStartup;
+
+        __m256  r   = _mm256_loadu_ps(rain + i);
+        __m256  p   = _mm256_loadu_ps(rainPrev + i);
+        __m256  s   = _mm256_loadu_ps(rainStartup + i);
+        __m256i sp  = _mm256_cvtepu8_epi32(_mm_loadl_epi64((const __m128i *)(startupPrev + i)));
+        __m256i st  = _mm256_cvtepu8_epi32(_mm_loadl_epi64((const __m128i *)st8));
+        __m256i ovf = _mm256_cvtepu16_epi32(_mm_loadu_si128((const __m128i *)(rainOvf + i)));
+
+        // rain < rainPrev
+        __m256i lt = _mm256_castps_si256(_mm256_cmp_ps(r, p, _CMP_LT_OQ));
+        // Startup change 0->1
+        __m256i rise = _mm256_andnot_si256(_mm256_cmpgt_epi32(sp, zero), _mm256_cmpgt_epi32(st, zero));
+
+        // Save last rain value before startup - or count overflow
+        s   = _mm256_blendv_ps(s, p, _mm256_castsi256_ps(_mm256_and_si256(lt, rise)));
+        ovf = _mm256_and_si256(_mm256_sub_epi32(ovf, _mm256_andnot_si256(rise, lt)), mask16);
+
+        __m256 cur = _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(_mm256_cvtepi32_ps(ovf), vmax), s), r);
+
+        _mm256_storeu_ps(rainStartup + i, s);
+        _mm256_storeu_ps(rainPrev + i, r);
+        _mm256_storeu_ps(rainCurr + i, cur);
+        _mm_storeu_si128((__m128i *)(rainOvf + i),
+                         _mm_packus_epi32(_mm256_castsi256_si128(ovf), _mm256_extracti128_si256(ovf, 1)));
+        memcpy(startupPrev + i, st8, 8);
+    }
+    return i;
+}
+
+__attribute__((target("avx2")))
+static size_t
+calendarAvx2(size_t n, const rainTime_t &t, const float *rainCurr,
+             uint8_t *tsDayBegin, float *rainDayBegin,
+             uint8_t *tsWeekBegin, float *rainWeekBegin, uint8_t *wdayPrev,
+             uint8_t *tsMonthBegin, float *rainMonthBegin)
+{
+    const __m256i wday    = _mm256_set1_epi32(t.wday);
+    const __m256i mon     = _mm256_set1_epi32(t.mon);
+    const __m256i invalid = _mm256_set1_epi32(0xFF);
+    const __m256i zero    = _mm256_setzero_si256();
+    const __m256i ones    = _mm256_cmpeq_epi32(zero, zero);
+    size_t i = 0;
+
+    for (; i + 8 <= n; i += 8) {
+        __m256  cur = _mm256_loadu_ps(rainCurr + i);
+        __m256i day = _mm256_cvtepu8_epi32(_mm_loadl_epi64((const __m128i *)(tsDayBegin + i)));
+        __m256i wk  = _mm256_cvtepu8_epi32(_mm_loadl_epi64((const __m128i *)(tsWeekBegin + i)));
+        __m256i wp  = _mm256_cvtepu8_epi32(_mm_loadl_epi64((const __m128i *)(wdayPrev + i)));
+        __m256i mo  = _mm256_cvtepu8_epi32(_mm_loadl_epi64((const __m128i *)(tsMonthBegin + i)));
+
+        // No saved data available yet - previous day of week is the current one
+        wp = _mm256_blendv_epi8(wp, wday, _mm256_cmpeq_epi32(wp, invalid));
+
+        // Day of week has changed (or no saved data, 0xFF)
+        __m256i dayMask = _mm256_xor_si256(_mm256_cmpeq_epi32(day, wday), ones);
+        // Transition from Sunday to Monday (or no saved data)
+        __m256i weekMask = _mm256_cmpeq_epi32(wk, invalid);
+        if (t.wday == 1) {
+            weekMask = _mm256_or_si256(weekMask, _mm256_cmpeq_epi32(wp, zero));
+        }
+        // Month has changed (or no saved data)
+        __m256i monMask = _mm256_xor_si256(_mm256_cmpeq_epi32(mo, mon), ones);
+
+        _mm256_storeu_ps(rainDayBegin + i,
+                         _mm256_blendv_ps(_mm256_loadu_ps(rainDayBegin + i), cur, _mm256_castsi256_ps(dayMask)));
+        _mm256_storeu_ps(rainWeekBegin + i,
+                         _mm256_blendv_ps(_mm256_loadu_ps(rainWeekBegin + i), cur, _mm256_castsi256_ps(weekMask)));
+        _mm256_storeu_ps(rainMonthBegin + i,
+                         _mm256_blendv_ps(_mm256_loadu_ps(rainMonthBegin + i), cur, _mm256_castsi256_ps(monMask)));
+
+        // Markers which are not updated already hold the current value
+        memset(tsDayBegin + i, t.wday, 8);
+        memset(wdayPrev + i, t.wday, 8);
+        memset(tsMonthBegin + i, t.mon, 8);
+        int m = _mm256_movemask_ps(_mm256_castsi256_ps(weekMask));
+        for (int j = 0; m != 0; j++, m >>= 1) {
+            if (m & 1) {
+                tsWeekBegin[i + j] = t.wday;
+            }
+        }
+    }
+    return i;
+}
+#endif
+
+void
+rainAccumulateBatch(size_t n, const float *rain, const bool *startup, float raingaugeMax,
+                    uint8_t *startupPrev, float *rainStartup, float *rainPrev, uint16_t *rainOvf,
+                    float *rainCurr)
+{
+    size_t i = 0;
+
+#if RAINGAUGE_SIMD_X86
+    int level = simdLevel.load(std::memory_order_relaxed);
+    if (level >= RAIN_SIMD_AVX2) {
+        i = accumulateAvx2(n, rain, startup, raingaugeMax, startupPrev, rainStartup, rainPrev, rainOvf, rainCurr);
+    }
+    if (level >= RAIN_SIMD_SSE41) {
+        i = accumulateSse41(i, n, rain, startup, raingaugeMax, startupPrev, rainStartup, rainPrev, rainOvf,
+                            rainCurr);
+    }
+#endif
+    accumulateScalar(i, n, rain, startup, raingaugeMax, startupPrev, rainStartup, rainPrev, rainOvf, rainCurr);
+}
+
+void
+rainCalendarBatch(size_t n, const rainTime_t &t, const float *rainCurr,
+                  uint8_t *tsDayBegin, float *rainDayBegin,
+                  uint8_t *tsWeekBegin, float *rainWeekBegin, uint8_t *wdayPrev,
+                  uint8_t *tsMonthBegin, float *rainMonthBegin)
+{
+    size_t i = 0;
+
+#if RAINGAUGE_SIMD_X86
+    int level = simdLevel.load(std::memory_order_relaxed);
+    if (level >= RAIN_SIMD_AVX2) {
+        i = calendarAvx2(n, t, rainCurr, tsDayBegin, rainDayBegin, tsWeekBegin, rainWeekBegin, wdayPrev,
+                         tsMonthBegin, rainMonthBegin);
+    }
+    if (level >= RAIN_SIMD_SSE41) {
+        i = calendarSse41(i, n, t, rainCurr, tsDayBegin, rainDayBegin, tsWeekBegin, rainWeekBegin, wdayPrev,
+                          tsMonthBegin, rainMonthBegin);
+    }
+#endif
+    calendarScalar(i, n, t, rainCurr, tsDayBegin, rainDayBegin, tsWeekBegin, rainWeekBegin, wdayPrev,
+                   tsMonthBegin, rainMonthBegin);
+}
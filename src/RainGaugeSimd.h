@@ -0,0 +1,151 @@
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// RainGaugeSimd.h
+//
+// Batch kernels for the per-gauge arithmetic of RainGauge::update() over
+// structure-of-arrays state (sensor startup/overflow correction and day/week/month
+// rollover), with SSE4.1 and AVX2 implementations and runtime CPU dispatch.
+//
+// https://github.com/matthias-bs/BresserWeatherSensorReceiver
+//
+//
+// created: 10/2026
+//
+//
+// MIT License
+//
+// Copyright (c) 2026 Matthias Prinke
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+// History:
+//
+// 20261016 Created
+// 20261017 Added SSE4.1 kernels
+//
+// ToDo:
+// -
+//
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "RainGauge.h"
+
+/**
+ * \def
+ *
+ * SSE4.1 and AVX2 kernels are only available with GCC/Clang on x86-64 (SSE floating point,
+ * i.e. no excess precision in the scalar code)
+ */
+#if defined(__x86_64__) && defined(__GNUC__)
+  #define RAINGAUGE_SIMD_X86 1
+#else
+  #define RAINGAUGE_SIMD_X86 0
+#endif
+
+/**
+ * \enum RainSimdLevel
+ *
+ * \brief Instruction set used by the batch kernels
+ */
+typedef enum {
+    RAIN_SIMD_SCALAR = 0, // portable C++ (RainGaugeCore)
+    RAIN_SIMD_SSE41  = 1, // 4 gauges per step
+    RAIN_SIMD_AVX2   = 2  // 8 gauges per step
+} RainSimdLevel;
+
+/**
+ * Best instruction set supported by the CPU
+ */
+RainSimdLevel rainSimdDetect(void);
+
+/**
+ * Select instruction set of the batch kernels
+ *
+ * The level is global; it may be changed while other threads run the kernels.
+ *
+ * \param level requested level; limited to rainSimdDetect()
+ *
+ * \returns selected level
+ */
+RainSimdLevel rainSimdSelect(RainSimdLevel level);
+
+/**
+ * \fn rainAccumulateBatch
+ *
+ * \brief Sensor startup and overflow correction for n gauges (RainGaugeCore::accumulate())
+ *
+ * All arrays are indexed by gauge; results are bit-identical for all levels.
+ *
+ * \param n            number of gauges
+ *
+ * \param rain         rain gauge raw values
+ *
+ * \param startup      sensor startup flags or NULL (no startup)
+ *
+ * \param raingaugeMax overflow value
+ *
+ * \param startupPrev  previous state of startup (in/out)
+ *
+ * \param rainStartup  rain gauge before startup (in/out)
+ *
+ * \param rainPrev     rain gauge at previous run (in/out)
+ *
+ * \param rainOvf      number of rain gauge overflows (in/out)
+ *
+ * \param rainCurr     current accumulated rain gauge values (output)
+ */
+void rainAccumulateBatch(size_t n, const float *rain, const bool *startup, float raingaugeMax,
+                         uint8_t *startupPrev, float *rainStartup, float *rainPrev, uint16_t *rainOvf,
+                         float *rainCurr);
+
+/**
+ * \fn rainCalendarBatch
+ *
+ * \brief Day/week/month rollover for n gauges at common calendar position (RainGaugeCore::calendar())
+ *
+ * All arrays are indexed by gauge; results are bit-identical for all levels.
+ *
+ * \param n              number of gauges
+ *
+ * \param t              local calendar position of all readings
+ *
+ * \param rainCurr       current accumulated rain gauge values
+ *
+ * \param tsDayBegin     day of week at begin of day (in/out)
+ *
+ * \param rainDayBegin   rain gauge at begin of day (in/out)
+ *
+ * \param tsWeekBegin    day of week at begin of week (in/out)
+ *
+ * \param rainWeekBegin  rain gauge at begin of week (in/out)
+ *
+ * \param wdayPrev       day of week at previous run (in/out)
+ *
+ * \param tsMonthBegin   month at begin of month (in/out)
+ *
+ * \param rainMonthBegin rain gauge at begin of month (in/out)
+ */
+void rainCalendarBatch(size_t n, const rainTime_t &t, const float *rainCurr,
+                       uint8_t *tsDayBegin, float *rainDayBegin,
+                       uint8_t *tsWeekBegin, float *rainWeekBegin, uint8_t *wdayPrev,
+                       uint8_t *tsMonthBegin, float *rainMonthBegin);
@@ -0,0 +1,216 @@
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// RainGaugeStats.h
+//
+// Consistent snapshots of rain gauge statistics for readers in other threads
+// (sequence lock; readers never block the writer and take no lock)
+//
+// https://github.com/matthias-bs/BresserWeatherSensorReceiver
+//
+//
+// created: 10/2026
+//
+//
+// MIT License
+//
+// Copyright (c) 2026 Matthias Prinke
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+// History:
+//
+// 20261016 Created
+// 20261016 Added RainGaugeObserver
+// 20261017 Include RainGauge.h for RAINGAUGE_MAX_VALUE
+//
+// ToDo:
+// -
+//
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <stdint.h>
+#include <string.h>
+#include <atomic>
+#include <thread>
+
+#include "RainGauge.h"
+
+/**
+ * \struct RainGaugeStats
+ *
+ * \brief Rain statistics of one gauge at one point in time
+ */
+typedef struct {
+    float     pastHour;     // rainfall during past window
+    float     currentDay;   // rainfall of current calendar day
+    float     currentWeek;  // rainfall of current calendar week
+    float     currentMonth; // rainfall of current calendar month
+} RainGaugeStats;
+
+/**
+ * \class RainGaugeObserver
+ *
+ * \brief Receives the statistics of a rain gauge after each change (e.g. RainTopK)
+ *
+ * changed() is called by the thread updating the rain gauge.
+ */
+class RainGaugeObserver {
+public:
+    virtual ~RainGaugeObserver() {};
+
+    /**
+     * Statistics of rain gauge have been changed
+     *
+     * \param id rain gauge id
+     *
+     * \param s  new statistics
+     */
+    virtual void changed(uint32_t id, const RainGaugeStats &s) = 0;
+};
+
+/**
+ * \class RainStatsCell
+ *
+ * \brief Rain statistics published by one writer thread, read by any number of threads
+ *
+ * \verbatim
+ * Sequence lock:
+ *
+ *   writer: seq = s+1 (odd); store values; seq = s+2 (even)
+ *   reader: s1 = seq; load values; s2 = seq; retry if s1 is odd or s1 != s2
+ * \endverbatim
+ *
+ * The values are stored as atomic words, so concurrent reads are free of data races;
+ * the writer never waits for readers.
+ */
+class RainStatsCell {
+public:
+    RainStatsCell() : seq(0) {
+      for (int i = 0; i < 4; i++) {
+          value[i].store(0, std::memory_order_relaxed);
+      }
+    };
+
+    /**
+     * Publish statistics (single writer thread)
+     */
+    void publish(const RainGaugeStats &s) {
+      uint32_t v[4];
+      uint32_t q = seq.load(std::memory_order_relaxed);
+
+      memcpy(v, &s, sizeof(v));
+      seq.store(q + 1, std::memory_order_relaxed);
+      std::atomic_thread_fence(std::memory_order_release);
+      for (int i = 0; i < 4; i++) {
+          value[i].store(v[i], std::memory_order_relaxed);
+      }
+      seq.store(q + 2, std::memory_order_release);
+    };
+
+    /**
+     * Read statistics once
+     *
+     * \returns false if the writer was active; s is not valid then
+     */
+    bool tryRead(RainGaugeStats &s) const {
+      uint32_t v[4];
+      uint32_t q1 = seq.load(std::memory_order_acquire);
+
+      if (q1 & 1)
+          return false;
+      for (int i = 0; i < 4; i++) {
+          v[i] = value[i].load(std::memory_order_relaxed);
+      }
+      std::atomic_thread_fence(std::memory_order_acquire);
+      if (seq.load(std::memory_order_relaxed) != q1)
+          return false;
+      memcpy(&s, v, sizeof(v));
+      return true;
+    };
+
+    /**
+     * Read consistent statistics (retries while the writer is active)
+     */
+    void read(RainGaugeStats &s) const {
+      while (!tryRead(s)) {
+          std::this_thread::yield();
+      }
+    };
+
+private:
+    static_assert(sizeof(RainGaugeStats) == 4 * sizeof(uint32_t), "RainGaugeStats layout");
+
+    std::atomic<uint32_t> seq;      // even: stable, odd: write in progress
+    std::atomic<uint32_t> value[4]; // RainGaugeStats as 32 bit words
+};
+
+/**
+ * \class RainGaugeSnapshotT
+ *
+ * \brief Single rain gauge (e.g. RainGauge, RainGaugeBucketT) with consistent snapshots
+ *
+ * update() is called by the writer thread and publishes the statistics after each
+ * update; snapshot() can be called from any thread.
+ *
+ * \tparam G rain gauge class
+ */
+template <class G>
+class RainGaugeSnapshotT {
+public:
+    /**
+     * Constructor
+     *
+     * \param g rain gauge (must outlive this object; only updated through this object)
+     */
+    RainGaugeSnapshotT(G &g) : gauge(g) {};
+
+    /**
+     * Update rain gauge (see G::update()) and publish statistics
+     */
+    template <class T>
+    void update(T time, float rain, bool startup = false, float raingaugeMax = RAINGAUGE_MAX_VALUE) {
+      gauge.update(time, rain, startup, raingaugeMax);
+      publish();
+    };
+
+    /**
+     * Publish statistics of rain gauge (e.g. after reset())
+     */
+    void publish(void) {
+      RainGaugeStats s;
+
+      s.pastHour     = gauge.pastHour();
+      s.currentDay   = gauge.currentDay();
+      s.currentWeek  = gauge.currentWeek();
+      s.currentMonth = gauge.currentMonth();
+      cell.publish(s);
+    };
+
+    /**
+     * Consistent statistics as of the most recent update() (any thread)
+     */
+    void snapshot(RainGaugeStats &s) const {
+      cell.read(s);
+    };
+
+private:
+    G            &gauge;
+    RainStatsCell cell;
+};
@@ -0,0 +1,500 @@
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// RainHistory.h
+//
+// Parallel replay of an archive of rain gauge readings, partitioned by gauge and
+// by local calendar month, with sequential stitching at the partition boundaries
+//
+// https://github.com/matthias-bs/BresserWeatherSensorReceiver
+//
+//
+// created: 10/2026
+//
+//
+// MIT License
+//
+// Copyright (c) 2026 Matthias Prinke
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+// History:
+//
+// 20261016 Created
+//
+// ToDo:
+// -
+//
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+
+#pragma once
+
+#include <stdint.h>
+#include <string.h>
+#include <cmath>
+#include <limits>
+#include <vector>
+
+#include "RainGauge.h"
+#include "RainGaugeFleet.h"
+#include "RainWorkPool.h"
+
+/**
+ * \def
+ *
+ * Number of readings per time conversion task of RainHistoryT::replay()
+ */
+#ifndef RAIN_HISTORY_CHUNK
+  #define RAIN_HISTORY_CHUNK 65536
+#endif
+
+/**
+ * \struct RainDayTotal
+ *
+ * \brief Rainfall of one local calendar day, as reported by currentDay() after its last reading
+ */
+typedef struct {
+    int32_t   day;   // days since 1970-01-01 (local date)
+    float     rain;  // currentDay() after last reading of day
+} RainDayTotal;
+
+/**
+ * \class RainHistoryT
+ *
+ * \brief Recomputation of the statistics of many rain gauges from their complete history
+ *
+ * The archive is partitioned by gauge and, within each gauge, into segments of one
+ * local calendar month. The result is the same as updating a reset RainGaugeT with
+ * every reading of a gauge in turn:
+ *
+ * \verbatim
+ * 1. parallel, chunks:   local calendar position of each reading; segment boundaries
+ * 2. parallel, segments: overflows and sensor startup within segment, starting from
+ *                        the previous reading's raw value and startup flag
+ * 3. sequential, gauge:  overflow count and startup value at begin of each segment
+ * 4. parallel, segments: accumulated values, day/week/month baselines and day totals;
+ *                        baselines not reset within the segment are marked as inherited
+ * 5. parallel, gauges:   stitching of inherited baselines across segments; the circular
+ *                        buffer is replayed with the known values (see
+ *                        RainGaugeT::rebuildBuffer()), since its head position depends
+ *                        on all previous readings
+ * \endverbatim
+ *
+ * Step 5 only executes the circular buffer operations per reading, so a single gauge
+ * with a long history is sped up as well.
+ *
+ * A day's baseline is reset whenever the day of week differs from the previous reading,
+ * the week's on a transition from Sunday to Monday and the month's whenever the month
+ * differs from the previous reading (see RainGaugeCore::calendar()).
+ */
+template <unsigned WindowSeconds, unsigned BufSize, unsigned Scale>
+class RainHistoryT {
+public:
+    typedef RainGaugeT<WindowSeconds, BufSize, Scale> Gauge;
+
+    /**
+     * Constructor
+     *
+     * \param gauges  number of rain gauges (ids 0..gauges-1)
+     *
+     * \param threads number of worker threads
+     */
+    RainHistoryT(size_t gauges, unsigned threads) :
+      pool(threads),
+      tz(NULL),
+      nvData(gauges),
+      rainCurr(gauges, 0),
+      dayTotals(gauges)
+    {
+      for (size_t g = 0; g < gauges; g++) {
+          resetGauge(g);
+      }
+    };
+
+    /**
+     * Number of worker threads
+     */
+    unsigned threads(void) const {
+      return pool.size();
+    };
+
+    /**
+     * Timezone of local calendar days
+     *
+     * \param timezone timezone table (must outlive this object) or NULL for libc local time
+     */
+    void  setTimeZone(const TimeZone *timezone) {
+      tz = timezone;
+    };
+
+    /**
+     * \fn replay
+     *
+     * \brief Recompute statistics of all gauges from reset state
+     *
+     * \param n            number of readings
+     *
+     * \param readings     readings; readings of the same gauge must be in chronological order,
+     *                     readings of different gauges may be interleaved
+     *
+     * \param rainGaugeMax overflow value; when reached, the rain gauge is reset to zero
+     *
+     * \returns false if a reading has an invalid id (no statistics are changed)
+     */
+    bool  replay(size_t n, const RainReading *readings, float raingaugeMax = RAINGAUGE_MAX_VALUE);
+
+    /**
+     * Final non-volatile data of rain gauge
+     */
+    const nvDataT<BufSize> &state(uint32_t id) const {
+      return nvData[id];
+    };
+
+    /**
+     * Final accumulated rain gauge value (including overflows)
+     */
+    float current(uint32_t id) const {
+      return rainCurr[id];
+    };
+
+    /**
+     * Rainfall per local calendar day with readings, in chronological order
+     */
+    const std::vector<RainDayTotal> &days(uint32_t id) const {
+      return dayTotals[id];
+    };
+
+    /**
+     * Number of segments (gauge and month) of last replay()
+     */
+    size_t segments(void) const {
+      return segs.size();
+    };
+
+private:
+    /*
+     * Sensor startup and overflow state (see RainGaugeCore::accumulate())
+     */
+    typedef struct {
+        bool      startupPrev;
+        float     rainStartup;
+        float     rainPrev;
+        uint16_t  rainOvf;
+    } Accu;
+
+    /*
+     * Day total with baseline; inherited: baseline was set before the segment
+     */
+    typedef struct {
+        int32_t   day;
+        float     last;
+        float     base;
+        bool      inherited;
+    } DayAcc;
+
+    typedef struct {
+        uint32_t  id;
+        size_t    begin;
+        size_t    end;
+        Accu      entry;       // state before first reading
+        Accu      exit;        // state after last reading (step 2: relative to entry)
+        bool      dayReset;    // baselines reset within segment and their last values
+        float     dayBase;
+        bool      weekReset;
+        float     weekBase;
+        uint8_t   weekWday;
+        bool      monthReset;
+        float     monthBase;
+        std::vector<DayAcc> days;
+    } Segment;
+
+    RainWorkPool              pool;
+    const TimeZone           *tz;
+    std::vector<nvDataT<BufSize> > nvData;
+    std::vector<float>        rainCurr;
+    std::vector<std::vector<RainDayTotal> > dayTotals;
+
+    std::vector<size_t>       offset;   // first reading of each gauge in samples
+    std::vector<rainSample_t> samples;  // readings partitioned by gauge
+    std::vector<rainTime_t>   times;    // local calendar positions of samples
+    std::vector<float>        curr;     // accumulated values of samples
+    std::vector<Segment>      segs;
+    std::vector<size_t>       gaugeSegs; // first segment of each gauge
+
+    void  resetGauge(size_t g) {
+      Gauge gauge(&nvData[g]);
+
+      memset(&nvData[g], 0, sizeof(nvData[g]));
+      gauge.reset();
+      rainCurr[g] = gauge.rainCurr;
+      dayTotals[g].clear();
+    };
+
+    /*
+     * Sensor startup and overflow state before reading i
+     */
+    Accu  previous(size_t i, uint32_t id) const {
+      Accu a = {false, 0, 0, 0};
+
+      if (i > offset[id]) {
+          a.startupPrev = samples[i - 1].startup;
+          a.rainPrev    = samples[i - 1].rain;
+      }
+      return a;
+    };
+
+    void  convert(size_t begin, size_t end, uint32_t id, std::vector<size_t> &starts);
+    void  summarize(Segment &seg, float raingaugeMax);
+    void  replaySegment(Segment &seg, float raingaugeMax);
+    void  finish(uint32_t id);
+};
+
+/**
+ * \typedef RainHistory
+ *
+ * \brief History replay with the parameters of RainGauge
+ */
+typedef RainHistoryT<RAINGAUGE_WINDOW, RAINGAUGE_BUF_SIZE, RAINGAUGE_SCALE> RainHistory;
+
+
+template <unsigned WindowSeconds, unsigned BufSize, unsigned Scale>
+bool
+RainHistoryT<WindowSeconds, BufSize, Scale>::replay(size_t n, const RainReading *readings, float raingaugeMax)
+{
+    size_t gauges = nvData.size();
+
+    // Partition by gauge (stable counting sort)
+    offset.assign(gauges + 1, 0);
+    for (size_t k = 0; k < n; k++) {
+        if (readings[k].id >= gauges)
+            return false;
+        offset[readings[k].id + 1]++;
+    }
+    for (size_t g = 0; g < gauges; g++) {
+        offset[g + 1] += offset[g];
+    }
+    std::vector<size_t> pos(offset.begin(), offset.end() - 1);
+    samples.resize(n);
+    times.resize(n);
+    curr.resize(n);
+    for (size_t k = 0; k < n; k++) {
+        rainSample_t &s = samples[pos[readings[k].id]++];
+        s.epoch   = readings[k].epoch;
+        s.rain    = readings[k].value;
+        s.startup = readings[k].startup;
+    }
+
+    // 1. Calendar positions and segment boundaries
+    std::vector<size_t>   chunkBegin;
+    std::vector<uint32_t> chunkId;
+    for (uint32_t g = 0; g < gauges; g++) {
+        for (size_t b = offset[g]; b < offset[g + 1]; b += RAIN_HISTORY_CHUNK) {
+            chunkBegin.push_back(b);
+            chunkId.push_back(g);
+        }
+    }
+    std::vector<std::vector<size_t> > starts(chunkBegin.size());
+    pool.run(chunkBegin.size(), [this, &chunkBegin, &chunkId, &starts](size_t c) {
+        uint32_t id  = chunkId[c];
+        size_t   end = offset[id + 1];
+        if (end - chunkBegin[c] > RAIN_HISTORY_CHUNK)
+            end = chunkBegin[c] + RAIN_HISTORY_CHUNK;
+        convert(chunkBegin[c], end, id, starts[c]);
+    });
+
+    segs.clear();
+    gaugeSegs.assign(gauges + 1, 0);
+    for (size_t c = 0; c < starts.size(); c++) {
+        for (size_t k = 0; k < starts[c].size(); k++) {
+            Segment seg;
+            seg.id    = chunkId[c];
+            seg.begin = starts[c][k];
+            segs.push_back(seg);
+        }
+    }
+    for (size_t s = 0; s < segs.size(); s++) {
+        bool last = (s + 1 == segs.size()) || (segs[s + 1].id != segs[s].id);
+        segs[s].end = last ? offset[segs[s].id + 1] : segs[s + 1].begin;
+        gaugeSegs[segs[s].id + 1] = s + 1;
+    }
+    for (size_t g = 0; g < gauges; g++) {
+        if (gaugeSegs[g + 1] < gaugeSegs[g])
+            gaugeSegs[g + 1] = gaugeSegs[g];
+    }
+
+    // 2. Overflows and sensor startup within segments
+    pool.run(segs.size(), [this, raingaugeMax](size_t s) {
+        summarize(segs[s], raingaugeMax);
+    });
+
+    // 3. State at begin of segments
+    for (size_t s = 0; s < segs.size(); s++) {
+        if ((s > 0) && (segs[s - 1].id == segs[s].id)) {
+            const Segment &prev = segs[s - 1];
+            segs[s].entry.rainOvf     = prev.exit.rainOvf;
+            segs[s].entry.rainStartup = prev.exit.rainStartup;
+        }
+        // Overflow count modulo 2^16 as in nvDataT; startup value kept if no startup in segment
+        segs[s].exit.rainOvf = (uint16_t)(segs[s].entry.rainOvf + segs[s].exit.rainOvf);
+        if (std::isnan(segs[s].exit.rainStartup)) {
+            segs[s].exit.rainStartup = segs[s].entry.rainStartup;
+        }
+    }
+
+    // 4. Accumulated values, baselines and day totals
+    pool.run(segs.size(), [this, raingaugeMax](size_t s) {
+        replaySegment(segs[s], raingaugeMax);
+    });
+
+    // 5. Stitching and final state per gauge
+    pool.run(gauges, [this](size_t g) {
+        finish((uint32_t)g);
+    });
+
+    return true;
+}
+
+template <unsigned WindowSeconds, unsigned BufSize, unsigned Scale>
+void
+RainHistoryT<WindowSeconds, BufSize, Scale>::convert(size_t begin, size_t end, uint32_t id, std::vector<size_t> &starts)
+{
+    RainClock  clock;
+    rainTime_t prev;
+
+    clock.setTimeZone(tz);
+    if (begin > offset[id]) {
+        clock.fromEpoch(samples[begin - 1].epoch, prev);
+    }
+    for (size_t i = begin; i < end; i++) {
+        clock.fromEpoch(samples[i].epoch, times[i]);
+        if ((i == offset[id]) || (times[i].mon != prev.mon)) {
+            starts.push_back(i);
+        }
+        prev = times[i];
+    }
+}
+
+template <unsigned WindowSeconds, unsigned BufSize, unsigned Scale>
+void
+RainHistoryT<WindowSeconds, BufSize, Scale>::summarize(Segment &seg, float raingaugeMax)
+{
+    seg.entry = previous(seg.begin, seg.id);
+
+    // Relative to entry state; NaN - no sensor startup within segment
+    Accu a = seg.entry;
+    a.rainStartup = std::numeric_limits<float>::quiet_NaN();
+    for (size_t i = seg.begin; i < seg.end; i++) {
+        RainGaugeCore::accumulate(&a, samples[i].rain, samples[i].startup, raingaugeMax);
+    }
+    seg.exit = a;
+}
+
+template <unsigned WindowSeconds, unsigned BufSize, unsigned Scale>
+void
+RainHistoryT<WindowSeconds, BufSize, Scale>::replaySegment(Segment &seg, float raingaugeMax)
+{
+    Accu a = seg.entry;
+
+    seg.dayReset   = false;
+    seg.dayBase    = 0;
+    seg.weekReset  = false;
+    seg.monthReset = false;
+    seg.days.clear();
+    for (size_t i = seg.begin; i < seg.end; i++) {
+        const rainTime_t &t     = times[i];
+        bool              first = (i == offset[seg.id]);
+        float             c     = RainGaugeCore::accumulate(&a, samples[i].rain, samples[i].startup, raingaugeMax);
+
+        curr[i] = c;
+        if (first || (t.wday != times[i - 1].wday)) {
+            seg.dayReset = true;
+            seg.dayBase  = c;
+        }
+        if (first || ((t.wday == 1) && (times[i - 1].wday == 0))) {
+            seg.weekReset = true;
+            seg.weekBase  = c;
+            seg.weekWday  = t.wday;
+        }
+        if (first || (t.mon != times[i - 1].mon)) {
+            seg.monthReset = true;
+            seg.monthBase  = c;
+        }
+        if (first || (t.day != times[i - 1].day)) {
+            DayAcc d = {t.day, c, seg.dayBase, !seg.dayReset};
+            seg.days.push_back(d);
+        } else {
+            seg.days.back().last = c;
+        }
+    }
+}
+
+template <unsigned WindowSeconds, unsigned BufSize, unsigned Scale>
+void
+RainHistoryT<WindowSeconds, BufSize, Scale>::finish(uint32_t id)
+{
+    resetGauge(id);
+    if (offset[id] == offset[id + 1])
+        return;
+
+    // Baselines inherited from previous segments
+    float   dayBase   = 0;
+    float   weekBase  = 0;
+    float   monthBase = 0;
+    uint8_t weekWday  = 0xFF;
+    std::vector<RainDayTotal> &totals = dayTotals[id];
+    for (size_t s = gaugeSegs[id]; s < gaugeSegs[id + 1]; s++) {
+        const Segment &seg = segs[s];
+        for (size_t k = 0; k < seg.days.size(); k++) {
+            const DayAcc &d = seg.days[k];
+            RainDayTotal  total;
+            total.day  = d.day;
+            total.rain = d.last - (d.inherited ? dayBase : d.base);
+            totals.push_back(total);
+        }
+        if (seg.dayReset) {
+            dayBase = seg.dayBase;
+        }
+        if (seg.weekReset) {
+            weekBase = seg.weekBase;
+            weekWday = seg.weekWday;
+        }
+        if (seg.monthReset) {
+            monthBase = seg.monthBase;
+        }
+    }
+
+    // Circular buffer, then the remaining fields as left by the last update
+    size_t            last = offset[id + 1] - 1;
+    const Segment    &seg  = segs[gaugeSegs[id + 1] - 1];
+    nvDataT<BufSize> *nv   = &nvData[id];
+    Gauge             gauge(nv);
+
+    gauge.rebuildBuffer(offset[id + 1] - offset[id], &times[offset[id]], &curr[offset[id]]);
+    nv->startupPrev    = seg.exit.startupPrev;
+    nv->rainStartup    = seg.exit.rainStartup;
+    nv->rainPrev       = seg.exit.rainPrev;
+    nv->rainOvf        = seg.exit.rainOvf;
+    nv->tsDayBegin     = times[last].wday;
+    nv->rainDayBegin   = dayBase;
+    nv->tsWeekBegin    = weekWday;
+    nv->rainWeekBegin  = weekBase;
+    nv->wdayPrev       = times[last].wday;
+    nv->tsMonthBegin   = times[last].mon;
+    nv->rainMonthBegin = monthBase;
+    rainCurr[id]       = curr[last];
+}
@@ -0,0 +1,249 @@
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// RainNvStore.cpp
+//
+// Persistent store for non-volatile rain gauge data (nvDataT records) in a
+// memory-mapped file - a restarted process resumes without replaying readings
+//
+// https://github.com/matthias-bs/BresserWeatherSensorReceiver
+//
+//
+// created: 10/2026
+//
+//
+// MIT License
+//
+// Copyright (c) 2026 Matthias Prinke
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+// History:
+//
+// 20261016 Created
+// 20261016 Added checkpoint LSN to header
+// 20261017 A file without header (crash during creation) is initialized again
+//
+// ToDo:
+// -
+//
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include <string.h>
+
+#include "RainNvStore.h"
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#define RAIN_NV_MMAP
+#endif
+
+static_assert(sizeof(RainNvHeader) == 64, "RainNvHeader layout");
+
+static const char RAIN_NV_MAGIC[4] = {'R', 'G', 'N', 'V'};
+
+RainNvFile::RainNvFile() :
+    fd(-1), base(NULL), length(0), recordSize(0), count(0), isNew(false), policy(RAIN_SYNC_NONE)
+{
+}
+
+RainNvFile::~RainNvFile()
+{
+    close();
+}
+
+#ifdef RAIN_NV_MMAP
+
+/*
+ * Header consists of zero bytes only (never written)
+ */
+static bool
+headerEmpty(const RainNvHeader &hdr)
+{
+    const uint8_t *p = (const uint8_t *)&hdr;
+
+    for (size_t i = 0; i < sizeof(hdr); i++) {
+        if (p[i] != 0)
+            return false;
+    }
+    return true;
+}
+
+bool
+RainNvFile::open(const char *path, uint32_t bufSize, uint32_t recordSize, uint32_t count,
+                 RainSyncPolicy policy)
+{
+    RainNvHeader hdr;
+    struct stat  st;
+
+    close();
+
+    fd = ::open(path, O_RDWR | O_CREAT, 0644);
+    if (fd < 0)
+        return false;
+    if (fstat(fd, &st) != 0) {
+        close();
+        return false;
+    }
+
+    // A file whose header has never been written (crash while creating it) holds no data
+    memset(&hdr, 0, sizeof(hdr));
+    if (((size_t)st.st_size >= sizeof(hdr)) && (pread(fd, &hdr, sizeof(hdr), 0) != (ssize_t)sizeof(hdr))) {
+        close();
+        return false;
+    }
+    isNew = headerEmpty(hdr);
+    if (isNew) {
+        if (count == 0) {
+            close();
+            return false;
+        }
+        memset(&hdr, 0, sizeof(hdr));
+        memcpy(hdr.magic, RAIN_NV_MAGIC, sizeof(hdr.magic));
+        hdr.version    = RAIN_NV_STORE_VERSION;
+        hdr.headerSize = sizeof(RainNvHeader);
+        hdr.bufSize    = bufSize;
+        hdr.recordSize = recordSize;
+        hdr.count      = count;
+        length = sizeof(RainNvHeader) + (size_t)count * recordSize;
+        // Records are zero-filled; header is written last
+        if ((ftruncate(fd, (off_t)length) != 0) ||
+            (pwrite(fd, &hdr, sizeof(hdr), 0) != (ssize_t)sizeof(hdr)) ||
+            (fsync(fd) != 0)) {
+            close();
+            return false;
+        }
+    } else {
+        if ((memcmp(hdr.magic, RAIN_NV_MAGIC, sizeof(hdr.magic)) != 0) ||
+            (hdr.version != RAIN_NV_STORE_VERSION) ||
+            (hdr.headerSize != sizeof(RainNvHeader)) ||
+            (hdr.bufSize != bufSize) ||
+            (hdr.recordSize != recordSize) ||
+            ((count != 0) && (hdr.count != count))) {
+            close();
+            return false;
+        }
+        length = sizeof(RainNvHeader) + (size_t)hdr.count * recordSize;
+        if ((size_t)st.st_size < length) {
+            close();
+            return false;
+        }
+    }
+
+    void *p = mmap(NULL, length, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    if (p == MAP_FAILED) {
+        close();
+        return false;
+    }
+    base             = static_cast<uint8_t *>(p);
+    this->recordSize = recordSize;
+    this->count      = hdr.count;
+    this->policy     = policy;
+    return true;
+}
+
+void
+RainNvFile::close(void)
+{
+    if (base) {
+        munmap(base, length);
+        base = NULL;
+    }
+    if (fd >= 0) {
+        ::close(fd);
+        fd = -1;
+    }
+    length = 0;
+    count  = 0;
+}
+
+bool
+RainNvFile::commit(uint32_t i)
+{
+    if (policy == RAIN_SYNC_NONE)
+        return true;
+
+    // msync() requires a page aligned address
+    size_t page  = (size_t)sysconf(_SC_PAGESIZE);
+    size_t begin = sizeof(RainNvHeader) + (size_t)i * recordSize;
+    size_t end   = begin + recordSize;
+    begin -= begin % page;
+
+    return msync(base + begin, end - begin, (policy == RAIN_SYNC_SYNC) ? MS_SYNC : MS_ASYNC) == 0;
+}
+
+bool
+RainNvFile::flush(void)
+{
+    if (!base)
+        return false;
+    return msync(base, length, MS_SYNC) == 0;
+}
+
+uint64_t
+RainNvFile::lsn(void) const
+{
+    return base ? reinterpret_cast<const RainNvHeader *>(base)->lsn : 0;
+}
+
+void
+RainNvFile::setLsn(uint64_t lsn)
+{
+    if (base)
+        reinterpret_cast<RainNvHeader *>(base)->lsn = lsn;
+}
+
+#else
+
+bool
+RainNvFile::open(const char *, uint32_t, uint32_t, uint32_t, RainSyncPolicy)
+{
+    return false;
+}
+
+void
+RainNvFile::close(void)
+{
+}
+
+bool
+RainNvFile::commit(uint32_t)
+{
+    return false;
+}
+
+bool
+RainNvFile::flush(void)
+{
+    return false;
+}
+
+uint64_t
+RainNvFile::lsn(void) const
+{
+    return 0;
+}
+
+void
+RainNvFile::setLsn(uint64_t)
+{
+}
+
+#endif
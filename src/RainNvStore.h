@@ -0,0 +1,236 @@
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// RainNvStore.h
+//
+// Persistent store for non-volatile rain gauge data (nvDataT records) in a
+// memory-mapped file - a restarted process resumes without replaying readings
+//
+// https://github.com/matthias-bs/BresserWeatherSensorReceiver
+//
+//
+// created: 10/2026
+//
+//
+// MIT License
+//
+// Copyright (c) 2026 Matthias Prinke
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+// History:
+//
+// 20261016 Created
+// 20261016 Added checkpoint LSN to header
+// 20261016 Version 2 - nvDataT::tsPrev
+// 20261017 Files without header are created again
+// 20261017 Version 3 - nvDataT: 16 bit time stamps with tsHigh bitmap
+//
+// ToDo:
+// -
+//
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "RainGauge.h"
+
+/**
+ * \def
+ *
+ * Version of the store file layout (header and nvDataT)
+ */
+#define RAIN_NV_STORE_VERSION 3
+
+/**
+ * \enum RainSyncPolicy
+ *
+ * \brief Write-back of modified records to the store file
+ */
+typedef enum {
+    RAIN_SYNC_NONE,  // left to the operating system - fastest, survives process crash only
+    RAIN_SYNC_ASYNC, // commit() schedules write-back of the record (msync(MS_ASYNC))
+    RAIN_SYNC_SYNC   // commit() waits until the record is written (msync(MS_SYNC)) - durable
+} RainSyncPolicy;
+
+/**
+ * \struct RainNvHeader
+ *
+ * \brief Header at the begin of the store file, followed by the records
+ */
+typedef struct {
+    char      magic[4];    // "RGNV"
+    uint16_t  version;     // RAIN_NV_STORE_VERSION
+    uint16_t  headerSize;  // sizeof(RainNvHeader) - offset of first record
+    uint32_t  bufSize;     // circular buffer size of nvDataT
+    uint32_t  recordSize;  // sizeof(nvDataT<bufSize>)
+    uint32_t  count;       // number of records
+    uint32_t  reserved0;
+    uint64_t  lsn;         // log sequence number of a checkpoint (see RainWal), otherwise 0
+    uint8_t   reserved[32];
+} RainNvHeader;
+
+/**
+ * \class RainNvFile
+ *
+ * \brief Memory-mapped file with header and fixed-size records
+ *
+ * The records are accessed in place; changes reach the file according to the
+ * RainSyncPolicy. Only available on POSIX systems - open() fails elsewhere.
+ */
+class RainNvFile {
+public:
+    RainNvFile();
+
+    /**
+     * Destructor - unmaps the file (modified records are written back by the OS)
+     */
+    ~RainNvFile();
+
+    /**
+     * Open or create store file and map it into memory
+     *
+     * An existing file is only accepted if its header matches version, bufSize
+     * and recordSize. A new file is created with all records set to zero; its
+     * header is written last, so a file with an all-zero header (crash during
+     * creation) is created again.
+     *
+     * \param path       file name
+     * \param bufSize    circular buffer size of the records
+     * \param recordSize size of one record
+     * \param count      number of records; 0 - use count of existing file
+     * \param policy     sync policy of commit()
+     *
+     * \returns true if the file has been mapped
+     */
+    bool  open(const char *path, uint32_t bufSize, uint32_t recordSize, uint32_t count,
+               RainSyncPolicy policy = RAIN_SYNC_NONE);
+
+    /**
+     * Unmap and close file
+     */
+    void  close(void);
+
+    /**
+     * Number of records
+     */
+    uint32_t size(void) const {
+      return count;
+    };
+
+    /**
+     * File has been created by open() - records are zero and have to be reset
+     */
+    bool  created(void) const {
+      return isNew;
+    };
+
+    /**
+     * Log sequence number stored in header
+     */
+    uint64_t lsn(void) const;
+
+    /**
+     * Store log sequence number in header (written back by flush())
+     */
+    void  setLsn(uint64_t lsn);
+
+    /**
+     * Write back record according to sync policy (after it has been modified)
+     *
+     * \param i record index
+     *
+     * \returns false on I/O error
+     */
+    bool  commit(uint32_t i);
+
+    /**
+     * Write back all records and wait for completion (independent of sync policy)
+     *
+     * \returns false on I/O error
+     */
+    bool  flush(void);
+
+protected:
+    /**
+     * Address of record i
+     */
+    void *record(uint32_t i) const {
+      return base + sizeof(RainNvHeader) + (size_t)i * recordSize;
+    };
+
+private:
+    int            fd;
+    uint8_t       *base;
+    size_t         length;
+    uint32_t       recordSize;
+    uint32_t       count;
+    bool           isNew;
+    RainSyncPolicy policy;
+
+    RainNvFile(const RainNvFile &);
+    RainNvFile &operator=(const RainNvFile &);
+};
+
+/**
+ * \class RainNvStoreT
+ *
+ * \brief Array of nvDataT records in a memory-mapped file
+ *
+ * Usage:
+ * \verbatim
+ * RainNvStore store;
+ * store.open("raingauge.nv", GAUGES, RAIN_SYNC_ASYNC);
+ * RainGauge rainGauge(store.data(id));
+ * if (store.created())
+ *     rainGauge.reset();
+ * else
+ *     rainGauge.resume();
+ * ...
+ * rainGauge.update(epoch, rain);
+ * store.commit(id);
+ * \endverbatim
+ *
+ * \tparam BufSize size of circular buffer for rainfall during past window
+ */
+template <unsigned BufSize>
+class RainNvStoreT : public RainNvFile {
+public:
+    /**
+     * Open or create store file (see RainNvFile::open())
+     */
+    bool  open(const char *path, uint32_t count, RainSyncPolicy policy = RAIN_SYNC_NONE) {
+      return RainNvFile::open(path, BufSize, sizeof(nvDataT<BufSize>), count, policy);
+    };
+
+    /**
+     * Non-volatile data of rain gauge i (valid until close())
+     */
+    nvDataT<BufSize> *data(uint32_t i) const {
+      return static_cast<nvDataT<BufSize> *>(record(i));
+    };
+};
+
+/**
+ * \typedef RainNvStore
+ *
+ * \brief Store for the non-volatile data of RainGauge
+ */
+typedef RainNvStoreT<RAINGAUGE_BUF_SIZE> RainNvStore;
@@ -0,0 +1,303 @@
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// RainQueue.h
+//
+// Bounded lock-free ring queues for rain gauge readings:
+// single-producer/single-consumer (Lamport) and multi-producer/single-consumer
+// (Vyukov) variants with batch dequeue and back-pressure reporting.
+//
+// https://github.com/matthias-bs/BresserWeatherSensorReceiver
+//
+//
+// created: 10/2026
+//
+//
+// MIT License
+//
+// Copyright (c) 2026 Matthias Prinke
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+// History:
+//
+// 20261016 Created
+// 20261017 Explicit padding instead of alignas (queues are allocated with new)
+//
+// ToDo:
+// -
+//
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+#include <atomic>
+#include <vector>
+
+/**
+ * \def
+ *
+ * Assumed cache line size - producer and consumer indices are kept apart
+ *
+ * The indices are separated by padding of this size rather than by alignas(): before
+ * C++17, new does not honour the alignment of over-aligned types.
+ */
+#define RAIN_QUEUE_CACHE_LINE 64
+
+/**
+ * Smallest power of two >= n (at least 2)
+ */
+static inline size_t rainQueueCapacity(size_t n)
+{
+    size_t c = 2;
+    while (c < n) {
+        c <<= 1;
+    }
+    return c;
+}
+
+/**
+ * \class RainSpscQueue
+ *
+ * \brief Bounded lock-free queue, one producer thread and one consumer thread
+ *
+ * Lamport ring buffer with free running indices; each side caches the other
+ * side's index, so the shared cache lines are only read when the queue
+ * appears to be full (producer) or empty (consumer).
+ *
+ * \tparam T element type (trivially copyable)
+ */
+template <class T>
+class RainSpscQueue {
+public:
+    /**
+     * Constructor
+     *
+     * \param capacity minimum number of elements; rounded up to a power of two
+     */
+    RainSpscQueue(size_t capacity) :
+      buf(rainQueueCapacity(capacity)), mask(rainQueueCapacity(capacity) - 1),
+      head(0), tailCache(0), tail(0), headCache(0), rejectCount(0)
+    {};
+
+    /**
+     * Number of elements the queue can hold
+     */
+    size_t capacity(void) const {
+      return mask + 1;
+    };
+
+    /**
+     * Append element (producer)
+     *
+     * \returns false if the queue is full (back-pressure); the element is not queued
+     */
+    bool push(const T &v) {
+      size_t t = tail.load(std::memory_order_relaxed);
+      if (t - headCache > mask) {
+          headCache = head.load(std::memory_order_acquire);
+          if (t - headCache > mask) {
+              rejectCount.fetch_add(1, std::memory_order_relaxed);
+              return false;
+          }
+      }
+      buf[t & mask] = v;
+      tail.store(t + 1, std::memory_order_release);
+      return true;
+    };
+
+    /**
+     * Remove up to max elements (consumer)
+     *
+     * \param out destination
+     *
+     * \param max maximum number of elements
+     *
+     * \returns number of elements removed
+     */
+    size_t popBatch(T *out, size_t max) {
+      size_t h = head.load(std::memory_order_relaxed);
+      if (tailCache - h < max) {
+          tailCache = tail.load(std::memory_order_acquire);
+      }
+      size_t n = tailCache - h;
+      if (n > max)
+          n = max;
+      for (size_t i = 0; i < n; i++) {
+          out[i] = buf[(h + i) & mask];
+      }
+      head.store(h + n, std::memory_order_release);
+      return n;
+    };
+
+    /**
+     * Number of queued elements (approximate if called concurrently)
+     */
+    size_t size(void) const {
+      return tail.load(std::memory_order_acquire) - head.load(std::memory_order_acquire);
+    };
+
+    /**
+     * Number of elements rejected by push() because the queue was full
+     */
+    uint64_t rejected(void) const {
+      return rejectCount.load(std::memory_order_relaxed);
+    };
+
+private:
+    std::vector<T> buf;
+    const size_t   mask;
+    char           pad0[RAIN_QUEUE_CACHE_LINE];
+
+    /* consumer */
+    std::atomic<size_t> head;
+    size_t         tailCache; // consumer's copy of tail
+    char           pad1[RAIN_QUEUE_CACHE_LINE];
+
+    /* producer */
+    std::atomic<size_t> tail;
+    size_t         headCache; // producer's copy of head
+    std::atomic<uint64_t> rejectCount;
+    char           pad2[RAIN_QUEUE_CACHE_LINE];
+};
+
+/**
+ * \class RainMpscQueue
+ *
+ * \brief Bounded lock-free queue, any number of producer threads and one consumer thread
+ *
+ * Dmitry Vyukov's bounded queue: each cell carries a sequence number which tells
+ * producers and the consumer whether the cell is free or filled for the current lap.
+ * Producers claim a cell with one compare-and-swap; the consumer needs none.
+ * Elements pushed by one producer are dequeued in their push order.
+ *
+ * \tparam T element type (trivially copyable)
+ */
+template <class T>
+class RainMpscQueue {
+public:
+    /**
+     * Constructor
+     *
+     * \param capacity minimum number of elements; rounded up to a power of two
+     */
+    RainMpscQueue(size_t capacity) :
+      cells(rainQueueCapacity(capacity)), mask(rainQueueCapacity(capacity) - 1),
+      enqueuePos(0), dequeuePos(0), rejectCount(0)
+    {
+      for (size_t i = 0; i <= mask; i++) {
+          cells[i].seq.store(i, std::memory_order_relaxed);
+      }
+    };
+
+    /**
+     * Number of elements the queue can hold
+     */
+    size_t capacity(void) const {
+      return mask + 1;
+    };
+
+    /**
+     * Append element (any producer thread)
+     *
+     * \returns false if the queue is full (back-pressure); the element is not queued
+     */
+    bool push(const T &v) {
+      Cell  *cell;
+      size_t pos = enqueuePos.load(std::memory_order_relaxed);
+      for (;;) {
+          cell = &cells[pos & mask];
+          size_t   seq = cell->seq.load(std::memory_order_acquire);
+          intptr_t dif = (intptr_t)seq - (intptr_t)pos;
+          if (dif == 0) {
+              // Cell is free in this lap - claim it
+              if (enqueuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+                  break;
+          } else if (dif < 0) {
+              // Cell still holds the element of the previous lap - full
+              rejectCount.fetch_add(1, std::memory_order_relaxed);
+              return false;
+          } else {
+              pos = enqueuePos.load(std::memory_order_relaxed);
+          }
+      }
+      cell->data = v;
+      cell->seq.store(pos + 1, std::memory_order_release);
+      return true;
+    };
+
+    /**
+     * Remove up to max elements (consumer)
+     *
+     * Stops at the first cell which has been claimed, but not yet filled by its producer.
+     *
+     * \param out destination
+     *
+     * \param max maximum number of elements
+     *
+     * \returns number of elements removed
+     */
+    size_t popBatch(T *out, size_t max) {
+      size_t pos = dequeuePos.load(std::memory_order_relaxed);
+      size_t n   = 0;
+      while (n < max) {
+          Cell *cell = &cells[pos & mask];
+          if (cell->seq.load(std::memory_order_acquire) != pos + 1)
+              break;
+          out[n++] = cell->data;
+          // Free cell for the next lap
+          cell->seq.store(pos + mask + 1, std::memory_order_release);
+          pos++;
+      }
+      dequeuePos.store(pos, std::memory_order_relaxed);
+      return n;
+    };
+
+    /**
+     * Number of queued elements (approximate if called concurrently)
+     */
+    size_t size(void) const {
+      size_t e = enqueuePos.load(std::memory_order_relaxed);
+      size_t d = dequeuePos.load(std::memory_order_relaxed);
+      return (e > d) ? e - d : 0;
+    };
+
+    /**
+     * Number of elements rejected by push() because the queue was full
+     */
+    uint64_t rejected(void) const {
+      return rejectCount.load(std::memory_order_relaxed);
+    };
+
+private:
+    struct Cell {
+      std::atomic<size_t> seq;
+      T                   data;
+    };
+
+    std::vector<Cell> cells;
+    const size_t      mask;
+    char              pad0[RAIN_QUEUE_CACHE_LINE];
+
+    std::atomic<size_t> enqueuePos; // producers
+    char              pad1[RAIN_QUEUE_CACHE_LINE];
+    std::atomic<size_t> dequeuePos; // consumer (written only by the consumer)
+    std::atomic<uint64_t> rejectCount;
+    char              pad2[RAIN_QUEUE_CACHE_LINE];
+};
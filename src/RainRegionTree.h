@@ -0,0 +1,202 @@
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// RainRegionTree.h
+//
+// Hierarchical regional rollups (e.g. catchment, region, country) of rain gauge
+// statistics, maintained incrementally on every rain gauge update
+//
+// https://github.com/matthias-bs/BresserWeatherSensorReceiver
+//
+//
+// created: 10/2026
+//
+//
+// MIT License
+//
+// Copyright (c) 2026 Matthias Prinke
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+// History:
+//
+// 20261016 Created
+//
+// ToDo:
+// -
+//
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+#include <vector>
+
+#include "RainGaugeStats.h"
+
+/**
+ * \def
+ *
+ * Region of rain gauges which are not assigned to any region (and parent of the root)
+ */
+#define RAIN_REGION_NONE 0xFFFFFFFFu
+
+/**
+ * \class RainRegionTree
+ *
+ * \brief Tree of regions with the sums of the statistics of their rain gauges
+ *
+ * Region 0 is the root (all assigned rain gauges). Every change of a rain gauge
+ * adds the difference to its previous statistics to its region and all ancestors,
+ * so the cost per update is bounded by the depth of the tree and total() is O(1).
+ * Totals are accumulated in double precision.
+ *
+ * Register with RainGaugeFleetT::addObserver(). Not thread-safe: updates and
+ * queries must be serialized by the caller.
+ */
+class RainRegionTree : public RainGaugeObserver {
+public:
+    /**
+     * Constructor - creates the root region
+     *
+     * \param gauges number of rain gauges (ids 0..gauges-1)
+     */
+    RainRegionTree(size_t gauges) : gaugeRegion(gauges, RAIN_REGION_NONE), gaugeStats(gauges) {
+      Node root = {RAIN_REGION_NONE, 0, 0, {0, 0, 0, 0}};
+      nodes.push_back(root);
+    };
+
+    /**
+     * Add region
+     *
+     * \param parent parent region
+     *
+     * \returns region id
+     */
+    uint32_t addRegion(uint32_t parent) {
+      Node n = {parent, (uint16_t)(nodes[parent].depth + 1), 0, {0, 0, 0, 0}};
+      nodes.push_back(n);
+      return (uint32_t)(nodes.size() - 1);
+    };
+
+    /**
+     * Assign rain gauge to region (moves its statistics from the previous region)
+     *
+     * A rain gauge contributes the statistics of its last change seen by the tree,
+     * so gauges should be assigned before the observer is registered.
+     *
+     * \param id     rain gauge id
+     * \param region region id or RAIN_REGION_NONE
+     */
+    void  assign(uint32_t id, uint32_t region) {
+      const RainGaugeStats &s = gaugeStats[id];
+      double d[4] = {s.pastHour, s.currentDay, s.currentWeek, s.currentMonth};
+
+      if (gaugeRegion[id] != RAIN_REGION_NONE) {
+          double neg[4] = {-d[0], -d[1], -d[2], -d[3]};
+          propagate(gaugeRegion[id], neg, -1);
+      }
+      gaugeRegion[id] = region;
+      propagate(region, d, 1);
+    };
+
+    /**
+     * Observer interface
+     */
+    virtual void changed(uint32_t id, const RainGaugeStats &s) {
+      RainGaugeStats &old = gaugeStats[id];
+      double d[4] = {
+          (double)s.pastHour - old.pastHour,
+          (double)s.currentDay - old.currentDay,
+          (double)s.currentWeek - old.currentWeek,
+          (double)s.currentMonth - old.currentMonth
+      };
+
+      old = s;
+      propagate(gaugeRegion[id], d, 0);
+    };
+
+    /**
+     * Sums of the statistics of all rain gauges in region and its sub-regions
+     *
+     * \param region region id
+     * \param s      sums (output)
+     */
+    void  total(uint32_t region, RainGaugeStats &s) const {
+      const Node &n = nodes[region];
+
+      s.pastHour     = (float)n.sum[0];
+      s.currentDay   = (float)n.sum[1];
+      s.currentWeek  = (float)n.sum[2];
+      s.currentMonth = (float)n.sum[3];
+    };
+
+    /**
+     * Number of rain gauges in region and its sub-regions
+     */
+    uint32_t gauges(uint32_t region) const {
+      return nodes[region].gauges;
+    };
+
+    /**
+     * Parent of region (RAIN_REGION_NONE for the root)
+     */
+    uint32_t parent(uint32_t region) const {
+      return nodes[region].parent;
+    };
+
+    /**
+     * Depth of region (0 for the root)
+     */
+    unsigned depth(uint32_t region) const {
+      return nodes[region].depth;
+    };
+
+    /**
+     * Number of regions
+     */
+    size_t regions(void) const {
+      return nodes.size();
+    };
+
+private:
+    struct Node {
+      uint32_t parent;
+      uint16_t depth;
+      uint32_t gauges;
+      double   sum[4]; // pastHour, currentDay, currentWeek, currentMonth
+    };
+
+    std::vector<Node>           nodes;
+    std::vector<uint32_t>       gaugeRegion;
+    std::vector<RainGaugeStats> gaugeStats;
+
+    /**
+     * Add d to the sums and count to the gauge counters of region and its ancestors
+     */
+    void  propagate(uint32_t region, const double d[4], int count) {
+      for (uint32_t r = region; r != RAIN_REGION_NONE; r = nodes[r].parent) {
+          Node &n = nodes[r];
+          n.sum[0] += d[0];
+          n.sum[1] += d[1];
+          n.sum[2] += d[2];
+          n.sum[3] += d[3];
+          n.gauges += count;
+      }
+    };
+};
@@ -0,0 +1,223 @@
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// RainReorder.h
+//
+// Bounded reorder stage for out-of-order and late-arriving rain gauge readings:
+// readings are held back until they are older than a lateness horizon and
+// released in chronological order.
+//
+// https://github.com/matthias-bs/BresserWeatherSensorReceiver
+//
+//
+// created: 10/2026
+//
+//
+// MIT License
+//
+// Copyright (c) 2026 Matthias Prinke
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+// History:
+//
+// 20261016 Created
+//
+// ToDo:
+// -
+//
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+#include <time.h>
+#include <algorithm>
+#include <limits>
+#include <vector>
+
+#include "RainGaugeFleet.h"
+
+/**
+ * \class RainReorderBuffer
+ *
+ * \brief Sorts readings which arrive out of order before they reach update()
+ *
+ * RainGaugeT::update() requires chronological order: an older time stamp is taken
+ * as a wrap of the hourly ring buffer and a lower value as an overflow of the rain
+ * gauge. Radio retransmissions, however, deliver readings seconds to minutes late.
+ *
+ * Readings are held in a min-heap ordered by time stamp (ties by arrival) and
+ * released by pop() once they are older than the watermark, i.e. the newest time
+ * stamp seen minus the lateness horizon. A reading which arrives after a newer
+ * reading of the same gauge has already been released cannot be put into order
+ * any more; push() drops it and counts it in late().
+ *
+ * The buffer is bounded: if more than capacity readings are held back, pop()
+ * releases the oldest ones before the watermark has passed them.
+ *
+ * Not thread-safe; one buffer per consumer (e.g. per shard of RainGaugeShardsT).
+ *
+ * \verbatim
+ * Cost: push() and pop() O(log held), memory 8 bytes per gauge + 32 bytes per held reading
+ * \endverbatim
+ */
+class RainReorderBuffer {
+public:
+    /**
+     * Constructor
+     *
+     * \param gauges   number of rain gauges (ids 0..gauges-1)
+     *
+     * \param horizon  lateness horizon in seconds; 0 - sort only within a batch
+     *
+     * \param capacity maximum number of readings held back
+     */
+    RainReorderBuffer(size_t gauges, uint32_t horizon, size_t capacity = 65536) :
+      horizonSec(horizon),
+      cap(capacity > 0 ? capacity : 1),
+      newest(std::numeric_limits<time_t>::min()),
+      seq(0),
+      nLate(0),
+      released(gauges, std::numeric_limits<time_t>::min())
+    {
+      heap.reserve(cap + 1);
+    };
+
+    /**
+     * \fn push
+     *
+     * \brief Add reading
+     *
+     * \param r reading; r.id < gauges
+     *
+     * \returns false if the reading was dropped (invalid id or too late)
+     */
+    bool  push(const RainReading &r) {
+      if (r.id >= released.size())
+          return false;
+      if (r.epoch < released[r.id]) {
+          nLate++;
+          return false;
+      }
+      Entry e = {r, seq++};
+      heap.push_back(e);
+      std::push_heap(heap.begin(), heap.end(), later);
+      if (r.epoch > newest)
+          newest = r.epoch;
+      return true;
+    };
+
+    /**
+     * \fn pop
+     *
+     * \brief Release readings older than the watermark (or beyond capacity)
+     *
+     * \param out readings in chronological order
+     *
+     * \param max size of out
+     *
+     * \returns number of readings released
+     */
+    size_t pop(RainReading *out, size_t max) {
+      return release(out, max, false);
+    };
+
+    /**
+     * \fn flush
+     *
+     * \brief Release all readings held back (e.g. at end of input)
+     *
+     * \param out readings in chronological order
+     *
+     * \param max size of out
+     *
+     * \returns number of readings released
+     */
+    size_t flush(RainReading *out, size_t max) {
+      return release(out, max, true);
+    };
+
+    /**
+     * Number of readings held back
+     */
+    size_t size(void) const {
+      return heap.size();
+    };
+
+    /**
+     * Number of readings dropped because they arrived too late
+     */
+    uint64_t late(void) const {
+      return nLate;
+    };
+
+    /**
+     * Lateness horizon in seconds
+     */
+    uint32_t horizon(void) const {
+      return horizonSec;
+    };
+
+    /**
+     * Readings with a time stamp up to the watermark are released by pop()
+     */
+    time_t watermark(void) const {
+      if (newest < std::numeric_limits<time_t>::min() + (time_t)horizonSec)
+          return std::numeric_limits<time_t>::min();
+      return newest - (time_t)horizonSec;
+    };
+
+private:
+    typedef struct {
+        RainReading reading;
+        uint64_t    seq;       // arrival order, keeps readings with equal time stamps stable
+    } Entry;
+
+    /*
+     * Heap order: std::push_heap() builds a max-heap, so "less" means "later"
+     */
+    static bool later(const Entry &a, const Entry &b) {
+      return (a.reading.epoch > b.reading.epoch) ||
+             ((a.reading.epoch == b.reading.epoch) && (a.seq > b.seq));
+    };
+
+    size_t release(RainReading *out, size_t max, bool all) {
+      time_t mark = watermark();
+      size_t n    = 0;
+
+      while ((n < max) && !heap.empty() &&
+             (all || (heap.front().reading.epoch <= mark) || (heap.size() > cap))) {
+          std::pop_heap(heap.begin(), heap.end(), later);
+          out[n] = heap.back().reading;
+          released[out[n].id] = out[n].epoch;
+          heap.pop_back();
+          n++;
+      }
+      return n;
+    };
+
+    uint32_t              horizonSec;
+    size_t                cap;
+    time_t                newest;   // newest time stamp seen
+    uint64_t              seq;
+    uint64_t              nLate;
+    std::vector<Entry>    heap;
+    std::vector<time_t>   released; // time stamp of last released reading per gauge
+};
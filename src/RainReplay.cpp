@@ -0,0 +1,439 @@
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// RainReplay.cpp
+//
+// Replay of recorded rain gauge readings: memory-mapped input file and parser for
+// CSV and JSON lines (no per-line allocation, no strptime())
+//
+// https://github.com/matthias-bs/BresserWeatherSensorReceiver
+//
+//
+// created: 10/2026
+//
+//
+// MIT License
+//
+// Copyright (c) 2026 Matthias Prinke
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+// History:
+//
+// 20261016 Created
+//
+// ToDo:
+// -
+//
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include <string.h>
+
+#include "CivilTime.h"
+#include "RainReplay.h"
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#define RAIN_REPLAY_MMAP
+#endif
+
+RainMappedFile::RainMappedFile() : base(NULL), length(0)
+{
+}
+
+RainMappedFile::~RainMappedFile()
+{
+    close();
+}
+
+#ifdef RAIN_REPLAY_MMAP
+
+bool
+RainMappedFile::open(const char *path)
+{
+    struct stat st;
+
+    close();
+    int fd = ::open(path, O_RDONLY);
+    if (fd < 0)
+        return false;
+    if (fstat(fd, &st) != 0) {
+        ::close(fd);
+        return false;
+    }
+    if (st.st_size > 0) {
+        void *p = mmap(NULL, (size_t)st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (p == MAP_FAILED) {
+            ::close(fd);
+            return false;
+        }
+        // The file is read once from begin to end
+        madvise(p, (size_t)st.st_size, MADV_SEQUENTIAL);
+        base   = static_cast<const char *>(p);
+        length = (size_t)st.st_size;
+    }
+    // The mapping stays valid after closing the file descriptor
+    ::close(fd);
+    return true;
+}
+
+void
+RainMappedFile::close(void)
+{
+    if (base) {
+        munmap(const_cast<char *>(base), length);
+    }
+    base   = NULL;
+    length = 0;
+}
+
+#else
+
+bool
+RainMappedFile::open(const char *)
+{
+    return false;
+}
+
+void
+RainMappedFile::close(void)
+{
+}
+
+#endif
+
+static inline bool
+isDigit(char c)
+{
+    return (c >= '0') && (c <= '9');
+}
+
+static inline void
+skipSpace(const char *&p, const char *end)
+{
+    while ((p < end) && ((*p == ' ') || (*p == '\t'))) {
+        p++;
+    }
+}
+
+/*
+ * Parse unsigned integer with exactly/at most digits
+ */
+static bool
+parseDigits(const char *&p, const char *end, unsigned minDigits, unsigned maxDigits, int64_t &v)
+{
+    unsigned n = 0;
+    v = 0;
+    while ((p < end) && isDigit(*p) && (n < maxDigits)) {
+        v = v * 10 + (*p - '0');
+        p++;
+        n++;
+    }
+    return n >= minDigits;
+}
+
+/*
+ * Parse literal (e.g. "true")
+ */
+static bool
+parseLiteral(const char *&p, const char *end, const char *lit)
+{
+    size_t n = strlen(lit);
+    if (((size_t)(end - p) < n) || (memcmp(p, lit, n) != 0))
+        return false;
+    p += n;
+    return true;
+}
+
+/*
+ * Parse startup flag (0, 1, false, true)
+ */
+static bool
+parseFlag(const char *&p, const char *end, bool &flag)
+{
+    if ((p < end) && ((*p == '0') || (*p == '1'))) {
+        flag = (*p == '1');
+        p++;
+        return true;
+    }
+    if (parseLiteral(p, end, "true")) {
+        flag = true;
+        return true;
+    }
+    if (parseLiteral(p, end, "false")) {
+        flag = false;
+        return true;
+    }
+    return false;
+}
+
+bool
+RainReplayParser::parseNumber(const char *&p, const char *end, double &v)
+{
+    static const double scale[] = {
+        1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9,
+        1e10, 1e11, 1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18
+    };
+    bool     neg = false;
+    uint64_t mant = 0;
+    unsigned digits = 0;
+    unsigned frac = 0;
+
+    if ((p < end) && (*p == '-')) {
+        neg = true;
+        p++;
+    }
+    while ((p < end) && isDigit(*p)) {
+        if (digits < 18) {
+            mant = mant * 10 + (uint64_t)(*p - '0');
+            digits++;
+        } else {
+            return false;
+        }
+        p++;
+    }
+    if ((p < end) && (*p == '.')) {
+        p++;
+        while ((p < end) && isDigit(*p)) {
+            // Further digits are beyond float precision
+            if (digits < 18) {
+                mant = mant * 10 + (uint64_t)(*p - '0');
+                digits++;
+                frac++;
+            }
+            p++;
+        }
+    }
+    if (digits == 0)
+        return false;
+    v = (double)mant / scale[frac];
+    if (neg)
+        v = -v;
+    return true;
+}
+
+bool
+RainReplayParser::parseTime(const char *&p, const char *end, time_t &t)
+{
+    bool    quoted = (p < end) && (*p == '"');
+    int64_t v;
+
+    if (quoted)
+        p++;
+
+    const char *begin = p;
+    if (!parseDigits(p, end, 1, 12, v))
+        return false;
+
+    if ((p - begin == 4) && (p < end) && (*p == '-')) {
+        // YYYY-MM-DD[T| ]HH:MM[:SS][.fff][Z]
+        int64_t year = v, mon, day, hour, min, sec = 0;
+        p++;
+        if (!parseDigits(p, end, 2, 2, mon) || (p >= end) || (*p++ != '-') ||
+            !parseDigits(p, end, 2, 2, day) || (p >= end) || ((*p != 'T') && (*p != ' ')))
+            return false;
+        p++;
+        if (!parseDigits(p, end, 2, 2, hour) || (p >= end) || (*p++ != ':') ||
+            !parseDigits(p, end, 2, 2, min))
+            return false;
+        if ((p < end) && (*p == ':')) {
+            p++;
+            if (!parseDigits(p, end, 2, 2, sec))
+                return false;
+            if ((p < end) && (*p == '.')) {
+                p++;
+                while ((p < end) && isDigit(*p)) {
+                    p++;
+                }
+            }
+        }
+        if ((p < end) && (*p == 'Z'))
+            p++;
+        if ((mon < 1) || (mon > 12) || (day < 1) || (day > 31) || (hour > 23) || (min > 59) || (sec > 60))
+            return false;
+        t = (time_t)((int64_t)daysFromCivil((int32_t)year, (int32_t)mon, (int32_t)day) * CIVIL_SECONDS_PER_DAY +
+                     hour * CIVIL_SECONDS_PER_HOUR + min * CIVIL_SECONDS_PER_MINUTE + sec);
+    } else {
+        t = (time_t)v;
+    }
+
+    if (quoted) {
+        if ((p >= end) || (*p != '"'))
+            return false;
+        p++;
+    }
+    return true;
+}
+
+bool
+RainReplayParser::parseCsv(const char *p, const char *end, RainReading &r) const
+{
+    double a, b;
+
+    if (!parseTime(p, end, r.epoch))
+        return false;
+    skipSpace(p, end);
+    if ((p >= end) || (*p++ != ','))
+        return false;
+    skipSpace(p, end);
+    if (!parseNumber(p, end, a))
+        return false;
+    skipSpace(p, end);
+
+    r.startup = false;
+    if ((p < end) && (*p == ',')) {
+        p++;
+        skipSpace(p, end);
+        if (!parseNumber(p, end, b) || (a < 0))
+            return false;
+        r.id    = (uint32_t)a;
+        r.value = (float)b;
+        skipSpace(p, end);
+        if ((p < end) && (*p == ',')) {
+            p++;
+            skipSpace(p, end);
+            if (!parseFlag(p, end, r.startup))
+                return false;
+            skipSpace(p, end);
+        }
+    } else {
+        r.id    = 0;
+        r.value = (float)a;
+    }
+    return p == end;
+}
+
+bool
+RainReplayParser::parseJson(const char *p, const char *end, RainReading &r) const
+{
+    bool   haveTime = false;
+    bool   haveValue = false;
+    double v;
+
+    r.id      = 0;
+    r.startup = false;
+
+    p++; // '{'
+    for (;;) {
+        skipSpace(p, end);
+        if ((p < end) && (*p == '}'))
+            break;
+        // Key
+        if ((p >= end) || (*p++ != '"'))
+            return false;
+        const char *key = p;
+        while ((p < end) && (*p != '"')) {
+            p++;
+        }
+        if (p >= end)
+            return false;
+        size_t keyLen = (size_t)(p - key);
+        p++;
+        skipSpace(p, end);
+        if ((p >= end) || (*p++ != ':'))
+            return false;
+        skipSpace(p, end);
+
+        // Value
+        if (((keyLen == 4) && (memcmp(key, "time", 4) == 0)) ||
+            ((keyLen == 2) && (memcmp(key, "ts", 2) == 0)) ||
+            ((keyLen == 5) && (memcmp(key, "epoch", 5) == 0))) {
+            if (!parseTime(p, end, r.epoch))
+                return false;
+            haveTime = true;
+        } else if ((keyLen == 2) && (memcmp(key, "id", 2) == 0)) {
+            if (!parseNumber(p, end, v) || (v < 0))
+                return false;
+            r.id = (uint32_t)v;
+        } else if (((keyLen == 5) && (memcmp(key, "value", 5) == 0)) ||
+                   ((keyLen == 4) && (memcmp(key, "rain", 4) == 0))) {
+            if (!parseNumber(p, end, v))
+                return false;
+            r.value = (float)v;
+            haveValue = true;
+        } else if ((keyLen == 7) && (memcmp(key, "startup", 7) == 0)) {
+            if (!parseFlag(p, end, r.startup))
+                return false;
+        } else if ((p < end) && (*p == '"')) {
+            // Skip string
+            p++;
+            while ((p < end) && (*p != '"')) {
+                p += (*p == '\\') ? 2 : 1;
+            }
+            if (p >= end)
+                return false;
+            p++;
+        } else {
+            // Skip number or literal
+            while ((p < end) && (*p != ',') && (*p != '}')) {
+                p++;
+            }
+        }
+
+        skipSpace(p, end);
+        if ((p < end) && (*p == ','))
+            p++;
+        else if ((p >= end) || (*p != '}'))
+            return false;
+    }
+    return haveTime && haveValue;
+}
+
+size_t
+RainReplayParser::parse(const char *&pos, const char *end, RainReading *out, size_t max, bool last)
+{
+    const char *p = pos;
+    size_t      n = 0;
+
+    while ((n < max) && (p < end)) {
+        const char *eol = static_cast<const char *>(memchr(p, '\n', (size_t)(end - p)));
+        if (!eol) {
+            if (!last)
+                break;
+            eol = end;
+        }
+        const char *lineEnd = eol;
+        if ((lineEnd > p) && (lineEnd[-1] == '\r'))
+            lineEnd--;
+        lineCount++;
+
+        const char *q = p;
+        skipSpace(q, lineEnd);
+        if ((q == lineEnd) || (*q == '#')) {
+            // Empty line or comment
+        } else if (*q == '{') {
+            if (parseJson(q, lineEnd, out[n]))
+                n++;
+            else
+                errorCount++;
+        } else if (isDigit(*q) || (*q == '"')) {
+            if (parseCsv(q, lineEnd, out[n]))
+                n++;
+            else
+                errorCount++;
+        } else if (lineCount > 1) {
+            // Only the first line may be a CSV header
+            errorCount++;
+        }
+        p = (eol < end) ? eol + 1 : end;
+    }
+    pos = p;
+    return n;
+}
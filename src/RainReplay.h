@@ -0,0 +1,170 @@
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// RainReplay.h
+//
+// Replay of recorded rain gauge readings: memory-mapped input file and parser for
+// CSV and JSON lines (no per-line allocation, no strptime())
+//
+// https://github.com/matthias-bs/BresserWeatherSensorReceiver
+//
+//
+// created: 10/2026
+//
+//
+// MIT License
+//
+// Copyright (c) 2026 Matthias Prinke
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+// History:
+//
+// 20261016 Created
+//
+// ToDo:
+// -
+//
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+#include <time.h>
+
+#include "RainGaugeFleet.h"
+
+/**
+ * \class RainMappedFile
+ *
+ * \brief Read-only memory-mapped file
+ *
+ * Only available on POSIX systems - open() fails elsewhere.
+ */
+class RainMappedFile {
+public:
+    RainMappedFile();
+    ~RainMappedFile();
+
+    /**
+     * Map file
+     *
+     * \returns true on success (also for an empty file)
+     */
+    bool  open(const char *path);
+
+    /**
+     * Unmap file
+     */
+    void  close(void);
+
+    /**
+     * File contents
+     */
+    const char *data(void) const {
+      return base;
+    };
+
+    /**
+     * File size
+     */
+    size_t size(void) const {
+      return length;
+    };
+
+private:
+    const char *base;
+    size_t      length;
+
+    RainMappedFile(const RainMappedFile &);
+    RainMappedFile &operator=(const RainMappedFile &);
+};
+
+/**
+ * \class RainReplayParser
+ *
+ * \brief Parser for recorded readings, one per line
+ *
+ * \verbatim
+ * CSV:        <time>,<id>,<value>[,<startup>]
+ *             <time>,<value>                      (rain gauge id 0)
+ * JSON lines: {"time": <time>, "id": <id>, "value": <value>, "startup": <startup>}
+ *             (keys in any order; "ts"/"epoch" and "rain" are accepted as well;
+ *              "id" and "startup" are optional)
+ *
+ * <time>:     seconds since epoch, or "YYYY-MM-DD[T| ]HH:MM[:SS][Z]" (UTC)
+ * <startup>:  0, 1, false, true
+ * \endverbatim
+ *
+ * Empty lines, lines starting with '#' and a CSV header line are skipped;
+ * other lines which cannot be parsed are counted by errors().
+ */
+class RainReplayParser {
+public:
+    RainReplayParser() : lineCount(0), errorCount(0) {};
+
+    /**
+     * Parse complete lines
+     *
+     * \param pos  begin of input; advanced to the first line which has not been parsed
+     * \param end  end of input
+     * \param out  readings (output)
+     * \param max  maximum number of readings
+     * \param last the input ends at end (the last line need not end with a newline)
+     *
+     * \returns number of readings
+     */
+    size_t parse(const char *&pos, const char *end, RainReading *out, size_t max, bool last = true);
+
+    /**
+     * Number of lines parsed
+     */
+    uint64_t lines(void) const {
+      return lineCount;
+    };
+
+    /**
+     * Number of lines with errors
+     */
+    uint64_t errors(void) const {
+      return errorCount;
+    };
+
+    /**
+     * Parse time stamp (seconds since epoch or ISO 8601 date and time, UTC)
+     *
+     * \param p   begin; advanced behind the time stamp
+     * \param end end of input
+     * \param t   seconds since epoch (output)
+     *
+     * \returns true on success
+     */
+    static bool parseTime(const char *&p, const char *end, time_t &t);
+
+    /**
+     * Parse decimal number ([-]digits[.digits])
+     */
+    static bool parseNumber(const char *&p, const char *end, double &v);
+
+private:
+    uint64_t lineCount;
+    uint64_t errorCount;
+
+    bool  parseCsv(const char *p, const char *end, RainReading &r) const;
+    bool  parseJson(const char *p, const char *end, RainReading &r) const;
+};
@@ -0,0 +1,145 @@
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// RainTopK.h
+//
+// Incrementally maintained ranking of rain gauges by rainfall during the past
+// window (pastHour()) - top-K queries without scanning the fleet
+//
+// https://github.com/matthias-bs/BresserWeatherSensorReceiver
+//
+//
+// created: 10/2026
+//
+//
+// MIT License
+//
+// Copyright (c) 2026 Matthias Prinke
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+// History:
+//
+// 20261016 Created
+//
+// ToDo:
+// -
+//
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+#include <set>
+#include <vector>
+
+#include "RainGaugeStats.h"
+
+/**
+ * \struct RainRank
+ *
+ * \brief Rain gauge and its rainfall during the past window
+ */
+typedef struct {
+    uint32_t  id;
+    float     value;
+} RainRank;
+
+/**
+ * \class RainTopK
+ *
+ * \brief Rain gauges ordered by pastHour(), updated on every change of a rain gauge
+ *
+ * All gauges with a non-zero value are kept in a balanced search tree (std::set),
+ * ordered by descending value and ascending id. A change costs O(log n) - also a
+ * decrease by eviction from the past window, which may move a gauge out of the
+ * top K and another one into it - and top(K) costs O(K).
+ *
+ * Register with RainGaugeFleetT::addObserver(). Not thread-safe: updates and
+ * queries must be serialized by the caller.
+ */
+class RainTopK : public RainGaugeObserver {
+public:
+    /**
+     * Constructor
+     *
+     * \param gauges number of rain gauges (ids 0..gauges-1)
+     */
+    RainTopK(size_t gauges) : value(gauges, 0.0f) {};
+
+    /**
+     * Observer interface - rank by pastHour
+     */
+    virtual void changed(uint32_t id, const RainGaugeStats &s) {
+      set(id, s.pastHour);
+    };
+
+    /**
+     * Set value of rain gauge
+     */
+    void  set(uint32_t id, float v) {
+      float old = value[id];
+
+      if (v == old)
+          return;
+      if (old > 0) {
+          RainRank r = {id, old};
+          ranking.erase(r);
+      }
+      if (v > 0) {
+          RainRank r = {id, v};
+          ranking.insert(r);
+      }
+      value[id] = v;
+    };
+
+    /**
+     * Rain gauges with the highest values, in descending order
+     *
+     * Gauges without rainfall are not included.
+     *
+     * \param k   maximum number of entries
+     * \param out entries (output, at least k)
+     *
+     * \returns number of entries
+     */
+    size_t top(size_t k, RainRank *out) const {
+      size_t n = 0;
+      for (std::set<RainRank, Greater>::const_iterator it = ranking.begin(); (n < k) && (it != ranking.end()); ++it) {
+          out[n++] = *it;
+      }
+      return n;
+    };
+
+    /**
+     * Number of rain gauges with non-zero value
+     */
+    size_t size(void) const {
+      return ranking.size();
+    };
+
+private:
+    struct Greater {
+      bool operator()(const RainRank &a, const RainRank &b) const {
+        return (a.value > b.value) || ((a.value == b.value) && (a.id < b.id));
+      };
+    };
+
+    std::set<RainRank, Greater> ranking;
+    std::vector<float>          value;
+};
@@ -0,0 +1,357 @@
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// RainTrace.cpp
+//
+// Compact columnar binary trace format for rain gauge readings
+//
+// https://github.com/matthias-bs/BresserWeatherSensorReceiver
+//
+//
+// created: 10/2026
+//
+//
+// MIT License
+//
+// Copyright (c) 2026 Matthias Prinke
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+// History:
+//
+// 20261016 Created
+//
+// ToDo:
+// -
+//
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include <math.h>
+#include <string.h>
+
+#include "RainTrace.h"
+#include "RainWal.h"
+
+/*
+ * File header
+ */
+typedef struct {
+    char      magic[4];   // "RGTR"
+    uint16_t  version;    // RAIN_TRACE_VERSION
+    uint16_t  scale;      // fixed-point scale of rain values
+    uint32_t  reserved;
+} RainTraceHeader;
+
+/*
+ * Block header
+ */
+typedef struct {
+    uint32_t  count;      // number of readings
+    uint32_t  size;       // payload size
+    uint32_t  crc;        // CRC-32 of payload
+    uint32_t  reserved;
+    int64_t   epoch;      // epoch of first reading
+} RainTraceBlock;
+
+static_assert(sizeof(RainTraceHeader) == 12, "RainTraceHeader layout");
+static_assert(sizeof(RainTraceBlock) == 24, "RainTraceBlock layout");
+
+static const char RAIN_TRACE_MAGIC[4] = {'R', 'G', 'T', 'R'};
+
+// Upper limit of readings per block accepted by the reader
+#define RAIN_TRACE_MAX_BLOCK (1u << 20)
+
+static inline uint64_t
+zigzag(int64_t v)
+{
+    return ((uint64_t)v << 1) ^ (uint64_t)(v >> 63);
+}
+
+static inline int64_t
+unzigzag(uint64_t v)
+{
+    return (int64_t)(v >> 1) ^ -(int64_t)(v & 1);
+}
+
+static inline void
+putVarint(std::vector<uint8_t> &out, uint64_t v)
+{
+    while (v >= 0x80) {
+        out.push_back((uint8_t)(v | 0x80));
+        v >>= 7;
+    }
+    out.push_back((uint8_t)v);
+}
+
+static inline bool
+getVarint(const uint8_t *&p, const uint8_t *end, uint64_t &v)
+{
+    v = 0;
+    for (unsigned shift = 0; shift < 64; shift += 7) {
+        if (p >= end)
+            return false;
+        uint8_t b = *p++;
+        v |= (uint64_t)(b & 0x7F) << shift;
+        if (!(b & 0x80))
+            return true;
+    }
+    return false;
+}
+
+RainTraceWriter::RainTraceWriter(unsigned scale, size_t blockSize) :
+    file(NULL), scale(scale ? scale : 1), blockSize(blockSize ? blockSize : 1),
+    count(0), roundCount(0), byteCount(0)
+{
+    if (this->blockSize > RAIN_TRACE_MAX_BLOCK)
+        this->blockSize = RAIN_TRACE_MAX_BLOCK;
+}
+
+RainTraceWriter::~RainTraceWriter()
+{
+    close();
+}
+
+bool
+RainTraceWriter::open(const char *path)
+{
+    RainTraceHeader hdr;
+
+    close();
+    file = fopen(path, "wb");
+    if (!file)
+        return false;
+
+    memset(&hdr, 0, sizeof(hdr));
+    memcpy(hdr.magic, RAIN_TRACE_MAGIC, sizeof(hdr.magic));
+    hdr.version = RAIN_TRACE_VERSION;
+    hdr.scale   = (uint16_t)scale;
+    count = roundCount = 0;
+    byteCount = sizeof(hdr);
+    block.clear();
+    prevRain.clear();
+    return fwrite(&hdr, sizeof(hdr), 1, file) == 1;
+}
+
+bool
+RainTraceWriter::write(const RainReading &r)
+{
+    if (!file)
+        return false;
+    block.push_back(r);
+    count++;
+    return (block.size() < blockSize) || flush();
+}
+
+bool
+RainTraceWriter::flush(void)
+{
+    RainTraceBlock hdr;
+
+    if (block.empty())
+        return true;
+
+    payload.clear();
+
+    // Gauge ids
+    uint32_t prevId = 0;
+    for (size_t i = 0; i < block.size(); i++) {
+        putVarint(payload, zigzag((int64_t)block[i].id - (int64_t)prevId));
+        prevId = block[i].id;
+    }
+
+    // Time stamps - delta-of-delta
+    int64_t prevEpoch = (int64_t)block[0].epoch;
+    int64_t prevDelta = 0;
+    for (size_t i = 0; i < block.size(); i++) {
+        int64_t delta = (int64_t)block[i].epoch - prevEpoch;
+        putVarint(payload, zigzag(delta - prevDelta));
+        prevEpoch = (int64_t)block[i].epoch;
+        prevDelta = delta;
+    }
+
+    // Rain values - fixed-point, delta to previous value of the same gauge
+    for (size_t i = 0; i < block.size(); i++) {
+        double  scaled = (double)block[i].value * scale;
+        int32_t fixed  = (int32_t)lround(scaled);
+        if ((float)((double)fixed / scale) != block[i].value)
+            roundCount++;
+        int32_t  prev   = 0;
+        uint32_t id     = block[i].id;
+        if (id < RAIN_TRACE_MAX_STATE) {
+            if (id >= prevRain.size())
+                prevRain.resize(id + 1, 0);
+            prev = prevRain[id];
+            prevRain[id] = fixed;
+        }
+        putVarint(payload, zigzag((int64_t)fixed - prev));
+    }
+
+    // Startup flags
+    size_t bitmap = payload.size();
+    payload.resize(bitmap + (block.size() + 7) / 8, 0);
+    for (size_t i = 0; i < block.size(); i++) {
+        if (block[i].startup)
+            payload[bitmap + i / 8] |= (uint8_t)(1 << (i % 8));
+    }
+
+    memset(&hdr, 0, sizeof(hdr));
+    hdr.count = (uint32_t)block.size();
+    hdr.size  = (uint32_t)payload.size();
+    hdr.crc   = rainCrc32(&payload[0], payload.size());
+    hdr.epoch = (int64_t)block[0].epoch;
+    block.clear();
+    byteCount += sizeof(hdr) + payload.size();
+    return (fwrite(&hdr, sizeof(hdr), 1, file) == 1) &&
+           (fwrite(&payload[0], payload.size(), 1, file) == 1);
+}
+
+bool
+RainTraceWriter::close(void)
+{
+    if (!file)
+        return true;
+    bool ok = flush();
+    ok = (fclose(file) == 0) && ok;
+    file = NULL;
+    return ok;
+}
+
+RainTraceReader::RainTraceReader() :
+    pos(NULL), end(NULL), scaleValue(1), failed(false), startupSize(0)
+{
+}
+
+bool
+RainTraceReader::isTrace(const char *data, size_t size)
+{
+    return (size >= sizeof(RainTraceHeader)) && (memcmp(data, RAIN_TRACE_MAGIC, sizeof(RAIN_TRACE_MAGIC)) == 0);
+}
+
+bool
+RainTraceReader::open(const char *path)
+{
+    if (!file.open(path))
+        return false;
+    return open(file.data(), file.size());
+}
+
+bool
+RainTraceReader::open(const char *data, size_t size)
+{
+    RainTraceHeader hdr;
+
+    failed = false;
+    pos = end = NULL;
+    if (!isTrace(data, size))
+        return false;
+    memcpy(&hdr, data, sizeof(hdr));
+    if ((hdr.version != RAIN_TRACE_VERSION) || (hdr.scale == 0))
+        return false;
+
+    scaleValue = hdr.scale;
+    pos = data + sizeof(hdr);
+    end = data + size;
+    prevRain.clear();
+    return true;
+}
+
+size_t
+RainTraceReader::next(const uint32_t *&ids, const time_t *&epochs, const float *&values, const bool *&startup)
+{
+    RainTraceBlock hdr;
+
+    if (failed || !pos || (pos >= end))
+        return 0;
+    if ((size_t)(end - pos) < sizeof(hdr)) {
+        failed = true;
+        return 0;
+    }
+    memcpy(&hdr, pos, sizeof(hdr));
+    const uint8_t *p    = reinterpret_cast<const uint8_t *>(pos + sizeof(hdr));
+    const uint8_t *pend = p + hdr.size;
+    size_t         n    = hdr.count;
+    if ((hdr.count == 0) || (hdr.count > RAIN_TRACE_MAX_BLOCK) ||
+        ((size_t)(end - pos) - sizeof(hdr) < hdr.size) || (hdr.size < (n + 7) / 8) ||
+        (rainCrc32(p, hdr.size) != hdr.crc)) {
+        failed = true;
+        return 0;
+    }
+
+    if (idBuf.size() < n) {
+        idBuf.resize(n);
+        epochBuf.resize(n);
+        valueBuf.resize(n);
+    }
+    if (startupSize < n) {
+        startupBuf.reset(new bool[n]);
+        startupSize = n;
+    }
+
+    uint64_t v;
+    uint32_t id = 0;
+    for (size_t i = 0; i < n; i++) {
+        if (!getVarint(p, pend, v)) {
+            failed = true;
+            return 0;
+        }
+        id = (uint32_t)((int64_t)id + unzigzag(v));
+        idBuf[i] = id;
+    }
+
+    int64_t epoch = hdr.epoch;
+    int64_t delta = 0;
+    for (size_t i = 0; i < n; i++) {
+        if (!getVarint(p, pend, v)) {
+            failed = true;
+            return 0;
+        }
+        delta += unzigzag(v);
+        epoch += delta;
+        epochBuf[i] = (time_t)epoch;
+    }
+
+    for (size_t i = 0; i < n; i++) {
+        if (!getVarint(p, pend, v)) {
+            failed = true;
+            return 0;
+        }
+        int32_t  fixed = (int32_t)unzigzag(v);
+        uint32_t gid   = idBuf[i];
+        if (gid < RAIN_TRACE_MAX_STATE) {
+            if (gid >= prevRain.size())
+                prevRain.resize(gid + 1, 0);
+            fixed += prevRain[gid];
+            prevRain[gid] = fixed;
+        }
+        valueBuf[i] = (float)((double)fixed / scaleValue);
+    }
+
+    if ((size_t)(pend - p) != (n + 7) / 8) {
+        failed = true;
+        return 0;
+    }
+    for (size_t i = 0; i < n; i++) {
+        startupBuf[i] = (p[i / 8] >> (i % 8)) & 1;
+    }
+
+    pos     = reinterpret_cast<const char *>(pend);
+    ids     = &idBuf[0];
+    epochs  = &epochBuf[0];
+    values  = &valueBuf[0];
+    startup = startupBuf.get();
+    return n;
+}
@@ -0,0 +1,235 @@
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// RainTrace.h
+//
+// Compact columnar binary trace format for rain gauge readings (gauge id, epoch,
+// rain, startup): delta-of-delta time stamps, fixed-point rain values
+//
+// https://github.com/matthias-bs/BresserWeatherSensorReceiver
+//
+//
+// created: 10/2026
+//
+//
+// MIT License
+//
+// Copyright (c) 2026 Matthias Prinke
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+// History:
+//
+// 20261016 Created
+//
+// ToDo:
+// -
+//
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <time.h>
+#include <memory>
+#include <vector>
+
+#include "RainGaugeFleet.h"
+#include "RainReplay.h"
+
+/**
+ * \def
+ *
+ * Version of the trace file layout
+ */
+#define RAIN_TRACE_VERSION 1
+
+/**
+ * \def
+ *
+ * Rain values of gauge ids below this limit are delta-encoded against the previous
+ * value of the same gauge, others are stored as is
+ */
+#define RAIN_TRACE_MAX_STATE (1u << 24)
+
+/**
+ * \verbatim
+ * File:   header (12 bytes: "RGTR", version, scale, reserved)
+ *         block ...
+ *
+ * Block:  count (uint32), payload size (uint32), CRC-32 of payload (uint32),
+ *         reserved (uint32), epoch of first reading (int64), payload
+ *
+ * Payload (columns of count readings, all integers as LEB128 varints,
+ *          signed values zigzag-encoded):
+ *         id:      id - previous id
+ *         epoch:   delta-of-delta (epoch[i] - epoch[i-1]) - (epoch[i-1] - epoch[i-2]),
+ *                  starting from the first epoch with delta 0
+ *         rain:    round(rain * scale) - previous value of the same gauge
+ *         startup: bitmap, bit (i % 8) of byte (i / 8)
+ * \endverbatim
+ */
+
+/**
+ * \class RainTraceWriter
+ *
+ * \brief Writes readings to a trace file, one block per blockSize readings
+ */
+class RainTraceWriter {
+public:
+    /**
+     * Constructor
+     *
+     * \param scale     fixed-point scale of rain values (10: 0.1 mm, as RainGauge)
+     * \param blockSize number of readings per block
+     */
+    RainTraceWriter(unsigned scale = RAINGAUGE_SCALE, size_t blockSize = 4096);
+
+    /**
+     * Destructor - closes file
+     */
+    ~RainTraceWriter();
+
+    /**
+     * Create trace file
+     */
+    bool  open(const char *path);
+
+    /**
+     * Append reading
+     *
+     * \returns false on I/O error
+     */
+    bool  write(const RainReading &r);
+
+    /**
+     * Write last block and close file
+     *
+     * \returns false on I/O error
+     */
+    bool  close(void);
+
+    /**
+     * Number of readings written
+     */
+    uint64_t readings(void) const {
+      return count;
+    };
+
+    /**
+     * Number of rain values which are not multiples of 1/scale (rounded)
+     */
+    uint64_t rounded(void) const {
+      return roundCount;
+    };
+
+    /**
+     * Number of bytes written
+     */
+    uint64_t bytes(void) const {
+      return byteCount;
+    };
+
+private:
+    FILE                    *file;
+    unsigned                 scale;
+    size_t                   blockSize;
+    uint64_t                 count;
+    uint64_t                 roundCount;
+    uint64_t                 byteCount;
+    std::vector<RainReading> block;
+    std::vector<int32_t>     prevRain;
+    std::vector<uint8_t>     payload;
+
+    bool  flush(void);
+
+    RainTraceWriter(const RainTraceWriter &);
+    RainTraceWriter &operator=(const RainTraceWriter &);
+};
+
+/**
+ * \class RainTraceReader
+ *
+ * \brief Streaming reader of a memory-mapped trace file
+ *
+ * next() decodes one block into column arrays which can be passed directly to
+ * RainGaugeFleetT::updateBatch():
+ * \verbatim
+ * while ((n = reader.next(ids, epochs, values, startup)) > 0)
+ *     fleet.updateBatch(n, ids, epochs, values, startup);
+ * \endverbatim
+ */
+class RainTraceReader {
+public:
+    RainTraceReader();
+
+    /**
+     * Map trace file and check header
+     */
+    bool  open(const char *path);
+
+    /**
+     * Check header of trace in memory (must stay valid while reading)
+     */
+    bool  open(const char *data, size_t size);
+
+    /**
+     * Decode next block
+     *
+     * The arrays are valid until the next call.
+     *
+     * \returns number of readings; 0 at end of file or on error
+     */
+    size_t next(const uint32_t *&ids, const time_t *&epochs, const float *&values, const bool *&startup);
+
+    /**
+     * A corrupted or truncated block has been found
+     */
+    bool  error(void) const {
+      return failed;
+    };
+
+    /**
+     * Fixed-point scale of rain values
+     */
+    unsigned scale(void) const {
+      return scaleValue;
+    };
+
+    /**
+     * File is a trace file (checks magic only)
+     */
+    static bool isTrace(const char *data, size_t size);
+
+private:
+    RainMappedFile          file;
+    const char             *pos;
+    const char             *end;
+    unsigned                scaleValue;
+    bool                    failed;
+    std::vector<uint32_t>   idBuf;
+    std::vector<time_t>     epochBuf;
+    std::vector<float>      valueBuf;
+    std::unique_ptr<bool[]> startupBuf;
+    size_t                  startupSize;
+    std::vector<int32_t>    prevRain;
+
+    RainTraceReader(const RainTraceReader &);
+    RainTraceReader &operator=(const RainTraceReader &);
+};
@@ -0,0 +1,403 @@
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// RainWal.cpp
+//
+// Write-ahead log of rain gauge readings with group commit
+//
+// https://github.com/matthias-bs/BresserWeatherSensorReceiver
+//
+//
+// created: 10/2026
+//
+//
+// MIT License
+//
+// Copyright (c) 2026 Matthias Prinke
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+// History:
+//
+// 20261016 Created
+// 20261017 append() withdraws its record if the group commit fails; a failed
+//          commit() cuts the log back to the durable records
+//
+// ToDo:
+// -
+//
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include <stddef.h>
+#include <string.h>
+#include <string>
+
+#include "RainWal.h"
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <stdio.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#define RAIN_WAL_POSIX
+#endif
+
+/*
+ * Log file header
+ */
+typedef struct {
+    char      magic[4];   // "RGWL"
+    uint16_t  version;    // RAIN_WAL_VERSION
+    uint16_t  recordSize; // sizeof(RainWalRecord)
+    uint32_t  reserved0;
+    uint32_t  reserved1;
+    uint64_t  baseLsn;    // LSN of first record
+    uint64_t  reserved2;
+} RainWalHeader;
+
+static_assert(sizeof(RainWalHeader) == 32, "RainWalHeader layout");
+static_assert(sizeof(RainWalRecord) == 32, "RainWalRecord layout");
+
+static const char RAIN_WAL_MAGIC[4] = {'R', 'G', 'W', 'L'};
+
+// Number of records read at once by open() and replay()
+#define RAIN_WAL_READ_BATCH 1024
+
+/*
+ * CRC-32 lookup table (initialized on first use, thread-safe in C++11)
+ */
+struct RainCrcTable {
+    uint32_t t[256];
+
+    RainCrcTable() {
+      for (uint32_t i = 0; i < 256; i++) {
+          uint32_t c = i;
+          for (int k = 0; k < 8; k++) {
+              c = (c & 1) ? (0xEDB88320u ^ (c >> 1)) : (c >> 1);
+          }
+          t[i] = c;
+      }
+    };
+};
+
+uint32_t
+rainCrc32(const void *data, size_t size, uint32_t crc)
+{
+    static const RainCrcTable table;
+
+    const uint8_t *p = static_cast<const uint8_t *>(data);
+    crc = ~crc;
+    for (size_t i = 0; i < size; i++) {
+        crc = table.t[(crc ^ p[i]) & 0xFF] ^ (crc >> 8);
+    }
+    return ~crc;
+}
+
+/*
+ * CRC of record (all fields but crc)
+ */
+static uint32_t
+walRecordCrc(const RainWalRecord &rec)
+{
+    return rainCrc32(&rec, offsetof(RainWalRecord, crc));
+}
+
+RainWal::RainWal(size_t groupSize) :
+    fd(-1), groupSize(groupSize ? groupSize : 1), baseLsn(1), nextLsn(1), durableLsn(0), syncs(0)
+{
+    pending.reserve((this->groupSize < RAIN_WAL_READ_BATCH) ? this->groupSize : RAIN_WAL_READ_BATCH);
+}
+
+RainWal::~RainWal()
+{
+    close();
+}
+
+uint64_t
+RainWal::append(const RainReading &r)
+{
+    RainWalRecord rec;
+
+    if (fd < 0)
+        return 0;
+
+    memset(&rec, 0, sizeof(rec));
+    rec.lsn   = nextLsn;
+    rec.epoch = (int64_t)r.epoch;
+    rec.id    = r.id;
+    rec.value = r.value;
+    rec.flags = r.startup ? 1 : 0;
+    rec.crc   = walRecordCrc(rec);
+    pending.push_back(rec);
+    nextLsn++;
+
+    if ((pending.size() >= groupSize) && !commit()) {
+        // Not logged - the caller does not apply the reading, so it must not be
+        // written by a later commit() either
+        pending.pop_back();
+        nextLsn--;
+        return 0;
+    }
+    return rec.lsn;
+}
+
+#ifdef RAIN_WAL_POSIX
+
+/*
+ * Make written data durable
+ */
+static bool
+walSync(int fd)
+{
+#if defined(__APPLE__)
+    return fsync(fd) == 0;
+#else
+    return fdatasync(fd) == 0;
+#endif
+}
+
+bool
+RainWal::open(const char *path, uint64_t minLsn)
+{
+    RainWalHeader hdr;
+    struct stat   st;
+
+    close();
+    fd = ::open(path, O_RDWR | O_CREAT, 0644);
+    if ((fd < 0) || (fstat(fd, &st) != 0)) {
+        close();
+        return false;
+    }
+
+    if (st.st_size == 0) {
+        if (!restart(minLsn ? minLsn : 1)) {
+            close();
+            return false;
+        }
+        return true;
+    }
+
+    if ((pread(fd, &hdr, sizeof(hdr), 0) != (ssize_t)sizeof(hdr)) ||
+        (memcmp(hdr.magic, RAIN_WAL_MAGIC, sizeof(hdr.magic)) != 0) ||
+        (hdr.version != RAIN_WAL_VERSION) ||
+        (hdr.recordSize != sizeof(RainWalRecord)) ||
+        (hdr.baseLsn == 0)) {
+        close();
+        return false;
+    }
+
+    // Find end of valid records
+    RainWalRecord buf[RAIN_WAL_READ_BATCH];
+    uint64_t      lsn = hdr.baseLsn;
+    off_t         pos = sizeof(hdr);
+    bool          end = false;
+    while (!end) {
+        ssize_t n = pread(fd, buf, sizeof(buf), pos);
+        if (n < 0) {
+            close();
+            return false;
+        }
+        size_t k;
+        for (k = 0; k < (size_t)n / sizeof(RainWalRecord); k++) {
+            if ((buf[k].lsn != lsn) || (buf[k].crc != walRecordCrc(buf[k])))
+                break;
+            lsn++;
+        }
+        pos += (off_t)(k * sizeof(RainWalRecord));
+        end = (k < RAIN_WAL_READ_BATCH);
+    }
+
+    baseLsn    = hdr.baseLsn;
+    nextLsn    = lsn;
+    durableLsn = lsn - 1;
+
+    if (nextLsn < minLsn) {
+        // All records are covered by a newer checkpoint
+        if (!restart(minLsn)) {
+            close();
+            return false;
+        }
+    } else if (pos != st.st_size) {
+        // Drop torn tail
+        if ((ftruncate(fd, pos) != 0) || !walSync(fd)) {
+            close();
+            return false;
+        }
+    }
+    return true;
+}
+
+void
+RainWal::close(void)
+{
+    if (fd >= 0) {
+        ::close(fd);
+        fd = -1;
+    }
+    pending.clear();
+}
+
+bool
+RainWal::commit(void)
+{
+    if (fd < 0)
+        return false;
+    if (pending.empty())
+        return true;
+
+    size_t bytes = pending.size() * sizeof(RainWalRecord);
+    off_t  pos   = (off_t)(sizeof(RainWalHeader) + (durableLsn + 1 - baseLsn) * sizeof(RainWalRecord));
+    if ((pwrite(fd, &pending[0], bytes, pos) != (ssize_t)bytes) || !walSync(fd)) {
+        // Remove records which may have reached the file - open() would replay them.
+        // If this fails too, the log is closed and has to be reopened.
+        if ((ftruncate(fd, pos) != 0) || !walSync(fd)) {
+            ::close(fd);
+            fd = -1;
+        }
+        return false;
+    }
+
+    durableLsn = pending.back().lsn;
+    pending.clear();
+    syncs++;
+    return true;
+}
+
+bool
+RainWal::replay(uint64_t lsn, const std::function<void(const RainReading &)> &fn) const
+{
+    RainWalRecord buf[RAIN_WAL_READ_BATCH];
+    uint64_t      first = (lsn < baseLsn) ? baseLsn : lsn + 1;
+
+    if (fd < 0)
+        return false;
+
+    while (first <= durableLsn) {
+        uint64_t count = durableLsn + 1 - first;
+        if (count > RAIN_WAL_READ_BATCH)
+            count = RAIN_WAL_READ_BATCH;
+        off_t   pos   = (off_t)(sizeof(RainWalHeader) + (first - baseLsn) * sizeof(RainWalRecord));
+        size_t  bytes = (size_t)count * sizeof(RainWalRecord);
+        if (pread(fd, buf, bytes, pos) != (ssize_t)bytes)
+            return false;
+        for (size_t k = 0; k < count; k++) {
+            RainReading r;
+            r.epoch   = (time_t)buf[k].epoch;
+            r.id      = buf[k].id;
+            r.value   = buf[k].value;
+            r.startup = (buf[k].flags & 1) != 0;
+            fn(r);
+        }
+        first += count;
+    }
+    return true;
+}
+
+bool
+RainWal::truncate(void)
+{
+    if (!commit())
+        return false;
+    return restart(nextLsn);
+}
+
+bool
+RainWal::restart(uint64_t lsn)
+{
+    RainWalHeader hdr;
+
+    memset(&hdr, 0, sizeof(hdr));
+    memcpy(hdr.magic, RAIN_WAL_MAGIC, sizeof(hdr.magic));
+    hdr.version    = RAIN_WAL_VERSION;
+    hdr.recordSize = sizeof(RainWalRecord);
+    hdr.baseLsn    = lsn;
+
+    // The header is written first - stale records behind it no longer match their LSN
+    if ((pwrite(fd, &hdr, sizeof(hdr), 0) != (ssize_t)sizeof(hdr)) ||
+        (ftruncate(fd, sizeof(hdr)) != 0) ||
+        (fsync(fd) != 0))
+        return false;
+
+    baseLsn    = lsn;
+    nextLsn    = lsn;
+    durableLsn = lsn - 1;
+    return true;
+}
+
+bool
+rainDurableRename(const char *from, const char *to)
+{
+    if (rename(from, to) != 0)
+        return false;
+
+    // Sync directory containing the new name
+    std::string dir(to);
+    size_t      slash = dir.rfind('/');
+    dir = (slash == std::string::npos) ? std::string(".") : dir.substr(0, slash ? slash : 1);
+    int dfd = ::open(dir.c_str(), O_RDONLY);
+    if (dfd < 0)
+        return false;
+    bool ok = (fsync(dfd) == 0);
+    ::close(dfd);
+    return ok;
+}
+
+#else
+
+bool
+RainWal::open(const char *, uint64_t)
+{
+    return false;
+}
+
+void
+RainWal::close(void)
+{
+    pending.clear();
+}
+
+bool
+RainWal::commit(void)
+{
+    return false;
+}
+
+bool
+RainWal::replay(uint64_t, const std::function<void(const RainReading &)> &) const
+{
+    return false;
+}
+
+bool
+RainWal::truncate(void)
+{
+    return false;
+}
+
+bool
+RainWal::restart(uint64_t)
+{
+    return false;
+}
+
+bool
+rainDurableRename(const char *, const char *)
+{
+    return false;
+}
+
+#endif
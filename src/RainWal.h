@@ -0,0 +1,391 @@
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// RainWal.h
+//
+// Write-ahead log of rain gauge readings with group commit, checkpoints of the
+// non-volatile data and recovery (replay of the log tail after the checkpoint)
+//
+// https://github.com/matthias-bs/BresserWeatherSensorReceiver
+//
+//
+// created: 10/2026
+//
+//
+// MIT License
+//
+// Copyright (c) 2026 Matthias Prinke
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+// History:
+//
+// 20261016 Created
+// 20261017 RainGaugeDurableT writes incremental RainCheckpointT checkpoints
+// 20261017 append() withdraws its record if the group commit fails
+// 20261017 RainGaugeDurableT::update() reports checkpoint failures by lastCheckpointFailed()
+//
+// ToDo:
+// -
+//
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <functional>
+#include <string>
+#include <vector>
+
+#include "RainGaugeFleet.h"
+#include "RainCheckpoint.h"
+
+/**
+ * \def
+ *
+ * Version of the log file layout
+ */
+#define RAIN_WAL_VERSION 1
+
+/**
+ * \struct RainWalRecord
+ *
+ * \brief Log record of one reading
+ */
+typedef struct {
+    uint64_t  lsn;     // log sequence number (consecutive)
+    int64_t   epoch;   // seconds since epoch (UTC)
+    uint32_t  id;      // rain gauge id
+    float     value;   // rain gauge raw value
+    uint32_t  flags;   // bit 0: sensor startup flag
+    uint32_t  crc;     // CRC-32 of the preceding fields
+} RainWalRecord;
+
+/**
+ * CRC-32 (IEEE 802.3, reflected polynomial 0xEDB88320)
+ *
+ * \param data data
+ * \param size number of bytes
+ * \param crc  CRC of preceding data (for incremental computation)
+ */
+uint32_t rainCrc32(const void *data, size_t size, uint32_t crc = 0);
+
+/**
+ * \class RainWal
+ *
+ * \brief Append-only log of readings with group commit
+ *
+ * append() only buffers the record; commit() writes all buffered records with one
+ * write() and makes them durable with one fdatasync(). A reading may be acknowledged
+ * when its log sequence number is not greater than durable().
+ *
+ * \verbatim
+ * File: header (32 bytes: "RGWL", version, record size, LSN of first record)
+ *       RainWalRecord ...
+ * \endverbatim
+ *
+ * open() drops a torn or corrupted tail (CRC or LSN mismatch) left by a crash.
+ * Only available on POSIX systems - open() fails elsewhere.
+ */
+class RainWal {
+public:
+    /**
+     * Constructor
+     *
+     * \param groupSize append() commits automatically when this many records are buffered
+     */
+    RainWal(size_t groupSize = 256);
+
+    /**
+     * Destructor - buffered records which have not been committed are lost
+     */
+    ~RainWal();
+
+    /**
+     * Open or create log file
+     *
+     * \param path   file name
+     * \param minLsn smallest LSN of the next record (e.g. checkpoint LSN + 1);
+     *               older records are discarded
+     *
+     * \returns true on success
+     */
+    bool  open(const char *path, uint64_t minLsn = 1);
+
+    /**
+     * Close log file (without commit)
+     */
+    void  close(void);
+
+    /**
+     * Append reading
+     *
+     * \returns log sequence number of the record or 0 on error (the record has not
+     *          been logged and its LSN is used by the next record)
+     */
+    uint64_t append(const RainReading &r);
+
+    /**
+     * Write buffered records and wait until they are durable
+     *
+     * On error, the buffered records are kept for the next commit().
+     *
+     * \returns false on I/O error
+     */
+    bool  commit(void);
+
+    /**
+     * Call fn for all durable records with LSN greater than lsn (in order)
+     *
+     * \returns false on I/O error
+     */
+    bool  replay(uint64_t lsn, const std::function<void(const RainReading &)> &fn) const;
+
+    /**
+     * Remove all records from the log (after a checkpoint containing them)
+     *
+     * Buffered records are committed first; LSNs continue.
+     *
+     * \returns false on I/O error
+     */
+    bool  truncate(void);
+
+    /**
+     * LSN of the last appended record (0 if none)
+     */
+    uint64_t last(void) const {
+      return nextLsn - 1;
+    };
+
+    /**
+     * LSN of the last durable record (0 if none)
+     */
+    uint64_t durable(void) const {
+      return durableLsn;
+    };
+
+    /**
+     * Number of records in the log file
+     */
+    uint64_t records(void) const {
+      return durableLsn + 1 - baseLsn;
+    };
+
+    /**
+     * Number of commits which have written records (i.e. fdatasync() calls)
+     */
+    uint64_t commits(void) const {
+      return syncs;
+    };
+
+private:
+    int                        fd;
+    size_t                     groupSize;
+    uint64_t                   baseLsn;    // LSN of first record in file
+    uint64_t                   nextLsn;
+    uint64_t                   durableLsn;
+    uint64_t                   syncs;
+    std::vector<RainWalRecord> pending;
+
+    /**
+     * Write header with LSN of first record and remove all records
+     */
+    bool  restart(uint64_t lsn);
+
+    RainWal(const RainWal &);
+    RainWal &operator=(const RainWal &);
+};
+
+/**
+ * Rename file and make the rename durable (sync directory)
+ *
+ * \returns false on error
+ */
+bool rainDurableRename(const char *from, const char *to);
+
+/**
+ * \class RainGaugeDurableT
+ *
+ * \brief Crash-safe updates of a RainGaugeFleetT
+ *
+ * Every reading is logged before the fleet is updated. checkpoint() writes the
+ * blocks of modified gauges to a RainCheckpointT file (tagged with the LSN of the
+ * last logged reading) and truncates the log. open() loads the checkpoint and replays
+ * only the log records after it.
+ *
+ * The modification flags of the fleet are cleared by checkpoint() - they must not be
+ * cleared by other checkpoints of the same fleet.
+ *
+ * \verbatim
+ * RainGaugeDurable durable(fleet, 256, 100000);
+ * durable.open("raingauge.wal", "raingauge.ckpt");
+ * for each received reading r:
+ *     lsn = durable.update(r);
+ * durable.commit();       // acknowledge readings up to durable.durable()
+ * \endverbatim
+ */
+template <unsigned WindowSeconds, unsigned BufSize, unsigned Scale>
+class RainGaugeDurableT {
+public:
+    typedef RainGaugeFleetT<WindowSeconds, BufSize, Scale> Fleet;
+    typedef RainCheckpointT<WindowSeconds, BufSize, Scale> Checkpoint;
+
+    /**
+     * Constructor
+     *
+     * \param fleet              rain gauges (must outlive this object)
+     * \param groupSize          number of readings per group commit
+     * \param checkpointInterval number of readings between automatic checkpoints; 0 - none
+     */
+    RainGaugeDurableT(Fleet &fleet, size_t groupSize = 256, uint64_t checkpointInterval = 0) :
+      fleet(fleet), wal(groupSize), maxValue(RAINGAUGE_MAX_VALUE), interval(checkpointInterval),
+      sinceCheckpoint(0), replayCount(0), ckptFailed(false)
+    {};
+
+    /**
+     * Recover fleet from checkpoint and log, then open log for appending
+     *
+     * \param walPath        log file name
+     * \param checkpointPath checkpoint file name
+     * \param raingaugeMax   overflow value
+     *
+     * \returns true on success
+     */
+    bool  open(const char *walPath, const char *checkpointPath, float raingaugeMax = RAINGAUGE_MAX_VALUE) {
+      uint64_t lsn = 0;
+
+      ckptPath = checkpointPath;
+      maxValue = raingaugeMax;
+      if (!loadCheckpoint(lsn))
+          return false;
+      if (!wal.open(walPath, lsn + 1))
+          return false;
+      replayCount = 0;
+      sinceCheckpoint = 0;
+      return wal.replay(lsn, [this](const RainReading &r) {
+          fleet.update(1, &r, maxValue);
+          replayCount++;
+          sinceCheckpoint++;
+      });
+    };
+
+    /**
+     * Log reading and update rain gauge
+     *
+     * A failed automatic checkpoint does not affect the reading (see
+     * lastCheckpointFailed()); it is retried with the next reading.
+     *
+     * \returns log sequence number or 0 on error (the fleet is not updated then)
+     */
+    uint64_t update(const RainReading &r) {
+      uint64_t lsn = wal.append(r);
+
+      if (lsn == 0)
+          return 0;
+      fleet.update(1, &r, maxValue);
+      if (interval && (++sinceCheckpoint >= interval))
+          checkpoint();
+      return lsn;
+    };
+
+    /**
+     * Make all logged readings durable
+     */
+    bool  commit(void) {
+      return wal.commit();
+    };
+
+    /**
+     * Write checkpoint and truncate log
+     *
+     * Only blocks with modified gauges are written, to the shadow slots of the
+     * checkpoint file; a crash leaves the previous checkpoint valid.
+     */
+    bool  checkpoint(void) {
+      ckptFailed = true;
+      if (!wal.commit())
+          return false;
+      if (!ckpt.write(ckptPath.c_str(), fleet, wal.last()))
+          return false;
+      sinceCheckpoint = 0;
+      ckptFailed = !wal.truncate();
+      return !ckptFailed;
+    };
+
+    /**
+     * The last checkpoint (automatic or by checkpoint()) has failed
+     */
+    bool  lastCheckpointFailed(void) const {
+      return ckptFailed;
+    };
+
+    /**
+     * LSN of the last durable reading
+     */
+    uint64_t durable(void) const {
+      return wal.durable();
+    };
+
+    /**
+     * Number of readings replayed by open()
+     */
+    uint64_t replayed(void) const {
+      return replayCount;
+    };
+
+    /**
+     * Log (e.g. for statistics)
+     */
+    const RainWal &log(void) const {
+      return wal;
+    };
+
+private:
+    Fleet       &fleet;
+    RainWal      wal;
+    Checkpoint   ckpt;
+    std::string  ckptPath;
+    float        maxValue;
+    uint64_t     interval;
+    uint64_t     sinceCheckpoint;
+    uint64_t     replayCount;
+    bool         ckptFailed;
+
+    /**
+     * Load checkpoint (if any) into fleet
+     */
+    bool  loadCheckpoint(uint64_t &lsn) {
+      FILE *f = fopen(ckptPath.c_str(), "rb");
+      if (!f)
+          return true;
+      fclose(f);
+
+      if (!ckpt.read(ckptPath.c_str(), fleet, maxValue))
+          return false;
+      lsn = ckpt.lsn();
+      return true;
+    };
+};
+
+/**
+ * \typedef RainGaugeDurable
+ *
+ * \brief Crash-safe updates of a RainGaugeFleet
+ */
+typedef RainGaugeDurableT<RAINGAUGE_WINDOW, RAINGAUGE_BUF_SIZE, RAINGAUGE_SCALE> RainGaugeDurable;
@@ -0,0 +1,167 @@
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// RainWorkPool.cpp
+//
+// Thread pool with per-worker task deques and work stealing
+//
+// https://github.com/matthias-bs/BresserWeatherSensorReceiver
+//
+//
+// created: 10/2026
+//
+//
+// MIT License
+//
+// Copyright (c) 2026 Matthias Prinke
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+// History:
+//
+// 20261016 Created
+//
+// ToDo:
+// -
+//
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+
+#include "RainWorkPool.h"
+
+RainWorkPool::RainWorkPool(unsigned n) :
+    generation(0), pending(0), active(0), stop(false), job(NULL), stealCount(0)
+{
+    if (n == 0)
+        n = 1;
+    for (unsigned i = 0; i < n; i++) {
+        workers.push_back(new Worker);
+    }
+    for (unsigned i = 0; i < n; i++) {
+        threads.push_back(std::thread(&RainWorkPool::workerLoop, this, i));
+    }
+}
+
+RainWorkPool::~RainWorkPool()
+{
+    {
+        std::lock_guard<std::mutex> guard(lock);
+        stop = true;
+    }
+    wake.notify_all();
+    for (size_t i = 0; i < threads.size(); i++) {
+        threads[i].join();
+    }
+    for (size_t i = 0; i < workers.size(); i++) {
+        delete workers[i];
+    }
+}
+
+void
+RainWorkPool::run(size_t tasks, const std::function<void(size_t)> &fn)
+{
+    if (tasks == 0)
+        return;
+
+    // Contiguous blocks of task numbers per worker
+    size_t n = workers.size();
+    for (size_t w = 0; w < n; w++) {
+        std::lock_guard<std::mutex> guard(workers[w]->lock);
+        for (size_t task = w * tasks / n; task < (w + 1) * tasks / n; task++) {
+            workers[w]->tasks.push_back(task);
+        }
+    }
+
+    std::unique_lock<std::mutex> guard(lock);
+    job     = &fn;
+    pending = tasks;
+    generation++;
+    wake.notify_all();
+    // Wait until all tasks are completed and no worker is still looking for tasks
+    while ((pending > 0) || (active > 0)) {
+        done.wait(guard);
+    }
+    job = NULL;
+}
+
+bool
+RainWorkPool::next(unsigned self, size_t &task)
+{
+    // Own deque - most recently assigned task first
+    {
+        Worker *w = workers[self];
+        std::lock_guard<std::mutex> guard(w->lock);
+        if (!w->tasks.empty()) {
+            task = w->tasks.back();
+            w->tasks.pop_back();
+            return true;
+        }
+    }
+
+    // Steal oldest task from other workers
+    for (size_t i = 1; i < workers.size(); i++) {
+        Worker *w = workers[(self + i) % workers.size()];
+        std::lock_guard<std::mutex> guard(w->lock);
+        if (!w->tasks.empty()) {
+            task = w->tasks.front();
+            w->tasks.pop_front();
+            stealCount++;
+            return true;
+        }
+    }
+    return false;
+}
+
+void
+RainWorkPool::workerLoop(unsigned self)
+{
+    uint64_t seen = 0;
+
+    for (;;) {
+        const std::function<void(size_t)> *fn;
+        {
+            std::unique_lock<std::mutex> guard(lock);
+            while (!stop && (generation == seen)) {
+                wake.wait(guard);
+            }
+            if (stop)
+                return;
+            seen = generation;
+            // Woken up too late - run() has already returned
+            if (job == NULL)
+                continue;
+            fn   = job;
+            active++;
+        }
+
+        size_t task;
+        size_t completed = 0;
+        while (next(self, task)) {
+            (*fn)(task);
+            completed++;
+        }
+
+        {
+            std::lock_guard<std::mutex> guard(lock);
+            pending -= completed;
+            active--;
+            if ((pending == 0) && (active == 0)) {
+                done.notify_all();
+            }
+        }
+    }
+}
@@ -0,0 +1,138 @@
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// RainWorkPool.h
+//
+// Thread pool with per-worker task deques and work stealing
+//
+// https://github.com/matthias-bs/BresserWeatherSensorReceiver
+//
+//
+// created: 10/2026
+//
+//
+// MIT License
+//
+// Copyright (c) 2026 Matthias Prinke
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+// History:
+//
+// 20261016 Created
+//
+// ToDo:
+// -
+//
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/**
+ * \class RainWorkPool
+ *
+ * \brief Thread pool executing a set of independent tasks with work stealing
+ *
+ * run() distributes the task numbers in contiguous blocks to the workers' deques.
+ * Each worker takes tasks from the back of its own deque; when it is empty, the
+ * worker steals from the front of the other workers' deques, so uneven task
+ * durations are balanced. A task number is executed exactly once per run().
+ */
+class RainWorkPool {
+public:
+    /**
+     * Constructor - starts the worker threads
+     *
+     * \param threads number of worker threads (at least one)
+     */
+    RainWorkPool(unsigned threads);
+
+    /**
+     * Destructor - stops the worker threads
+     */
+    ~RainWorkPool();
+
+    /**
+     * Number of worker threads
+     */
+    unsigned size(void) const {
+      return (unsigned)workers.size();
+    };
+
+    /**
+     * Execute fn(task) for task in [0, tasks) on the worker threads and wait for completion
+     *
+     * Must not be called concurrently from several threads.
+     *
+     * \param tasks number of tasks
+     *
+     * \param fn    task function
+     */
+    void run(size_t tasks, const std::function<void(size_t)> &fn);
+
+    /**
+     * Number of tasks executed by a worker other than the one it was assigned to
+     */
+    uint64_t steals(void) const {
+      return stealCount.load();
+    };
+
+private:
+    /*
+     * Task deque of one worker
+     */
+    struct Worker {
+      std::mutex         lock;
+      std::deque<size_t> tasks;
+    };
+
+    std::vector<std::thread> threads;
+    std::vector<Worker *>    workers;
+
+    std::mutex               lock;      // protects generation, pending, active, stop and job
+    std::condition_variable  wake;      // new run() or stop
+    std::condition_variable  done;      // all tasks of current run() completed
+    uint64_t                 generation; // number of run() calls
+    size_t                   pending;   // tasks of current run() not yet completed
+    unsigned                 active;    // workers processing tasks of current run()
+    bool                     stop;
+    const std::function<void(size_t)> *job;
+
+    std::atomic<uint64_t>    stealCount;
+
+    /**
+     * Worker thread main loop
+     */
+    void workerLoop(unsigned self);
+
+    /**
+     * Get next task - own deque first, then steal
+     *
+     * \returns false if all deques are empty
+     */
+    bool next(unsigned self, size_t &task);
+};
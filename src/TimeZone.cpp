@@ -0,0 +1,450 @@
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// TimeZone.cpp
+//
+// Immutable UTC offset table for a local timezone, loaded once from tzdata (TZif) files
+// or from a POSIX TZ rule string.
+//
+// See RFC 8536 for the TZif format and POSIX.1-2017 section 8.3 (TZ) for the rule syntax.
+//
+// https://github.com/matthias-bs/BresserWeatherSensorReceiver
+//
+//
+// created: 10/2026
+//
+//
+// MIT License
+//
+// Copyright (c) 2026 Matthias Prinke
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+// History:
+//
+// 20261016 Created
+//
+// ToDo:
+// -
+//
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <algorithm>
+#include <string>
+
+#include "CivilTime.h"
+#include "TimeZone.h"
+
+/*
+ * Read big-endian integers from TZif data
+ */
+static int32_t
+tzifInt32(const uint8_t *p)
+{
+    return (int32_t)(((uint32_t)p[0] << 24) | ((uint32_t)p[1] << 16) | ((uint32_t)p[2] << 8) | p[3]);
+}
+
+static int64_t
+tzifInt64(const uint8_t *p)
+{
+    return (int64_t)(((uint64_t)(uint32_t)tzifInt32(p) << 32) | (uint32_t)tzifInt32(p + 4));
+}
+
+/*
+ * Epoch at begin of year
+ */
+static int64_t
+yearStart(int32_t year)
+{
+    return (int64_t)daysFromCivil(year, 1, 1) * CIVIL_SECONDS_PER_DAY;
+}
+
+bool
+TimeZone::load(const char *name, int32_t firstYear, int32_t lastYear)
+{
+    std::string path;
+
+    if (name[0] == '/') {
+        path = name;
+    } else {
+        const char *dir = getenv("TZDIR");
+        path  = (dir != NULL) ? dir : TIMEZONE_DIR;
+        path += "/";
+        path += name;
+    }
+
+    FILE *f = fopen(path.c_str(), "rb");
+    if (f == NULL)
+        return false;
+
+    std::vector<uint8_t> buf;
+    uint8_t chunk[4096];
+    size_t  n;
+    while ((n = fread(chunk, 1, sizeof(chunk), f)) > 0) {
+        buf.insert(buf.end(), chunk, chunk + n);
+    }
+    fclose(f);
+
+    TimeZone tz;
+    if (!tz.parseTzif(buf.data(), buf.size(), firstYear, lastYear))
+        return false;
+
+    *this = tz;
+    return true;
+}
+
+bool
+TimeZone::loadPosix(const char *spec, int32_t firstYear, int32_t lastYear)
+{
+    TimeZone tz;
+    if (!tz.appendPosix(spec, firstYear, lastYear))
+        return false;
+    tz.clip(firstYear, lastYear);
+
+    *this = tz;
+    return true;
+}
+
+bool
+TimeZone::parseTzif(const uint8_t *buf, size_t size, int32_t firstYear, int32_t lastYear)
+{
+    const size_t HEADER_SIZE = 44;
+
+    if ((size < HEADER_SIZE) || (memcmp(buf, "TZif", 4) != 0))
+        return false;
+
+    const uint8_t *p   = buf;
+    const uint8_t *end = buf + size;
+    int            timeSize = 4;
+
+    for (int pass = 0; pass < 2; pass++) {
+        if ((size_t)(end - p) < HEADER_SIZE)
+            return false;
+
+        char     version = (char)p[4];
+        uint32_t isutcnt = (uint32_t)tzifInt32(p + 20);
+        uint32_t isstdcnt = (uint32_t)tzifInt32(p + 24);
+        uint32_t leapcnt = (uint32_t)tzifInt32(p + 28);
+        uint32_t timecnt = (uint32_t)tzifInt32(p + 32);
+        uint32_t typecnt = (uint32_t)tzifInt32(p + 36);
+        uint32_t charcnt = (uint32_t)tzifInt32(p + 40);
+        p += HEADER_SIZE;
+
+        size_t dataSize = (size_t)timecnt * timeSize + timecnt + typecnt * 6 + charcnt
+                          + (size_t)leapcnt * (timeSize + 4) + isstdcnt + isutcnt;
+        if ((typecnt == 0) || ((size_t)(end - p) < dataSize))
+            return false;
+
+        // Version 1 data block is skipped if 64-bit data follows
+        if ((pass == 0) && (version >= '2')) {
+            p += dataSize;
+            timeSize = 8;
+            continue;
+        }
+
+        const uint8_t *times = p;
+        const uint8_t *idx   = times + (size_t)timecnt * timeSize;
+        const uint8_t *types = idx + timecnt;
+
+        // Local time type 0 applies before the first transition
+        offsetBefore = tzifInt32(types);
+
+        trans.clear();
+        offsets.clear();
+        for (uint32_t i = 0; i < timecnt; i++) {
+            if (idx[i] >= typecnt)
+                return false;
+            int64_t t = (timeSize == 8) ? tzifInt64(times + 8 * i) : tzifInt32(times + 4 * i);
+            trans.push_back(t);
+            offsets.push_back(tzifInt32(types + 6 * idx[i]));
+        }
+        p += dataSize;
+
+        // Footer with POSIX TZ rule for times after the last transition
+        if ((timeSize == 8) && (end - p > 2) && (*p == '\n')) {
+            const uint8_t *nl = (const uint8_t *)memchr(p + 1, '\n', end - p - 1);
+            if ((nl != NULL) && (nl > p + 1)) {
+                std::string footer((const char *)p + 1, nl - p - 1);
+                if (!appendPosix(footer.c_str(), firstYear, lastYear))
+                    return false;
+            }
+        }
+        break;
+    }
+
+    clip(firstYear, lastYear);
+    return true;
+}
+
+/*
+ * Parse POSIX TZ name - alphabetic or quoted in <>
+ */
+static const char *
+posixName(const char *s)
+{
+    if (*s == '<') {
+        const char *e = strchr(s, '>');
+        return (e != NULL) ? e + 1 : NULL;
+    }
+    const char *p = s;
+    while ((*p >= 'A' && *p <= 'Z') || (*p >= 'a' && *p <= 'z'))
+        p++;
+    return (p - s >= 3) ? p : NULL;
+}
+
+/*
+ * Parse POSIX TZ time [+|-]hh[:mm[:ss]] in seconds
+ */
+static const char *
+posixTime(const char *s, int32_t &secs)
+{
+    int32_t sign = 1;
+    if (*s == '+' || *s == '-') {
+        sign = (*s == '-') ? -1 : 1;
+        s++;
+    }
+    if (*s < '0' || *s > '9')
+        return NULL;
+
+    int32_t part[3] = {0, 0, 0};
+    for (int i = 0; i < 3; i++) {
+        if (i > 0) {
+            if (*s != ':')
+                break;
+            s++;
+        }
+        if (*s < '0' || *s > '9')
+            return NULL;
+        while (*s >= '0' && *s <= '9')
+            part[i] = part[i] * 10 + (*s++ - '0');
+    }
+    secs = sign * (part[0] * CIVIL_SECONDS_PER_HOUR + part[1] * CIVIL_SECONDS_PER_MINUTE + part[2]);
+    return s;
+}
+
+/**
+ * \typedef posixRule_t
+ *
+ * \brief Start or end rule of daylight saving time
+ */
+typedef struct {
+    char    type;  // 'J' - Julian day [1..365] w/o Feb 29, 'D' - zero-based day, 'M' - month.week.day
+    int32_t day;
+    int32_t week;
+    int32_t month;
+    int32_t time;  // local time of transition
+} posixRule_t;
+
+static const char *
+posixRule(const char *s, posixRule_t &r)
+{
+    r.time = 2 * CIVIL_SECONDS_PER_HOUR;
+    r.week = r.month = r.day = 0;
+
+    if (*s == 'M') {
+        r.type = 'M';
+        s++;
+        r.month = (int32_t)strtol(s, (char **)&s, 10);
+        if (*s++ != '.')
+            return NULL;
+        r.week = (int32_t)strtol(s, (char **)&s, 10);
+        if (*s++ != '.')
+            return NULL;
+        r.day = (int32_t)strtol(s, (char **)&s, 10);
+        if (r.month < 1 || r.month > 12 || r.week < 1 || r.week > 5 || r.day < 0 || r.day > 6)
+            return NULL;
+    } else if (*s == 'J') {
+        r.type = 'J';
+        s++;
+        r.day = (int32_t)strtol(s, (char **)&s, 10);
+        if (r.day < 1 || r.day > 365)
+            return NULL;
+    } else if (*s >= '0' && *s <= '9') {
+        r.type = 'D';
+        r.day = (int32_t)strtol(s, (char **)&s, 10);
+        if (r.day > 365)
+            return NULL;
+    } else {
+        return NULL;
+    }
+
+    if (*s == '/') {
+        s = posixTime(s + 1, r.time);
+    }
+    return s;
+}
+
+/*
+ * Local time (seconds since epoch, wall clock) of rule in given year
+ */
+static int64_t
+posixRuleLocal(const posixRule_t &r, int32_t year)
+{
+    int32_t z;
+    bool    leap = (daysInMonth(year, 2) == 29);
+
+    if (r.type == 'J') {
+        z = daysFromCivil(year, 1, 1) + r.day - 1 + ((leap && r.day >= 60) ? 1 : 0);
+    } else if (r.type == 'D') {
+        z = daysFromCivil(year, 1, 1) + r.day;
+    } else {
+        int32_t first = daysFromCivil(year, r.month, 1);
+        z = first + (r.day - weekdayFromDays(first) + 7) % 7 + (r.week - 1) * 7;
+        while (z >= first + daysInMonth(year, r.month))
+            z -= 7;
+    }
+    return (int64_t)z * CIVIL_SECONDS_PER_DAY + r.time;
+}
+
+bool
+TimeZone::appendPosix(const char *spec, int32_t firstYear, int32_t lastYear)
+{
+    const char *s = posixName(spec);
+    int32_t     stdOffset;
+    int32_t     dstOffset;
+
+    if ((s == NULL) || ((s = posixTime(s, stdOffset)) == NULL))
+        return false;
+
+    // POSIX offsets are positive west of Greenwich
+    stdOffset = -stdOffset;
+
+    if (*s == '\0') {
+        // No daylight saving time
+        if (trans.empty())
+            offsetBefore = stdOffset;
+        return true;
+    }
+
+    if ((s = posixName(s)) == NULL)
+        return false;
+
+    dstOffset = stdOffset + CIVIL_SECONDS_PER_HOUR;
+    if (*s != ',' && *s != '\0') {
+        if ((s = posixTime(s, dstOffset)) == NULL)
+            return false;
+        dstOffset = -dstOffset;
+    }
+
+    posixRule_t start;
+    posixRule_t stop;
+    if ((*s != ',') || ((s = posixRule(s + 1, start)) == NULL))
+        return false;
+    if ((*s != ',') || ((s = posixRule(s + 1, stop)) == NULL))
+        return false;
+    if (*s != '\0')
+        return false;
+
+    // Southern hemisphere: year begins in daylight saving time
+    if (trans.empty()) {
+        offsetBefore = (posixRuleLocal(start, firstYear) - stdOffset > posixRuleLocal(stop, firstYear) - dstOffset) ?
+                        dstOffset : stdOffset;
+    }
+
+    int64_t last = trans.empty() ? INT64_MIN : trans.back();
+    int32_t year = firstYear;
+    if (!trans.empty()) {
+        year = std::max(year, yearFromDays((int32_t)civilFloorDiv(last, CIVIL_SECONDS_PER_DAY)));
+    }
+
+    for (; year <= lastYear; year++) {
+        // Start of DST is given in standard time, end of DST in daylight saving time
+        int64_t tStart = posixRuleLocal(start, year) - stdOffset;
+        int64_t tStop  = posixRuleLocal(stop, year) - dstOffset;
+
+        if (tStart < tStop) {
+            if (tStart > last) { trans.push_back(tStart); offsets.push_back(dstOffset); }
+            if (tStop > last)  { trans.push_back(tStop);  offsets.push_back(stdOffset); }
+        } else {
+            // Southern hemisphere
+            if (tStop > last)  { trans.push_back(tStop);  offsets.push_back(stdOffset); }
+            if (tStart > last) { trans.push_back(tStart); offsets.push_back(dstOffset); }
+        }
+        if (!trans.empty())
+            last = trans.back();
+    }
+    return true;
+}
+
+void
+TimeZone::clip(int32_t firstYear, int32_t lastYear)
+{
+    int64_t tFirst = yearStart(firstYear);
+    int64_t tEnd   = yearStart(lastYear + 1);
+
+    // Offset in effect at begin of first year
+    std::vector<int64_t>::iterator first = std::upper_bound(trans.begin(), trans.end(), tFirst);
+    size_t nFirst = first - trans.begin();
+    if (nFirst > 0)
+        offsetBefore = offsets[nFirst - 1];
+
+    std::vector<int64_t>::iterator last = std::lower_bound(trans.begin(), trans.end(), tEnd);
+    size_t nLast = last - trans.begin();
+
+    trans.erase(trans.begin() + nLast, trans.end());
+    offsets.erase(offsets.begin() + nLast, offsets.end());
+    trans.erase(trans.begin(), trans.begin() + nFirst);
+    offsets.erase(offsets.begin(), offsets.begin() + nFirst);
+
+    // Remove transitions without change of UTC offset (e.g. change of abbreviation only)
+    size_t n = 0;
+    int32_t prev = offsetBefore;
+    for (size_t i = 0; i < trans.size(); i++) {
+        if (offsets[i] != prev) {
+            trans[n]   = trans[i];
+            offsets[n] = offsets[i];
+            prev       = offsets[i];
+            n++;
+        }
+    }
+    trans.resize(n);
+    offsets.resize(n);
+}
+
+int32_t
+TimeZone::utcOffset(int64_t epoch) const
+{
+    std::vector<int64_t>::const_iterator it = std::upper_bound(trans.begin(), trans.end(), epoch);
+
+    return (it == trans.begin()) ? offsetBefore : offsets[(it - trans.begin()) - 1];
+}
+
+void
+TimeZone::localDay(int64_t epoch, int32_t &day, int64_t &midnight, int64_t &nextMidnight) const
+{
+    int32_t offset = utcOffset(epoch);
+    int64_t local  = epoch + offset;
+
+    day = (int32_t)civilFloorDiv(local, CIVIL_SECONDS_PER_DAY);
+
+    // Local midnight with the UTC offset in effect at midnight
+    int64_t localMidnight = (int64_t)day * CIVIL_SECONDS_PER_DAY;
+    midnight = localMidnight - utcOffset(localMidnight - offset);
+    if (midnight > epoch) {
+        // Midnight skipped by a transition - day begins at the transition
+        midnight = epoch - (local - localMidnight);
+    }
+
+    int64_t localNext = localMidnight + CIVIL_SECONDS_PER_DAY;
+    nextMidnight = localNext - utcOffset(localNext - offset);
+    if (nextMidnight <= epoch) {
+        nextMidnight = midnight + CIVIL_SECONDS_PER_DAY;
+    }
+}
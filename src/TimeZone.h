@@ -0,0 +1,152 @@
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// TimeZone.h
+//
+// Immutable UTC offset table for a local timezone, loaded once from tzdata (TZif) files
+// or from a POSIX TZ rule string.
+//
+// All queries are a binary search over the table - no libc time calls, no global state -
+// so gauges bound to different timezones can be updated on different threads.
+//
+// https://github.com/matthias-bs/BresserWeatherSensorReceiver
+//
+//
+// created: 10/2026
+//
+//
+// MIT License
+//
+// Copyright (c) 2026 Matthias Prinke
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+// History:
+//
+// 20261016 Created
+//
+// ToDo:
+// -
+//
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <stdint.h>
+#include <vector>
+
+/**
+ * \def
+ *
+ * Default directory of the tzdata files (overridden by environment variable TZDIR)
+ */
+#ifndef TIMEZONE_DIR
+  #define TIMEZONE_DIR "/usr/share/zoneinfo"
+#endif
+
+/**
+ * \class TimeZone
+ *
+ * \brief UTC offset transitions of a timezone for a range of years
+ *
+ * The table is built once by load() or loadPosix() and is not modified afterwards;
+ * a TimeZone object can be shared between threads.
+ * A default constructed TimeZone is UTC.
+ */
+class TimeZone {
+public:
+    TimeZone() {
+      offsetBefore = 0;
+    };
+
+    /**
+     * Load timezone from tzdata file
+     *
+     * Transitions after the last one stored in the file are generated from the
+     * POSIX TZ rule in the file's footer (TZif version 2 and later).
+     *
+     * \param name      timezone name (e.g. "Europe/Berlin") relative to $TZDIR or TIMEZONE_DIR,
+     *                  or absolute path of a TZif file
+     *
+     * \param firstYear first year covered by the table
+     *
+     * \param lastYear  last year covered by the table
+     *
+     * \returns true if successful; the object is unchanged otherwise
+     */
+    bool load(const char *name, int32_t firstYear = 1970, int32_t lastYear = 2100);
+
+    /**
+     * Load timezone from POSIX TZ rule string
+     *
+     * \param spec      POSIX TZ rule (e.g. "CET-1CEST,M3.5.0,M10.5.0/3")
+     *
+     * \param firstYear first year covered by the table
+     *
+     * \param lastYear  last year covered by the table
+     *
+     * \returns true if successful; the object is unchanged otherwise
+     */
+    bool loadPosix(const char *spec, int32_t firstYear = 1970, int32_t lastYear = 2100);
+
+    /**
+     * UTC offset (local time - UTC) in seconds at given time
+     *
+     * \param epoch seconds since epoch (UTC)
+     */
+    int32_t utcOffset(int64_t epoch) const;
+
+    /**
+     * Local day containing given time
+     *
+     * \param epoch        seconds since epoch (UTC)
+     *
+     * \param day          days since 1970-01-01 of local date (output)
+     *
+     * \param midnight     epoch at begin of local day (output)
+     *
+     * \param nextMidnight epoch at begin of next local day (output)
+     */
+    void localDay(int64_t epoch, int32_t &day, int64_t &midnight, int64_t &nextMidnight) const;
+
+    /**
+     * Number of transitions in the table
+     */
+    size_t transitions(void) const {
+      return trans.size();
+    };
+
+private:
+    std::vector<int64_t> trans;        // transition times (UTC), ascending
+    std::vector<int32_t> offsets;      // UTC offset valid from trans[i]
+    int32_t              offsetBefore; // UTC offset before first transition
+
+    /**
+     * Parse TZif file contents
+     */
+    bool parseTzif(const uint8_t *buf, size_t size, int32_t firstYear, int32_t lastYear);
+
+    /**
+     * Append transitions generated from POSIX TZ rule for years after last transition
+     */
+    bool appendPosix(const char *spec, int32_t firstYear, int32_t lastYear);
+
+    /**
+     * Drop transitions outside of [firstYear, lastYear]
+     */
+    void clip(int32_t firstYear, int32_t lastYear);
+};
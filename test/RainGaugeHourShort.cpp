@@ -93,7 +93,11 @@ TEST(TestRainGaugeHourShort, RainHourShort) {
    .tsMonthBegin = 0xFF,
    .rainMonthBegin = 0,
    .rainPrev = 0,
-   .rainOvf = 0
+   .rainOvf = 0,
+   .peakIdx = {0},
+   .peakFirst = 0,
+   .peakCount = 0,
+   .tsPrev = 0
   };
 
   RainGauge rainGauge(&data);
@@ -0,0 +1,193 @@
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// RainTestUtil.h
+//
+// Helpers shared by the unit tests: start time, pseudo-random readings, comparison of
+// non-volatile data, rain gauge initialization and timezone setting
+//
+// https://github.com/matthias-bs/BresserWeatherSensorReceiver
+//
+//
+// created: 10/2026
+//
+//
+// MIT License
+//
+// Copyright (c) 2026 Matthias Prinke
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+// History:
+//
+// 20261017 Created from the helpers of TestRainGaugeBackfill, TestRainGaugeCoalesce,
+//          TestRainHistory, TestRainGaugeT and TestRainGaugeEpoch
+//
+// ToDo:
+// -
+//
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <gtest/gtest.h>
+#include <stdlib.h>
+#include <string.h>
+#include <string>
+#include <vector>
+
+#include "RainGauge.h"
+#include "TimeZone.h"
+
+// 2022-09-04 20:00 UTC
+static const time_t T_BEGIN = 1662321600;
+
+/*
+ * Pseudo-random numbers (xorshift32) - same sequence on every platform
+ */
+class TestRandom {
+public:
+  TestRandom() : x(2463534242u) {}
+
+  uint32_t next(void) {
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    return x;
+  }
+
+private:
+  uint32_t x;
+};
+
+/*
+ * Parameters of makeSamples()
+ */
+struct SampleSpec {
+  unsigned interval;   // mean interval between readings in seconds
+  unsigned wetPercent; // fraction of days with showers (in the first quarter of every three hours)
+  time_t   maxGap;     // outages (about one in 1000 readings) of up to maxGap seconds; 0: none
+  bool     weekGaps;   // two in three outages are exactly one day or one week
+  bool     restarts;   // sensor restarts (counter starts at zero)
+
+  SampleSpec(unsigned interval) :
+    interval(interval), wetPercent(100), maxGap(0), weekGaps(false), restarts(false) {}
+};
+
+/*
+ * Readings of a single rain gauge starting at T_BEGIN; the counter overflows at 100 mm
+ */
+static inline void makeSamples(std::vector<rainSample_t> &samples, size_t n, const SampleSpec &spec)
+{
+  TestRandom rnd;
+  time_t     t    = T_BEGIN;
+  float      rain = 0;
+
+  samples.clear();
+  for (size_t i = 0; i < n; i++) {
+    uint32_t x = rnd.next();
+    t += 1 + x % (2 * spec.interval);
+    if ((spec.maxGap > 0) && (x % 997 == 0)) {
+      if (spec.weekGaps && (x % 3 != 2)) {
+        t += (x % 3 == 0) ? 86400 : 7 * 86400;
+      } else {
+        t += (time_t)(x % spec.maxGap);
+      }
+    }
+    uint32_t day = (uint32_t)(t / 86400);
+    bool wet = ((day * 2654435761u) >> 8) % 100 < spec.wetPercent;
+    if (wet && ((t % 10800) < 2700) && ((x >> 8) % 4 == 0)) {
+      rain += 0.1f * (float)(1 + (x >> 16) % 5);
+    }
+    bool startup = spec.restarts && ((x >> 4) % 4001 == 0);
+    if (startup) {
+      rain = 0;
+    }
+    if (rain >= 100) {
+      rain -= 100;
+    }
+    rainSample_t s = {t, rain, startup};
+    samples.push_back(s);
+  }
+}
+
+/*
+ * Same state of non-volatile data; the peak rain rate deque may be stored at a different position
+ */
+template <unsigned BufSize>
+static void expectSameState(const nvDataT<BufSize> &a, const nvDataT<BufSize> &b, const std::string &msg)
+{
+  ASSERT_EQ(0, memcmp(a.tsBuf, b.tsBuf, sizeof(a.tsBuf))) << msg;
+  ASSERT_EQ(0, memcmp(a.rainBuf, b.rainBuf, sizeof(a.rainBuf))) << msg;
+  ASSERT_EQ(0, memcmp(a.tsHigh, b.tsHigh, sizeof(a.tsHigh))) << msg;
+  ASSERT_EQ(a.head, b.head) << msg;
+  ASSERT_EQ(a.tail, b.tail) << msg;
+  ASSERT_EQ(a.tsPrev, b.tsPrev) << msg;
+  ASSERT_EQ(a.startupPrev, b.startupPrev) << msg;
+  ASSERT_EQ(a.rainStartup, b.rainStartup) << msg;
+  ASSERT_EQ(a.tsDayBegin, b.tsDayBegin) << msg;
+  ASSERT_EQ(a.rainDayBegin, b.rainDayBegin) << msg;
+  ASSERT_EQ(a.tsWeekBegin, b.tsWeekBegin) << msg;
+  ASSERT_EQ(a.rainWeekBegin, b.rainWeekBegin) << msg;
+  ASSERT_EQ(a.wdayPrev, b.wdayPrev) << msg;
+  ASSERT_EQ(a.tsMonthBegin, b.tsMonthBegin) << msg;
+  ASSERT_EQ(a.rainMonthBegin, b.rainMonthBegin) << msg;
+  ASSERT_EQ(a.rainPrev, b.rainPrev) << msg;
+  ASSERT_EQ(a.rainOvf, b.rainOvf) << msg;
+  ASSERT_EQ(a.peakCount, b.peakCount) << msg;
+  for (unsigned i = 0; i < a.peakCount; i++) {
+    ASSERT_EQ(a.peakIdx[(a.peakFirst + i) % BufSize], b.peakIdx[(b.peakFirst + i) % BufSize]) << msg;
+  }
+}
+
+/*
+ * Initialize non-volatile data and rain gauge
+ */
+template <class G, class D>
+static void initGauge(G &rainGauge, D &data, const TimeZone *tz)
+{
+  memset(&data, 0, sizeof(data));
+  rainGauge.reset();
+  rainGauge.setTimeZone(tz);
+}
+
+/*
+ * Set timezone for the lifetime of the object, restore previous setting afterwards
+ */
+class TzGuard {
+public:
+  TzGuard(const char *tz) {
+    const char *prev = getenv("TZ");
+    saved = (prev != NULL);
+    if (saved)
+      prevTz = prev;
+    setenv("TZ", tz, 1);
+    tzset();
+  }
+
+  ~TzGuard() {
+    if (saved)
+      setenv("TZ", prevTz.c_str(), 1);
+    else
+      unsetenv("TZ");
+    tzset();
+  }
+
+private:
+  bool        saved;
+  std::string prevTz;
+};
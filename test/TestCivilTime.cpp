@@ -0,0 +1,141 @@
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// TestCivilTime.cpp
+//
+// Googletest unit tests for CivilTime - comparison against libc time conversion
+//
+// https://github.com/matthias-bs/BresserWeatherSensorReceiver
+//
+//
+// created: 10/2026
+//
+//
+// MIT License
+//
+// Copyright (c) 2026 Matthias Prinke
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+// History:
+//
+// 20261016 Created
+//
+// ToDo: 
+// -
+//
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include <gtest/gtest.h>
+#include <string.h>
+
+#define TOLERANCE 0.11
+#include "CivilTime.h"
+#include "RainGauge.h"
+
+
+/*
+ * Compare civil date conversion with gmtime_r() over several centuries
+ */
+TEST(TestCivilTime, CompareGmtime) {
+  for (int32_t z = daysFromCivil(1900, 1, 1); z < daysFromCivil(2200, 1, 1); z += 13) {
+    time_t t = (time_t)z * CIVIL_SECONDS_PER_DAY;
+    tm     tm;
+    gmtime_r(&t, &tm);
+
+    ASSERT_EQ(tm.tm_wday,        weekdayFromDays(z));
+    ASSERT_EQ(tm.tm_mon + 1,     monthFromDays(z));
+    ASSERT_EQ(tm.tm_mday,        dayFromDays(z));
+    ASSERT_EQ(tm.tm_year + 1900, yearFromDays(z));
+    ASSERT_EQ(z, daysFromTm(tm.tm_year, tm.tm_mon, tm.tm_mday));
+  }
+}
+
+
+/*
+ * Out-of-range fields are normalized like mktime() does
+ */
+TEST(TestCivilTime, Normalization) {
+  EXPECT_EQ(daysFromCivil(2023, 3, 1),   daysFromCivil(2023, 2, 29));
+  EXPECT_EQ(daysFromCivil(2024, 2, 29),  daysFromCivil(2024, 3, 0));
+  EXPECT_EQ(daysFromCivil(2021, 12, 31), daysFromTm(122, 0, 0));
+  EXPECT_EQ(daysFromCivil(2021, 11, 1),  daysFromTm(122, -2, 1));
+  EXPECT_EQ(29, daysInMonth(2024, 2));
+  EXPECT_EQ(28, daysInMonth(2100, 2));
+  EXPECT_EQ(31, daysInMonth(2022, 12));
+}
+
+
+/*
+ * RainGauge only evaluates the date and time fields of struct tm,
+ * tm_wday/tm_yday are derived internally
+ */
+TEST(TestCivilTime, RainGaugeDateOnly) {
+  nvData_t data = {
+   .tsBuf = {0},
+   .rainBuf = {0}, 
+   .head = 0,
+   .tail = 0,
+   .startupPrev = false,
+   .rainStartup = 0,
+   .tsDayBegin = 0xFF,
+   .rainDayBegin = 0,
+   .tsWeekBegin = 0xFF,
+   .rainWeekBegin = 0,
+   .wdayPrev = 0xFF,
+   .tsMonthBegin = 0xFF,
+   .rainMonthBegin = 0,
+   .rainPrev = 0,
+   .rainOvf = 0,
+   .peakIdx = {0},
+   .peakFirst = 0,
+   .peakCount = 0,
+   .tsPrev = 0
+  };
+
+  RainGauge rainGauge(&data);
+  rainGauge.reset();
+
+  tm tm;
+  memset(&tm, 0, sizeof(tm));
+
+  // Sunday, 2023-09-03 23:30
+  tm.tm_year = 123; tm.tm_mon = 8; tm.tm_mday = 3; tm.tm_hour = 23; tm.tm_min = 30;
+  rainGauge.update(tm, 10.0);
+
+  // Sunday, 2023-09-03 23:54
+  tm.tm_min = 54;
+  rainGauge.update(tm, 11.0);
+  ASSERT_NEAR(1.0, rainGauge.pastHour(), TOLERANCE);
+  ASSERT_NEAR(1.0, rainGauge.currentDay(), TOLERANCE);
+  ASSERT_NEAR(1.0, rainGauge.currentWeek(), TOLERANCE);
+
+  // Monday, 2023-09-04 00:06 - given as 2023-09-03 24:06
+  tm.tm_hour = 24; tm.tm_min = 6;
+  rainGauge.update(tm, 12.0);
+  ASSERT_NEAR(2.0, rainGauge.pastHour(), TOLERANCE);
+  ASSERT_NEAR(0,   rainGauge.currentDay(), TOLERANCE);
+  ASSERT_NEAR(0,   rainGauge.currentWeek(), TOLERANCE);
+  ASSERT_NEAR(2.0, rainGauge.currentMonth(), TOLERANCE);
+
+  // Friday, 2023-09-29 given as 2023-10-(-1)
+  tm.tm_mon = 9; tm.tm_mday = -1; tm.tm_hour = 12; tm.tm_min = 0;
+  rainGauge.update(tm, 13.0);
+  ASSERT_NEAR(0,   rainGauge.currentDay(), TOLERANCE);
+  ASSERT_NEAR(1.0, rainGauge.currentWeek(), TOLERANCE);
+  ASSERT_NEAR(3.0, rainGauge.currentMonth(), TOLERANCE);
+}
@@ -0,0 +1,201 @@
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// TestRainAsync.cpp
+//
+// Unit tests for the C++20 coroutine ingestion pipeline (RainAsync.h);
+// built as separate executable async_tests
+//
+// https://github.com/matthias-bs/BresserWeatherSensorReceiver
+//
+//
+// created: 10/2026
+//
+//
+// MIT License
+//
+// Copyright (c) 2026 Matthias Prinke
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+// History:
+//
+// 20261016 Created
+// 20261017 Use helpers from RainTestUtil.h
+//
+// ToDo:
+// -
+//
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+
+
+#include <gtest/gtest.h>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "RainAsync.h"
+#include "RainGaugeFleet.h"
+#include "RainTestUtil.h"
+#include "TimeZone.h"
+
+#define STREAMS  2000
+#define READINGS 24
+
+static RainTask produce(RainChannel<int> &ch, int n)
+{
+  for (int i = 0; i < n; i++) {
+    if (!co_await ch.push(i))
+      co_return;
+  }
+  ch.close();
+}
+
+static RainTask consume(RainChannel<int> &ch, std::vector<int> &out)
+{
+  while (std::optional<int> v = co_await ch.pop()) {
+    out.push_back(*v);
+  }
+}
+
+static RainTask fail(RainExecutor &ex)
+{
+  co_await ex.yield();
+  throw std::runtime_error("stage failed");
+}
+
+/*
+ * Reading k of gauge id; gauges report every 5 minutes, with an offset of up to 199 s
+ */
+static RainReading reading(uint32_t id, int k)
+{
+  RainReading r = {T_BEGIN + k * 300 + (time_t)(id % 200), id, 0.1f * (float)(k * (id % 7)), false};
+  return r;
+}
+
+static std::string line(const RainReading &r)
+{
+  return std::to_string((long long)r.epoch) + "," + std::to_string(r.id) + "," + std::to_string(r.value) + "\n";
+}
+
+/*
+ * Stream of one gauge: one line per resumption; readings 10 and 11 swapped
+ */
+static RainTask stream(RainExecutor &ex, RainChannel<std::string> &in, uint32_t id)
+{
+  for (int k = 0; k < READINGS; k++) {
+    int j = (k == 10) ? 11 : (k == 11) ? 10 : k;
+    if (!co_await in.push(line(reading(id, j))))
+      co_return;
+    co_await ex.yield();
+  }
+}
+
+
+/*
+ * Bounded channel: producer suspends when full, values keep their order
+ */
+TEST(TestRainAsync, Channel) {
+  RainExecutor     ex;
+  RainChannel<int> ch(ex, 2);
+  std::vector<int> out;
+
+  ex.spawn(produce(ch, 10));
+  ex.run();
+  EXPECT_EQ(2u, ch.size());
+  EXPECT_EQ(1u, ex.pending());
+
+  ex.spawn(consume(ch, out));
+  ex.run();
+  EXPECT_EQ(0u, ex.pending());
+  ASSERT_EQ(10u, out.size());
+  for (int i = 0; i < 10; i++) {
+    EXPECT_EQ(i, out[i]);
+  }
+  EXPECT_TRUE(ch.isClosed());
+}
+
+/*
+ * Exception of a coroutine is rethrown by run()
+ */
+TEST(TestRainAsync, Exception) {
+  RainExecutor ex;
+
+  ex.spawn(fail(ex));
+  EXPECT_THROW(ex.run(), std::runtime_error);
+  EXPECT_EQ(0u, ex.pending());
+}
+
+/*
+ * Thousands of interleaved gauge streams on one thread give the same statistics as
+ * updates in chronological order
+ */
+TEST(TestRainAsync, Pipeline) {
+  TimeZone          utc;
+  RainGaugeFleet    fleet(STREAMS);
+  RainGaugeFleet    expected(STREAMS);
+  RainExecutor      ex;
+  // Under back-pressure, the streams drift apart by a few rounds of readings
+  RainAsyncPipeline pipeline(ex, fleet, 3600, 4);
+  uint64_t          published = 0;
+  RainGaugeStats    last      = {0, 0, 0, 0};
+
+  fleet.setTimeZone(&utc);
+  expected.setTimeZone(&utc);
+  for (int k = 0; k < READINGS; k++) {
+    for (uint32_t id = 0; id < STREAMS; id++) {
+      RainReading r = reading(id, k);
+      expected.update(1, &r);
+    }
+  }
+
+  pipeline.setPublisher([&](uint32_t id, const RainGaugeStats &s) {
+    published++;
+    if (id == STREAMS - 1)
+      last = s;
+  });
+  pipeline.start();
+  for (uint32_t id = 0; id < STREAMS; id++) {
+    ex.spawn(stream(ex, pipeline.input(), id));
+  }
+  ex.spawn([](RainChannel<std::string> &in) -> RainTask {
+    co_await in.push("# comment\n1662321600,99999,1.0\nnot a reading\n");
+  }(pipeline.input()));
+
+  ex.run();
+  EXPECT_EQ(5u, ex.pending());
+  pipeline.close();
+  ex.run();
+  EXPECT_EQ(0u, ex.pending());
+
+  const RainAsyncStats &st = pipeline.stats();
+  EXPECT_EQ((uint64_t)STREAMS * READINGS + 1, st.decoded);
+  EXPECT_EQ(1u, st.errors);
+  EXPECT_EQ(1u, st.rejected);
+  EXPECT_EQ(0u, st.late);
+  EXPECT_EQ((uint64_t)STREAMS * READINGS, st.applied);
+  EXPECT_EQ(published, st.published);
+  EXPECT_GE(published, (uint64_t)STREAMS);
+
+  for (uint32_t id = 0; id < STREAMS; id++) {
+    ASSERT_FLOAT_EQ(expected.current(id), fleet.current(id)) << "id " << id;
+    ASSERT_FLOAT_EQ(expected.pastHour(id), fleet.pastHour(id)) << "id " << id;
+    ASSERT_FLOAT_EQ(expected.currentDay(id), fleet.currentDay(id)) << "id " << id;
+  }
+  EXPECT_FLOAT_EQ(expected.pastHour(STREAMS - 1), last.pastHour);
+}
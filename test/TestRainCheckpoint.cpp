@@ -0,0 +1,282 @@
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// TestRainCheckpoint.cpp
+//
+// Unit tests for RainCheckpointT (incremental checkpoints with per-block CRC)
+//
+// https://github.com/matthias-bs/BresserWeatherSensorReceiver
+//
+//
+// created: 10/2026
+//
+//
+// MIT License
+//
+// Copyright (c) 2026 Matthias Prinke
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+// History:
+//
+// 20261016 Created
+// 20261017 Adapted to shadow slots; added interrupted write and header copy tests
+// 20261017 Use helpers from RainTestUtil.h
+//
+// ToDo:
+// -
+//
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+
+
+#include <gtest/gtest.h>
+#include <stdio.h>
+#include <string.h>
+#include <vector>
+
+#include "RainCheckpoint.h"
+#include "RainGaugeFleet.h"
+#include "RainTestUtil.h"
+#include "TimeZone.h"
+
+#define GAUGES 1000
+
+typedef RainGaugeFleetT<3600, 62, 10> Fleet60s;
+typedef RainCheckpointT<3600, 62, 10> Checkpoint60s;
+
+static void updateAll(Fleet60s &fleet, int rounds)
+{
+    float values[GAUGES];
+    for (int i = 0; i < rounds; i++) {
+        for (int g = 0; g < GAUGES; g++) {
+            values[g] = 0.1f * (float)((i * (g % 7 + 1)) % 900);
+        }
+        fleet.updateAll(T_BEGIN + i * 300, values);
+    }
+}
+
+/*
+ * Offset of slot s of block b in a checkpoint file with 64 gauges per block
+ */
+static long slotOffset(const RainCheckpointHeader &hdr, uint32_t b, unsigned s)
+{
+    long dataOffset = (long)((2 * sizeof(hdr) + hdr.blocks * 2 * sizeof(RainCheckpointSlot) + 63) & ~(size_t)63);
+    return dataOffset + ((long)s * hdr.blocks + b) * 64 * (long)sizeof(nvDataT<62>);
+}
+
+static void expectEqual(const Fleet60s &a, const Fleet60s &b, uint32_t first, uint32_t end)
+{
+    for (uint32_t g = first; g < end; g++) {
+        ASSERT_FLOAT_EQ(a.pastHour(g), b.pastHour(g)) << g;
+        ASSERT_FLOAT_EQ(a.currentDay(g), b.currentDay(g)) << g;
+        ASSERT_FLOAT_EQ(a.currentWeek(g), b.currentWeek(g)) << g;
+        ASSERT_FLOAT_EQ(a.currentMonth(g), b.currentMonth(g)) << g;
+    }
+}
+
+
+/*
+ * Only blocks with modified rain gauges are rewritten
+ */
+TEST(TestRainCheckpoint, Incremental) {
+  const char   *path = "TestRainCheckpointIncr.ckpt";
+  TimeZone      utc;
+  Fleet60s      fleet(GAUGES);
+  Checkpoint60s ckpt(64);
+
+  remove(path);
+  fleet.setTimeZone(&utc);
+  updateAll(fleet, 100);
+  EXPECT_TRUE(fleet.dirty(0));
+  EXPECT_TRUE(fleet.dirty(GAUGES - 1));
+
+  ASSERT_TRUE(ckpt.write(path, fleet, 17));
+  EXPECT_EQ(16u, ckpt.blocksWritten());
+  EXPECT_FALSE(fleet.dirty(0));
+
+  ASSERT_TRUE(ckpt.write(path, fleet, 18));
+  EXPECT_EQ(0u, ckpt.blocksWritten());
+
+  uint32_t ids[3]    = {5, 700, 6};
+  time_t   epochs[3] = {T_BEGIN + 100 * 300, T_BEGIN + 100 * 300, T_BEGIN + 100 * 300};
+  float    values[3] = {95.0f, 3.0f, 1.0f};
+  fleet.updateBatch(3, ids, epochs, values);
+  EXPECT_TRUE(fleet.dirty(5));
+  EXPECT_FALSE(fleet.dirty(7));
+  ASSERT_TRUE(ckpt.write(path, fleet, 19));
+  EXPECT_EQ(2u, ckpt.blocksWritten());
+
+  Fleet60s restored(GAUGES);
+  Checkpoint60s reader;
+  ASSERT_TRUE(reader.read(path, restored));
+  EXPECT_EQ(19u, reader.lsn());
+  EXPECT_EQ(0u, reader.corruptBlocks());
+  EXPECT_FALSE(restored.dirty(5));
+  expectEqual(fleet, restored, 0, GAUGES);
+
+  // Different block size - file is rewritten completely
+  Checkpoint60s ckpt100(100);
+  ASSERT_TRUE(ckpt100.write(path, fleet));
+  EXPECT_EQ(10u, ckpt100.blocksWritten());
+  ASSERT_TRUE(reader.read(path, restored));
+  expectEqual(fleet, restored, 0, GAUGES);
+  remove(path);
+}
+
+/*
+ * Corrupted blocks and headers are detected
+ */
+TEST(TestRainCheckpoint, Corruption) {
+  const char   *path = "TestRainCheckpointCrc.ckpt";
+  TimeZone      utc;
+  Fleet60s      fleet(GAUGES);
+  Checkpoint60s ckpt(64);
+
+  remove(path);
+  fleet.setTimeZone(&utc);
+  updateAll(fleet, 50);
+  ASSERT_TRUE(ckpt.write(path, fleet));
+
+  // Flip one byte in block 3 (slot 0, header copy 1 after the first commit)
+  RainCheckpointHeader hdr;
+  FILE *f = fopen(path, "r+b");
+  ASSERT_TRUE(f != NULL);
+  fseek(f, sizeof(hdr), SEEK_SET);
+  ASSERT_EQ(1u, fread(&hdr, sizeof(hdr), 1, f));
+  ASSERT_EQ(1u, hdr.generation);
+  long pos = slotOffset(hdr, 3, 0) + 1000;
+  fseek(f, pos, SEEK_SET);
+  int c = fgetc(f);
+  fseek(f, pos, SEEK_SET);
+  fputc(c ^ 0x10, f);
+  fclose(f);
+
+  Fleet60s restored(GAUGES);
+  Checkpoint60s reader;
+  EXPECT_FALSE(reader.read(path, restored));
+  EXPECT_EQ(1u, reader.corruptBlocks());
+  expectEqual(fleet, restored, 0, 3 * 64);
+  expectEqual(fleet, restored, 4 * 64, GAUGES);
+  EXPECT_EQ(0, restored.currentMonth(3 * 64 + 10));
+
+  // Unmodified blocks are not rewritten; block 3 is repaired when one of its gauges changes
+  ASSERT_TRUE(ckpt.write(path, fleet));
+  EXPECT_EQ(0u, ckpt.blocksWritten());
+  EXPECT_FALSE(reader.read(path, restored));
+  fleet.reset(3 * 64);
+  ASSERT_TRUE(ckpt.write(path, fleet));
+  EXPECT_EQ(1u, ckpt.blocksWritten());
+  EXPECT_TRUE(reader.read(path, restored));
+
+  remove(path);
+}
+
+/*
+ * Blocks written without commit do not replace the committed checkpoint
+ */
+TEST(TestRainCheckpoint, Interrupted) {
+  const char   *path = "TestRainCheckpointCrash.ckpt";
+  TimeZone      utc;
+  Fleet60s      fleet(GAUGES);
+  Checkpoint60s ckpt(64);
+
+  remove(path);
+  fleet.setTimeZone(&utc);
+  updateAll(fleet, 50);
+  ASSERT_TRUE(ckpt.write(path, fleet, 7));
+
+  // Crash after writing block 3 and the first half of block 4
+  RainCheckpointFile   file;
+  RainCheckpointHeader hdr;
+  bool                 fresh = true;
+  std::vector<nvDataT<62> > garbage(2 * 64);
+  memset(&garbage[0], 0x5A, garbage.size() * sizeof(garbage[0]));
+  ASSERT_TRUE(file.open(path, hdr));
+  ASSERT_TRUE(file.create(path, hdr, fresh));
+  EXPECT_FALSE(fresh);
+  ASSERT_TRUE(file.writeBlocks(3, 1, &garbage[0]));
+  file.close();
+  FILE *f = fopen(path, "r+b");
+  ASSERT_TRUE(f != NULL);
+  fseek(f, slotOffset(hdr, 4, 1), SEEK_SET);
+  ASSERT_EQ(32u, fwrite(&garbage[0], sizeof(garbage[0]), 32, f));
+  fclose(f);
+
+  Fleet60s restored(GAUGES);
+  Checkpoint60s reader;
+  ASSERT_TRUE(reader.read(path, restored));
+  EXPECT_EQ(7u, reader.lsn());
+  EXPECT_EQ(0u, reader.corruptBlocks());
+  expectEqual(fleet, restored, 0, GAUGES);
+
+  // The next commit only takes over the blocks written by itself
+  uint32_t id    = 5 * 64;
+  time_t   epoch = T_BEGIN + 50 * 300;
+  float    value = 95.0f;
+  fleet.updateBatch(1, &id, &epoch, &value);
+  ASSERT_TRUE(ckpt.write(path, fleet, 8));
+  EXPECT_EQ(1u, ckpt.blocksWritten());
+  ASSERT_TRUE(reader.read(path, restored));
+  EXPECT_EQ(8u, reader.lsn());
+  expectEqual(fleet, restored, 0, GAUGES);
+  remove(path);
+}
+
+/*
+ * A corrupted header falls back to the previous header copy
+ */
+TEST(TestRainCheckpoint, HeaderCopies) {
+  const char   *path = "TestRainCheckpointHdr.ckpt";
+  TimeZone      utc;
+  Fleet60s      fleet(GAUGES);
+  Checkpoint60s ckpt(64);
+
+  remove(path);
+  fleet.setTimeZone(&utc);
+  updateAll(fleet, 50);
+  ASSERT_TRUE(ckpt.write(path, fleet, 1));
+  Fleet60s previous(GAUGES);
+  Checkpoint60s reader;
+  ASSERT_TRUE(reader.read(path, previous));
+
+  uint32_t id    = 3 * 64;
+  time_t   epoch = T_BEGIN + 50 * 300;
+  float    value = 95.0f;
+  fleet.updateBatch(1, &id, &epoch, &value);
+  ASSERT_TRUE(ckpt.write(path, fleet, 2));
+
+  // Generation 2 is in header copy 0
+  FILE *f = fopen(path, "r+b");
+  ASSERT_TRUE(f != NULL);
+  fseek(f, 16, SEEK_SET);
+  fputc(0x7F, f);
+  fclose(f);
+  Fleet60s restored(GAUGES);
+  ASSERT_TRUE(reader.read(path, restored));
+  EXPECT_EQ(1u, reader.lsn());
+  expectEqual(previous, restored, 0, GAUGES);
+
+  // Both copies corrupted
+  f = fopen(path, "r+b");
+  ASSERT_TRUE(f != NULL);
+  fseek(f, sizeof(RainCheckpointHeader) + 16, SEEK_SET);
+  fputc(0x7F, f);
+  fclose(f);
+  EXPECT_FALSE(reader.read(path, restored));
+  remove(path);
+}
@@ -41,6 +41,7 @@
 ///////////////////////////////////////////////////////////////////////////////////////////////////
 
 #include <gtest/gtest.h>
+#include <string.h>
 
 #define TOLERANCE 0.11
 #include "RainGauge.h"
@@ -68,7 +69,10 @@
 
 static void setTime(const char *time, tm &tm, time_t &ts)
 {
+  // strptime() does not set tm_sec - avoid normalization of uninitialized fields by mktime()
+  memset(&tm, 0, sizeof(tm));
   strptime(time, "%Y-%m-%d %H:%M", &tm);
+  tm.tm_isdst = -1;
   ts = mktime(&tm);
 }
 
@@ -92,7 +96,11 @@ TEST(TestRainGauge, RainHour) {
    .tsMonthBegin = 0xFF,
    .rainMonthBegin = 0,
    .rainPrev = 0,
-   .rainOvf = 0
+   .rainOvf = 0,
+   .peakIdx = {0},
+   .peakFirst = 0,
+   .peakCount = 0,
+   .tsPrev = 0
   };
 
   RainGauge rainGauge(&data00);
@@ -190,7 +198,11 @@ TEST(TestRainGauge, RainHourShort) {
    .tsMonthBegin = 0xFF,
    .rainMonthBegin = 0,
    .rainPrev = 0,
-   .rainOvf = 0
+   .rainOvf = 0,
+   .peakIdx = {0},
+   .peakFirst = 0,
+   .peakCount = 0,
+   .tsPrev = 0
   };
 
   RainGauge rainGauge01(&data01);
@@ -300,7 +312,11 @@ TEST(TestRainGauge, RainHourLong) {
    .tsMonthBegin = 0xFF,
    .rainMonthBegin = 0,
    .rainPrev = 0,
-   .rainOvf = 0
+   .rainOvf = 0,
+   .peakIdx = {0},
+   .peakFirst = 0,
+   .peakCount = 0,
+   .tsPrev = 0
   };
 
   RainGauge rainGauge02(&data02);
@@ -395,7 +411,11 @@ TEST(TestRainGauge, RainHourExtreme) {
    .tsMonthBegin = 0xFF,
    .rainMonthBegin = 0,
    .rainPrev = 0,
-   .rainOvf = 0
+   .rainOvf = 0,
+   .peakIdx = {0},
+   .peakFirst = 0,
+   .peakCount = 0,
+   .tsPrev = 0
   };
 
   RainGauge rainGauge(&data03);
@@ -463,7 +483,11 @@ TEST(TestRainGauge, RainDaily) {
    .tsMonthBegin = 0xFF,
    .rainMonthBegin = 0,
    .rainPrev = 0,
-   .rainOvf = 0
+   .rainOvf = 0,
+   .peakIdx = {0},
+   .peakFirst = 0,
+   .peakCount = 0,
+   .tsPrev = 0
   };
 
   RainGauge rainGauge(&data04);
@@ -526,7 +550,11 @@ TEST(TestRainGauge, RainWeekly) {
    .tsMonthBegin = 0xFF,
    .rainMonthBegin = 0,
    .rainPrev = 0,
-   .rainOvf = 0
+   .rainOvf = 0,
+   .peakIdx = {0},
+   .peakFirst = 0,
+   .peakCount = 0,
+   .tsPrev = 0
   };
 
   RainGauge rainGauge(&data05);
@@ -602,7 +630,11 @@ TEST(TestRainGauge, RainMonthly) {
    .tsMonthBegin = 0xFF,
    .rainMonthBegin = 0,
    .rainPrev = 0,
-   .rainOvf = 0
+   .rainOvf = 0,
+   .peakIdx = {0},
+   .peakFirst = 0,
+   .peakCount = 0,
+   .tsPrev = 0
   };
 
   RainGauge rainGauge(&data06);
@@ -747,7 +779,11 @@ TEST(TestRainGauge, RainHourOv) {
    .tsMonthBegin = 0xFF,
    .rainMonthBegin = 0,
    .rainPrev = 0,
-   .rainOvf = 0
+   .rainOvf = 0,
+   .peakIdx = {0},
+   .peakFirst = 0,
+   .peakCount = 0,
+   .tsPrev = 0
   };
 
   RainGauge rainGauge(&data07);
@@ -845,7 +881,11 @@ TEST(TestRainGauge, RainHourOvMidnight) {
    .tsMonthBegin = 0xFF,
    .rainMonthBegin = 0,
    .rainPrev = 0,
-   .rainOvf = 0
+   .rainOvf = 0,
+   .peakIdx = {0},
+   .peakFirst = 0,
+   .peakCount = 0,
+   .tsPrev = 0
   };
 
   RainGauge rainGauge(&data08);
@@ -948,7 +988,11 @@ TEST(TestRainGauge, RainDailyOv) {
    .tsMonthBegin = 0xFF,
    .rainMonthBegin = 0,
    .rainPrev = 0,
-   .rainOvf = 0
+   .rainOvf = 0,
+   .peakIdx = {0},
+   .peakFirst = 0,
+   .peakCount = 0,
+   .tsPrev = 0
   };
 
   RainGauge rainGauge(&data09);
@@ -1013,7 +1057,11 @@ TEST(TestRainGauge, RainWeeklyOv) {
    .tsMonthBegin = 0xFF,
    .rainMonthBegin = 0,
    .rainPrev = 0,
-   .rainOvf = 0
+   .rainOvf = 0,
+   .peakIdx = {0},
+   .peakFirst = 0,
+   .peakCount = 0,
+   .tsPrev = 0
   };
 
   RainGauge rainGauge(&data10);
@@ -1090,7 +1138,11 @@ TEST(TestRainGauge, RainMonthlyOv) {
    .tsMonthBegin = 0xFF,
    .rainMonthBegin = 0,
    .rainPrev = 0,
-   .rainOvf = 0
+   .rainOvf = 0,
+   .peakIdx = {0},
+   .peakFirst = 0,
+   .peakCount = 0,
+   .tsPrev = 0
   };
 
   RainGauge rainGauge(&data11);
@@ -1237,7 +1289,11 @@ TEST(TestRainGauge, TestRainStartup) {
    .tsMonthBegin = 0xFF,
    .rainMonthBegin = 0,
    .rainPrev = 0,
-   .rainOvf = 0
+   .rainOvf = 0,
+   .peakIdx = {0},
+   .peakFirst = 0,
+   .peakCount = 0,
+   .tsPrev = 0
   };
 
   RainGauge rainGauge(&data12);
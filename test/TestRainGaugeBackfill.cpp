@@ -0,0 +1,150 @@
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// TestRainGaugeBackfill.cpp
+//
+// Unit tests for RainGauge::backfill() - same state as sequential updates
+//
+// https://github.com/matthias-bs/BresserWeatherSensorReceiver
+//
+//
+// created: 10/2026
+//
+//
+// MIT License
+//
+// Copyright (c) 2026 Matthias Prinke
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+// History:
+//
+// 20261016 Created
+// 20261017 Use helpers from RainTestUtil.h
+//
+// ToDo:
+// -
+//
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+
+#include <gtest/gtest.h>
+#include <string.h>
+#include <vector>
+
+#include "RainGauge.h"
+#include "RainTestUtil.h"
+#include "TimeZone.h"
+
+// Circular buffer too small for the update rate (overwrites) and large enough
+typedef RainGaugeT<3600, 11, 10> RainGaugeSmall;
+typedef RainGaugeT<3600, 62, 10> RainGauge60s;
+
+/*
+ * Backfill and sequential updates with the same samples, then further sequential updates
+ */
+template <class G, unsigned BufSize>
+static void compare(const std::vector<rainSample_t> &samples, size_t split, const TimeZone *tz, const char *msg)
+{
+  nvDataT<BufSize> dataSeq;
+  nvDataT<BufSize> dataBulk;
+  G seq(&dataSeq);
+  G bulk(&dataBulk);
+
+  memset(&dataSeq, 0, sizeof(dataSeq));
+  memset(&dataBulk, 0, sizeof(dataBulk));
+  seq.reset();
+  bulk.reset();
+  seq.setTimeZone(tz);
+  bulk.setTimeZone(tz);
+
+  for (size_t i = 0; i < split; i++) {
+    seq.update(samples[i].epoch, samples[i].rain, samples[i].startup);
+    bulk.update(samples[i].epoch, samples[i].rain, samples[i].startup);
+  }
+  for (size_t i = split; i < samples.size(); i++) {
+    seq.update(samples[i].epoch, samples[i].rain, samples[i].startup);
+  }
+  bulk.backfill(samples.size() - split, &samples[split]);
+
+  expectSameState(dataSeq, dataBulk, msg);
+  EXPECT_EQ(seq.rainCurr, bulk.rainCurr) << msg;
+  EXPECT_EQ(seq.pastHour(), bulk.pastHour()) << msg;
+  EXPECT_EQ(seq.pastHourPeakRate(), bulk.pastHourPeakRate()) << msg;
+  EXPECT_EQ(seq.currentDay(), bulk.currentDay()) << msg;
+  EXPECT_EQ(seq.currentWeek(), bulk.currentWeek()) << msg;
+  EXPECT_EQ(seq.currentMonth(), bulk.currentMonth()) << msg;
+
+  // Both continue identically
+  time_t t = samples.back().epoch;
+  for (int i = 0; i < 200; i++) {
+    t += 45;
+    seq.update(t, samples.back().rain + 0.1f * (float)i);
+    bulk.update(t, samples.back().rain + 0.1f * (float)i);
+    ASSERT_EQ(seq.pastHourPeakRate(), bulk.pastHourPeakRate()) << msg << " i=" << i;
+  }
+  expectSameState(dataSeq, dataBulk, msg);
+}
+
+
+/*
+ * Regular readings; circular buffer with and without overwrites
+ */
+TEST(TestRainGaugeBackfill, Regular) {
+  TimeZone utc;
+  std::vector<rainSample_t> samples;
+
+  SampleSpec spec(30);
+  spec.restarts = true;
+  makeSamples(samples, 100000, spec);
+  compare<RainGaugeSmall, 11>(samples, 0, &utc, "small");
+  compare<RainGauge60s, 62>(samples, 0, &utc, "60s");
+}
+
+/*
+ * Outages of one day or more, daylight saving time changes
+ */
+TEST(TestRainGaugeBackfill, GapsDst) {
+  TimeZone cet;
+  std::vector<rainSample_t> samples;
+
+  ASSERT_TRUE(cet.loadPosix("CET-1CEST,M3.5.0,M10.5.0/3", 1970, 2100));
+  SampleSpec spec(300);
+  spec.maxGap   = 3 * 86400;
+  spec.weekGaps = true;
+  spec.restarts = true;
+  makeSamples(samples, 100000, spec);
+  compare<RainGaugeSmall, 11>(samples, 0, &cet, "small");
+  compare<RainGauge60s, 62>(samples, 0, &cet, "60s");
+}
+
+/*
+ * Backfill continues from the state of previous updates
+ */
+TEST(TestRainGaugeBackfill, Append) {
+  TimeZone utc;
+  std::vector<rainSample_t> samples;
+
+  SampleSpec spec(120);
+  spec.maxGap   = 3 * 86400;
+  spec.weekGaps = true;
+  spec.restarts = true;
+  makeSamples(samples, 20000, spec);
+  compare<RainGauge60s, 62>(samples, 1, &utc, "split 1");
+  compare<RainGauge60s, 62>(samples, 7777, &utc, "split 7777");
+  compare<RainGauge60s, 62>(samples, samples.size(), &utc, "empty");
+}
@@ -0,0 +1,183 @@
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// TestRainGaugeBuckets.cpp
+//
+// Googletest unit tests for RainGaugeBucketT - time-bucketed rolling window
+//
+// https://github.com/matthias-bs/BresserWeatherSensorReceiver
+//
+//
+// created: 10/2026
+//
+//
+// MIT License
+//
+// Copyright (c) 2026 Matthias Prinke
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+// History:
+//
+// 20261016 Created
+// 20261017 Added test across daylight saving time changes
+//
+// ToDo:
+// -
+//
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include <gtest/gtest.h>
+#include <string.h>
+
+#define TOLERANCE 0.11
+#include "RainGauge.h"
+#include "RainGaugeBuckets.h"
+#include "TimeZone.h"
+
+// 60 one-minute buckets
+typedef RainGaugeBucketT<3600, 60, 10> RainGaugeBuckets;
+
+
+/*
+ * Rolling window does not depend on the update rate
+ */
+TEST(TestRainGaugeBuckets, UpdateRates) {
+  TimeZone utc;
+  int      rates[] = {1, 12, 60, 360, 600};
+
+  for (size_t r = 0; r < sizeof(rates) / sizeof(rates[0]); r++) {
+    nvBucketDataT<60> data;
+    memset(&data, 0, sizeof(data));
+    RainGaugeBuckets rainGauge(&data);
+    rainGauge.reset();
+    rainGauge.setTimeZone(&utc);
+
+    // 2022-09-06 23:00 UTC, 0.1 mm/min for 3 hours across midnight
+    time_t t0 = 1662505200;
+    for (int s = 0; s <= 3 * 3600; s += rates[r]) {
+      rainGauge.update(t0 + s, 0.1f * (float)(s / 60));
+      if (s >= 3600 && s % 600 == 0) {
+        ASSERT_NEAR(6.0, rainGauge.pastHour(), TOLERANCE) << "rate " << rates[r] << " s, t=" << s;
+      }
+    }
+  }
+}
+
+
+/*
+ * Burst of readings within one time slot
+ */
+TEST(TestRainGaugeBuckets, Burst) {
+  TimeZone utc;
+
+  nvBucketDataT<60> data;
+  memset(&data, 0, sizeof(data));
+  RainGaugeBuckets rainGauge(&data);
+  rainGauge.reset();
+  rainGauge.setTimeZone(&utc);
+
+  // 2022-09-06 08:00 UTC
+  time_t t0 = 1662451200;
+  rainGauge.update(t0, 10.0);
+  for (int i = 1; i <= 10000; i++) {
+    rainGauge.update(t0 + 30, 10.0f + 0.001f * i);
+  }
+  ASSERT_NEAR(10.0, rainGauge.pastHour(), TOLERANCE);
+
+  // Burst leaves the window after one hour
+  rainGauge.update(t0 + 3600 - 60, 20.0);
+  ASSERT_NEAR(10.0, rainGauge.pastHour(), TOLERANCE);
+  rainGauge.update(t0 + 3600, 20.0);
+  ASSERT_NEAR(0, rainGauge.pastHour(), TOLERANCE);
+
+  // Gap longer than window
+  rainGauge.update(t0 + 5 * 3600, 21.0);
+  ASSERT_NEAR(1.0, rainGauge.pastHour(), TOLERANCE);
+}
+
+
+/*
+ * Daily, weekly and monthly rainfall and overflow handling as with RainGauge
+ */
+TEST(TestRainGaugeBuckets, Calendar) {
+  TimeZone utc;
+
+  nvBucketDataT<60> dataBuckets;
+  nvData_t          data;
+  memset(&dataBuckets, 0, sizeof(dataBuckets));
+  memset(&data, 0, sizeof(data));
+  RainGaugeBuckets rainGaugeBuckets(&dataBuckets);
+  RainGauge        rainGauge(&data);
+  rainGaugeBuckets.reset();
+  rainGauge.reset();
+  rainGaugeBuckets.setTimeZone(&utc);
+  rainGauge.setTimeZone(&utc);
+
+  // 2022-08-25 00:00 UTC, 6 minute interval for 45 days, rain gauge overflow at 100 mm
+  time_t t0   = 1661385600;
+  float  rain = 0;
+  for (int i = 0; i < 45 * 240; i++) {
+    rain += (float)(i % 3) * 0.1f;
+    if (rain >= RAINGAUGE_MAX_VALUE)
+      rain -= RAINGAUGE_MAX_VALUE;
+    rainGaugeBuckets.update(t0 + i * 360, rain);
+    rainGauge.update(t0 + i * 360, rain);
+
+    ASSERT_FLOAT_EQ(rainGauge.currentDay(),   rainGaugeBuckets.currentDay());
+    ASSERT_FLOAT_EQ(rainGauge.currentWeek(),  rainGaugeBuckets.currentWeek());
+    ASSERT_FLOAT_EQ(rainGauge.currentMonth(), rainGaugeBuckets.currentMonth());
+    if (i > 20) {
+      ASSERT_NEAR(rainGauge.pastHour(), rainGaugeBuckets.pastHour(), 0.21);
+    }
+  }
+}
+
+
+/*
+ * Rolling window is continuous across daylight saving time changes - no readings are dropped
+ */
+TEST(TestRainGaugeBuckets, DaylightSavingTime) {
+  TimeZone utc;
+  TimeZone cet;
+
+  ASSERT_TRUE(cet.loadPosix("CET-1CEST,M3.5.0,M10.5.0/3"));
+
+  // 2023-03-25 22:00 UTC and 2023-10-28 22:00 UTC, 0.1 mm/min for 6 hours across the change
+  time_t t0[] = {1679781600, 1698530400};
+  for (size_t k = 0; k < sizeof(t0) / sizeof(t0[0]); k++) {
+    nvBucketDataT<60> dataUtc;
+    nvBucketDataT<60> dataCet;
+    memset(&dataUtc, 0, sizeof(dataUtc));
+    memset(&dataCet, 0, sizeof(dataCet));
+    RainGaugeBuckets rainGaugeUtc(&dataUtc);
+    RainGaugeBuckets rainGaugeCet(&dataCet);
+    rainGaugeUtc.reset();
+    rainGaugeCet.reset();
+    rainGaugeUtc.setTimeZone(&utc);
+    rainGaugeCet.setTimeZone(&cet);
+
+    for (int s = 0; s <= 6 * 3600; s += 60) {
+      rainGaugeUtc.update(t0[k] + s, 0.1f * (float)(s / 60));
+      rainGaugeCet.update(t0[k] + s, 0.1f * (float)(s / 60));
+      ASSERT_FLOAT_EQ(rainGaugeUtc.pastHour(), rainGaugeCet.pastHour()) << "t=" << t0[k] + s;
+      if (s >= 3600) {
+        ASSERT_NEAR(6.0, rainGaugeCet.pastHour(), TOLERANCE) << "t=" << t0[k] + s;
+      }
+    }
+  }
+}
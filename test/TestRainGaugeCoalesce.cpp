@@ -0,0 +1,209 @@
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// TestRainGaugeCoalesce.cpp
+//
+// Unit tests for RainGauge coalescing mode - same statistics as without coalescing
+//
+// https://github.com/matthias-bs/BresserWeatherSensorReceiver
+//
+//
+// created: 10/2026
+//
+//
+// MIT License
+//
+// Copyright (c) 2026 Matthias Prinke
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+// History:
+//
+// 20261016 Created
+// 20261017 Use helpers from RainTestUtil.h
+//
+// ToDo:
+// -
+//
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+
+
+#include <gtest/gtest.h>
+#include <string.h>
+#include <vector>
+
+#include "RainGauge.h"
+#include "RainTestUtil.h"
+#include "TimeZone.h"
+
+// Circular buffer large enough for the update rate (no overwrites)
+typedef RainGaugeT<3600, 512, 10> RainGaugeLarge;
+
+/*
+ * Circular buffer entries stored and removed, counted from the movement of head and tail
+ * (the buffer must not overflow)
+ */
+struct BufCount {
+  uint32_t stores;
+  uint32_t evictions;
+  unsigned head;
+  unsigned tail;
+
+  BufCount(const nvDataT<512> &data) : stores(0), evictions(0), head(data.head), tail(data.tail) {}
+
+  void update(const nvDataT<512> &data) {
+    stores    += (data.head + 512 - head) % 512;
+    evictions += (data.tail + 512 - tail) % 512;
+    head       = data.head;
+    tail       = data.tail;
+  }
+};
+
+/*
+ * Updates with and without coalescing; returns stores with coalescing
+ *
+ * The peak rain rates only match for a non-decreasing rain counter: coalescing drops intervals
+ * with zero rate, which are the maximum if all other intervals in the window are negative
+ * (e.g. after repeated sensor restarts).
+ */
+static uint32_t compare(const std::vector<rainSample_t> &samples, const TimeZone *tz, bool peak, const char *msg)
+{
+  nvDataT<512> dataRef;
+  nvDataT<512> dataCoal;
+  RainGaugeLarge ref(&dataRef);
+  RainGaugeLarge coal(&dataCoal);
+
+  memset(&dataRef, 0, sizeof(dataRef));
+  memset(&dataCoal, 0, sizeof(dataCoal));
+  ref.reset();
+  coal.reset();
+  ref.setTimeZone(tz);
+  coal.setTimeZone(tz);
+  coal.setCoalescing(true);
+
+  BufCount refCount(dataRef);
+  BufCount coalCount(dataCoal);
+  for (size_t i = 0; i < samples.size(); i++) {
+    ref.update(samples[i].epoch, samples[i].rain, samples[i].startup);
+    coal.update(samples[i].epoch, samples[i].rain, samples[i].startup);
+    refCount.update(dataRef);
+    coalCount.update(dataCoal);
+    EXPECT_EQ(ref.pastHour(), coal.pastHour()) << msg << " i=" << i;
+    if (peak) {
+      EXPECT_EQ(ref.pastHourPeakRate(), coal.pastHourPeakRate()) << msg << " i=" << i;
+    }
+    if (::testing::Test::HasFailure()) {
+      return 0;
+    }
+  }
+  EXPECT_EQ(ref.currentDay(), coal.currentDay()) << msg;
+  EXPECT_EQ(ref.currentWeek(), coal.currentWeek()) << msg;
+  EXPECT_EQ(ref.currentMonth(), coal.currentMonth()) << msg;
+
+  // Without coalescing, every reading is stored
+  EXPECT_EQ(samples.size(), refCount.stores) << msg;
+  EXPECT_LE(coalCount.stores, refCount.stores) << msg;
+  EXPECT_LE(coalCount.evictions, refCount.evictions) << msg;
+  return coalCount.stores;
+}
+
+
+/*
+ * Readings with given mean interval, fraction of wet days, outages of up to 20 hours
+ * (with time stamps of seconds since midnight, longer gaps are aliased to shorter ones
+ * and the statistics depend on the entries stored before) and sensor restarts
+ */
+static void makeSamples(std::vector<rainSample_t> &samples, size_t n, unsigned interval, unsigned wetPercent, bool gaps,
+                        bool restarts)
+{
+  SampleSpec spec(interval);
+
+  spec.wetPercent = wetPercent;
+  spec.maxGap     = gaps ? 72000 : 0;
+  spec.restarts   = restarts;
+  makeSamples(samples, n, spec);
+}
+
+
+/*
+ * Showers on every day; regular readings
+ */
+TEST(TestRainGaugeCoalesce, Wet) {
+  TimeZone utc;
+  std::vector<rainSample_t> samples;
+
+  makeSamples(samples, 50000, 30, 100, false, false);
+  compare(samples, &utc, true, "wet");
+}
+
+/*
+ * Mostly dry days; outages, daylight saving time changes and sensor restarts
+ */
+TEST(TestRainGaugeCoalesce, DryGapsDst) {
+  TimeZone cet;
+  std::vector<rainSample_t> samples;
+
+  ASSERT_TRUE(cet.loadPosix("CET-1CEST,M3.5.0,M10.5.0/3", 1970, 2100));
+  makeSamples(samples, 100000, 120, 20, true, false);
+  compare(samples, &cet, true, "dry");
+  makeSamples(samples, 100000, 120, 20, true, true);
+  compare(samples, &cet, false, "dry restarts");
+}
+
+/*
+ * Stores drop with the fraction of dry days
+ */
+TEST(TestRainGaugeCoalesce, Stores) {
+  TimeZone utc;
+  std::vector<rainSample_t> samples;
+
+  makeSamples(samples, 50000, 30, 0, false, false);
+  uint32_t dry = compare(samples, &utc, true, "all dry");
+
+  makeSamples(samples, 50000, 30, 50, false, false);
+  uint32_t half = compare(samples, &utc, true, "half wet");
+
+  // Without rain, about one entry per window
+  EXPECT_LT(dry, samples.size() / 50);
+  EXPECT_LT(dry, half);
+  EXPECT_LT(half, samples.size() / 2);
+}
+
+/*
+ * Without coalescing, the circular buffer is the same as before (every reading stored)
+ */
+TEST(TestRainGaugeCoalesce, Disabled) {
+  nvDataT<512> data;
+  RainGaugeLarge rg(&data);
+  TimeZone utc;
+
+  memset(&data, 0, sizeof(data));
+  rg.reset();
+  rg.setTimeZone(&utc);
+
+  BufCount count(data);
+  for (int i = 0; i < 100; i++) {
+    rg.update(T_BEGIN + 60 * i, 10.0f);
+    count.update(data);
+    EXPECT_EQ((unsigned)(i + 1), data.head);
+    EXPECT_EQ(data.ts(data.head), data.tsPrev);
+  }
+  EXPECT_EQ(100u, count.stores);
+  // Initial tail entry and 39 readings older than one hour
+  EXPECT_EQ(40u, count.evictions);
+}
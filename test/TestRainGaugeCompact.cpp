@@ -0,0 +1,139 @@
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// TestRainGaugeCompact.cpp
+//
+// Unit tests for RainGaugeCompactT (delta-encoded circular buffer)
+//
+// https://github.com/matthias-bs/BresserWeatherSensorReceiver
+//
+//
+// created: 10/2026
+//
+//
+// MIT License
+//
+// Copyright (c) 2026 Matthias Prinke
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+// History:
+//
+// 20261016 Created
+// 20261017 Use helpers from RainTestUtil.h
+//
+// ToDo:
+// -
+//
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+
+#include <gtest/gtest.h>
+#include <string.h>
+
+#define TOLERANCE 0.11
+#include "RainGauge.h"
+#include "RainGaugeCompact.h"
+#include "RainTestUtil.h"
+#include "TimeZone.h"
+
+// Update rate of 360 s - one spare entry
+typedef RainGaugeCompactT<3600, 12, 10> RainGaugeCompact;
+
+static_assert(sizeof(nvCompactDataT<RAINGAUGE_BUF_SIZE>) < sizeof(nvData_t), "compact buffer is smaller");
+static_assert(sizeof(nvCompactDataT<62>) < sizeof(nvDataT<62>), "compact buffer is smaller");
+
+
+/*
+ * Same results as RainGaugeT - irregular update rate, across midnight, full buffer
+ */
+TEST(TestRainGaugeCompact, MatchesRainGaugeT) {
+  TimeZone utc;
+
+  nvCompactDataT<62> data;
+  nvDataT<62>        dataRef;
+  nvCompactDataT<8>  dataSmall;
+  nvDataT<8>         dataSmallRef;
+  RainGaugeCompactT<3600, 62, 10> rainGauge(&data);
+  RainGaugeT<3600, 62, 10>        rainGaugeRef(&dataRef);
+  RainGaugeCompactT<3600, 8, 10>  rainGaugeSmall(&dataSmall);
+  RainGaugeT<3600, 8, 10>         rainGaugeSmallRef(&dataSmallRef);
+  initGauge(rainGauge, data, &utc);
+  initGauge(rainGaugeRef, dataRef, &utc);
+  initGauge(rainGaugeSmall, dataSmall, &utc);
+  initGauge(rainGaugeSmallRef, dataSmallRef, &utc);
+
+  // 2022-09-06 21:00 UTC
+  time_t t    = 1662498000;
+  float  rain = 0;
+  for (int i = 0; i < 600; i++) {
+    t    += 60 * (1 + (i * 5) % 7);
+    rain += (float)((i * 13) % 9) * 0.1f;
+    rainGauge.update(t, rain);
+    rainGaugeRef.update(t, rain);
+    rainGaugeSmall.update(t, rain);
+    rainGaugeSmallRef.update(t, rain);
+    ASSERT_NEAR(rainGaugeRef.pastHour(), rainGauge.pastHour(), 0.001) << "i=" << i;
+    ASSERT_NEAR(rainGaugeSmallRef.pastHour(), rainGaugeSmall.pastHour(), 0.001) << "i=" << i;
+    ASSERT_FLOAT_EQ(rainGaugeRef.currentDay(), rainGauge.currentDay()) << "i=" << i;
+  }
+}
+
+/*
+ * No wraparound of rolling window beyond 6553.5 mm accumulated rain
+ */
+TEST(TestRainGaugeCompact, NoWrapAround) {
+  TimeZone utc;
+
+  nvCompactDataT<12> data;
+  RainGaugeCompact rainGauge(&data);
+  initGauge(rainGauge, data, &utc);
+
+  // 2022-09-06 00:00 UTC, 60 mm every 6 minutes, rain gauge overflow at 1000 mm
+  time_t t0 = 1662422400;
+  for (int i = 0; i <= 200; i++) {
+    rainGauge.update(t0 + i * 360, (float)((i * 60) % 1000), false, 1000.0f);
+    if (i >= 10) {
+      ASSERT_NEAR(600.0, rainGauge.pastHour(), TOLERANCE) << "i=" << i;
+    }
+  }
+  ASSERT_NEAR(12000.0, rainGauge.rainCurr, TOLERANCE);
+  ASSERT_NEAR(12000.0, rainGauge.currentDay(), TOLERANCE);
+}
+
+/*
+ * Partial reset of the rolling window
+ */
+TEST(TestRainGaugeCompact, ResetHour) {
+  TimeZone utc;
+
+  nvCompactDataT<12> data;
+  RainGaugeCompact rainGauge(&data);
+  initGauge(rainGauge, data, &utc);
+
+  // 2022-09-06 08:00 UTC, 0.5 mm every 6 minutes
+  time_t t0 = 1662451200;
+  for (int i = 0; i <= 5; i++) {
+    rainGauge.update(t0 + i * 360, 10.0f + 0.5f * i);
+  }
+  ASSERT_NEAR(2.5, rainGauge.pastHour(), TOLERANCE);
+  ASSERT_NEAR(2.5, rainGauge.currentDay(), TOLERANCE);
+
+  rainGauge.reset(RESET_RAIN_H);
+  ASSERT_NEAR(0, rainGauge.pastHour(), TOLERANCE);
+  ASSERT_NEAR(2.5, rainGauge.currentDay(), TOLERANCE);
+}
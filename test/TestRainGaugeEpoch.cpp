@@ -0,0 +1,250 @@
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// TestRainGaugeEpoch.cpp
+//
+// Googletest unit tests for RainGauge - update() with epoch time stamps
+//
+// https://github.com/matthias-bs/BresserWeatherSensorReceiver
+//
+//
+// created: 10/2026
+//
+//
+// MIT License
+//
+// Copyright (c) 2026 Matthias Prinke
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+// History:
+//
+// 20261016 Created
+// 20261017 Added tests across the midnight after DST changes (libc and TimeZone)
+// 20261017 Use helpers from RainTestUtil.h
+//
+// ToDo: 
+// -
+//
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+
+#include <gtest/gtest.h>
+#include <stdlib.h>
+#include <string>
+
+#define TOLERANCE 0.11
+#include "RainGauge.h"
+#include "RainTestUtil.h"
+#include "TimeZone.h"
+
+
+static nvData_t nvDataInit(void)
+{
+  nvData_t data = {
+   .tsBuf = {0},
+   .rainBuf = {0}, 
+   .head = 0,
+   .tail = 0,
+   .startupPrev = false,
+   .rainStartup = 0,
+   .tsDayBegin = 0xFF,
+   .rainDayBegin = 0,
+   .tsWeekBegin = 0xFF,
+   .rainWeekBegin = 0,
+   .wdayPrev = 0xFF,
+   .tsMonthBegin = 0xFF,
+   .rainMonthBegin = 0,
+   .rainPrev = 0,
+   .rainOvf = 0,
+   .peakIdx = {0},
+   .peakFirst = 0,
+   .peakCount = 0,
+   .tsPrev = 0
+  };
+  return data;
+}
+
+/*
+ * Feed identical readings via update(tm) and update(time_t) and compare all statistics
+ *
+ * The epoch updates use the given timezone table, or the libc local time if zone is NULL.
+ */
+static void compareTmEpoch(time_t t0, int count, int interval, const TimeZone *zone = NULL)
+{
+  nvData_t  dataTm    = nvDataInit();
+  nvData_t  dataEpoch = nvDataInit();
+  RainGauge rainGaugeTm(&dataTm);
+  RainGauge rainGaugeEpoch(&dataEpoch);
+  rainGaugeTm.reset();
+  rainGaugeEpoch.reset();
+  rainGaugeEpoch.setTimeZone(zone);
+
+  float rain = 0;
+  for (int i = 0; i < count; i++) {
+    time_t t = t0 + (time_t)i * interval;
+    tm     tm;
+    localtime_r(&t, &tm);
+
+    // Rain gauge overflow at 100 mm
+    rain += (i % 7) * 0.3f;
+    if (rain >= RAINGAUGE_MAX_VALUE)
+      rain -= RAINGAUGE_MAX_VALUE;
+
+    rainGaugeTm.update(tm, rain);
+    rainGaugeEpoch.update(t, rain);
+
+    ASSERT_FLOAT_EQ(rainGaugeTm.pastHour(),     rainGaugeEpoch.pastHour());
+    ASSERT_FLOAT_EQ(rainGaugeTm.currentDay(),   rainGaugeEpoch.currentDay());
+    ASSERT_FLOAT_EQ(rainGaugeTm.currentWeek(),  rainGaugeEpoch.currentWeek());
+    ASSERT_FLOAT_EQ(rainGaugeTm.currentMonth(), rainGaugeEpoch.currentMonth());
+  }
+  ASSERT_EQ(0, memcmp(&dataTm, &dataEpoch, sizeof(nvData_t)));
+}
+
+
+/*
+ * Epoch and struct tm updates are equivalent in UTC
+ */
+TEST(TestRainGaugeEpoch, CompareUtc) {
+  TzGuard tz("UTC0");
+
+  // 2022-09-06 08:00 UTC, 6 minute interval, 40 days
+  compareTmEpoch(1662451200, 40 * 240, 360);
+
+  // 2023-12-30 23:30:17 UTC, odd seconds, 7 minute interval across new year
+  compareTmEpoch(1703979017, 2000, 420);
+}
+
+
+/*
+ * Epoch and struct tm updates are equivalent in local time without DST change
+ */
+TEST(TestRainGaugeEpoch, CompareLocal) {
+  TzGuard tz("CET-1CEST,M3.5.0,M10.5.0/3");
+
+  // 2022-09-06 08:00 CEST, 5 minute interval, 30 days
+  compareTmEpoch(1662444000, 30 * 288, 300);
+}
+
+
+/*
+ * Change to daylight saving time - time stamps are wall clock time as with update(tm)
+ */
+TEST(TestRainGaugeEpoch, DaylightSavingTime) {
+  TzGuard tz("CET-1CEST,M3.5.0,M10.5.0/3");
+
+  nvData_t  data = nvDataInit();
+  RainGauge rainGauge(&data);
+  rainGauge.reset();
+
+  // 2023-03-26 01:00 CET
+  time_t t0 = 1679788800;
+
+  rainGauge.update(t0, 10.0);
+  ASSERT_NEAR(0, rainGauge.pastHour(), TOLERANCE);
+
+  // 01:55 CET
+  rainGauge.update(t0 + 55 * 60, 10.5);
+  ASSERT_NEAR(0.5, rainGauge.pastHour(), TOLERANCE);
+
+  // 03:05 CEST - 65 minutes elapsed since 01:00 CET, wall clock shows 125 minutes;
+  // the window is empty except for the previous reading
+  rainGauge.update(t0 + 65 * 60, 11.5);
+  ASSERT_NEAR(1.0, rainGauge.pastHour(), TOLERANCE);
+  ASSERT_NEAR(1.5, rainGauge.currentDay(), TOLERANCE);
+
+  // 2023-03-27 00:10 CEST - new day
+  rainGauge.update(t0 + 22 * 3600 + 70 * 60, 12.0);
+  ASSERT_NEAR(0.5, rainGauge.pastHour(), TOLERANCE);
+  ASSERT_NEAR(0, rainGauge.currentDay(), TOLERANCE);
+  ASSERT_NEAR(0, rainGauge.currentWeek(), TOLERANCE);
+}
+
+
+/*
+ * Readings every 6 minutes with 0.1 mm each across the midnight following a DST change
+ *
+ * \param t0  epoch of first reading (12 hours before the change)
+ *
+ * \param t24 epoch of the following local midnight
+ *
+ * \param zone timezone table or NULL for libc local time
+ */
+static void midnightAfterDst(time_t t0, time_t t24, const TimeZone *zone = NULL)
+{
+  nvData_t  data = nvDataInit();
+  RainGauge rainGauge(&data);
+  rainGauge.reset();
+  rainGauge.setTimeZone(zone);
+
+  float rain = 0;
+  for (time_t t = t0; t <= t24 + 3600; t += 360) {
+    rain += 0.1f;
+    rainGauge.update(t, rain);
+    if (t >= t24) {
+      ASSERT_NEAR(1.0, rainGauge.pastHour(), TOLERANCE) << "t=" << t;
+    }
+  }
+}
+
+
+/*
+ * Epoch and struct tm updates are equivalent across DST changes and the following midnight
+ */
+TEST(TestRainGaugeEpoch, CompareDst) {
+  TzGuard tz("CET-1CEST,M3.5.0,M10.5.0/3");
+
+  // 2023-03-25 12:00 CET, 6 minute interval, 2 days
+  compareTmEpoch(1679742000, 2 * 240, 360);
+
+  // 2023-10-28 12:00 CEST, 6 minute interval, 2 days
+  compareTmEpoch(1698487200, 2 * 240, 360);
+}
+
+
+/*
+ * Rolling window after the midnight following a DST change
+ */
+TEST(TestRainGaugeEpoch, MidnightAfterDst) {
+  TzGuard tz("CET-1CEST,M3.5.0,M10.5.0/3");
+
+  // 2023-03-25 14:00 CET ... 2023-03-27 00:00 CEST (22:00 UTC)
+  midnightAfterDst(1679749200, 1679868000);
+
+  // 2023-10-28 14:00 CEST ... 2023-10-30 00:00 CET (23:00 UTC)
+  midnightAfterDst(1698494400, 1698620400);
+}
+
+
+/*
+ * Same with timezone tables from POSIX rule and tzdata (if installed)
+ */
+TEST(TestRainGaugeEpoch, DstTimeZone) {
+  TzGuard  tz("CET-1CEST,M3.5.0,M10.5.0/3");
+  TimeZone zones[2];
+
+  ASSERT_TRUE(zones[0].loadPosix("CET-1CEST,M3.5.0,M10.5.0/3"));
+  size_t n = zones[1].load("Europe/Berlin") ? 2 : 1;
+
+  for (size_t i = 0; i < n; i++) {
+    compareTmEpoch(1679742000, 2 * 240, 360, &zones[i]);
+    compareTmEpoch(1698487200, 2 * 240, 360, &zones[i]);
+    midnightAfterDst(1679749200, 1679868000, &zones[i]);
+    midnightAfterDst(1698494400, 1698620400, &zones[i]);
+  }
+}
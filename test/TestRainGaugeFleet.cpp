@@ -0,0 +1,214 @@
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// TestRainGaugeFleet.cpp
+//
+// Unit tests for RainGaugeFleetT (structure-of-arrays store with batch update)
+//
+// https://github.com/matthias-bs/BresserWeatherSensorReceiver
+//
+//
+// created: 10/2026
+//
+//
+// MIT License
+//
+// Copyright (c) 2026 Matthias Prinke
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+// History:
+//
+// 20261016 Created
+//
+// ToDo:
+// -
+//
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+
+#include <gtest/gtest.h>
+#include <math.h>
+#include <string.h>
+
+#define TOLERANCE 0.11
+#include "RainGauge.h"
+#include "RainGaugeFleet.h"
+#include "TimeZone.h"
+
+#define GAUGES 5
+
+// Update rates down to 60 s - one spare entry
+typedef RainGaugeFleetT<3600, 62, 10> Fleet60s;
+typedef RainGaugeT<3600, 62, 10>      RainGauge60s;
+
+
+/*
+ * Interleaved batches give the same results as independent RainGaugeT instances
+ */
+TEST(TestRainGaugeFleet, MatchesRainGaugeT) {
+  TimeZone utc;
+
+  Fleet60s fleet(GAUGES);
+  fleet.setTimeZone(&utc);
+
+  nvDataT<62>   data[GAUGES];
+  RainGauge60s *rainGauge[GAUGES];
+  for (int g = 0; g < GAUGES; g++) {
+    memset(&data[g], 0, sizeof(data[g]));
+    rainGauge[g] = new RainGauge60s(&data[g]);
+    rainGauge[g]->reset();
+    rainGauge[g]->setTimeZone(&utc);
+  }
+
+  // 2022-09-04 20:00 UTC (Sunday), batches of up to 2 * GAUGES readings for three days
+  time_t t    = 1662321600;
+  float  rain[GAUGES] = {0};
+  for (int b = 0; b < 800; b++) {
+    uint32_t ids[2 * GAUGES];
+    time_t   epochs[2 * GAUGES];
+    float    values[2 * GAUGES];
+    size_t   n = 0;
+    for (int k = 0; k < 2 * GAUGES; k++) {
+      uint32_t id = (uint32_t)((b * 3 + k * 7) % GAUGES);
+      if ((b + k) % 3 == 0)
+        continue;
+      t += 20;
+      rain[id] += (float)((b * 13 + id) % 9) * 0.1f;
+      ids[n]    = id;
+      epochs[n] = t;
+      values[n] = (float)fmod(rain[id], 100.0);
+      n++;
+    }
+    fleet.updateBatch(n, ids, epochs, values);
+    for (size_t k = 0; k < n; k++) {
+      rainGauge[ids[k]]->update(epochs[k], values[k]);
+    }
+    for (int g = 0; g < GAUGES; g++) {
+      ASSERT_FLOAT_EQ(rainGauge[g]->pastHour(), fleet.pastHour(g)) << "b=" << b << " g=" << g;
+      ASSERT_FLOAT_EQ(rainGauge[g]->currentDay(), fleet.currentDay(g)) << "b=" << b << " g=" << g;
+      ASSERT_FLOAT_EQ(rainGauge[g]->currentWeek(), fleet.currentWeek(g)) << "b=" << b << " g=" << g;
+      ASSERT_FLOAT_EQ(rainGauge[g]->currentMonth(), fleet.currentMonth(g)) << "b=" << b << " g=" << g;
+    }
+  }
+  for (int g = 0; g < GAUGES; g++) {
+    delete rainGauge[g];
+  }
+}
+
+/*
+ * Import and export of non-volatile data of a single rain gauge
+ */
+TEST(TestRainGaugeFleet, LoadStore) {
+  TimeZone utc;
+
+  Fleet60s fleet(GAUGES);
+  fleet.setTimeZone(&utc);
+
+  nvDataT<62> data;
+  memset(&data, 0, sizeof(data));
+  RainGauge60s rainGauge(&data);
+  rainGauge.reset();
+  rainGauge.setTimeZone(&utc);
+
+  // 2022-09-06 08:00 UTC, overflow at 100 mm
+  time_t t0 = 1662451200;
+  for (int i = 0; i < 30; i++) {
+    rainGauge.update(t0 + i * 120, (float)fmod(95.0 + 0.7 * i, 100.0));
+  }
+  fleet.load(3, data);
+  EXPECT_FLOAT_EQ(rainGauge.rainCurr, fleet.current(3));
+  EXPECT_FLOAT_EQ(rainGauge.pastHour(), fleet.pastHour(3));
+
+  for (int i = 30; i < 60; i++) {
+    uint32_t id    = 3;
+    time_t   epoch = t0 + i * 120;
+    float    value = (float)fmod(95.0 + 0.7 * i, 100.0);
+    rainGauge.update(epoch, value);
+    fleet.updateBatch(1, &id, &epoch, &value);
+  }
+
+  nvDataT<62> stored;
+  memset(&stored, 0, sizeof(stored));
+  fleet.store(3, stored);
+  RainGauge60s rainGaugeStored(&stored);
+  rainGaugeStored.rainCurr = fleet.current(3);
+  EXPECT_FLOAT_EQ(rainGauge.pastHour(), rainGaugeStored.pastHour());
+  EXPECT_FLOAT_EQ(rainGauge.currentDay(), rainGaugeStored.currentDay());
+  EXPECT_FLOAT_EQ(rainGauge.pastHourPeakRate(), rainGaugeStored.pastHourPeakRate());
+  EXPECT_EQ(0, memcmp(data.tsBuf, stored.tsBuf, sizeof(data.tsBuf)));
+  EXPECT_EQ(0, memcmp(data.rainBuf, stored.rainBuf, sizeof(data.rainBuf)));
+  EXPECT_EQ(0, memcmp(data.tsHigh, stored.tsHigh, sizeof(data.tsHigh)));
+
+  // Other gauges are not affected
+  EXPECT_FLOAT_EQ(0, fleet.current(2));
+  EXPECT_FLOAT_EQ(0, fleet.pastHour(4));
+}
+
+/*
+ * Sensor startup and partial reset
+ */
+TEST(TestRainGaugeFleet, StartupReset) {
+  TimeZone utc;
+
+  RainGaugeFleet fleet(2);
+  fleet.setTimeZone(&utc);
+
+  // 2022-09-06 08:00 UTC
+  uint32_t ids[2]     = {0, 1};
+  time_t   epochs[2]  = {1662451200, 1662451200};
+  float    values[2]  = {10.0f, 10.0f};
+  bool     startup[2] = {false, false};
+  fleet.updateBatch(2, ids, epochs, values, startup);
+
+  // Gauge 0: sensor startup; gauge 1: overflow
+  epochs[0] = epochs[1] = 1662451200 + 360;
+  values[0] = values[1] = 1.0f;
+  startup[0] = true;
+  fleet.updateBatch(2, ids, epochs, values, startup);
+  EXPECT_NEAR(11.0, fleet.current(0), TOLERANCE);
+  EXPECT_NEAR(101.0, fleet.current(1), TOLERANCE);
+
+  fleet.reset(1, RESET_RAIN_D);
+  EXPECT_NEAR(101.0, fleet.currentDay(1), TOLERANCE);
+  EXPECT_NEAR(1.0, fleet.currentDay(0), TOLERANCE);
+}
+
+/*
+ * Readings with out-of-range ids are ignored
+ */
+TEST(TestRainGaugeFleet, InvalidId) {
+  TimeZone utc;
+
+  RainGaugeFleet fleet(2);
+  fleet.setTimeZone(&utc);
+
+  // 2022-09-06 08:00 UTC
+  uint32_t ids[3]    = {0, 2, 1};
+  time_t   epochs[3] = {1662451200, 1662451200, 1662451200};
+  float    values[3] = {10.0f, 20.0f, 30.0f};
+  EXPECT_EQ(2u, fleet.updateBatch(3, ids, epochs, values));
+  EXPECT_NEAR(10.0, fleet.current(0), TOLERANCE);
+  EXPECT_NEAR(30.0, fleet.current(1), TOLERANCE);
+
+  RainReading r[2] = {};
+  r[0].id = 0xFFFFFFFF; r[0].epoch = 1662451200 + 360; r[0].value = 40.0f;
+  r[1].id = 1;          r[1].epoch = 1662451200 + 360; r[1].value = 31.0f;
+  EXPECT_EQ(1u, fleet.update(2, r));
+  EXPECT_NEAR(10.0, fleet.current(0), TOLERANCE);
+  EXPECT_NEAR(1.0, fleet.pastHour(1), TOLERANCE);
+}
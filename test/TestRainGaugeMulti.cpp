@@ -0,0 +1,185 @@
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// TestRainGaugeMulti.cpp
+//
+// Unit tests for RainGaugeMultiT (several rolling windows in one update pass)
+//
+// https://github.com/matthias-bs/BresserWeatherSensorReceiver
+//
+//
+// created: 10/2026
+//
+//
+// MIT License
+//
+// Copyright (c) 2026 Matthias Prinke
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+// History:
+//
+// 20261016 Created
+// 20261017 Added test across daylight saving time changes
+//
+// ToDo:
+// -
+//
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+
+#include <gtest/gtest.h>
+#include <string.h>
+
+#define TOLERANCE 0.11
+#include "RainGauge.h"
+#include "RainGaugeMulti.h"
+#include "TimeZone.h"
+
+// 10 min / 1 h / 3 h / 24 h at one update per 6 minutes (240 entries + 2 spare)
+typedef RainGaugeMultiT<242, 4, 10> RainGaugeMulti;
+
+static const uint32_t windows[4] = {600, 3600, 3 * 3600, 24 * 3600};
+
+
+/*
+ * Windows < 1 day match independent RainGaugeT instances exactly
+ * (all buffers sized for one update per minute)
+ */
+TEST(TestRainGaugeMulti, MatchesSingleWindow) {
+  TimeZone utc;
+
+  nvMultiDataT<1442, 4> data;
+  memset(&data, 0, sizeof(data));
+  RainGaugeMultiT<1442, 4, 10> rainGauge(&data, windows);
+  rainGauge.reset();
+  rainGauge.setTimeZone(&utc);
+
+  nvDataT<12> data10m;
+  nvDataT<62> data1h;
+  nvDataT<182> data3h;
+  memset(&data10m, 0, sizeof(data10m));
+  memset(&data1h, 0, sizeof(data1h));
+  memset(&data3h, 0, sizeof(data3h));
+  RainGaugeT<600, 12, 10>       rainGauge10m(&data10m);
+  RainGaugeT<3600, 62, 10>      rainGauge1h(&data1h);
+  RainGaugeT<3 * 3600, 182, 10> rainGauge3h(&data3h);
+  rainGauge10m.reset();
+  rainGauge1h.reset();
+  rainGauge3h.reset();
+  rainGauge10m.setTimeZone(&utc);
+  rainGauge1h.setTimeZone(&utc);
+  rainGauge3h.setTimeZone(&utc);
+
+  // 2022-09-06 20:00 UTC, irregular rain and update rate across midnight
+  time_t t = 1662494400;
+  float  rain = 0;
+  for (int i = 0; i < 400; i++) {
+    t += (i % 3 == 0) ? 360 : 60 * (1 + i % 5);
+    rain += (float)((i * 7) % 11) / 10;
+    rainGauge.update(t, rain);
+    rainGauge10m.update(t, rain);
+    rainGauge1h.update(t, rain);
+    rainGauge3h.update(t, rain);
+    ASSERT_FLOAT_EQ(rainGauge10m.pastHour(), rainGauge.pastWindow(0)) << "i=" << i;
+    ASSERT_FLOAT_EQ(rainGauge1h.pastHour(),  rainGauge.pastWindow(1)) << "i=" << i;
+    ASSERT_FLOAT_EQ(rainGauge3h.pastHour(),  rainGauge.pastWindow(2)) << "i=" << i;
+    ASSERT_FLOAT_EQ(rainGauge1h.currentDay(), rainGauge.currentDay()) << "i=" << i;
+    ASSERT_FLOAT_EQ(rainGauge1h.currentWeek(), rainGauge.currentWeek()) << "i=" << i;
+    ASSERT_FLOAT_EQ(rainGauge1h.currentMonth(), rainGauge.currentMonth()) << "i=" << i;
+  }
+}
+
+/*
+ * 24 hour window across midnight and rain gauge overflow
+ */
+TEST(TestRainGaugeMulti, Window24h) {
+  TimeZone utc;
+
+  nvMultiDataT<242, 4> data;
+  memset(&data, 0, sizeof(data));
+  RainGaugeMulti rainGauge(&data, windows);
+  rainGauge.reset();
+  rainGauge.setTimeZone(&utc);
+
+  // 2022-09-06 12:00 UTC, 0.1 mm every 6 minutes for two days
+  time_t t0 = 1662465600;
+  for (int i = 0; i <= 480; i++) {
+    rainGauge.update(t0 + i * 360, (float)(i % 200) / 10, false, 20.0f);
+    if (i >= 240) {
+      ASSERT_NEAR(24.0, rainGauge.pastWindow(3), TOLERANCE) << "i=" << i;
+      ASSERT_NEAR(3.0,  rainGauge.pastWindow(2), TOLERANCE) << "i=" << i;
+      ASSERT_NEAR(1.0,  rainGauge.pastWindow(1), TOLERANCE) << "i=" << i;
+      ASSERT_NEAR(0.2,  rainGauge.pastWindow(0), TOLERANCE) << "i=" << i;
+    }
+  }
+  ASSERT_NEAR(48.0, rainGauge.rainCurr, TOLERANCE);
+}
+
+/*
+ * Windows are continuous across daylight saving time changes
+ */
+TEST(TestRainGaugeMulti, DaylightSavingTime) {
+  TimeZone cet;
+
+  ASSERT_TRUE(cet.loadPosix("CET-1CEST,M3.5.0,M10.5.0/3"));
+
+  // 2023-03-25 12:00 UTC and 2023-10-28 12:00 UTC, 0.1 mm every 6 minutes for two days
+  time_t t0[] = {1679745600, 1698494400};
+  for (size_t k = 0; k < sizeof(t0) / sizeof(t0[0]); k++) {
+    nvMultiDataT<242, 4> data;
+    memset(&data, 0, sizeof(data));
+    RainGaugeMulti rainGauge(&data, windows);
+    rainGauge.reset();
+    rainGauge.setTimeZone(&cet);
+
+    for (int i = 0; i <= 480; i++) {
+      rainGauge.update(t0[k] + i * 360, (float)(i % 200) / 10, false, 20.0f);
+      if (i >= 240) {
+        ASSERT_NEAR(24.0, rainGauge.pastWindow(3), TOLERANCE) << "i=" << i;
+        ASSERT_NEAR(1.0,  rainGauge.pastWindow(1), TOLERANCE) << "i=" << i;
+      }
+    }
+  }
+}
+
+/*
+ * Windows are sorted into ascending order
+ */
+TEST(TestRainGaugeMulti, SortedWindows) {
+  TimeZone utc;
+  const uint32_t unsorted[3] = {3600, 600, 1800};
+
+  nvMultiDataT<14, 3> data;
+  memset(&data, 0, sizeof(data));
+  RainGaugeMultiT<14, 3, 10> rainGauge(&data, unsorted);
+  rainGauge.reset();
+  rainGauge.setTimeZone(&utc);
+
+  EXPECT_EQ(600u,  rainGauge.windowLength(0));
+  EXPECT_EQ(1800u, rainGauge.windowLength(1));
+  EXPECT_EQ(3600u, rainGauge.windowLength(2));
+
+  // 1 mm every 5 minutes
+  time_t t0 = 1662465600;
+  for (int i = 0; i <= 36; i++) {
+    rainGauge.update(t0 + i * 300, (float)i);
+  }
+  EXPECT_NEAR(12.0, rainGauge.pastWindow(2), TOLERANCE);
+  EXPECT_NEAR(6.0,  rainGauge.pastWindow(1), TOLERANCE);
+  EXPECT_NEAR(2.0,  rainGauge.pastWindow(0), TOLERANCE);
+}
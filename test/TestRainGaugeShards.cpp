@@ -0,0 +1,123 @@
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// TestRainGaugeShards.cpp
+//
+// Unit tests for RainWorkPool and RainGaugeShardsT (multi-threaded ingestion)
+//
+// https://github.com/matthias-bs/BresserWeatherSensorReceiver
+//
+//
+// created: 10/2026
+//
+//
+// MIT License
+//
+// Copyright (c) 2026 Matthias Prinke
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+// History:
+//
+// 20261016 Created
+//
+// ToDo:
+// -
+//
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+
+#include <gtest/gtest.h>
+#include <atomic>
+#include <vector>
+
+#include "RainGauge.h"
+#include "RainGaugeFleet.h"
+#include "RainGaugeShards.h"
+#include "RainWorkPool.h"
+#include "TimeZone.h"
+
+#define GAUGES 257
+
+
+/*
+ * Every task is executed exactly once per run(), also with uneven task durations
+ */
+TEST(TestRainGaugeShards, WorkPoolTasksOnce) {
+  RainWorkPool pool(3);
+  EXPECT_EQ(3u, pool.size());
+
+  for (int round = 0; round < 50; round++) {
+    std::vector<std::atomic<int> > count(200 + round);
+    for (size_t i = 0; i < count.size(); i++) {
+      count[i] = 0;
+    }
+    pool.run(count.size(), [&count](size_t task) {
+      // The first tasks are much longer than the others
+      volatile unsigned x = 0;
+      for (unsigned i = 0; i < ((task < 10) ? 20000u : 10u); i++) {
+        x = x + i;
+      }
+      count[task]++;
+    });
+    for (size_t i = 0; i < count.size(); i++) {
+      ASSERT_EQ(1, count[i].load()) << "round " << round << " task " << i;
+    }
+  }
+  pool.run(0, [](size_t) { FAIL(); });
+}
+
+/*
+ * Same results as a single RainGaugeFleet for any number of threads and shards
+ */
+TEST(TestRainGaugeShards, MatchesFleet) {
+  TimeZone utc;
+  unsigned threads[] = {1, 2, 4};
+  unsigned shards[]  = {0, 1, 7};
+
+  for (size_t c = 0; c < sizeof(threads) / sizeof(threads[0]); c++) {
+    RainGaugeFleet  fleet(GAUGES);
+    RainGaugeShards sharded(GAUGES, threads[c], shards[c]);
+    fleet.setTimeZone(&utc);
+    sharded.setTimeZone(&utc);
+    EXPECT_EQ(threads[c], sharded.threads());
+
+    // 2022-09-04 22:00 UTC, batches with several readings per gauge
+    time_t t0 = 1662328800;
+    std::vector<RainReading> batch;
+    for (int b = 0; b < 60; b++) {
+      batch.clear();
+      for (int k = 0; k < 3 * GAUGES; k++) {
+        RainReading r;
+        r.id      = (uint32_t)((k * 31 + b) % GAUGES);
+        r.epoch   = t0 + b * 900 + k / 4;
+        r.value   = (float)((r.id * 3 + b * 7 + k) % 1000) / 10;
+        r.startup = (b == 30) && (r.id % 5 == 0);
+        batch.push_back(r);
+      }
+      fleet.update(batch.size(), &batch[0]);
+      sharded.ingest(batch.size(), &batch[0]);
+    }
+    for (uint32_t id = 0; id < GAUGES; id++) {
+      ASSERT_FLOAT_EQ(fleet.current(id), sharded.current(id)) << "threads " << threads[c] << " id " << id;
+      ASSERT_FLOAT_EQ(fleet.pastHour(id), sharded.pastHour(id)) << "threads " << threads[c] << " id " << id;
+      ASSERT_FLOAT_EQ(fleet.currentDay(id), sharded.currentDay(id)) << "threads " << threads[c] << " id " << id;
+      ASSERT_FLOAT_EQ(fleet.currentWeek(id), sharded.currentWeek(id)) << "threads " << threads[c] << " id " << id;
+      ASSERT_FLOAT_EQ(fleet.currentMonth(id), sharded.currentMonth(id)) << "threads " << threads[c] << " id " << id;
+    }
+  }
+}
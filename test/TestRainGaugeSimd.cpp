@@ -0,0 +1,188 @@
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// TestRainGaugeSimd.cpp
+//
+// Unit tests for the batch kernels (RainGaugeSimd.h) and RainGaugeFleetT::updateAll()
+//
+// https://github.com/matthias-bs/BresserWeatherSensorReceiver
+//
+//
+// created: 10/2026
+//
+//
+// MIT License
+//
+// Copyright (c) 2026 Matthias Prinke
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+// History:
+//
+// 20261016 Created
+// 20261017 Compare every supported level with the scalar kernels
+//
+// ToDo:
+// -
+//
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+
+#include <gtest/gtest.h>
+#include <string.h>
+#include <vector>
+
+#include "RainGauge.h"
+#include "RainGaugeFleet.h"
+#include "RainGaugeSimd.h"
+#include "TimeZone.h"
+
+// Not a multiple of the SIMD width
+#define GAUGES 1003
+
+/*
+ * Per-gauge state of the batch kernels
+ */
+struct BatchState {
+  std::vector<uint8_t>  startupPrev;
+  std::vector<float>    rainStartup;
+  std::vector<float>    rainPrev;
+  std::vector<uint16_t> rainOvf;
+  std::vector<float>    rainCurr;
+  std::vector<uint8_t>  tsDayBegin;
+  std::vector<float>    rainDayBegin;
+  std::vector<uint8_t>  tsWeekBegin;
+  std::vector<float>    rainWeekBegin;
+  std::vector<uint8_t>  wdayPrev;
+  std::vector<uint8_t>  tsMonthBegin;
+  std::vector<float>    rainMonthBegin;
+
+  BatchState(size_t n) :
+    startupPrev(n), rainStartup(n), rainPrev(n), rainOvf(n), rainCurr(n),
+    tsDayBegin(n), rainDayBegin(n), tsWeekBegin(n), rainWeekBegin(n), wdayPrev(n),
+    tsMonthBegin(n), rainMonthBegin(n)
+  {
+    uint32_t x = 12345;
+    for (size_t i = 0; i < n; i++) {
+      x = x * 1103515245u + 12345u;
+      startupPrev[i]    = (x >> 8) & 1;
+      rainStartup[i]    = (float)((x >> 12) % 1000) / 10;
+      rainPrev[i]       = (float)((x >> 4) % 1000) / 10;
+      rainOvf[i]        = (i % 97 == 0) ? 0xFFFF : (uint16_t)((x >> 16) % 5);
+      tsDayBegin[i]     = (i % 13 == 0) ? 0xFF : (uint8_t)((x >> 20) % 7);
+      tsWeekBegin[i]    = (i % 11 == 0) ? 0xFF : (uint8_t)((x >> 21) % 7);
+      wdayPrev[i]       = (i % 7 == 0) ? 0xFF : (uint8_t)((x >> 22) % 7);
+      tsMonthBegin[i]   = (i % 5 == 0) ? 0xFF : (uint8_t)((x >> 23) % 12 + 1);
+      rainDayBegin[i]   = 1.0f;
+      rainWeekBegin[i]  = 2.0f;
+      rainMonthBegin[i] = 3.0f;
+    }
+  }
+
+  void run(const float *rain, const bool *startup, const rainTime_t &t) {
+    size_t n = rainCurr.size();
+    rainAccumulateBatch(n, rain, startup, 100.0f,
+                        &startupPrev[0], &rainStartup[0], &rainPrev[0], &rainOvf[0], &rainCurr[0]);
+    rainCalendarBatch(n, t, &rainCurr[0], &tsDayBegin[0], &rainDayBegin[0], &tsWeekBegin[0], &rainWeekBegin[0],
+                      &wdayPrev[0], &tsMonthBegin[0], &rainMonthBegin[0]);
+  }
+
+  bool operator==(const BatchState &o) const {
+    return (startupPrev == o.startupPrev) &&
+           (memcmp(&rainStartup[0], &o.rainStartup[0], rainStartup.size() * sizeof(float)) == 0) &&
+           (memcmp(&rainPrev[0], &o.rainPrev[0], rainPrev.size() * sizeof(float)) == 0) &&
+           (rainOvf == o.rainOvf) &&
+           (memcmp(&rainCurr[0], &o.rainCurr[0], rainCurr.size() * sizeof(float)) == 0) &&
+           (tsDayBegin == o.tsDayBegin) &&
+           (memcmp(&rainDayBegin[0], &o.rainDayBegin[0], rainDayBegin.size() * sizeof(float)) == 0) &&
+           (tsWeekBegin == o.tsWeekBegin) &&
+           (memcmp(&rainWeekBegin[0], &o.rainWeekBegin[0], rainWeekBegin.size() * sizeof(float)) == 0) &&
+           (wdayPrev == o.wdayPrev) &&
+           (tsMonthBegin == o.tsMonthBegin) &&
+           (memcmp(&rainMonthBegin[0], &o.rainMonthBegin[0], rainMonthBegin.size() * sizeof(float)) == 0);
+  }
+};
+
+
+/*
+ * All instruction set levels give bit-identical results
+ */
+TEST(TestRainGaugeSimd, KernelsBitIdentical) {
+  RainSimdLevel best = rainSimdDetect();
+
+  BatchState scalar(GAUGES);
+  std::vector<BatchState> simd(best + 1, BatchState(GAUGES));
+  std::vector<float> rain(GAUGES);
+  bool startup[GAUGES];
+
+  // Sunday -> Monday -> Tuesday, change of month on Tuesday
+  rainTime_t t[3] = {{19240, 3600, 0, 9, 19240LL * 86400 + 3600},
+                     {19241, 3600, 1, 9, 19241LL * 86400 + 3600},
+                     {19242, 3600, 2, 10, 19242LL * 86400 + 3600}};
+  for (int step = 0; step < 9; step++) {
+    for (size_t i = 0; i < GAUGES; i++) {
+      rain[i]    = (float)((i * 31 + step * 17) % 1000) / 10;
+      startup[i] = ((i + step) % 4) == 0;
+    }
+    rainSimdSelect(RAIN_SIMD_SCALAR);
+    scalar.run(&rain[0], (step % 2) ? startup : NULL, t[step % 3]);
+    for (int level = RAIN_SIMD_SSE41; level <= best; level++) {
+      EXPECT_EQ(level, rainSimdSelect((RainSimdLevel)level));
+      simd[level].run(&rain[0], (step % 2) ? startup : NULL, t[step % 3]);
+      ASSERT_TRUE(scalar == simd[level]) << "step " << step << " level " << level;
+    }
+  }
+  rainSimdSelect(best);
+}
+
+/*
+ * Fleet update at a common time stamp gives the same results as updateBatch()
+ */
+TEST(TestRainGaugeSimd, FleetUpdateAll) {
+  TimeZone utc;
+
+  RainGaugeFleet fleetAll(GAUGES);
+  RainGaugeFleet fleetBatch(GAUGES);
+  fleetAll.setTimeZone(&utc);
+  fleetBatch.setTimeZone(&utc);
+
+  std::vector<uint32_t> ids(GAUGES);
+  std::vector<time_t>   epochs(GAUGES);
+  std::vector<float>    values(GAUGES);
+  bool startup[GAUGES];
+  for (size_t i = 0; i < GAUGES; i++) {
+    ids[i] = (uint32_t)i;
+  }
+
+  // 2022-09-04 22:00 UTC (Sunday), every 6 minutes for two days
+  time_t t0 = 1662328800;
+  for (int step = 0; step < 480; step++) {
+    for (size_t i = 0; i < GAUGES; i++) {
+      epochs[i]  = t0 + step * 360;
+      values[i]  = (float)((i * 7 + step * (1 + i % 3)) % 1000) / 10;
+      startup[i] = (step == 100) && (i % 2 == 0);
+    }
+    fleetAll.updateAll(epochs[0], &values[0], startup);
+    fleetBatch.updateBatch(GAUGES, &ids[0], &epochs[0], &values[0], startup);
+    for (uint32_t i = 0; i < GAUGES; i += 17) {
+      ASSERT_FLOAT_EQ(fleetBatch.pastHour(i), fleetAll.pastHour(i)) << "step " << step << " id " << i;
+      ASSERT_FLOAT_EQ(fleetBatch.currentDay(i), fleetAll.currentDay(i)) << "step " << step << " id " << i;
+      ASSERT_FLOAT_EQ(fleetBatch.currentWeek(i), fleetAll.currentWeek(i)) << "step " << step << " id " << i;
+      ASSERT_FLOAT_EQ(fleetBatch.currentMonth(i), fleetAll.currentMonth(i)) << "step " << step << " id " << i;
+    }
+  }
+}
@@ -0,0 +1,324 @@
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// TestRainGaugeStats.cpp
+//
+// Unit tests for RainStatsCell, RainGaugeSnapshotT and RainGaugeFleetT::snapshot()
+// (consistent reads during concurrent updates)
+//
+// https://github.com/matthias-bs/BresserWeatherSensorReceiver
+//
+//
+// created: 10/2026
+//
+//
+// MIT License
+//
+// Copyright (c) 2026 Matthias Prinke
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+// History:
+//
+// 20261016 Created
+// 20261017 Added test of publishing once per batch
+// 20261017 Added test of enabling snapshots
+//
+// ToDo:
+// -
+//
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+
+
+#include <gtest/gtest.h>
+#include <atomic>
+#include <string.h>
+#include <thread>
+#include <vector>
+
+#include "RainGauge.h"
+#include "RainGaugeFleet.h"
+#include "RainGaugeStats.h"
+#include "TimeZone.h"
+
+#define READERS 3
+
+typedef RainGaugeFleetT<3600, 62, 10> Fleet60s;
+typedef RainGaugeT<3600, 62, 10>      RainGauge60s;
+
+// 2022-08-01 00:00 UTC - Monday and first day of month
+static const time_t T_BEGIN = 1659312000;
+
+
+/*
+ * Readers never see values of two different publish() calls mixed
+ */
+TEST(TestRainGaugeStats, CellConsistent) {
+  RainStatsCell     cell;
+  std::atomic<bool> done(false);
+  std::atomic<long> reads(0);
+  std::atomic<long> errors(0);
+
+  std::vector<std::thread> readers;
+  for (int r = 0; r < READERS; r++) {
+    readers.push_back(std::thread([&]() {
+      uint32_t prev = 0;
+      while (!done.load()) {
+        RainGaugeStats s;
+        cell.read(s);
+        uint32_t k = (uint32_t)s.pastHour;
+        if ((s.currentDay != 2.0f * k) || (s.currentWeek != 3.0f * k) || (s.currentMonth != 4.0f * k) ||
+            (k < prev))
+          errors++;
+        prev = k;
+        reads++;
+      }
+    }));
+  }
+
+  for (uint32_t k = 1; k <= 200000; k++) {
+    RainGaugeStats s = {(float)k, 2.0f * k, 3.0f * k, 4.0f * k};
+    cell.publish(s);
+  }
+  done = true;
+  for (size_t r = 0; r < readers.size(); r++) {
+    readers[r].join();
+  }
+
+  RainGaugeStats s;
+  EXPECT_TRUE(cell.tryRead(s));
+  EXPECT_EQ(200000.0f, s.pastHour);
+  EXPECT_EQ(800000.0f, s.currentMonth);
+  EXPECT_EQ(0, errors.load());
+  EXPECT_GT(reads.load(), 0);
+}
+
+/*
+ * snapshot() returns the same values as the accessors after updateBatch(), updateAll(), reset() and load()
+ */
+TEST(TestRainGaugeStats, FleetSnapshot) {
+  TimeZone utc;
+  Fleet60s fleet(4);
+  fleet.setTimeZone(&utc);
+  fleet.setSnapshots(true);
+
+  RainGaugeStats s;
+  fleet.snapshot(2, s);
+  EXPECT_EQ(0, s.pastHour);
+  EXPECT_EQ(0, s.currentMonth);
+
+  float values[4] = {0};
+  for (int i = 0; i < 3000; i++) {
+    time_t   t  = T_BEGIN + i * 300;
+    uint32_t id = (uint32_t)(i % 4);
+    values[id] += 0.1f * (i % 5);
+    if (i % 3 == 0) {
+      fleet.updateAll(t, values);
+    } else {
+      fleet.updateBatch(1, &id, &t, &values[id]);
+    }
+    for (uint32_t g = 0; g < 4; g++) {
+      fleet.snapshot(g, s);
+      ASSERT_EQ(fleet.pastHour(g), s.pastHour) << "i=" << i;
+      ASSERT_EQ(fleet.currentDay(g), s.currentDay) << "i=" << i;
+      ASSERT_EQ(fleet.currentWeek(g), s.currentWeek) << "i=" << i;
+      ASSERT_EQ(fleet.currentMonth(g), s.currentMonth) << "i=" << i;
+    }
+  }
+
+  nvDataT<62> nv;
+  fleet.store(1, nv);
+  fleet.reset(1);
+  fleet.snapshot(1, s);
+  EXPECT_EQ(0, s.currentMonth);
+  fleet.load(1, nv);
+  fleet.snapshot(1, s);
+  EXPECT_EQ(fleet.currentMonth(1), s.currentMonth);
+  EXPECT_GT(s.currentMonth, 0);
+}
+
+/*
+ * Readers in other threads get consistent snapshots while the fleet is updated
+ *
+ * On the first day of a month which is a Monday, day, week and month totals are equal
+ * in every consistent state.
+ */
+TEST(TestRainGaugeStats, FleetConcurrent) {
+  TimeZone          utc;
+  Fleet60s          fleet(2);
+  std::atomic<bool> done(false);
+  std::atomic<long> errors(0);
+
+  fleet.setTimeZone(&utc);
+  fleet.setSnapshots(true);
+
+  std::vector<std::thread> readers;
+  for (int r = 0; r < READERS; r++) {
+    readers.push_back(std::thread([&]() {
+      while (!done.load()) {
+        RainGaugeStats s;
+        fleet.snapshot(1, s);
+        if ((s.currentDay != s.currentWeek) || (s.currentDay != s.currentMonth) ||
+            (s.pastHour > s.currentDay + 0.01f))
+          errors++;
+      }
+    }));
+  }
+
+  for (int round = 0; round < 20; round++) {
+    float rain = 0;
+    fleet.reset(1);
+    for (int i = 0; i < 1440; i++) {
+      uint32_t id = 1;
+      time_t   t  = T_BEGIN + i * 60;
+      rain += 0.1f * ((i + round) % 3);
+      fleet.updateBatch(1, &id, &t, &rain);
+    }
+  }
+  done = true;
+  for (size_t r = 0; r < readers.size(); r++) {
+    readers[r].join();
+  }
+  EXPECT_EQ(0, errors.load());
+}
+
+/*
+ * Single rain gauge wrapped by RainGaugeSnapshotT
+ */
+TEST(TestRainGaugeStats, SingleGauge) {
+  TimeZone     utc;
+  nvDataT<62>  data;
+  memset(&data, 0, sizeof(data));
+  RainGauge60s rainGauge(&data);
+  rainGauge.reset();
+  rainGauge.setTimeZone(&utc);
+
+  RainGaugeSnapshotT<RainGauge60s> gauge(rainGauge);
+  std::atomic<bool> done(false);
+  std::atomic<long> errors(0);
+
+  std::thread reader([&]() {
+    while (!done.load()) {
+      RainGaugeStats s;
+      gauge.snapshot(s);
+      if ((s.currentDay != s.currentWeek) || (s.currentDay != s.currentMonth))
+        errors++;
+    }
+  });
+
+  float rain = 0;
+  for (int i = 0; i < 1440; i++) {
+    rain += 0.2f;
+    gauge.update(T_BEGIN + i * 60, rain);
+  }
+  done = true;
+  reader.join();
+
+  RainGaugeStats s;
+  gauge.snapshot(s);
+  EXPECT_EQ(rainGauge.pastHour(), s.pastHour);
+  EXPECT_EQ(rainGauge.currentDay(), s.currentDay);
+  EXPECT_EQ(rainGauge.currentMonth(), s.currentMonth);
+  EXPECT_EQ(0, errors.load());
+
+  rainGauge.reset();
+  gauge.publish();
+  gauge.snapshot(s);
+  EXPECT_EQ(0, s.currentDay);
+}
+
+/*
+ * Observer records the notifications of a fleet
+ */
+class CountingObserver : public RainGaugeObserver {
+public:
+  std::vector<uint32_t>       ids;
+  std::vector<RainGaugeStats> stats;
+
+  virtual void changed(uint32_t id, const RainGaugeStats &s) {
+    ids.push_back(id);
+    stats.push_back(s);
+  }
+};
+
+/*
+ * update*() publishes each changed gauge once per batch, with the statistics at the end of the batch
+ */
+TEST(TestRainGaugeStats, FleetPublishOncePerBatch) {
+  TimeZone         utc;
+  Fleet60s         fleet(4);
+  CountingObserver observer;
+
+  fleet.setTimeZone(&utc);
+  fleet.setSnapshots(true);
+  fleet.addObserver(&observer);
+
+  uint32_t ids[5]    = {2, 0, 2, 2, 0};
+  time_t   epochs[5] = {T_BEGIN, T_BEGIN, T_BEGIN + 300, T_BEGIN + 600, T_BEGIN + 300};
+  float    values[5] = {1.0f, 5.0f, 2.0f, 3.5f, 6.0f};
+  fleet.updateBatch(5, ids, epochs, values);
+
+  ASSERT_EQ(2u, observer.ids.size());
+  EXPECT_EQ(2u, observer.ids[0]);
+  EXPECT_EQ(0u, observer.ids[1]);
+  EXPECT_EQ(fleet.pastHour(2), observer.stats[0].pastHour);
+  EXPECT_EQ(fleet.currentDay(0), observer.stats[1].currentDay);
+
+  RainGaugeStats s;
+  fleet.snapshot(2, s);
+  EXPECT_EQ(fleet.pastHour(2), s.pastHour);
+
+  // Same gauges again in the next batch
+  observer.ids.clear();
+  fleet.updateBatch(2, ids, epochs, values);
+  EXPECT_EQ(2u, observer.ids.size());
+  fleet.removeObserver(&observer);
+}
+
+/*
+ * snapshot() is only updated after setSnapshots(true)
+ */
+TEST(TestRainGaugeStats, FleetSnapshotDisabled) {
+  TimeZone utc;
+  Fleet60s fleet(2);
+  fleet.setTimeZone(&utc);
+
+  uint32_t id     = 1;
+  time_t   epoch  = T_BEGIN;
+  float    value  = 4.0f;
+  fleet.updateBatch(1, &id, &epoch, &value);
+  epoch += 300;
+  value = 6.5f;
+  fleet.updateBatch(1, &id, &epoch, &value);
+
+  RainGaugeStats s;
+  fleet.snapshot(1, s);
+  EXPECT_EQ(0, s.pastHour);
+
+  fleet.setSnapshots(true);
+  fleet.snapshot(1, s);
+  EXPECT_EQ(fleet.pastHour(1), s.pastHour);
+  EXPECT_GT(s.pastHour, 0);
+
+  fleet.setSnapshots(false);
+  epoch += 300;
+  value = 9.0f;
+  fleet.updateBatch(1, &id, &epoch, &value);
+  fleet.snapshot(1, s);
+  EXPECT_NEAR(2.5, s.pastHour, 0.01);
+}
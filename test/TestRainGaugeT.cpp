@@ -0,0 +1,274 @@
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// TestRainGaugeT.cpp
+//
+// Googletest unit tests for RainGaugeT - compile-time window length, buffer size and scale
+//
+// https://github.com/matthias-bs/BresserWeatherSensorReceiver
+//
+//
+// created: 10/2026
+//
+//
+// MIT License
+//
+// Copyright (c) 2026 Matthias Prinke
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+// History:
+//
+// 20261016 Created
+// 20261016 Added tests for pastHourPeakRate()
+// 20261017 Use helpers from RainTestUtil.h
+// 20261017 Added peak rain rate test with overwritten head
+// 20261017 Added test for accumulated rain above 6553.5 mm
+//
+// ToDo:
+// -
+//
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include <gtest/gtest.h>
+#include <string.h>
+#include <type_traits>
+
+#define TOLERANCE 0.11
+#include "RainGauge.h"
+#include "RainTestUtil.h"
+#include "TimeZone.h"
+
+// Update rates of 12 s, 60 s and 360 s - one spare entry, since a reading
+// exactly WindowSeconds old is still part of the window
+typedef RainGaugeT<3600, 302, 10> RainGauge12s;
+typedef RainGaugeT<3600, 62,  10> RainGauge60s;
+typedef RainGaugeT<3600, 12,  10> RainGauge360s;
+
+static_assert(std::is_same<RainGauge12s::index_t, uint16_t>::value, "16 bit index for large buffer");
+static_assert(std::is_same<RainGauge::index_t, uint8_t>::value, "8 bit index for default buffer");
+static_assert(std::is_same<RainGauge, RainGaugeT<3600, RAINGAUGE_BUF_SIZE, 10> >::value, "default alias");
+
+
+/*
+ * Peak rain rate by scanning the circular buffer (reference)
+ */
+template <unsigned BufSize>
+static float scanPeakRate(const nvDataT<BufSize> &data)
+{
+  float peak = 0;
+  for (unsigned i = data.tail; i != data.head; ) {
+    unsigned prev = i;
+    i = (i + 1) % BufSize;
+    uint32_t dt = (data.ts(i) + 86400 - data.ts(prev)) % 86400;
+    if (dt == 0)
+      continue;
+    float rate = (float)(0.1 * (int16_t)(uint16_t)(data.rainBuf[i] - data.rainBuf[prev]) * 3600 / dt);
+    peak = (rate > peak) ? rate : peak;
+  }
+  return peak;
+}
+
+
+/*
+ * Gauges with different update rates side by side
+ */
+TEST(TestRainGaugeT, UpdateRates) {
+  TimeZone utc;
+
+  nvDataT<302> data12;
+  nvDataT<62>  data60;
+  nvDataT<12>  data360;
+  RainGauge12s  rainGauge12(&data12);
+  RainGauge60s  rainGauge60(&data60);
+  RainGauge360s rainGauge360(&data360);
+  initGauge(rainGauge12, data12, &utc);
+  initGauge(rainGauge60, data60, &utc);
+  initGauge(rainGauge360, data360, &utc);
+
+  // 2022-09-06 08:00 UTC, 0.1 mm/min for 3 hours
+  time_t t0 = 1662451200;
+  for (int s = 0; s <= 3 * 3600; s += 12) {
+    float rain = 0.1f * (float)(s / 60);
+    rainGauge12.update(t0 + s, rain);
+    if (s % 60 == 0)
+      rainGauge60.update(t0 + s, rain);
+    if (s % 360 == 0)
+      rainGauge360.update(t0 + s, rain);
+
+    if (s >= 3600 && s % 360 == 0) {
+      ASSERT_NEAR(6.0, rainGauge12.pastHour(), TOLERANCE);
+      ASSERT_NEAR(6.0, rainGauge60.pastHour(), TOLERANCE);
+      ASSERT_NEAR(6.0, rainGauge360.pastHour(), TOLERANCE);
+    }
+  }
+  ASSERT_NEAR(18.0, rainGauge12.currentDay(), TOLERANCE);
+  ASSERT_NEAR(18.0, rainGauge60.currentDay(), TOLERANCE);
+  ASSERT_NEAR(18.0, rainGauge360.currentDay(), TOLERANCE);
+}
+
+
+/*
+ * Power-of-two buffer size (bit mask) behaves like any other buffer size
+ */
+TEST(TestRainGaugeT, PowerOfTwo) {
+  TimeZone utc;
+
+  nvDataT<16> data16;
+  nvDataT<17> data17;
+  RainGaugeT<3600, 16, 10> rainGauge16(&data16);
+  RainGaugeT<3600, 17, 10> rainGauge17(&data17);
+  initGauge(rainGauge16, data16, &utc);
+  initGauge(rainGauge17, data17, &utc);
+
+  // 2022-09-06 22:00 UTC, 5 minute interval across midnight, irregular rain
+  time_t t0   = 1662501600;
+  float  rain = 0;
+  for (int i = 0; i < 200; i++) {
+    rain += (float)((i * 7) % 5) * 0.1f;
+    rainGauge16.update(t0 + i * 300, rain);
+    rainGauge17.update(t0 + i * 300, rain);
+    ASSERT_FLOAT_EQ(rainGauge17.pastHour(), rainGauge16.pastHour());
+    ASSERT_FLOAT_EQ(rainGauge17.currentDay(), rainGauge16.currentDay());
+  }
+}
+
+
+/*
+ * Rolling window of 10 minutes at 0.01 mm resolution
+ */
+TEST(TestRainGaugeT, WindowScale) {
+  TimeZone utc;
+
+  nvDataT<12> data;
+  RainGaugeT<600, 12, 100> rainGauge(&data);
+  initGauge(rainGauge, data, &utc);
+
+  // 2022-09-06 08:00 UTC, one minute interval, 0.03 mm/min
+  time_t t0 = 1662451200;
+  for (int i = 0; i <= 30; i++) {
+    rainGauge.update(t0 + i * 60, 0.03f * i);
+    if (i >= 10) {
+      ASSERT_NEAR(0.3, rainGauge.pastHour(), 0.011);
+    }
+  }
+}
+
+
+/*
+ * Peak rain rate of past hour matches a scan of the circular buffer,
+ * with irregular update rate, across midnight and with a full buffer
+ */
+TEST(TestRainGaugeT, PeakRate) {
+  TimeZone utc;
+
+  nvDataT<62> data;
+  nvDataT<8>  dataSmall;
+  RainGauge60s            rainGauge(&data);
+  RainGaugeT<3600, 8, 10> rainGaugeSmall(&dataSmall);
+  initGauge(rainGauge, data, &utc);
+  initGauge(rainGaugeSmall, dataSmall, &utc);
+
+  ASSERT_FLOAT_EQ(0, rainGauge.pastHourPeakRate());
+
+  // 2022-09-06 21:00 UTC
+  time_t t    = 1662498000;
+  float  rain = 0;
+  for (int i = 0; i < 600; i++) {
+    t    += 60 * (1 + (i * 5) % 7);
+    rain += (float)((i * 13) % 9) * 0.1f;
+    rainGauge.update(t, rain);
+    rainGaugeSmall.update(t, rain);
+    ASSERT_FLOAT_EQ(scanPeakRate(data), rainGauge.pastHourPeakRate()) << "i=" << i;
+    ASSERT_FLOAT_EQ(scanPeakRate(dataSmall), rainGaugeSmall.pastHourPeakRate()) << "i=" << i;
+  }
+}
+
+/*
+ * Peak rain rate with a full buffer: the overwritten head interval may drop below
+ * earlier intervals (bursts followed by dry readings)
+ */
+TEST(TestRainGaugeT, PeakRateOverwrite) {
+  TimeZone utc;
+
+  nvDataT<8>  data;
+  RainGaugeT<3600, 8, 10> rainGauge(&data);
+  initGauge(rainGauge, data, &utc);
+
+  TestRandom rnd;
+  // 2022-09-06 21:00 UTC
+  time_t t    = 1662498000;
+  float  rain = 0;
+  for (int i = 0; i < 5000; i++) {
+    uint32_t x = rnd.next();
+    t += 30 + x % 300;
+    if ((x >> 8) % 5 == 0) {
+      rain += 0.1f * (float)(1 + (x >> 12) % 30);
+    }
+    rainGauge.update(t, rain);
+    ASSERT_FLOAT_EQ(scanPeakRate(data), rainGauge.pastHourPeakRate()) << "i=" << i;
+  }
+}
+
+/*
+ * Accumulated rain beyond the range of the 16 bit circular buffer values (6553.5 mm)
+ */
+TEST(TestRainGaugeT, RainWrap) {
+  TimeZone utc;
+
+  nvDataT<62> data;
+  RainGauge60s rainGauge(&data);
+  initGauge(rainGauge, data, &utc);
+
+  // 2022-09-06 08:00 UTC
+  time_t t    = 1662451200;
+  float  rain = 0;
+  for (int i = 0; i < 14000; i++) {
+    t    += 60;
+    rain += 0.5f;
+    rainGauge.update(t, rain);
+    if (i >= 60) {
+      ASSERT_NEAR(30.0, rainGauge.pastHour(), TOLERANCE) << "i=" << i;
+      ASSERT_NEAR(30.0, rainGauge.pastHourPeakRate(), TOLERANCE) << "i=" << i;
+      ASSERT_FLOAT_EQ(scanPeakRate(data), rainGauge.pastHourPeakRate()) << "i=" << i;
+    }
+  }
+  ASSERT_GT(rain, 6553.5f);
+}
+
+/*
+ * Single burst: 1.5 mm in 6 minutes is 15 mm/h, expires after one hour
+ */
+TEST(TestRainGaugeT, PeakRateBurst) {
+  TimeZone utc;
+
+  nvDataT<12> data;
+  RainGauge360s rainGauge(&data);
+  initGauge(rainGauge, data, &utc);
+
+  // 2022-09-06 08:00 UTC
+  time_t t0 = 1662451200;
+  rainGauge.update(t0, 10.0f);
+  rainGauge.update(t0 + 360, 11.5f);
+  ASSERT_NEAR(15.0, rainGauge.pastHourPeakRate(), TOLERANCE);
+  for (int i = 2; i <= 10; i++) {
+    rainGauge.update(t0 + i * 360, 11.5f + 0.5f * (i - 1));
+    ASSERT_NEAR(15.0, rainGauge.pastHourPeakRate(), TOLERANCE) << "i=" << i;
+  }
+  rainGauge.update(t0 + 11 * 360, 16.5f);
+  ASSERT_NEAR(5.0, rainGauge.pastHourPeakRate(), TOLERANCE);
+}
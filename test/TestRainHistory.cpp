@@ -0,0 +1,183 @@
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// TestRainHistory.cpp
+//
+// Unit tests for RainHistory - parallel replay matches sequential updates
+//
+// https://github.com/matthias-bs/BresserWeatherSensorReceiver
+//
+//
+// created: 10/2026
+//
+//
+// MIT License
+//
+// Copyright (c) 2026 Matthias Prinke
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+// History:
+//
+// 20261016 Created
+// 20261017 Use helpers from RainTestUtil.h
+//
+// ToDo:
+// -
+//
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+
+
+// Small chunks, so that chunk boundaries fall within segments
+#define RAIN_HISTORY_CHUNK 1000
+
+#include <gtest/gtest.h>
+#include <string.h>
+#include <vector>
+
+#include "RainGauge.h"
+#include "RainHistory.h"
+#include "RainTestUtil.h"
+#include "TimeZone.h"
+
+#define GAUGES 7
+
+typedef RainGaugeT<3600, 12, 10> Gauge360s;
+typedef RainHistoryT<3600, 12, 10> History360s;
+
+/*
+ * Interleaved history of all gauges: irregular intervals, outages (some exactly a week),
+ * showers, overflows and sensor restarts; gauge GAUGES-1 has no readings
+ */
+static void makeArchive(std::vector<RainReading> &archive, size_t perGauge)
+{
+  std::vector<time_t> t(GAUGES);
+  std::vector<float>  rain(GAUGES, 0.0f);
+  TestRandom rnd;
+
+  for (uint32_t g = 0; g < GAUGES; g++) {
+    t[g] = T_BEGIN + g * 997;
+  }
+  archive.clear();
+  for (size_t i = 0; i < perGauge * (GAUGES - 1); i++) {
+    uint32_t x = rnd.next();
+    uint32_t g = x % (GAUGES - 1);
+    t[g] += 60 + (x >> 8) % 1800;
+    if ((x >> 4) % 1500 == 0) {
+      t[g] += ((x >> 12) % 2 == 0) ? 7 * 86400 : (time_t)((x >> 12) % (5 * 86400));
+    }
+    if ((x >> 10) % 40 < 6) {
+      rain[g] += 0.1f * (float)((x >> 16) % 20);
+    }
+    bool startup = ((x >> 6) % 3001 == 0);
+    if (startup) {
+      rain[g] = 0;
+    }
+    if (rain[g] >= 100) {
+      rain[g] -= 100;
+    }
+    RainReading r = {t[g], g, rain[g], startup};
+    archive.push_back(r);
+  }
+}
+
+
+/*
+ * Final state and day totals match sequential updates of each gauge, for any number of threads
+ */
+TEST(TestRainHistory, MatchesSequential) {
+  TimeZone cet;
+  std::vector<RainReading> archive;
+
+  ASSERT_TRUE(cet.loadPosix("CET-1CEST,M3.5.0,M10.5.0/3", 1970, 2100));
+  makeArchive(archive, 20000);
+
+  // Reference: sequential updates; currentDay() after the last reading of each local day
+  std::vector<nvDataT<12> > data(GAUGES);
+  std::vector<float>        curr(GAUGES);
+  std::vector<std::vector<RainDayTotal> > days(GAUGES);
+  for (uint32_t g = 0; g < GAUGES; g++) {
+    Gauge360s  gauge(&data[g]);
+    RainClock  clock;
+    rainTime_t t;
+    memset(&data[g], 0, sizeof(data[g]));
+    gauge.reset();
+    gauge.setTimeZone(&cet);
+    clock.setTimeZone(&cet);
+    for (size_t k = 0; k < archive.size(); k++) {
+      if (archive[k].id != g)
+        continue;
+      gauge.update(archive[k].epoch, archive[k].value, archive[k].startup);
+      clock.fromEpoch(archive[k].epoch, t);
+      if (days[g].empty() || (days[g].back().day != t.day)) {
+        RainDayTotal d = {t.day, 0};
+        days[g].push_back(d);
+      }
+      days[g].back().rain = gauge.currentDay();
+    }
+    curr[g] = gauge.rainCurr;
+  }
+
+  unsigned threads[] = {1, 3};
+  for (size_t c = 0; c < sizeof(threads) / sizeof(threads[0]); c++) {
+    History360s history(GAUGES, threads[c]);
+    history.setTimeZone(&cet);
+    ASSERT_TRUE(history.replay(archive.size(), &archive[0]));
+    EXPECT_GT(history.segments(), (size_t)(GAUGES - 1) * 6);
+
+    for (uint32_t g = 0; g < GAUGES; g++) {
+      expectSameState(data[g], history.state(g), "id " + std::to_string(g));
+      EXPECT_EQ(curr[g], history.current(g)) << "id " << g;
+      const std::vector<RainDayTotal> &d = history.days(g);
+      ASSERT_EQ(days[g].size(), d.size()) << "id " << g;
+      for (size_t k = 0; k < d.size(); k++) {
+        ASSERT_EQ(days[g][k].day, d[k].day) << "id " << g << " k " << k;
+        ASSERT_EQ(days[g][k].rain, d[k].rain) << "id " << g << " k " << k;
+      }
+    }
+  }
+}
+
+/*
+ * Replay starts from reset state; invalid ids are rejected
+ */
+TEST(TestRainHistory, Replay) {
+  TimeZone    utc;
+  History360s history(2, 2);
+  RainReading r[3] = {
+    {T_BEGIN,        0, 1.0f, false},
+    {T_BEGIN + 600,  0, 1.5f, false},
+    {T_BEGIN + 1200, 2, 2.0f, false}
+  };
+
+  history.setTimeZone(&utc);
+  EXPECT_FALSE(history.replay(3, r));
+  EXPECT_EQ(0u, history.days(0).size());
+
+  ASSERT_TRUE(history.replay(2, r));
+  EXPECT_FLOAT_EQ(1.5f, history.current(0));
+  ASSERT_EQ(1u, history.days(0).size());
+  EXPECT_FLOAT_EQ(0.5f, history.days(0)[0].rain);
+  EXPECT_EQ(0xFF, history.state(1).tsDayBegin);
+
+  // A second replay replaces the previous results
+  ASSERT_TRUE(history.replay(1, &r[1]));
+  EXPECT_FLOAT_EQ(1.5f, history.current(0));
+  EXPECT_FLOAT_EQ(0.0f, history.days(0)[0].rain);
+  EXPECT_EQ(1u, history.segments());
+}
@@ -0,0 +1,194 @@
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// TestRainNvStore.cpp
+//
+// Unit tests for RainNvStoreT (memory-mapped non-volatile data) and RainGaugeT::resume()
+//
+// https://github.com/matthias-bs/BresserWeatherSensorReceiver
+//
+//
+// created: 10/2026
+//
+//
+// MIT License
+//
+// Copyright (c) 2026 Matthias Prinke
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+// History:
+//
+// 20261016 Created
+// 20261017 Added test of file without header
+// 20261017 Use helpers from RainTestUtil.h
+//
+// ToDo:
+// -
+//
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+
+
+#include <gtest/gtest.h>
+#include <stdio.h>
+#include <string.h>
+#include <vector>
+
+#include "RainGauge.h"
+#include "RainNvStore.h"
+#include "RainTestUtil.h"
+#include "TimeZone.h"
+
+#define GAUGES 5
+#define STORE_FILE  "TestRainNvStore.nv"
+#define HEADER_FILE "TestRainNvStoreHeader.nv"
+#define EMPTY_FILE  "TestRainNvStoreEmpty.nv"
+
+typedef RainGaugeT<3600, 62, 10> RainGauge60s;
+typedef RainNvStoreT<62>         NvStore60s;
+
+
+/*
+ * A restarted process resumes with the statistics of the previous run
+ */
+TEST(TestRainNvStore, Resume) {
+  TimeZone utc;
+  float    pastHour[GAUGES], peak[GAUGES], day[GAUGES], week[GAUGES], month[GAUGES];
+  float    rain[GAUGES] = {0};
+  time_t   t = T_BEGIN;
+
+  remove(STORE_FILE);
+  {
+    NvStore60s store;
+    ASSERT_TRUE(store.open(STORE_FILE, GAUGES, RAIN_SYNC_ASYNC));
+    EXPECT_TRUE(store.created());
+    EXPECT_EQ(GAUGES, (int)store.size());
+
+    for (uint32_t g = 0; g < GAUGES; g++) {
+      RainGauge60s rainGauge(store.data(g));
+      rainGauge.reset();
+      rainGauge.setTimeZone(&utc);
+      // Overflow at 100 mm and sensor startup
+      for (int i = 0; i < 2000; i++) {
+        rain[g] += 0.1f * (float)((i + g) % 4);
+        if (rain[g] >= 100.0f)
+          rain[g] -= 100.0f;
+        rainGauge.update(t + i * 120, (i == 1500) ? 0.5f : rain[g], i >= 1500);
+        ASSERT_TRUE(store.commit(g));
+      }
+      pastHour[g] = rainGauge.pastHour();
+      peak[g]     = rainGauge.pastHourPeakRate();
+      day[g]      = rainGauge.currentDay();
+      week[g]     = rainGauge.currentWeek();
+      month[g]    = rainGauge.currentMonth();
+      EXPECT_GT(month[g], 100.0f);
+    }
+  }
+
+  {
+    NvStore60s store;
+    ASSERT_TRUE(store.open(STORE_FILE, 0, RAIN_SYNC_SYNC));
+    EXPECT_FALSE(store.created());
+    EXPECT_EQ(GAUGES, (int)store.size());
+
+    for (uint32_t g = 0; g < GAUGES; g++) {
+      RainGauge60s rainGauge(store.data(g));
+      rainGauge.resume();
+      EXPECT_FLOAT_EQ(pastHour[g], rainGauge.pastHour());
+      EXPECT_FLOAT_EQ(day[g], rainGauge.currentDay());
+      EXPECT_FLOAT_EQ(week[g], rainGauge.currentWeek());
+      EXPECT_FLOAT_EQ(month[g], rainGauge.currentMonth());
+      EXPECT_FLOAT_EQ(peak[g], rainGauge.pastHourPeakRate());
+    }
+
+    // Updates continue seamlessly
+    RainGauge60s rainGauge(store.data(0));
+    rainGauge.resume();
+    rainGauge.setTimeZone(&utc);
+    rainGauge.update(t + 2000 * 120, rain[0] + 1.0f);
+    EXPECT_FLOAT_EQ(month[0] + 1.0f, rainGauge.currentMonth());
+    EXPECT_TRUE(store.flush());
+  }
+  remove(STORE_FILE);
+}
+
+/*
+ * Files with different layout are rejected
+ */
+TEST(TestRainNvStore, HeaderMismatch) {
+  remove(HEADER_FILE);
+  {
+    NvStore60s store;
+    EXPECT_FALSE(store.open(HEADER_FILE, 0));
+  }
+  remove(HEADER_FILE);
+  {
+    NvStore60s store;
+    ASSERT_TRUE(store.open(HEADER_FILE, 3));
+  }
+  {
+    // Different number of records
+    NvStore60s store;
+    EXPECT_FALSE(store.open(HEADER_FILE, 4));
+    EXPECT_TRUE(store.open(HEADER_FILE, 3));
+  }
+  {
+    // Different buffer size
+    RainNvStoreT<12> store;
+    EXPECT_FALSE(store.open(HEADER_FILE, 3));
+  }
+  {
+    // Different version
+    FILE *f = fopen(HEADER_FILE, "r+b");
+    ASSERT_TRUE(f != NULL);
+    fseek(f, 4, SEEK_SET);
+    fputc(RAIN_NV_STORE_VERSION + 1, f);
+    fclose(f);
+    NvStore60s store;
+    EXPECT_FALSE(store.open(HEADER_FILE, 3));
+  }
+  remove(HEADER_FILE);
+}
+
+/*
+ * A file whose header has not been written (crash while creating it) is created again
+ */
+TEST(TestRainNvStore, HeaderNotWritten) {
+  std::vector<uint8_t> zero(sizeof(RainNvHeader) + 3 * sizeof(nvDataT<62>));
+  FILE *f = fopen(EMPTY_FILE, "wb");
+  ASSERT_TRUE(f != NULL);
+  ASSERT_EQ(zero.size(), fwrite(&zero[0], 1, zero.size(), f));
+  fclose(f);
+  {
+    // Number of records unknown
+    NvStore60s store;
+    EXPECT_FALSE(store.open(EMPTY_FILE, 0));
+  }
+  {
+    NvStore60s store;
+    ASSERT_TRUE(store.open(EMPTY_FILE, 3));
+    EXPECT_TRUE(store.created());
+  }
+  {
+    NvStore60s store;
+    ASSERT_TRUE(store.open(EMPTY_FILE, 0));
+    EXPECT_FALSE(store.created());
+    EXPECT_EQ(3u, store.size());
+  }
+  remove(EMPTY_FILE);
+}
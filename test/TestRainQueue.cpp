@@ -0,0 +1,230 @@
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// TestRainQueue.cpp
+//
+// Unit tests for RainSpscQueue, RainMpscQueue and the queued ingestion of RainGaugeShardsT
+//
+// https://github.com/matthias-bs/BresserWeatherSensorReceiver
+//
+//
+// created: 10/2026
+//
+//
+// MIT License
+//
+// Copyright (c) 2026 Matthias Prinke
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+// History:
+//
+// 20261016 Created
+// 20261017 Consumers yield when the queue is empty; fewer items (single core hosts)
+//
+// ToDo:
+// -
+//
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+
+#include <gtest/gtest.h>
+#include <thread>
+#include <vector>
+
+#include "RainGaugeFleet.h"
+#include "RainGaugeShards.h"
+#include "RainQueue.h"
+#include "TimeZone.h"
+
+#define ITEMS     10000
+#define PRODUCERS 4
+
+
+/*
+ * Capacity, back-pressure and batch dequeue (single thread)
+ */
+TEST(TestRainQueue, BackPressure) {
+  RainSpscQueue<int> spsc(5);
+  RainMpscQueue<int> mpsc(5);
+  int out[16];
+
+  EXPECT_EQ(8u, spsc.capacity());
+  EXPECT_EQ(8u, mpsc.capacity());
+  for (int i = 0; i < 8; i++) {
+    EXPECT_TRUE(spsc.push(i));
+    EXPECT_TRUE(mpsc.push(i));
+  }
+  EXPECT_FALSE(spsc.push(8));
+  EXPECT_FALSE(mpsc.push(8));
+  EXPECT_EQ(1u, spsc.rejected());
+  EXPECT_EQ(1u, mpsc.rejected());
+  EXPECT_EQ(8u, spsc.size());
+  EXPECT_EQ(8u, mpsc.size());
+
+  EXPECT_EQ(3u, spsc.popBatch(out, 3));
+  EXPECT_EQ(2, out[2]);
+  EXPECT_EQ(3u, mpsc.popBatch(out, 3));
+  EXPECT_EQ(2, out[2]);
+  EXPECT_TRUE(spsc.push(8));
+  EXPECT_TRUE(mpsc.push(8));
+  EXPECT_EQ(6u, spsc.popBatch(out, 16));
+  EXPECT_EQ(8, out[5]);
+  EXPECT_EQ(6u, mpsc.popBatch(out, 16));
+  EXPECT_EQ(8, out[5]);
+  EXPECT_EQ(0u, spsc.popBatch(out, 16));
+  EXPECT_EQ(0u, mpsc.popBatch(out, 16));
+}
+
+/*
+ * SPSC: all elements arrive in order
+ */
+TEST(TestRainQueue, SpscThreads) {
+  RainSpscQueue<uint32_t> q(64);
+
+  std::thread producer([&q]() {
+    for (uint32_t i = 0; i < ITEMS; ) {
+      if (q.push(i))
+        i++;
+      else
+        std::this_thread::yield();
+    }
+  });
+
+  uint32_t expected = 0;
+  uint32_t out[32];
+  while (expected < ITEMS) {
+    size_t n = q.popBatch(out, 32);
+    if (n == 0)
+      std::this_thread::yield();
+    for (size_t k = 0; k < n; k++) {
+      ASSERT_EQ(expected, out[k]);
+      expected++;
+    }
+  }
+  producer.join();
+  EXPECT_EQ(0u, q.size());
+}
+
+/*
+ * MPSC: all elements arrive, in order per producer
+ */
+TEST(TestRainQueue, MpscThreads) {
+  RainMpscQueue<uint32_t> q(64);
+
+  std::vector<std::thread> producers;
+  for (uint32_t p = 0; p < PRODUCERS; p++) {
+    producers.push_back(std::thread([&q, p]() {
+      for (uint32_t i = 0; i < ITEMS; ) {
+        if (q.push((p << 24) | i))
+          i++;
+        else
+          std::this_thread::yield();
+      }
+    }));
+  }
+
+  uint32_t next[PRODUCERS] = {0};
+  size_t   received = 0;
+  uint32_t out[32];
+  while (received < PRODUCERS * ITEMS) {
+    size_t n = q.popBatch(out, 32);
+    if (n == 0)
+      std::this_thread::yield();
+    for (size_t k = 0; k < n; k++) {
+      uint32_t p = out[k] >> 24;
+      ASSERT_LT(p, (uint32_t)PRODUCERS);
+      ASSERT_EQ(next[p], out[k] & 0xFFFFFF);
+      next[p]++;
+    }
+    received += n;
+  }
+  for (size_t p = 0; p < producers.size(); p++) {
+    producers[p].join();
+  }
+}
+
+/*
+ * Readings pushed by several receiver threads give the same results as a single fleet
+ */
+TEST(TestRainQueue, ShardsPushDrain) {
+  TimeZone utc;
+  const uint32_t gauges = 64;
+
+  RainGaugeFleet  fleet(gauges);
+  RainGaugeShards shards(gauges, 2, 0, 128);
+  RainSpscQueue<RainReading> single(128);
+  RainGaugeShards shardsSpsc(gauges, 2);
+  fleet.setTimeZone(&utc);
+  shards.setTimeZone(&utc);
+  shardsSpsc.setTimeZone(&utc);
+
+  // One receiver thread per group of gauges; 2022-09-06 00:00 UTC, one reading per 2 minutes
+  const int steps = 1000;
+  std::vector<std::thread> receivers;
+  for (uint32_t p = 0; p < PRODUCERS; p++) {
+    receivers.push_back(std::thread([&shards, p, gauges]() {
+      for (int step = 0; step < steps; step++) {
+        for (uint32_t id = p; id < gauges; id += PRODUCERS) {
+          RainReading r;
+          r.id      = id;
+          r.epoch   = 1662422400 + step * 120;
+          r.value   = (float)((id + step * (1 + id % 3)) % 1000) / 10;
+          r.startup = false;
+          while (!shards.push(r)) {
+            std::this_thread::yield();
+          }
+        }
+      }
+    }));
+  }
+  size_t applied = 0;
+  while (applied < (size_t)steps * gauges) {
+    size_t n = shards.drain();
+    if (n == 0)
+      std::this_thread::yield();
+    applied += n;
+  }
+  for (size_t p = 0; p < receivers.size(); p++) {
+    receivers[p].join();
+  }
+  EXPECT_EQ(0u, shards.queued());
+
+  // Reference and single receiver queue
+  for (int step = 0; step < steps; step++) {
+    for (uint32_t id = 0; id < gauges; id++) {
+      RainReading r;
+      r.id      = id;
+      r.epoch   = 1662422400 + step * 120;
+      r.value   = (float)((id + step * (1 + id % 3)) % 1000) / 10;
+      r.startup = false;
+      fleet.update(1, &r);
+      while (!single.push(r)) {
+        shardsSpsc.ingestFrom(single, 64);
+      }
+    }
+  }
+  shardsSpsc.ingestFrom(single, SIZE_MAX);
+
+  for (uint32_t id = 0; id < gauges; id++) {
+    ASSERT_FLOAT_EQ(fleet.current(id), shards.current(id)) << "id " << id;
+    ASSERT_FLOAT_EQ(fleet.pastHour(id), shards.pastHour(id)) << "id " << id;
+    ASSERT_FLOAT_EQ(fleet.currentDay(id), shards.currentDay(id)) << "id " << id;
+    ASSERT_FLOAT_EQ(fleet.pastHour(id), shardsSpsc.pastHour(id)) << "id " << id;
+    ASSERT_FLOAT_EQ(fleet.currentDay(id), shardsSpsc.currentDay(id)) << "id " << id;
+  }
+}
@@ -0,0 +1,147 @@
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// TestRainRegionTree.cpp
+//
+// Unit tests for RainRegionTree (hierarchical regional rollups)
+//
+// https://github.com/matthias-bs/BresserWeatherSensorReceiver
+//
+//
+// created: 10/2026
+//
+//
+// MIT License
+//
+// Copyright (c) 2026 Matthias Prinke
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+// History:
+//
+// 20261016 Created
+// 20261017 Use helpers from RainTestUtil.h
+//
+// ToDo:
+// -
+//
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+
+
+#include <gtest/gtest.h>
+#include <vector>
+
+#include "RainGaugeFleet.h"
+#include "RainRegionTree.h"
+#include "RainTestUtil.h"
+#include "TimeZone.h"
+
+#define GAUGES 300
+
+typedef RainGaugeFleetT<3600, 62, 10> Fleet60s;
+
+/*
+ * Sums over all gauges in region by brute force
+ */
+static void bruteForce(const Fleet60s &fleet, const RainRegionTree &tree, const std::vector<uint32_t> &region,
+                       uint32_t r, double sum[4], uint32_t &count)
+{
+    sum[0] = sum[1] = sum[2] = sum[3] = 0;
+    count = 0;
+    for (uint32_t g = 0; g < GAUGES; g++) {
+        uint32_t a = region[g];
+        while ((a != RAIN_REGION_NONE) && (a != r)) {
+            a = tree.parent(a);
+        }
+        if (a == RAIN_REGION_NONE)
+            continue;
+        sum[0] += fleet.pastHour(g);
+        sum[1] += fleet.currentDay(g);
+        sum[2] += fleet.currentWeek(g);
+        sum[3] += fleet.currentMonth(g);
+        count++;
+    }
+}
+
+
+/*
+ * Regional totals match the sums over the rain gauges, also after reassignment
+ */
+TEST(TestRainRegionTree, Totals) {
+  TimeZone       utc;
+  Fleet60s       fleet(GAUGES);
+  RainRegionTree tree(GAUGES);
+
+  // Root -> 3 regions -> 4 catchments each
+  std::vector<uint32_t> catchments;
+  for (int r = 0; r < 3; r++) {
+    uint32_t region = tree.addRegion(0);
+    for (int c = 0; c < 4; c++) {
+      catchments.push_back(tree.addRegion(region));
+    }
+  }
+  EXPECT_EQ(16u, tree.regions());
+  EXPECT_EQ(2u, tree.depth(catchments[5]));
+
+  // Every 10th gauge is not assigned
+  std::vector<uint32_t> region(GAUGES);
+  for (uint32_t g = 0; g < GAUGES; g++) {
+    region[g] = (g % 10 == 9) ? RAIN_REGION_NONE : catchments[g % catchments.size()];
+    tree.assign(g, region[g]);
+  }
+  EXPECT_EQ(270u, tree.gauges(0));
+
+  fleet.setTimeZone(&utc);
+  fleet.addObserver(&tree);
+
+  float    rain[GAUGES] = {0};
+  uint32_t x = 2463534242u;
+  time_t   t = T_BEGIN;
+  for (int b = 0; b < 300; b++) {
+    for (int k = 0; k < 50; k++) {
+      x ^= x << 13;
+      x ^= x >> 17;
+      x ^= x << 5;
+      uint32_t id = x % GAUGES;
+      rain[id] += 0.1f * (float)(x % 7);
+      t += 10;
+      fleet.updateBatch(1, &id, &t, &rain[id]);
+    }
+    if (b == 150) {
+      // Move some gauges to another catchment, assign an unassigned one
+      for (uint32_t g = 0; g < GAUGES; g += 7) {
+        region[g] = catchments[(g / 7) % catchments.size()];
+        tree.assign(g, region[g]);
+      }
+    }
+
+    for (uint32_t r = 0; r < tree.regions(); r++) {
+      double         sum[4];
+      uint32_t       count;
+      RainGaugeStats s;
+      bruteForce(fleet, tree, region, r, sum, count);
+      tree.total(r, s);
+      ASSERT_EQ(count, tree.gauges(r)) << "b=" << b << " r=" << r;
+      ASSERT_NEAR(sum[0], s.pastHour, 1e-3) << "b=" << b << " r=" << r;
+      ASSERT_NEAR(sum[1], s.currentDay, 1e-3) << "b=" << b << " r=" << r;
+      ASSERT_NEAR(sum[2], s.currentWeek, 1e-3) << "b=" << b << " r=" << r;
+      ASSERT_NEAR(sum[3], s.currentMonth, 1e-2) << "b=" << b << " r=" << r;
+    }
+  }
+  fleet.removeObserver(&tree);
+}
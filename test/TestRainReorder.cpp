@@ -0,0 +1,189 @@
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// TestRainReorder.cpp
+//
+// Unit tests for RainReorderBuffer and the reorder stage of RainGaugeShards
+//
+// https://github.com/matthias-bs/BresserWeatherSensorReceiver
+//
+//
+// created: 10/2026
+//
+//
+// MIT License
+//
+// Copyright (c) 2026 Matthias Prinke
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+// History:
+//
+// 20261016 Created
+// 20261017 Use helpers from RainTestUtil.h
+//
+// ToDo:
+// -
+//
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+
+
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <vector>
+
+#include "RainGaugeFleet.h"
+#include "RainGaugeShards.h"
+#include "RainReorder.h"
+#include "RainTestUtil.h"
+#include "TimeZone.h"
+
+#define GAUGES  97
+#define HORIZON 120
+
+static RainReading reading(uint32_t id, time_t epoch, float value)
+{
+  RainReading r;
+  r.id      = id;
+  r.epoch   = epoch;
+  r.value   = value;
+  r.startup = false;
+  return r;
+}
+
+
+/*
+ * Readings are released in chronological order once the watermark has passed them
+ */
+TEST(TestRainReorder, Order) {
+  RainReorderBuffer buf(4, 60);
+  RainReading       out[8];
+
+  EXPECT_TRUE(buf.push(reading(0, T_BEGIN + 30, 1.0f)));
+  EXPECT_TRUE(buf.push(reading(1, T_BEGIN + 10, 2.0f)));
+  EXPECT_TRUE(buf.push(reading(2, T_BEGIN + 20, 3.0f)));
+  EXPECT_EQ(T_BEGIN - 30, buf.watermark());
+  EXPECT_EQ(0u, buf.pop(out, 8));
+  EXPECT_EQ(3u, buf.size());
+
+  // Newest time stamp T_BEGIN+85 -> watermark T_BEGIN+25
+  EXPECT_TRUE(buf.push(reading(3, T_BEGIN + 85, 4.0f)));
+  ASSERT_EQ(2u, buf.pop(out, 8));
+  EXPECT_EQ(1u, out[0].id);
+  EXPECT_EQ(2u, out[1].id);
+
+  // Readings with equal time stamps keep their arrival order
+  EXPECT_TRUE(buf.push(reading(2, T_BEGIN + 30, 5.0f)));
+  ASSERT_EQ(3u, buf.flush(out, 8));
+  EXPECT_EQ(0u, out[0].id);
+  EXPECT_EQ(2u, out[1].id);
+  EXPECT_EQ(5.0f, out[1].value);
+  EXPECT_EQ(3u, out[2].id);
+  EXPECT_EQ(0u, buf.size());
+  EXPECT_FALSE(buf.push(reading(4, T_BEGIN + 90, 1.0f)));
+}
+
+/*
+ * A reading older than the last released reading of its gauge is dropped
+ */
+TEST(TestRainReorder, Late) {
+  RainReorderBuffer buf(2, 60);
+  RainReading       out[8];
+
+  buf.push(reading(0, T_BEGIN, 1.0f));
+  buf.push(reading(1, T_BEGIN + 100, 1.0f));
+  ASSERT_EQ(1u, buf.pop(out, 8));
+
+  // Gauge 0 is too late, gauge 1 is still held back and can be sorted in
+  EXPECT_FALSE(buf.push(reading(0, T_BEGIN - 5, 0.5f)));
+  EXPECT_TRUE(buf.push(reading(1, T_BEGIN + 50, 0.5f)));
+  EXPECT_EQ(1u, buf.late());
+  ASSERT_EQ(2u, buf.flush(out, 8));
+  EXPECT_EQ(T_BEGIN + 50, out[0].epoch);
+  EXPECT_EQ(T_BEGIN + 100, out[1].epoch);
+}
+
+/*
+ * No more than capacity readings are held back
+ */
+TEST(TestRainReorder, Capacity) {
+  RainReorderBuffer buf(1, 3600, 16);
+  RainReading       out[64];
+
+  for (int i = 0; i < 40; i++) {
+    buf.push(reading(0, T_BEGIN + i, (float)i));
+  }
+  ASSERT_EQ(24u, buf.pop(out, 64));
+  EXPECT_EQ(16u, buf.size());
+  for (int i = 0; i < 24; i++) {
+    EXPECT_EQ(T_BEGIN + i, out[i].epoch);
+  }
+}
+
+/*
+ * Readings delayed by less than the horizon and queued in arrival order give the same
+ * results as a fleet updated in chronological order
+ */
+TEST(TestRainReorder, ShardsMatchFleet) {
+  TimeZone                 utc;
+  RainGaugeFleet           fleet(GAUGES);
+  RainGaugeShards          sharded(GAUGES, 2, 5);
+  std::vector<RainReading> sorted;
+  std::vector<float>       rain(GAUGES, 0.0f);
+  std::vector<std::pair<time_t, size_t> > arrival;
+  uint32_t x = 2463534242u;
+
+  fleet.setTimeZone(&utc);
+  sharded.setTimeZone(&utc);
+  sharded.setReorder(HORIZON);
+
+  // Two days, a reading every two seconds
+  for (int i = 0; i < 86400; i++) {
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    uint32_t id = x % GAUGES;
+    if ((i / 3000) % 3 == 0)
+      rain[id] += 0.1f * (float)(x % 4);
+    sorted.push_back(reading(id, T_BEGIN + 2 * i, rain[id]));
+    arrival.push_back(std::make_pair(T_BEGIN + 2 * i + (time_t)((x >> 8) % HORIZON), sorted.size() - 1));
+  }
+  std::sort(arrival.begin(), arrival.end());
+
+  fleet.update(sorted.size(), &sorted[0]);
+  size_t applied = 0;
+  for (size_t k = 0; k < arrival.size(); k++) {
+    ASSERT_TRUE(sharded.push(sorted[arrival[k].second]));
+    if (k % 500 == 499)
+      applied += sharded.drain();
+  }
+  applied += sharded.drain();
+  EXPECT_GT(sharded.held(), 0u);
+  applied += sharded.flushReorder();
+  EXPECT_EQ(sorted.size(), applied);
+  EXPECT_EQ(0u, sharded.held());
+  EXPECT_EQ(0u, sharded.late());
+
+  for (uint32_t id = 0; id < GAUGES; id++) {
+    ASSERT_FLOAT_EQ(fleet.current(id), sharded.current(id)) << "id " << id;
+    ASSERT_FLOAT_EQ(fleet.pastHour(id), sharded.pastHour(id)) << "id " << id;
+    ASSERT_FLOAT_EQ(fleet.currentDay(id), sharded.currentDay(id)) << "id " << id;
+    ASSERT_FLOAT_EQ(fleet.currentWeek(id), sharded.currentWeek(id)) << "id " << id;
+    ASSERT_FLOAT_EQ(fleet.currentMonth(id), sharded.currentMonth(id)) << "id " << id;
+  }
+}
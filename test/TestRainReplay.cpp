@@ -0,0 +1,226 @@
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// TestRainReplay.cpp
+//
+// Unit tests for RainReplayParser and RainMappedFile
+//
+// https://github.com/matthias-bs/BresserWeatherSensorReceiver
+//
+//
+// created: 10/2026
+//
+//
+// MIT License
+//
+// Copyright (c) 2026 Matthias Prinke
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+// History:
+//
+// 20261016 Created
+//
+// ToDo:
+// -
+//
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+
+
+#include <gtest/gtest.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <string>
+
+#include "CivilTime.h"
+#include "RainGauge.h"
+#include "RainReplay.h"
+#include "TimeZone.h"
+
+
+/*
+ * Time stamps: seconds since epoch and ISO 8601
+ */
+TEST(TestRainReplay, ParseTime) {
+  const char *tests[] = {
+    "1662451200", "2022-09-06T08:00:00Z", "2022-09-06 08:00:00", "2022-09-06T08:00", "\"2022-09-06T08:00:00.250Z\""
+  };
+  for (size_t i = 0; i < sizeof(tests) / sizeof(tests[0]); i++) {
+    const char *p = tests[i];
+    time_t      t = 0;
+    EXPECT_TRUE(RainReplayParser::parseTime(p, p + strlen(tests[i]), t)) << tests[i];
+    EXPECT_EQ(1662451200, t) << tests[i];
+    EXPECT_EQ(tests[i] + strlen(tests[i]), p) << tests[i];
+  }
+
+  const char *leap = "2024-02-29T23:59:59Z";
+  const char *p = leap;
+  time_t      t;
+  EXPECT_TRUE(RainReplayParser::parseTime(p, p + strlen(leap), t));
+  EXPECT_EQ((time_t)daysFromCivil(2024, 3, 1) * 86400 - 1, t);
+
+  const char *bad[] = {"2022-13-06T08:00:00Z", "2022-09-06X08:00", "2022-09-06T8:00", "x"};
+  for (size_t i = 0; i < sizeof(bad) / sizeof(bad[0]); i++) {
+    p = bad[i];
+    EXPECT_FALSE(RainReplayParser::parseTime(p, p + strlen(bad[i]), t)) << bad[i];
+  }
+}
+
+/*
+ * Decimal numbers give the same float values as strtof()
+ */
+TEST(TestRainReplay, ParseNumber) {
+  char buf[32];
+  for (int i = 0; i < 100000; i++) {
+    snprintf(buf, sizeof(buf), "%d.%d", i / 10, i % 10);
+    const char *p = buf;
+    double      v;
+    ASSERT_TRUE(RainReplayParser::parseNumber(p, buf + strlen(buf), v));
+    ASSERT_EQ(strtof(buf, NULL), (float)v) << buf;
+  }
+  const char *neg = "-12.625";
+  const char *p = neg;
+  double      v;
+  EXPECT_TRUE(RainReplayParser::parseNumber(p, neg + 7, v));
+  EXPECT_EQ(-12.625, v);
+}
+
+/*
+ * CSV and JSON lines, comments, header, errors and a last line without newline
+ */
+TEST(TestRainReplay, ParseLines) {
+  const char *text =
+    "time,id,value,startup\n"
+    "# comment\n"
+    "2022-09-06T08:00:00Z,3,12.5,0\r\n"
+    "1662451260, 4, 0.1 ,true\n"
+    "\n"
+    "2022-09-06T08:02:00Z,7.5\n"
+    "{\"time\": \"2022-09-06T08:03:00Z\", \"id\": 2, \"value\": 1.5, \"startup\": true}\n"
+    "{\"sensor\": \"abc\", \"rain\": 2.5, \"ts\": 1662451440, \"battery\": 1}\n"
+    "2022-09-06T08:05:00Z;1;2\n"
+    "{\"time\": 1662451500}\n"
+    "1662451560,1,3.5";
+
+  RainReplayParser parser;
+  RainReading      r[10];
+  const char      *pos = text;
+  const char      *end = text + strlen(text);
+
+  // Complete lines only
+  size_t n = parser.parse(pos, end, r, 10, false);
+  ASSERT_EQ(5u, n);
+  EXPECT_EQ(2u, parser.errors());
+  n += parser.parse(pos, end, r + n, 10 - n, true);
+  ASSERT_EQ(6u, n);
+  EXPECT_EQ(end, pos);
+  EXPECT_EQ(11u, parser.lines());
+  EXPECT_EQ(2u, parser.errors());
+
+  EXPECT_EQ(1662451200, r[0].epoch);
+  EXPECT_EQ(3u, r[0].id);
+  EXPECT_EQ(12.5f, r[0].value);
+  EXPECT_FALSE(r[0].startup);
+
+  EXPECT_EQ(1662451260, r[1].epoch);
+  EXPECT_EQ(4u, r[1].id);
+  EXPECT_EQ(0.1f, r[1].value);
+  EXPECT_TRUE(r[1].startup);
+
+  EXPECT_EQ(1662451320, r[2].epoch);
+  EXPECT_EQ(0u, r[2].id);
+  EXPECT_EQ(7.5f, r[2].value);
+
+  EXPECT_EQ(1662451380, r[3].epoch);
+  EXPECT_EQ(2u, r[3].id);
+  EXPECT_EQ(1.5f, r[3].value);
+  EXPECT_TRUE(r[3].startup);
+
+  EXPECT_EQ(1662451440, r[4].epoch);
+  EXPECT_EQ(0u, r[4].id);
+  EXPECT_EQ(2.5f, r[4].value);
+
+  EXPECT_EQ(1662451560, r[5].epoch);
+  EXPECT_EQ(1u, r[5].id);
+  EXPECT_EQ(3.5f, r[5].value);
+}
+
+/*
+ * Replay of a mapped file gives the same statistics as direct updates
+ */
+TEST(TestRainReplay, MappedFile) {
+  const char *path = "TestRainReplay.csv";
+  TimeZone    utc;
+  nvData_t    nvDirect;
+  RainGauge   direct(&nvDirect);
+
+  direct.reset();
+  direct.setTimeZone(&utc);
+
+  FILE *f = fopen(path, "w");
+  ASSERT_TRUE(f != NULL);
+  float rain = 0;
+  for (int i = 0; i < 5000; i++) {
+    time_t t = 1662451200 + i * 360;
+    rain += 0.1f * (float)(i % 4);
+    if (rain >= 100.0f)
+      rain -= 100.0f;
+    char value[16];
+    snprintf(value, sizeof(value), "%.1f", rain);
+    if (i % 2) {
+      fprintf(f, "%lld,0,%s\n", (long long)t, value);
+    } else {
+      int days = (int)(t / 86400);
+      int secs = (int)(t % 86400);
+      fprintf(f, "%04d-%02d-%02dT%02d:%02d:%02dZ,%s\n", yearFromDays(days), monthFromDays(days),
+              dayFromDays(days), secs / 3600, (secs / 60) % 60, secs % 60, value);
+    }
+    direct.update(t, strtof(value, NULL));
+  }
+  fclose(f);
+
+  RainMappedFile file;
+  ASSERT_TRUE(file.open(path));
+  EXPECT_GT(file.size(), 0u);
+
+  nvData_t         nv;
+  RainGauge        replayed(&nv);
+  RainReplayParser parser;
+  RainReading      chunk[64];
+  const char      *pos = file.data();
+  size_t           total = 0;
+  replayed.reset();
+  replayed.setTimeZone(&utc);
+  while (pos < file.data() + file.size()) {
+    size_t n = parser.parse(pos, file.data() + file.size(), chunk, 64);
+    for (size_t k = 0; k < n; k++) {
+      replayed.update(chunk[k].epoch, chunk[k].value, chunk[k].startup);
+    }
+    total += n;
+  }
+  EXPECT_EQ(5000u, total);
+  EXPECT_EQ(0u, parser.errors());
+  EXPECT_FLOAT_EQ(direct.pastHour(), replayed.pastHour());
+  EXPECT_FLOAT_EQ(direct.currentDay(), replayed.currentDay());
+  EXPECT_FLOAT_EQ(direct.currentWeek(), replayed.currentWeek());
+  EXPECT_FLOAT_EQ(direct.currentMonth(), replayed.currentMonth());
+
+  file.close();
+  remove(path);
+}
@@ -0,0 +1,156 @@
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// TestRainTopK.cpp
+//
+// Unit tests for RainTopK (ranking of rain gauges by pastHour())
+//
+// https://github.com/matthias-bs/BresserWeatherSensorReceiver
+//
+//
+// created: 10/2026
+//
+//
+// MIT License
+//
+// Copyright (c) 2026 Matthias Prinke
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+// History:
+//
+// 20261016 Created
+// 20261017 Use helpers from RainTestUtil.h
+//
+// ToDo:
+// -
+//
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+
+
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <vector>
+
+#include "RainGaugeFleet.h"
+#include "RainTestUtil.h"
+#include "RainTopK.h"
+#include "TimeZone.h"
+
+#define GAUGES 500
+#define K      50
+
+typedef RainGaugeFleetT<3600, 62, 10> Fleet60s;
+
+static bool greater(const RainRank &a, const RainRank &b)
+{
+    return (a.value > b.value) || ((a.value == b.value) && (a.id < b.id));
+}
+
+
+/*
+ * Order, ties and removal of gauges without rainfall
+ */
+TEST(TestRainTopK, Set) {
+  RainTopK topK(10);
+  RainRank r[10];
+
+  EXPECT_EQ(0u, topK.top(5, r));
+  topK.set(3, 1.5f);
+  topK.set(7, 2.5f);
+  topK.set(1, 1.5f);
+  topK.set(9, 0.5f);
+  EXPECT_EQ(4u, topK.size());
+
+  ASSERT_EQ(3u, topK.top(3, r));
+  EXPECT_EQ(7u, r[0].id);
+  EXPECT_EQ(2.5f, r[0].value);
+  EXPECT_EQ(1u, r[1].id);
+  EXPECT_EQ(3u, r[2].id);
+
+  // Decrease moves gauge down, zero removes it
+  topK.set(7, 1.0f);
+  topK.set(1, 0.0f);
+  ASSERT_EQ(3u, topK.top(10, r));
+  EXPECT_EQ(3u, r[0].id);
+  EXPECT_EQ(7u, r[1].id);
+  EXPECT_EQ(9u, r[2].id);
+}
+
+/*
+ * Ranking fed by fleet updates (including eviction from the past window)
+ * matches sorting all gauges
+ */
+TEST(TestRainTopK, MatchesSort) {
+  TimeZone utc;
+  Fleet60s fleet(GAUGES);
+  RainTopK topK(GAUGES);
+  float    rain[GAUGES] = {0};
+  uint32_t x = 2463534242u;
+
+  fleet.setTimeZone(&utc);
+  fleet.addObserver(&topK);
+
+  time_t t = T_BEGIN;
+  for (int b = 0; b < 400; b++) {
+    uint32_t ids[GAUGES / 4];
+    time_t   epochs[GAUGES / 4];
+    float    values[GAUGES / 4];
+    for (int k = 0; k < GAUGES / 4; k++) {
+      x ^= x << 13;
+      x ^= x >> 17;
+      x ^= x << 5;
+      uint32_t id = x % GAUGES;
+      // Showers on a few gauges at a time, so rankings change often
+      if ((id / 50) % 8 == (uint32_t)(b / 25) % 8)
+        rain[id] += 0.1f * (float)(x % 30);
+      t += 2;
+      ids[k]    = id;
+      epochs[k] = t;
+      values[k] = rain[id];
+    }
+    fleet.updateBatch(GAUGES / 4, ids, epochs, values);
+
+    std::vector<RainRank> all;
+    for (uint32_t g = 0; g < GAUGES; g++) {
+      RainRank r = {g, fleet.pastHour(g)};
+      if (r.value > 0)
+        all.push_back(r);
+    }
+    std::sort(all.begin(), all.end(), greater);
+
+    RainRank r[K];
+    size_t   n = topK.top(K, r);
+    ASSERT_EQ(std::min(all.size(), (size_t)K), n) << "b=" << b;
+    ASSERT_EQ(all.size(), topK.size()) << "b=" << b;
+    for (size_t i = 0; i < n; i++) {
+      ASSERT_EQ(all[i].id, r[i].id) << "b=" << b << " i=" << i;
+      ASSERT_EQ(all[i].value, r[i].value) << "b=" << b << " i=" << i;
+    }
+  }
+
+  // Reset removes gauge from ranking
+  RainRank r[K];
+  ASSERT_GT(topK.top(1, r), 0u);
+  fleet.reset(r[0].id);
+  RainRank r2[K];
+  topK.top(1, r2);
+  EXPECT_NE(r[0].id, r2[0].id);
+
+  fleet.removeObserver(&topK);
+}
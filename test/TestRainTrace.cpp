@@ -0,0 +1,217 @@
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// TestRainTrace.cpp
+//
+// Unit tests for RainTraceWriter and RainTraceReader (columnar binary trace format)
+//
+// https://github.com/matthias-bs/BresserWeatherSensorReceiver
+//
+//
+// created: 10/2026
+//
+//
+// MIT License
+//
+// Copyright (c) 2026 Matthias Prinke
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+// History:
+//
+// 20261016 Created
+// 20261017 Use helpers from RainTestUtil.h
+//
+// ToDo:
+// -
+//
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+
+
+#include <gtest/gtest.h>
+#include <stdio.h>
+#include <vector>
+
+#include "RainGaugeFleet.h"
+#include "RainTestUtil.h"
+#include "RainTrace.h"
+#include "TimeZone.h"
+
+#define GAUGES 100
+
+typedef RainGaugeFleetT<3600, 62, 10> Fleet60s;
+
+/*
+ * Readings of GAUGES gauges every 6 minutes with jitter, 0.1 mm resolution
+ */
+static void makeReadings(std::vector<RainReading> &readings, size_t n)
+{
+    std::vector<int> rain(GAUGES, 0);
+    uint32_t x = 2463534242u;
+
+    readings.resize(n);
+    for (size_t i = 0; i < n; i++) {
+        x ^= x << 13;
+        x ^= x >> 17;
+        x ^= x << 5;
+        RainReading &r = readings[i];
+        r.id      = (uint32_t)((i * 37) % GAUGES);
+        r.epoch   = T_BEGIN + (time_t)(i / GAUGES) * 360 + (time_t)(x % 5);
+        rain[r.id] = (rain[r.id] + (int)(x % 4)) % 1000;
+        r.value   = (float)rain[r.id] / 10.0f;
+        r.startup = (x % 97) == 0;
+    }
+}
+
+
+/*
+ * Readings are restored exactly
+ */
+TEST(TestRainTrace, RoundTrip) {
+  const char *path = "TestRainTraceRoundTrip.rgt";
+  std::vector<RainReading> readings;
+  makeReadings(readings, 10000);
+
+  // Gauge ids outside of the delta-encoding range, negative epoch deltas
+  readings[10].id    = 0xFFFFFFF0u;
+  readings[11].epoch = readings[10].epoch - 1000;
+
+  RainTraceWriter writer(10, 512);
+  ASSERT_TRUE(writer.open(path));
+  for (size_t i = 0; i < readings.size(); i++) {
+    ASSERT_TRUE(writer.write(readings[i]));
+  }
+  ASSERT_TRUE(writer.close());
+  EXPECT_EQ(readings.size(), writer.readings());
+  EXPECT_EQ(0u, writer.rounded());
+  // Well below the 24 bytes of RainReading and ~25 bytes of a CSV line
+  EXPECT_LT(writer.bytes(), readings.size() * 4);
+
+  RainTraceReader reader;
+  ASSERT_TRUE(reader.open(path));
+  EXPECT_EQ(10u, reader.scale());
+
+  const uint32_t *ids;
+  const time_t   *epochs;
+  const float    *values;
+  const bool     *startup;
+  size_t          total = 0;
+  size_t          n;
+  while ((n = reader.next(ids, epochs, values, startup)) > 0) {
+    EXPECT_LE(n, 512u);
+    for (size_t k = 0; k < n; k++) {
+      const RainReading &r = readings[total + k];
+      ASSERT_EQ(r.id, ids[k]) << total + k;
+      ASSERT_EQ(r.epoch, epochs[k]) << total + k;
+      ASSERT_EQ(r.value, values[k]) << total + k;
+      ASSERT_EQ(r.startup, startup[k]) << total + k;
+    }
+    total += n;
+  }
+  EXPECT_FALSE(reader.error());
+  EXPECT_EQ(readings.size(), total);
+  remove(path);
+}
+
+/*
+ * Batches from the reader drive a fleet like the original readings
+ */
+TEST(TestRainTrace, Fleet) {
+  const char *path = "TestRainTraceFleet.rgt";
+  TimeZone    utc;
+  std::vector<RainReading> readings;
+  makeReadings(readings, 20000);
+
+  RainTraceWriter writer;
+  ASSERT_TRUE(writer.open(path));
+  for (size_t i = 0; i < readings.size(); i++) {
+    writer.write(readings[i]);
+  }
+  ASSERT_TRUE(writer.close());
+
+  Fleet60s expected(GAUGES);
+  expected.setTimeZone(&utc);
+  expected.update(readings.size(), &readings[0]);
+
+  Fleet60s        fleet(GAUGES);
+  RainTraceReader reader;
+  fleet.setTimeZone(&utc);
+  ASSERT_TRUE(reader.open(path));
+  const uint32_t *ids;
+  const time_t   *epochs;
+  const float    *values;
+  const bool     *startup;
+  size_t          n;
+  while ((n = reader.next(ids, epochs, values, startup)) > 0) {
+    fleet.updateBatch(n, ids, epochs, values, startup);
+  }
+  EXPECT_FALSE(reader.error());
+  for (uint32_t g = 0; g < GAUGES; g++) {
+    ASSERT_EQ(expected.pastHour(g), fleet.pastHour(g)) << g;
+    ASSERT_EQ(expected.currentDay(g), fleet.currentDay(g)) << g;
+    ASSERT_EQ(expected.currentWeek(g), fleet.currentWeek(g)) << g;
+    ASSERT_EQ(expected.currentMonth(g), fleet.currentMonth(g)) << g;
+  }
+  remove(path);
+}
+
+/*
+ * Corrupted and truncated blocks are detected
+ */
+TEST(TestRainTrace, Corruption) {
+  const char *path = "TestRainTraceCrc.rgt";
+  std::vector<RainReading> readings;
+  makeReadings(readings, 3000);
+
+  RainTraceWriter writer(10, 1000);
+  ASSERT_TRUE(writer.open(path));
+  for (size_t i = 0; i < readings.size(); i++) {
+    writer.write(readings[i]);
+  }
+  ASSERT_TRUE(writer.close());
+
+  RainMappedFile file;
+  ASSERT_TRUE(file.open(path));
+  std::vector<char> data(file.data(), file.data() + file.size());
+
+  const uint32_t *ids;
+  const time_t   *epochs;
+  const float    *values;
+  const bool     *startup;
+
+  // Flip a byte in the second block
+  RainTraceReader reader;
+  data[data.size() / 2] ^= 0x04;
+  ASSERT_TRUE(reader.open(&data[0], data.size()));
+  EXPECT_EQ(1000u, reader.next(ids, epochs, values, startup));
+  EXPECT_EQ(0u, reader.next(ids, epochs, values, startup));
+  EXPECT_TRUE(reader.error());
+
+  // Truncated last block
+  data[data.size() / 2] ^= 0x04;
+  ASSERT_TRUE(reader.open(&data[0], data.size() - 10));
+  EXPECT_EQ(1000u, reader.next(ids, epochs, values, startup));
+  EXPECT_EQ(1000u, reader.next(ids, epochs, values, startup));
+  EXPECT_EQ(0u, reader.next(ids, epochs, values, startup));
+  EXPECT_TRUE(reader.error());
+
+  // Not a trace
+  EXPECT_FALSE(reader.open("1662321600,1,0.5\n", 17));
+  file.close();
+  remove(path);
+}
@@ -0,0 +1,303 @@
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// TestRainWal.cpp
+//
+// Unit tests for RainWal (write-ahead log) and RainGaugeDurableT (checkpoint and recovery)
+//
+// https://github.com/matthias-bs/BresserWeatherSensorReceiver
+//
+//
+// created: 10/2026
+//
+//
+// MIT License
+//
+// Copyright (c) 2026 Matthias Prinke
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+// History:
+//
+// 20261016 Created
+// 20261017 Added failed group commit test
+// 20261017 Added failed automatic checkpoint test
+// 20261017 Use helpers from RainTestUtil.h
+//
+// ToDo:
+// -
+//
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+
+
+#include <gtest/gtest.h>
+#include <signal.h>
+#include <stdio.h>
+#include <sys/resource.h>
+#include <vector>
+
+#include "RainGaugeFleet.h"
+#include "RainTestUtil.h"
+#include "RainWal.h"
+#include "TimeZone.h"
+
+#define GAUGES 20
+
+typedef RainGaugeFleetT<3600, 62, 10>   Fleet60s;
+typedef RainGaugeDurableT<3600, 62, 10> Durable60s;
+
+static RainReading reading(size_t i)
+{
+    RainReading r;
+    r.id      = (uint32_t)((i * 7) % GAUGES);
+    r.epoch   = T_BEGIN + (time_t)(i / GAUGES) * 120;
+    r.value   = (float)((i / GAUGES) % 1000) * 0.1f + (float)(r.id % 3) * 0.1f;
+    r.startup = (i % 1000) == 999;
+    return r;
+}
+
+
+/*
+ * Records become durable in groups and are replayed in order
+ */
+TEST(TestRainWal, GroupCommit) {
+  const char *path = "TestRainWalGroup.wal";
+  remove(path);
+  {
+    RainWal wal(10);
+    ASSERT_TRUE(wal.open(path));
+    for (size_t i = 0; i < 25; i++) {
+      EXPECT_EQ(i + 1, wal.append(reading(i)));
+    }
+    EXPECT_EQ(20u, wal.durable());
+    EXPECT_EQ(25u, wal.last());
+    EXPECT_EQ(2u, wal.commits());
+    ASSERT_TRUE(wal.commit());
+    EXPECT_EQ(25u, wal.durable());
+    EXPECT_EQ(3u, wal.commits());
+    ASSERT_TRUE(wal.commit());
+    EXPECT_EQ(3u, wal.commits());
+  }
+  {
+    RainWal wal;
+    ASSERT_TRUE(wal.open(path));
+    EXPECT_EQ(25u, wal.records());
+    EXPECT_EQ(25u, wal.durable());
+
+    size_t n = 0;
+    ASSERT_TRUE(wal.replay(5, [&n](const RainReading &r) {
+      RainReading e = reading(n + 5);
+      EXPECT_EQ(e.id, r.id);
+      EXPECT_EQ(e.epoch, r.epoch);
+      EXPECT_EQ(e.value, r.value);
+      EXPECT_EQ(e.startup, r.startup);
+      n++;
+    }));
+    EXPECT_EQ(20u, n);
+
+    // LSNs continue after truncate()
+    EXPECT_EQ(26u, wal.append(reading(25)));
+    ASSERT_TRUE(wal.truncate());
+    EXPECT_EQ(0u, wal.records());
+    EXPECT_EQ(27u, wal.append(reading(26)));
+    ASSERT_TRUE(wal.commit());
+  }
+  {
+    RainWal wal;
+    ASSERT_TRUE(wal.open(path));
+    EXPECT_EQ(1u, wal.records());
+    EXPECT_EQ(27u, wal.durable());
+  }
+  remove(path);
+}
+
+/*
+ * A torn or corrupted tail is dropped
+ */
+TEST(TestRainWal, TornTail) {
+  const char *path = "TestRainWalTorn.wal";
+  remove(path);
+  {
+    RainWal wal(4);
+    ASSERT_TRUE(wal.open(path));
+    for (size_t i = 0; i < 10; i++) {
+      wal.append(reading(i));
+    }
+    ASSERT_TRUE(wal.commit());
+  }
+  {
+    // Half-written record at end
+    FILE *f = fopen(path, "ab");
+    ASSERT_TRUE(f != NULL);
+    fwrite("torn record", 1, 11, f);
+    fclose(f);
+  }
+  {
+    RainWal wal;
+    ASSERT_TRUE(wal.open(path));
+    EXPECT_EQ(10u, wal.records());
+  }
+  {
+    // Corrupt value of record 8 (LSN)
+    FILE *f = fopen(path, "r+b");
+    ASSERT_TRUE(f != NULL);
+    fseek(f, 32 + 7 * (long)sizeof(RainWalRecord) + 20, SEEK_SET);
+    fputc(0x55, f);
+    fclose(f);
+  }
+  {
+    RainWal wal;
+    ASSERT_TRUE(wal.open(path));
+    EXPECT_EQ(7u, wal.records());
+    EXPECT_EQ(8u, wal.append(reading(7)));
+  }
+  remove(path);
+}
+
+/*
+ * A record whose group commit fails is not logged
+ */
+TEST(TestRainWal, FailedCommit) {
+  const char *path = "TestRainWalFail.wal";
+  remove(path);
+  {
+    RainWal wal(4);
+    ASSERT_TRUE(wal.open(path));
+    for (size_t i = 0; i < 3; i++) {
+      EXPECT_EQ(i + 1, wal.append(reading(i)));
+    }
+
+    // Writes beyond the header fail with EFBIG
+    struct rlimit saved;
+    struct rlimit limit;
+    ASSERT_EQ(0, getrlimit(RLIMIT_FSIZE, &saved));
+    limit = saved;
+    limit.rlim_cur = 32;
+    void (*handler)(int) = signal(SIGXFSZ, SIG_IGN);
+    ASSERT_EQ(0, setrlimit(RLIMIT_FSIZE, &limit));
+    EXPECT_EQ(0u, wal.append(reading(100)));
+    EXPECT_FALSE(wal.commit());
+    ASSERT_EQ(0, setrlimit(RLIMIT_FSIZE, &saved));
+    signal(SIGXFSZ, handler);
+
+    EXPECT_EQ(3u, wal.last());
+    EXPECT_EQ(0u, wal.durable());
+    EXPECT_EQ(4u, wal.append(reading(3)));
+    EXPECT_EQ(4u, wal.durable());
+  }
+  {
+    RainWal wal;
+    ASSERT_TRUE(wal.open(path));
+    EXPECT_EQ(4u, wal.records());
+
+    size_t n = 0;
+    ASSERT_TRUE(wal.replay(0, [&n](const RainReading &r) {
+      RainReading e = reading(n);
+      EXPECT_EQ(e.id, r.id);
+      EXPECT_EQ(e.epoch, r.epoch);
+      EXPECT_EQ(e.value, r.value);
+      n++;
+    }));
+    EXPECT_EQ(4u, n);
+  }
+  remove(path);
+}
+
+/*
+ * Recovery from checkpoint and log tail gives the state of all durable readings
+ */
+TEST(TestRainWal, Recovery) {
+  const char *walPath  = "TestRainWalRecovery.wal";
+  const char *ckptPath = "TestRainWalRecovery.ckpt";
+  TimeZone    utc;
+  Fleet60s    expected(GAUGES);
+  uint64_t    durable;
+
+  remove(walPath);
+  remove(ckptPath);
+  expected.setTimeZone(&utc);
+  {
+    Fleet60s   fleet(GAUGES);
+    Durable60s log(fleet, 64, 5000);
+    fleet.setTimeZone(&utc);
+    ASSERT_TRUE(log.open(walPath, ckptPath));
+    EXPECT_EQ(0u, log.replayed());
+    for (size_t i = 0; i < 12345; i++) {
+      RainReading r = reading(i);
+      ASSERT_EQ(i + 1, log.update(r));
+    }
+    // Crash - readings after the last group commit (groups restart at each checkpoint) are lost
+    durable = log.durable();
+    EXPECT_EQ(10000u + (2345u / 64u) * 64u, durable);
+  }
+  for (size_t i = 0; i < durable; i++) {
+    RainReading r = reading(i);
+    expected.update(1, &r);
+  }
+  {
+    Fleet60s   fleet(GAUGES);
+    Durable60s log(fleet, 64, 5000);
+    fleet.setTimeZone(&utc);
+    ASSERT_TRUE(log.open(walPath, ckptPath));
+    // Only the readings after the last checkpoint (at 10000) are replayed
+    EXPECT_EQ(durable - 10000, log.replayed());
+    for (uint32_t g = 0; g < GAUGES; g++) {
+      EXPECT_FLOAT_EQ(expected.pastHour(g), fleet.pastHour(g)) << g;
+      EXPECT_FLOAT_EQ(expected.currentDay(g), fleet.currentDay(g)) << g;
+      EXPECT_FLOAT_EQ(expected.currentWeek(g), fleet.currentWeek(g)) << g;
+      EXPECT_FLOAT_EQ(expected.currentMonth(g), fleet.currentMonth(g)) << g;
+    }
+
+    // Logging continues after recovery
+    RainReading r = reading(durable);
+    EXPECT_EQ(durable + 1, log.update(r));
+    ASSERT_TRUE(log.checkpoint());
+    EXPECT_EQ(0u, log.log().records());
+  }
+  remove(walPath);
+  remove(ckptPath);
+}
+
+/*
+ * A failed automatic checkpoint does not fail the logged reading
+ */
+TEST(TestRainWal, FailedCheckpoint) {
+  const char *walPath  = "TestRainWalCkptFail.wal";
+  const char *ckptPath = "TestRainWalNoDir/raingauge.ckpt";
+  TimeZone    utc;
+  Fleet60s    fleet(GAUGES);
+  Fleet60s    expected(GAUGES);
+
+  remove(walPath);
+  fleet.setTimeZone(&utc);
+  expected.setTimeZone(&utc);
+  Durable60s log(fleet, 4, 3);
+  ASSERT_TRUE(log.open(walPath, ckptPath));
+  for (size_t i = 0; i < 5; i++) {
+    RainReading r = reading(i);
+    EXPECT_EQ(i + 1, log.update(r));
+    expected.update(1, &r);
+  }
+  EXPECT_TRUE(log.lastCheckpointFailed());
+  for (uint32_t g = 0; g < GAUGES; g++) {
+    EXPECT_FLOAT_EQ(expected.pastHour(g), fleet.pastHour(g)) << g;
+  }
+  ASSERT_TRUE(log.commit());
+  EXPECT_EQ(5u, log.log().records());
+  remove(walPath);
+}
@@ -0,0 +1,227 @@
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// TestTimeZone.cpp
+//
+// Googletest unit tests for TimeZone - comparison against libc local time conversion
+//
+// https://github.com/matthias-bs/BresserWeatherSensorReceiver
+//
+//
+// created: 10/2026
+//
+//
+// MIT License
+//
+// Copyright (c) 2026 Matthias Prinke
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+// History:
+//
+// 20261016 Created
+// 20261017 Use helpers from RainTestUtil.h
+//
+// ToDo:
+// -
+//
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include <gtest/gtest.h>
+#include <stdlib.h>
+#include <string.h>
+#include <string>
+
+#define TOLERANCE 0.11
+#include "RainGauge.h"
+#include "RainTestUtil.h"
+#include "TimeZone.h"
+
+
+/*
+ * Compare UTC offsets with libc in given time range
+ */
+static void compareLibc(const TimeZone &tz, const char *tzEnv, time_t from, time_t to, time_t step)
+{
+  TzGuard guard(tzEnv);
+
+  for (time_t t = from; t < to; t += step) {
+    tm tm;
+    localtime_r(&t, &tm);
+    ASSERT_EQ(tm.tm_gmtoff, tz.utcOffset(t)) << tzEnv << " at " << t;
+  }
+}
+
+
+/*
+ * Default constructed timezone is UTC
+ */
+TEST(TestTimeZone, Utc) {
+  TimeZone tz;
+  int32_t  day;
+  int64_t  midnight;
+  int64_t  next;
+
+  EXPECT_EQ(0, tz.utcOffset(0));
+  EXPECT_EQ(0, tz.utcOffset(1700000000));
+
+  // 2022-09-06 08:00 UTC
+  tz.localDay(1662451200, day, midnight, next);
+  EXPECT_EQ(daysFromCivil(2022, 9, 6), day);
+  EXPECT_EQ(1662422400, midnight);
+  EXPECT_EQ(1662422400 + 86400, next);
+}
+
+
+/*
+ * POSIX TZ rules - northern and southern hemisphere, explicit DST offset, Julian days
+ */
+TEST(TestTimeZone, PosixRule) {
+  TimeZone tz;
+
+  ASSERT_TRUE(tz.loadPosix("CET-1CEST,M3.5.0,M10.5.0/3", 1970, 2100));
+  // 2023-03-26 01:00 UTC: CET -> CEST
+  EXPECT_EQ(3600, tz.utcOffset(1679792399));
+  EXPECT_EQ(7200, tz.utcOffset(1679792400));
+  // 2023-10-29 01:00 UTC: CEST -> CET
+  EXPECT_EQ(7200, tz.utcOffset(1698541199));
+  EXPECT_EQ(3600, tz.utcOffset(1698541200));
+  EXPECT_EQ(2 * (2100 - 1970 + 1), (int)tz.transitions());
+
+  const char *rules[] = {
+    "CET-1CEST,M3.5.0,M10.5.0/3",
+    "EST5EDT,M3.2.0,M11.1.0",
+    "AEST-10AEDT,M10.1.0,M4.1.0/3",
+    "<+1030>-10:30<+11>-11,M10.1.0,M4.1.0",
+    "NZST-12NZDT,M9.5.0,M4.1.0/3",
+    "<-03>3",
+    "XXX3YYY2,J60/1:30,300/23"
+  };
+  for (size_t i = 0; i < sizeof(rules) / sizeof(rules[0]); i++) {
+    ASSERT_TRUE(tz.loadPosix(rules[i], 1970, 2100)) << rules[i];
+    // 1970-01-01 .. 2099-12-31
+    compareLibc(tz, rules[i], 0, 4102444800, 86400 * 3 + 3607);
+  }
+
+  EXPECT_FALSE(tz.loadPosix("", 1970, 2100));
+  EXPECT_FALSE(tz.loadPosix("CET-1CEST,M3.5.0", 1970, 2100));
+  EXPECT_FALSE(tz.loadPosix("CET-1CEST,M13.5.0,M10.5.0", 1970, 2100));
+}
+
+
+/*
+ * Timezones from tzdata files, including years covered by the POSIX footer rule
+ */
+TEST(TestTimeZone, Tzdata) {
+  const char *zones[] = {
+    "Europe/Berlin",
+    "America/New_York",
+    "America/Sao_Paulo",
+    "Australia/Sydney",
+    "Australia/Lord_Howe",
+    "Asia/Kolkata",
+    "Pacific/Chatham"
+  };
+
+  TimeZone tz;
+  if (!tz.load("Europe/Berlin")) {
+    GTEST_SKIP() << "tzdata not installed";
+  }
+
+  for (size_t i = 0; i < sizeof(zones) / sizeof(zones[0]); i++) {
+    ASSERT_TRUE(tz.load(zones[i], 1980, 2080)) << zones[i];
+    std::string env = std::string(":") + zones[i];
+    // 1980-01-01 .. 2080-12-31
+    compareLibc(tz, env.c_str(), 315532800, 3502828800LL, 86400 + 3593);
+  }
+
+  EXPECT_FALSE(tz.load("Nowhere/Atlantis"));
+}
+
+
+/*
+ * Local day boundaries on days with DST change
+ */
+TEST(TestTimeZone, LocalDay) {
+  TimeZone tz;
+  int32_t  day;
+  int64_t  midnight;
+  int64_t  next;
+
+  ASSERT_TRUE(tz.loadPosix("CET-1CEST,M3.5.0,M10.5.0/3"));
+
+  // 2023-03-26 12:00 CEST - day has 23 hours
+  tz.localDay(1679824800, day, midnight, next);
+  EXPECT_EQ(daysFromCivil(2023, 3, 26), day);
+  EXPECT_EQ(1679785200, midnight);
+  EXPECT_EQ(1679785200 + 23 * 3600, next);
+
+  // 2023-10-29 12:00 CET - day has 25 hours
+  tz.localDay(1698577200, day, midnight, next);
+  EXPECT_EQ(daysFromCivil(2023, 10, 29), day);
+  EXPECT_EQ(1698530400, midnight);
+  EXPECT_EQ(1698530400 + 25 * 3600, next);
+
+  // Midnight does not exist: 00:00 -> 01:00 (<-02>2<-01>,M3.5.0/0,M10.5.0/1)
+  ASSERT_TRUE(tz.loadPosix("<-02>2<-01>,M3.5.0/0,M10.5.0/1"));
+  // 2023-03-26 12:00 local (-01)
+  tz.localDay(1679832000, day, midnight, next);
+  EXPECT_EQ(daysFromCivil(2023, 3, 26), day);
+  // day begins at 01:00 local = 02:00 UTC
+  EXPECT_EQ(1679796000, midnight);
+}
+
+
+/*
+ * RainGauge bound to a TimeZone is equivalent to libc local time
+ */
+TEST(TestTimeZone, RainGaugeBinding) {
+  nvData_t dataTz;
+  nvData_t dataLibc;
+  memset(&dataTz, 0, sizeof(nvData_t));
+  memset(&dataLibc, 0, sizeof(nvData_t));
+
+  RainGauge rainGaugeTz(&dataTz);
+  RainGauge rainGaugeLibc(&dataLibc);
+  rainGaugeTz.reset();
+  rainGaugeLibc.reset();
+
+  TimeZone tz;
+  ASSERT_TRUE(tz.loadPosix("CET-1CEST,M3.5.0,M10.5.0/3"));
+  rainGaugeTz.setTimeZone(&tz);
+
+  TzGuard guard("CET-1CEST,M3.5.0,M10.5.0/3");
+
+  // 2022-12-01 00:00 UTC, 7 minute interval, 400 days
+  time_t t0   = 1669852800;
+  float  rain = 0;
+  for (int i = 0; i < 400 * 205; i++) {
+    time_t t = t0 + (time_t)i * 420;
+    rain += (i % 11) * 0.1f;
+    if (rain >= RAINGAUGE_MAX_VALUE)
+      rain -= RAINGAUGE_MAX_VALUE;
+
+    rainGaugeTz.update(t, rain);
+    rainGaugeLibc.update(t, rain);
+
+    ASSERT_FLOAT_EQ(rainGaugeLibc.pastHour(),     rainGaugeTz.pastHour());
+    ASSERT_FLOAT_EQ(rainGaugeLibc.currentDay(),   rainGaugeTz.currentDay());
+    ASSERT_FLOAT_EQ(rainGaugeLibc.currentWeek(),  rainGaugeTz.currentWeek());
+    ASSERT_FLOAT_EQ(rainGaugeLibc.currentMonth(), rainGaugeTz.currentMonth());
+  }
+  ASSERT_EQ(0, memcmp(&dataTz, &dataLibc, sizeof(nvData_t)));
+}
@@ -0,0 +1,234 @@
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// RainReplayMain.cpp
+//
+// rain_replay - replays recorded readings (CSV, JSON lines or RainTrace binary trace) into
+// a RainGauge or a RainGaugeFleet and reports parse and update throughput separately
+//
+// https://github.com/matthias-bs/BresserWeatherSensorReceiver
+//
+//
+// created: 10/2026
+//
+//
+// MIT License
+//
+// Copyright (c) 2026 Matthias Prinke
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+// History:
+//
+// 20261016 Created
+// 20261016 Added binary trace input
+//
+// ToDo:
+// -
+//
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <chrono>
+
+#include "RainGauge.h"
+#include "RainGaugeFleet.h"
+#include "RainReplay.h"
+#include "RainTrace.h"
+#include "TimeZone.h"
+
+// Number of readings parsed and applied at once
+#define REPLAY_CHUNK 4096
+
+typedef std::chrono::steady_clock Clock;
+
+static double elapsedNs(Clock::time_point start, Clock::time_point stop)
+{
+    return std::chrono::duration<double, std::nano>(stop - start).count();
+}
+
+static void usage(const char *prog)
+{
+    fprintf(stderr,
+        "Usage: %s [-g gauges] [-t timezone] [-m max] file\n"
+        "  file        CSV, JSON lines or binary trace (see rain_trace)\n"
+        "  -g gauges   replay into a RainGaugeFleet with ids 0..gauges-1\n"
+        "              (default: one RainGauge, readings with id 0)\n"
+        "  -t timezone IANA timezone name for day/week/month boundaries (default: UTC)\n"
+        "  -m max      rain gauge overflow value (default: %d)\n",
+        prog, RAINGAUGE_MAX_VALUE);
+}
+
+static void report(const char *name, uint64_t readings, double ns, size_t bytes)
+{
+    printf("%-8s %10.1f ms %12.0f readings/s", name, ns / 1.0e6, (ns > 0) ? readings * 1.0e9 / ns : 0.0);
+    if (bytes)
+        printf(" %10.1f MB/s", (ns > 0) ? bytes * 1.0e3 / ns : 0.0);
+    printf("\n");
+}
+
+int main(int argc, char *argv[])
+{
+    size_t      gauges = 0;
+    const char *tzName = NULL;
+    float       maxValue = RAINGAUGE_MAX_VALUE;
+    int         i;
+
+    for (i = 1; i < argc - 1; i++) {
+        if (strcmp(argv[i], "-g") == 0) {
+            gauges = (size_t)strtoul(argv[++i], NULL, 10);
+        } else if (strcmp(argv[i], "-t") == 0) {
+            tzName = argv[++i];
+        } else if (strcmp(argv[i], "-m") == 0) {
+            maxValue = (float)strtod(argv[++i], NULL);
+        } else {
+            break;
+        }
+    }
+    if (i != argc - 1) {
+        usage(argv[0]);
+        return 2;
+    }
+
+    TimeZone tz;
+    if (tzName && !tz.load(tzName)) {
+        fprintf(stderr, "cannot load timezone %s\n", tzName);
+        return 1;
+    }
+
+    RainMappedFile file;
+    if (!file.open(argv[i])) {
+        fprintf(stderr, "cannot open %s\n", argv[i]);
+        return 1;
+    }
+
+    nvData_t        nv;
+    RainGauge       rainGauge(&nv);
+    RainGaugeFleet *fleet = NULL;
+    if (gauges) {
+        fleet = new RainGaugeFleet(gauges);
+        fleet->setTimeZone(&tz);
+    } else {
+        rainGauge.reset();
+        rainGauge.setTimeZone(&tz);
+    }
+
+    RainReplayParser parser;
+    RainTraceReader  trace;
+    bool             isTrace = RainTraceReader::isTrace(file.data(), file.size());
+    RainReading      chunk[REPLAY_CHUNK];
+    const char      *pos = file.data();
+    const char      *end = file.data() + file.size();
+    uint64_t         readings = 0;
+    uint64_t         ignored = 0;
+    double           parseNs = 0;
+    double           updateNs = 0;
+
+    if (isTrace && !trace.open(file.data(), file.size())) {
+        fprintf(stderr, "unsupported trace file %s\n", argv[i]);
+        return 1;
+    }
+
+    while (isTrace) {
+        const uint32_t *ids;
+        const time_t   *epochs;
+        const float    *values;
+        const bool     *startup;
+
+        Clock::time_point t0 = Clock::now();
+        size_t n = trace.next(ids, epochs, values, startup);
+        Clock::time_point t1 = Clock::now();
+        if (n == 0)
+            break;
+
+        // Columns are passed to the fleet as they are; readings of unknown rain gauges are skipped
+        size_t m = 0;
+        size_t first = 0;
+        for (size_t k = 0; k <= n; k++) {
+            bool known = (k < n) && (fleet ? (ids[k] < gauges) : (ids[k] == 0));
+            if (known)
+                continue;
+            if (fleet) {
+                fleet->updateBatch(k - first, ids + first, epochs + first, values + first, startup + first, maxValue);
+            } else {
+                for (size_t j = first; j < k; j++) {
+                    rainGauge.update(epochs[j], values[j], startup[j], maxValue);
+                }
+            }
+            m += k - first;
+            first = k + 1;
+        }
+        Clock::time_point t2 = Clock::now();
+
+        parseNs   += elapsedNs(t0, t1);
+        updateNs  += elapsedNs(t1, t2);
+        readings  += m;
+        ignored   += n - m;
+    }
+
+    while (!isTrace && (pos < end)) {
+        Clock::time_point t0 = Clock::now();
+        size_t n = parser.parse(pos, end, chunk, REPLAY_CHUNK);
+        Clock::time_point t1 = Clock::now();
+
+        // Drop readings of unknown rain gauges
+        size_t m = 0;
+        for (size_t k = 0; k < n; k++) {
+            if (fleet ? (chunk[k].id < gauges) : (chunk[k].id == 0))
+                chunk[m++] = chunk[k];
+        }
+        if (fleet) {
+            fleet->update(m, chunk, maxValue);
+        } else {
+            for (size_t k = 0; k < m; k++) {
+                rainGauge.update(chunk[k].epoch, chunk[k].value, chunk[k].startup, maxValue);
+            }
+        }
+        Clock::time_point t2 = Clock::now();
+
+        parseNs   += elapsedNs(t0, t1);
+        updateNs  += elapsedNs(t1, t2);
+        readings  += m;
+        ignored   += n - m;
+    }
+
+    uint64_t errors = isTrace ? (trace.error() ? 1 : 0) : parser.errors();
+    printf("%s: %zu bytes, %llu lines, %llu readings, %llu ignored, %llu errors\n",
+           argv[i], file.size(), (unsigned long long)parser.lines(), (unsigned long long)readings,
+           (unsigned long long)ignored, (unsigned long long)errors);
+    report(isTrace ? "decode" : "parse", readings + ignored, parseNs, file.size());
+    report("update", readings, updateNs, 0);
+
+    if (fleet) {
+        double hour = 0, day = 0, month = 0;
+        for (uint32_t id = 0; id < gauges; id++) {
+            hour  += fleet->pastHour(id);
+            day   += fleet->currentDay(id);
+            month += fleet->currentMonth(id);
+        }
+        printf("fleet of %zu gauges, sums: past hour %.1f, day %.1f, month %.1f\n", gauges, hour, day, month);
+        delete fleet;
+    } else {
+        printf("past hour %.1f, day %.1f, week %.1f, month %.1f\n",
+               rainGauge.pastHour(), rainGauge.currentDay(), rainGauge.currentWeek(), rainGauge.currentMonth());
+    }
+
+    return (errors == 0) ? 0 : 1;
+}
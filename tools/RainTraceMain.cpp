@@ -0,0 +1,126 @@
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// RainTraceMain.cpp
+//
+// rain_trace - converts recorded readings (CSV or JSON lines) to the binary trace
+// format of RainTraceWriter
+//
+// https://github.com/matthias-bs/BresserWeatherSensorReceiver
+//
+//
+// created: 10/2026
+//
+//
+// MIT License
+//
+// Copyright (c) 2026 Matthias Prinke
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+// History:
+//
+// 20261016 Created
+//
+// ToDo:
+// -
+//
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "RainGauge.h"
+#include "RainReplay.h"
+#include "RainTrace.h"
+
+// Number of readings parsed at once
+#define TRACE_CHUNK 4096
+
+static void usage(const char *prog)
+{
+    fprintf(stderr,
+        "Usage: %s [-b block_size] [-s scale] input output\n"
+        "  input       CSV or JSON lines (see rain_replay)\n"
+        "  output      binary trace\n"
+        "  -b size     readings per block (default: 4096)\n"
+        "  -s scale    fixed-point scale of rain values (default: %d)\n",
+        prog, RAINGAUGE_SCALE);
+}
+
+int main(int argc, char *argv[])
+{
+    size_t   blockSize = 4096;
+    unsigned scale = RAINGAUGE_SCALE;
+    int      i;
+
+    for (i = 1; i < argc - 2; i++) {
+        if (strcmp(argv[i], "-b") == 0) {
+            blockSize = (size_t)strtoul(argv[++i], NULL, 10);
+        } else if (strcmp(argv[i], "-s") == 0) {
+            scale = (unsigned)strtoul(argv[++i], NULL, 10);
+        } else {
+            break;
+        }
+    }
+    if (i != argc - 2) {
+        usage(argv[0]);
+        return 2;
+    }
+
+    RainMappedFile input;
+    if (!input.open(argv[i])) {
+        fprintf(stderr, "cannot open %s\n", argv[i]);
+        return 1;
+    }
+    RainTraceWriter writer(scale, blockSize);
+    if (!writer.open(argv[i + 1])) {
+        fprintf(stderr, "cannot create %s\n", argv[i + 1]);
+        return 1;
+    }
+
+    RainReplayParser parser;
+    RainReading      chunk[TRACE_CHUNK];
+    const char      *pos = input.data();
+    const char      *end = input.data() + input.size();
+    while (pos < end) {
+        size_t n = parser.parse(pos, end, chunk, TRACE_CHUNK);
+        for (size_t k = 0; k < n; k++) {
+            if (!writer.write(chunk[k])) {
+                fprintf(stderr, "cannot write %s\n", argv[i + 1]);
+                return 1;
+            }
+        }
+    }
+    if (!writer.close()) {
+        fprintf(stderr, "cannot write %s\n", argv[i + 1]);
+        return 1;
+    }
+
+    printf("%llu readings, %llu errors, %llu rain values rounded to 1/%u\n",
+           (unsigned long long)writer.readings(), (unsigned long long)parser.errors(),
+           (unsigned long long)writer.rounded(), scale);
+    printf("%zu bytes -> %llu bytes (%.1f bytes per reading, ratio %.1f)\n",
+           input.size(), (unsigned long long)writer.bytes(),
+           writer.readings() ? (double)writer.bytes() / writer.readings() : 0.0,
+           writer.bytes() ? (double)input.size() / writer.bytes() : 0.0);
+
+    return (parser.errors() == 0) ? 0 : 1;
+}